@@ -0,0 +1,24 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "bench.hpp"
+
+// 替换全局的 operator new, 统计堆内存分配次数. 数组和 nothrow 版本默认调用这里
+namespace {
+std::atomic<std::size_t> heap_allocations{0};
+}  // namespace
+
+std::size_t cxxui::bench::GetHeapAllocations() noexcept {
+    return heap_allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t /*size*/) noexcept { std::free(p); }
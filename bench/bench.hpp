@@ -0,0 +1,157 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cxxui::bench {
+
+/** 阻止编译器优化掉结果 */
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/** 进程启动后调用 operator new 的次数 */
+std::size_t GetHeapAllocations() noexcept;
+
+/** 执行 fn 平均每次分配堆内存的次数 */
+template <typename Fn>
+double CountHeapAllocations(Fn&& fn, std::size_t runs = 100) {
+    std::size_t before = GetHeapAllocations();
+    for (std::size_t i = 0; i < runs; ++i) {
+        fn();
+    }
+    return static_cast<double>(GetHeapAllocations() - before) / static_cast<double>(runs);
+}
+
+/** 单项测试的结果 */
+struct Result {
+    std::string name;
+    /** 每个样本的迭代次数 */
+    std::size_t iterations = 0;
+    /** 各样本每次迭代耗时的中位数和最小值 */
+    double ns_per_op = 0.0;
+    double min_ns_per_op = 0.0;
+    /** 每次迭代处理的字节数, 0 表示不统计吞吐量 */
+    std::size_t bytes_per_op = 0;
+    /** 场景相关的计数, 如缓存命中率 */
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+/** 运行参数 */
+struct Options {
+    /** 每个样本的最短时间 */
+    std::chrono::nanoseconds min_time = std::chrono::milliseconds{50};
+    /** 样本数量 */
+    std::size_t samples = 5;
+};
+
+/**
+ * @brief 测试函数的上下文
+ * @details 测试函数先准备数据，再调用 Measure 计时，准备数据的时间不计入结果。
+ */
+class State {
+public:
+    State(const Options& options, Result& result)
+        : options_(options),
+          result_(result) {}
+
+    /**
+     * @brief 重复执行 fn 并计时
+     * @details 先倍增迭代次数直到超过最短时间，再按该次数采样，取每次迭代耗时的中位数
+     */
+    template <typename Fn>
+    void Measure(Fn&& fn) {
+        std::size_t iterations = 1;
+        while (true) {
+            auto elapsed = Run(fn, iterations);
+            if (elapsed >= options_.min_time || iterations >= (std::size_t{1} << 40)) {
+                break;
+            }
+            // 按已用时间估计需要的次数, 最多放大 10 倍
+            double ratio = elapsed.count() > 0
+                               ? static_cast<double>(options_.min_time.count()) / elapsed.count()
+                               : 10.0;
+            ratio = (std::min)((std::max)(ratio * 1.2, 2.0), 10.0);
+            iterations = static_cast<std::size_t>(iterations * ratio);
+        }
+        std::vector<double> samples;
+        for (std::size_t i = 0; i < (std::max)(options_.samples, std::size_t{1}); ++i) {
+            samples.push_back(static_cast<double>(Run(fn, iterations).count()) / iterations);
+        }
+        std::sort(samples.begin(), samples.end());
+        result_.iterations = iterations;
+        result_.ns_per_op = samples[samples.size() / 2];
+        result_.min_ns_per_op = samples.front();
+    }
+    /** 设置每次迭代处理的字节数 */
+    void SetBytes(std::size_t bytes_per_op) noexcept { result_.bytes_per_op = bytes_per_op; }
+    /** 记录场景相关的计数 */
+    void SetCounter(std::string name, double value) {
+        result_.counters.emplace_back(std::move(name), value);
+    }
+
+private:
+    const Options& options_;
+    Result& result_;
+
+    template <typename Fn>
+    static std::chrono::nanoseconds Run(Fn& fn, std::size_t iterations) {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            fn();
+        }
+        return std::chrono::steady_clock::now() - start;
+    }
+};
+
+/** 注册的测试 */
+struct Benchmark {
+    std::string name;
+    std::function<void(State&)> fn;
+};
+
+/** 所有测试, 按注册顺序运行 */
+inline std::vector<Benchmark>& GetBenchmarks() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+/**
+ * @brief 注册测试
+ *
+ * @param name 测试名, 以 / 分隔分组, 如 "utf/u82w/ascii_1k"
+ * @param fn 测试函数
+ */
+inline void Register(std::string name, std::function<void(State&)> fn) {
+    GetBenchmarks().push_back({std::move(name), std::move(fn)});
+}
+
+/** 在静态初始化时注册测试 */
+struct Registrar {
+    template <typename Fn>
+    explicit Registrar(Fn&& fn) {
+        fn();
+    }
+};
+
+}  // namespace cxxui::bench
+
+#define CXXUI_BENCH_CONCAT_IMPL(a, b) a##b
+#define CXXUI_BENCH_CONCAT(a, b) CXXUI_BENCH_CONCAT_IMPL(a, b)
+/** 定义一组测试的注册函数, 函数体内调用 Register */
+#define CXXUI_BENCH_GROUP(group)                                                          \
+    static void CXXUI_BENCH_CONCAT(RegisterBench_, group)();                              \
+    static const ::cxxui::bench::Registrar CXXUI_BENCH_CONCAT(bench_registrar_, group){ \
+        CXXUI_BENCH_CONCAT(RegisterBench_, group)};                                       \
+    static void CXXUI_BENCH_CONCAT(RegisterBench_, group)()
@@ -0,0 +1,373 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cxxui/core/layout.hpp>
+#include <cxxui/core/detail/damage.hpp>
+#include <cxxui/core/detail/dispatch.hpp>
+#include <cxxui/core/detail/library.hpp>
+#include <cxxui/core/detail/pixel_kernels.hpp>
+#include <cxxui/core/detail/placement.hpp>
+#include <cxxui/core/detail/string_coder.hpp>
+#include <cxxui/core/detail/timer_wheel.hpp>
+#include "bench.hpp"
+
+using namespace cxxui;
+using namespace cxxui::detail;
+using namespace cxxui::bench;
+
+namespace {
+
+/** 重复 pattern 直到长度不少于 size 字节 */
+std::string MakeText(std::string_view pattern, std::size_t size) {
+    std::string text;
+    while (text.size() < size) {
+        text.append(pattern);
+    }
+    return text;
+}
+
+void AddUtf(const char* name, std::string_view pattern, std::size_t size) {
+    std::string text = MakeText(pattern, size);
+    Register(std::string{"utf/u82w/"} + name, [text](State& state) {
+        state.SetBytes(text.size());
+        state.Measure([&text] { DoNotOptimize(U82W(text)); });
+    });
+    Register(std::string{"utf/w2u8/"} + name, [text](State& state) {
+        std::wstring wide = U82W(text);
+        state.SetBytes(text.size());
+        state.Measure([&wide] { DoNotOptimize(W2U8(wide)); });
+    });
+}
+
+/** 三个显示器: 主屏 100%, 右侧 4K 150%, 上方 125% */
+std::vector<MonitorInfo> MakeMonitors() {
+    return {
+        {{0, 0, 1920, 1080}, 1.0f},
+        {{1920, 0, 4480, 1440}, 1.5f},
+        {{0, -1200, 1920, -120}, 1.25f},
+    };
+}
+
+/** 模拟窗口基类的事件处理函数, 与 WindowBase 的派发表结构相同 */
+template <typename Derived>
+struct FakeWindow {
+    void OnA(int) {}
+    void OnB(int) {}
+    void OnC(int) {}
+    void OnD(int) {}
+    void OnE(int) {}
+    void OnF(int) {}
+    void OnG(int) {}
+    void OnH(int) {}
+};
+struct FakeApp : FakeWindow<FakeApp> {
+    int sum = 0;
+    void OnA(int x) { sum += x; }
+    void OnC(int x) { sum ^= x; }
+    void OnF(int x) { sum -= x; }
+    void OnH(int x) { sum += x * 2; }
+};
+template <std::uint32_t Msg, auto Handler, auto Default>
+struct FakeEntry {
+    static constexpr std::uint32_t kMsg = Msg;
+    static constexpr bool kEnabled = IsOverridden<decltype(Handler), decltype(Default)>;
+    static void Invoke(FakeApp& app, int x) { (app.*Handler)(x); }
+};
+using Base = FakeWindow<FakeApp>;
+using FakeTable = DispatchTable<FakeEntry<0x0001, &FakeApp::OnA, &Base::OnA>,
+                                FakeEntry<0x0005, &FakeApp::OnB, &Base::OnB>,
+                                FakeEntry<0x000F, &FakeApp::OnC, &Base::OnC>,
+                                FakeEntry<0x0014, &FakeApp::OnD, &Base::OnD>,
+                                FakeEntry<0x0100, &FakeApp::OnE, &Base::OnE>,
+                                FakeEntry<0x0200, &FakeApp::OnF, &Base::OnF>,
+                                FakeEntry<0x0201, &FakeApp::OnG, &Base::OnG>,
+                                FakeEntry<0x0400, &FakeApp::OnH, &Base::OnH>>;
+
+std::uint32_t RandomPixel(std::mt19937& rng) {
+    std::uint32_t alpha = rng() % 256;
+    std::uint8_t c = static_cast<std::uint8_t>(rng() % (alpha + 1));
+    return ToPixel(Color(c, c, c, static_cast<std::uint8_t>(alpha)));
+}
+
+
+/** 模拟的动态库加载, 不访问文件系统, 只测量缓存和查找本身的开销 */
+struct FakeLoader {
+    static inline std::size_t opens = 0;
+    static void* Open(const char* name) noexcept {
+        ++opens;
+        return const_cast<char*>(name);
+    }
+    static void* Find(void*, const char* name) noexcept { return const_cast<char*>(name); }
+    static void Close(void*) noexcept {}
+};
+using FakeFn = void (*)();
+
+/** 进程已加载的系统库和其中的函数 */
+#if defined(_WIN32)
+constexpr const char* kSystemLibrary = "kernel32.dll";
+constexpr const char* kSystemFunction = "GetTickCount";
+#elif defined(__APPLE__)
+constexpr const char* kSystemLibrary = "libSystem.B.dylib";
+constexpr const char* kSystemFunction = "free";
+#else
+constexpr const char* kSystemLibrary = "libc.so.6";
+constexpr const char* kSystemFunction = "free";
+#endif
+
+}  // namespace
+
+CXXUI_BENCH_GROUP(utf) {
+    AddUtf("ascii_64", "hello, world! ", 64);
+    AddUtf("ascii_4k", "hello, world! ", 4096);
+    AddUtf("cjk_4k", "\xE4\xBD\xA0\xE5\xA5\xBD\xE4\xB8\x96\xE7\x95\x8C", 4096);
+    AddUtf("mixed_4k", "path/\xE6\x96\x87\xE4\xBB\xB6-\xF0\x9F\x98\x80.png;", 4096);
+}
+
+CXXUI_BENCH_GROUP(placement) {
+    Register("placement/center_scaled", [](State& state) {
+        auto monitors = MakeMonitors();
+        Point cursor{2500, 700};
+        state.Measure([&] {
+            DoNotOptimize(PlaceWindow(monitors, cursor, {0, 0, 640, 480, true, true}, true));
+        });
+    });
+    Register("placement/cross_monitor", [](State& state) {
+        auto monitors = MakeMonitors();
+        Point cursor{100, 100};
+        // 中心落在两个缩放比例不同的显示器交界处
+        state.Measure([&] {
+            DoNotOptimize(PlaceWindow(monitors, cursor, {1700, 100, 640, 480, false, false}, true));
+        });
+    });
+    Register("placement/unscaled", [](State& state) {
+        auto monitors = MakeMonitors();
+        Point cursor{100, 100};
+        state.Measure([&] {
+            DoNotOptimize(PlaceWindow(monitors, cursor, {0, 0, 640, 480, true, true}, false));
+        });
+    });
+}
+
+CXXUI_BENCH_GROUP(dispatch) {
+    Register("dispatch/table_mixed", [](State& state) {
+        static constexpr std::uint32_t kMessages[] = {0x0001, 0x0005, 0x000F, 0x0014,
+                                                      0x0100, 0x0200, 0x0201, 0x0400};
+        FakeApp app;
+        std::size_t i = 0;
+        state.Measure([&] {
+            std::uint32_t msg = kMessages[i++ % 8];
+            DoNotOptimize(msg);
+            DoNotOptimize(FakeTable::Dispatch(msg, app, 3));
+        });
+        DoNotOptimize(app.sum);
+    });
+    Register("dispatch/table_miss", [](State& state) {
+        FakeApp app;
+        std::uint32_t msg = 0x0113;
+        state.Measure([&] {
+            DoNotOptimize(msg);
+            DoNotOptimize(FakeTable::Dispatch(msg, app, 3));
+        });
+    });
+}
+
+CXXUI_BENCH_GROUP(layout) {
+    // 100 行 x 100 列的叶子节点
+    auto make_tree = [](LayoutNode& root) {
+        root.SetDirection(FlexDirection::COLUMN);
+        LayoutNode* last = nullptr;
+        for (int i = 0; i < 100; ++i) {
+            auto& row = root.AddChild().SetGrow(1);
+            for (int j = 0; j < 100; ++j) {
+                last = &row.AddChild().SetGrow(1).SetHandle(&row);
+            }
+        }
+        return last;
+    };
+    Register("layout/full_10k", [make_tree](State& state) {
+        LayoutNode root;
+        make_tree(root);
+        std::vector<LayoutNode*> changed;
+        int width = 4000;
+        state.Measure([&] {
+            // 改变根节点大小, 所有节点都要重新计算
+            width = width == 4000 ? 4001 : 4000;
+            changed.clear();
+            root.Compute({0, 0, width, 4000}, &changed);
+        });
+        state.SetCounter("changed", static_cast<double>(changed.size()));
+    });
+    Register("layout/incremental_leaf", [make_tree](State& state) {
+        LayoutNode root;
+        LayoutNode* last = make_tree(root);
+        std::vector<LayoutNode*> changed;
+        root.Compute({0, 0, 4000, 4000}, &changed);
+        int min_width = 80;
+        state.Measure([&] {
+            min_width = min_width == 80 ? 81 : 80;
+            last->SetMinWidth(min_width);
+            changed.clear();
+            root.Compute({0, 0, 4000, 4000}, &changed);
+        });
+        state.SetCounter("changed", static_cast<double>(changed.size()));
+    });
+}
+
+CXXUI_BENCH_GROUP(pixels) {
+    constexpr std::size_t kCount = 1920 * 1080;
+    auto make = [kCount] {
+        std::mt19937 rng(3);
+        std::vector<std::uint32_t> pixels(kCount);
+        for (auto& pixel : pixels) {
+            pixel = RandomPixel(rng);
+        }
+        return pixels;
+    };
+    Register("pixels/fill_1080p", [make, kCount](State& state) {
+        auto dst = make();
+        state.SetBytes(kCount * 4);
+        state.Measure([&] {
+            FillPixels(dst.data(), kCount, 0xFF112233);
+            DoNotOptimize(dst.data());
+        });
+    });
+    Register("pixels/copy_1080p", [make, kCount](State& state) {
+        auto dst = make();
+        auto src = make();
+        state.SetBytes(kCount * 4);
+        state.Measure([&] {
+            CopyPixels(dst.data(), src.data(), kCount);
+            DoNotOptimize(dst.data());
+        });
+    });
+    Register("pixels/blend_1080p", [make, kCount](State& state) {
+        auto dst = make();
+        auto src = make();
+        state.SetBytes(kCount * 4);
+        state.Measure([&] {
+            BlendPixels(dst.data(), src.data(), kCount);
+            DoNotOptimize(dst.data());
+        });
+    });
+    Register("pixels/blend_fill_1080p", [make, kCount](State& state) {
+        auto dst = make();
+        state.SetBytes(kCount * 4);
+        state.Measure([&] {
+            BlendFill(dst.data(), kCount, 0x80402010);
+            DoNotOptimize(dst.data());
+        });
+    });
+    Register("pixels/colors_1080p", [kCount](State& state) {
+        std::vector<std::uint32_t> dst(kCount);
+        std::vector<Color> src(kCount, Color(10, 20, 30, 128));
+        state.SetBytes(kCount * 4);
+        state.Measure([&] {
+            ColorsToPixels(dst.data(), src.data(), kCount);
+            DoNotOptimize(dst.data());
+        });
+    });
+}
+
+CXXUI_BENCH_GROUP(damage) {
+    // 4K 窗口上每帧 12 个分散的小控件失效, 如光标闪烁和进度更新
+    Register("damage/scattered_12_4k", [](State& state) {
+        DamageTracker tracker;
+        std::mt19937 rng(5);
+        std::int64_t raw = 0;
+        std::int64_t painted = 0;
+        std::size_t rects = 0;
+        std::size_t frames = 0;
+        state.Measure([&] {
+            for (int k = 0; k < 12; ++k) {
+                int x = static_cast<int>(rng() % 3800);
+                int y = static_cast<int>(rng() % 2100);
+                Rect r{x, y, x + 8 + static_cast<int>(rng() % 60),
+                       y + 8 + static_cast<int>(rng() % 40)};
+                raw += DamageTracker::Area(r);
+                tracker.Add(r);
+            }
+            for (const Rect& r : tracker.GetRects()) {
+                painted += DamageTracker::Area(r);
+            }
+            rects += tracker.GetRects().size();
+            ++frames;
+            tracker.Clear();
+        });
+        state.SetCounter("rects_per_frame", static_cast<double>(rects) / frames);
+        state.SetCounter("painted_over_raw", static_cast<double>(painted) / raw);
+        state.SetCounter("painted_over_full",
+                         static_cast<double>(painted) / (static_cast<double>(frames) * 3840 * 2160));
+    });
+}
+
+CXXUI_BENCH_GROUP(timer) {
+    constexpr std::size_t kTimers = 100000;
+    // 10 万个 1ms~60s 的重复定时器, 如大量动画、心跳和超时
+    auto make = [](TimerWheel& wheel, std::vector<TimerNode>& nodes, std::size_t& fired) {
+        std::mt19937 rng(9);
+        for (TimerNode& node : nodes) {
+            std::uint64_t delay = 1 + rng() % 60000;
+            node.callback = [&fired] { ++fired; };
+            wheel.Schedule(node, delay, delay);
+        }
+    };
+    // 大量活动定时器时启动并取消一个定时器
+    Register("timer/schedule_cancel_100k", [make](State& state) {
+        // 节点要晚于时间轮析构
+        std::vector<TimerNode> nodes(kTimers);
+        TimerWheel wheel;
+        std::size_t fired = 0;
+        make(wheel, nodes, fired);
+        TimerNode node;
+        std::uint64_t delay = 0;
+        state.Measure([&] {
+            delay = delay * 6364136223846793005ull + 1442695040888963407ull;
+            wheel.Schedule(node, 1 + (delay >> 40) % 60000);
+            wheel.Cancel(node);
+        });
+        state.SetCounter("active", static_cast<double>(wheel.Size()));
+    });
+    // 每帧(16ms)推进一次时间轮, 触发到期的定时器并重新排期
+    Register("timer/advance_frame_100k", [make](State& state) {
+        // 节点要晚于时间轮析构
+        std::vector<TimerNode> nodes(kTimers);
+        TimerWheel wheel;
+        std::size_t fired = 0;
+        make(wheel, nodes, fired);
+        std::size_t frames = 0;
+        state.Measure([&] {
+            wheel.Advance(wheel.Now() + 16);
+            ++frames;
+        });
+        state.SetCounter("fired_per_frame", static_cast<double>(fired) / frames);
+    });
+}
+
+CXXUI_BENCH_GROUP(library) {
+    // 已解析的函数每次调用的开销, 只有一次原子读取
+    Register("library/symbol_get_resolved", [](State& state) {
+        static Symbol<FakeFn, FakeLoader> symbol{"user32.dll", "SetThreadDpiAwarenessContext"};
+        symbol.Get();
+        state.Measure([] { DoNotOptimize(symbol.Get()); });
+    });
+    // 第一次解析: 在进程共享的模块表中查找已加载的库再查找函数
+    Register("library/symbol_resolve_first", [](State& state) {
+        const char* modules[] = {"user32.dll", "shcore.dll", "dwmapi.dll", "shlwapi.dll"};
+        std::size_t i = 0;
+        std::size_t opens = FakeLoader::opens;
+        state.Measure([&] {
+            Symbol<FakeFn, FakeLoader> symbol{modules[i++ % 4], "GetDpiForMonitor"};
+            DoNotOptimize(symbol.Get());
+        });
+        state.SetCounter("module_opens", static_cast<double>(FakeLoader::opens - opens));
+    });
+    // 对照: 每次调用都加载系统库并查找函数(库已被进程加载, 只增加引用计数)
+    Register("library/system_library_per_call", [](State& state) {
+        state.Measure([] {
+            Library library{kSystemLibrary};
+            DoNotOptimize(library.Get<FakeFn>(kSystemFunction));
+        });
+    });
+}
@@ -0,0 +1,129 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cxxui/core/executor.hpp>
+#include "bench.hpp"
+
+using namespace cxxui;
+using namespace cxxui::bench;
+
+namespace {
+
+/** 约 rounds 次乘加的计算, 模拟任务的工作量 */
+std::uint64_t Work(std::uint64_t seed, int rounds) {
+    for (int i = 0; i < rounds; ++i) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    }
+    return seed;
+}
+
+void WaitZero(const std::atomic<std::size_t>& left) {
+    while (left.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+}
+
+/** 测试的线程数: 1 2 4 8 和 CPU 核数 */
+std::vector<std::size_t> GetThreadCounts() {
+    std::vector<std::size_t> counts{1, 2, 4, 8};
+    std::size_t cores = std::thread::hardware_concurrency();
+    if (cores > 8) {
+        counts.push_back(cores);
+    }
+    return counts;
+}
+
+/** 记录线程数和被窃取任务的比例 */
+void SetStats(State& state, const Executor& executor) {
+    ExecutorStats stats = executor.GetStats();
+    state.SetCounter("threads", static_cast<double>(executor.GetThreadCount()));
+    state.SetCounter("stolen_pct",
+                     stats.executed > 0 ? 100.0 * static_cast<double>(stats.stolen) /
+                                              static_cast<double>(stats.executed)
+                                        : 0.0);
+}
+
+/** UI 线程一次投递 kTasks 个独立任务, 等待全部完成 */
+void AddFanout(std::size_t threads) {
+    Register("executor/fanout_10k_t" + std::to_string(threads), [threads](State& state) {
+        constexpr std::size_t kTasks = 10000;
+        Executor executor(threads);
+        std::atomic<std::size_t> left{0};
+        std::atomic<std::uint64_t> sink{0};
+        state.Measure([&] {
+            left.store(kTasks, std::memory_order_relaxed);
+            for (std::size_t i = 0; i < kTasks; ++i) {
+                executor.Post([&, i] {
+                    sink.fetch_add(Work(i, 200), std::memory_order_relaxed);
+                    left.fetch_sub(1, std::memory_order_release);
+                });
+            }
+            WaitZero(left);
+        });
+        SetStats(state, executor);
+    });
+}
+
+/** 池内递归拆分任务, 测试本线程队列和窃取 */
+void Split(Executor& executor,
+           std::atomic<std::size_t>& left,
+           std::atomic<std::uint64_t>& sink,
+           std::uint64_t begin,
+           std::uint64_t end) {
+    while (end - begin > 64) {
+        std::uint64_t mid = begin + (end - begin) / 2;
+        left.fetch_add(1, std::memory_order_relaxed);
+        executor.Post([&executor, &left, &sink, mid, end] { Split(executor, left, sink, mid, end); });
+        end = mid;
+    }
+    std::uint64_t sum = 0;
+    for (std::uint64_t i = begin; i < end; ++i) {
+        sum += Work(i, 20);
+    }
+    sink.fetch_add(sum, std::memory_order_relaxed);
+    left.fetch_sub(1, std::memory_order_release);
+}
+void AddSplit(std::size_t threads) {
+    Register("executor/split_64k_t" + std::to_string(threads), [threads](State& state) {
+        Executor executor(threads);
+        std::atomic<std::size_t> left{0};
+        std::atomic<std::uint64_t> sink{0};
+        state.Measure([&] {
+            left.store(1, std::memory_order_relaxed);
+            executor.Post([&] { Split(executor, left, sink, 0, 64 * 1024); });
+            WaitZero(left);
+        });
+        SetStats(state, executor);
+    });
+}
+
+}  // namespace
+
+CXXUI_BENCH_GROUP(executor) {
+    for (std::size_t threads : GetThreadCounts()) {
+        AddFanout(threads);
+    }
+    for (std::size_t threads : GetThreadCounts()) {
+        AddSplit(threads);
+    }
+    // 提交一个空任务并等待结果的往返延迟
+    Register("executor/submit_get", [](State& state) {
+        Executor executor(2);
+        state.Measure([&] { DoNotOptimize(executor.Submit([] { return 1; }).Get()); });
+    });
+    // 100 个 Then 依次执行的总延迟
+    Register("executor/then_chain_100", [](State& state) {
+        Executor executor(2);
+        state.Measure([&] {
+            Future<int> future = executor.Submit([] { return 0; });
+            for (int i = 0; i < 100; ++i) {
+                future = std::move(future).Then([](int value) { return value + 1; });
+            }
+            DoNotOptimize(future.Get());
+        });
+    });
+}
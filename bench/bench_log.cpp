@@ -0,0 +1,58 @@
+#include <chrono>
+
+#define CXXUI_LOG_LEVEL CXXUI_LOG_LEVEL_DEBUG
+#include <cxxui/core/log.hpp>
+#include "bench.hpp"
+
+using namespace cxxui;
+using namespace cxxui::bench;
+
+namespace {
+
+/** 每批写入的数量, 小于暂存区容量, 不会丢弃 */
+constexpr int kBatch = 512;
+
+/** 只统计写入线程的耗时, 不包括后台线程的格式化 */
+double MeasureProducer() {
+    std::chrono::nanoseconds total{0};
+    constexpr int kRounds = 200;
+    for (int round = 0; round < kRounds; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kBatch; ++i) {
+            CXXUI_LOG_WARN("ExecuteScript failed", i, "detail");
+        }
+        total += std::chrono::steady_clock::now() - start;
+        FlushLog();
+    }
+    return static_cast<double>(total.count()) / (kRounds * kBatch);
+}
+
+void AddFormat(const char* name, LogFormat format) {
+    Register(std::string{"log/"} + name, [format](State& state) {
+        std::size_t bytes = 0;
+        // 后台线程不主动写入, 由测试按批取出, 耗时包括格式化
+        StartLog([&bytes](std::string_view data) { bytes += data.size(); }, format,
+                 std::chrono::hours{1});
+        state.SetCounter("producer_ns", MeasureProducer());
+        int i = 0;
+        state.Measure([&i] {
+            CXXUI_LOG_WARN("ExecuteScript failed", i, "detail");
+            if (++i % kBatch == 0) {
+                FlushLog();
+            }
+        });
+        StopLog();
+        DoNotOptimize(bytes);
+    });
+}
+
+}  // namespace
+
+CXXUI_BENCH_GROUP(log) {
+    Register("log/disabled", [](State& state) {
+        int i = 0;
+        state.Measure([&i] { CXXUI_LOG_WARN("ExecuteScript failed", ++i); });
+    });
+    AddFormat("text", LogFormat::TEXT);
+    AddFormat("binary", LogFormat::BINARY);
+}
@@ -0,0 +1,22 @@
+#define CXXUI_ENABLE_TRACE
+#include <cxxui/core/trace.hpp>
+#include "bench.hpp"
+
+using namespace cxxui::bench;
+
+CXXUI_BENCH_GROUP(trace) {
+    Register("trace/scope", [](State& state) {
+        state.Measure([] { CXXUI_TRACE_SCOPE("bench"); });
+    });
+    Register("trace/instant", [](State& state) {
+        state.Measure([] { CXXUI_TRACE_INSTANT("bench"); });
+    });
+    Register("trace/async_pair", [](State& state) {
+        std::uint64_t id = 0;
+        state.Measure([&id] {
+            CXXUI_TRACE_ASYNC_BEGIN("bench", id);
+            CXXUI_TRACE_ASYNC_END("bench", id);
+            ++id;
+        });
+    });
+}
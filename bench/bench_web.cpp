@@ -0,0 +1,435 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cxxui/core/detail/page_cache.hpp>
+#include <cxxui/web_win/js_msg_map.hpp>
+#include <cxxui/web_win/impl/detail/body_reader.hpp>
+#include <cxxui/web_win/impl/detail/mime_types.hpp>
+#include <cxxui/web_win/impl/detail/patch_log.hpp>
+#include <cxxui/web_win/impl/detail/request_view.hpp>
+#include <cxxui/web_win/impl/detail/script_batch.hpp>
+#include "bench.hpp"
+
+using namespace cxxui;
+using namespace cxxui::detail;
+using namespace cxxui::bench;
+
+namespace {
+
+/** 公开 JsMsgMap 的处理和查找函数 */
+template <typename Json>
+class BasicBenchMsgMap : public JsMsgMap<BasicBenchMsgMap<Json>, Json> {
+public:
+    using JsMsgHandler<BasicBenchMsgMap<Json>, Json>::Handle;
+    using JsMsgMap<BasicBenchMsgMap<Json>, Json>::FindHandler;
+};
+using BenchMsgMap = BasicBenchMsgMap<json>;
+
+/** 改为不抛出异常之前的 JsMsgHandler::Handle, 用于比较错误处理的开销 */
+class LegacyMsgMap {
+public:
+    void bind(std::string url, std::function<json(json&)> func) {
+        handlers_[std::move(url)] = std::move(func);
+    }
+    std::string Handle(std::string msg) const noexcept {
+        json ctx;
+        std::string url;
+        try {
+            ctx = json::parse(std::move(msg));
+            url = ctx.at("url").get<std::string>();
+        } catch (const std::exception& e) {
+            ctx["code"] = static_cast<int>(JsMsgError::INVALID_REQ);
+            ctx["error"] = e.what();
+            return ctx.dump();
+        }
+        std::function<json(json&)> func;
+        try {
+            func = FindHandler(url);
+        } catch (const std::exception& e) {
+            ctx["code"] = static_cast<int>(JsMsgError::NO_METHOD);
+            ctx["error"] = e.what();
+            return ctx.dump();
+        }
+        try {
+            auto data = func(ctx["data"]);
+            ctx["data"] = data;
+            ctx["code"] = static_cast<int>(JsMsgError::SUCCESS);
+        } catch (const std::exception& e) {
+            ctx["code"] = static_cast<int>(JsMsgError::EXEC_ERROR);
+            ctx["error"] = e.what();
+            return ctx.dump();
+        }
+        return ctx.dump();
+    }
+
+private:
+    std::function<json(json&)> FindHandler(const std::string& url) const {
+        auto it = handlers_.find(url);
+        if (it == handlers_.end()) {
+            throw std::runtime_error("Method not found!");
+        }
+        return it->second;
+    }
+    std::map<std::string, std::function<json(json&)>> handlers_;
+};
+
+/** 错误请求, 每种对应一个错误分支 */
+struct ErrorCase {
+    const char* name;
+    const char* msg;
+};
+constexpr ErrorCase kErrorCases[] = {
+    {"invalid_json", R"({"url": "/echo", "data": )"},
+    {"no_url", R"({"data": {"id": 42}})"},
+    {"no_method", R"({"url": "/missing", "data": {"id": 42}})"},
+    {"handler_error", R"({"url": "/fail", "data": {"id": 42}})"},
+};
+
+/** 分别测试旧的异常处理和新的错误返回, 旧版响应函数只能抛出异常 */
+void AddError(const ErrorCase& error) {
+    Register(std::string{"js_msg/error/"} + error.name + "_legacy", [error](State& state) {
+        LegacyMsgMap map;
+        map.bind("/fail", [](json&) -> json { throw std::runtime_error("用户名不存在"); });
+        std::string msg = error.msg;
+        state.Measure([&] { DoNotOptimize(map.Handle(msg)); });
+    });
+    Register(std::string{"js_msg/error/"} + error.name, [error](State& state) {
+        BenchMsgMap map;
+        map.bind("/fail", [](json&) -> JsMsgResult { return FailJsMsg("用户名不存在"); });
+        std::string msg = error.msg;
+        state.Measure([&] { DoNotOptimize(map.Handle(msg)); });
+    });
+}
+
+/** 生成 data 中包含 size 字节左右字符串的请求 */
+std::string MakeRequest(const std::string& url, std::size_t size) {
+    json req{{"url", url}, {"data", {{"id", 42}, {"items", json::array()}}}};
+    auto& items = req["data"]["items"];
+    std::size_t used = 0;
+    for (int i = 0; used < size; ++i) {
+        std::string name = "item-" + std::to_string(i);
+        used += name.size() + 24;
+        items.push_back({{"name", std::move(name)}, {"value", i}});
+    }
+    return req.dump();
+}
+
+/** 请求和响应在堆上或消息内存池上分配, 统计每条消息分配堆内存的次数 */
+template <typename Json>
+void AddHandle(std::string name, std::size_t size) {
+    Register("js_msg/handle/" + name, [size](State& state) {
+        BasicBenchMsgMap<Json> map;
+        map.bind("/echo", [](Json& data) { return data["id"]; });
+        map.bind("/rows", [](Json& data) { return data["items"]; });
+        std::string echo = MakeRequest("/echo", size);
+        std::string rows = MakeRequest("/rows", size);
+        state.SetBytes(echo.size());
+        state.SetCounter("heap_allocs", CountHeapAllocations([&] { map.Handle(echo); }));
+        state.SetCounter("heap_allocs_rows", CountHeapAllocations([&] { map.Handle(rows); }));
+        state.Measure([&] { DoNotOptimize(map.Handle(echo)); });
+    });
+}
+void AddHandle(const char* name, std::size_t size) {
+    AddHandle<json>(name, size);
+    AddHandle<ArenaJson>(std::string{name} + "_arena", size);
+}
+
+/** 数量为 count 的路由, 形如 /api/module7/action3 */
+std::vector<std::string> MakeRoutes(std::size_t count) {
+    std::vector<std::string> routes;
+    for (std::size_t i = 0; i < count; ++i) {
+        routes.push_back("/api/module" + std::to_string(i / 10) + "/action" +
+                         std::to_string(i % 10));
+    }
+    return routes;
+}
+
+/** 长度为 size 的查询参数值, escape 为 true 时一半字符需要转义 */
+std::string MakeQueryValue(std::size_t size, bool escape) {
+    std::string value;
+    for (std::size_t i = 0; value.size() < size; ++i) {
+        value += escape && i % 2 ? "%E4" : "ab";
+    }
+    return value;
+}
+
+/** 带 rows 行数据的文档, 模拟大表格状态 */
+json MakeTable(std::size_t rows) {
+    json doc{{"title", "table"}, {"rows", json::array()}};
+    for (std::size_t i = 0; i < rows; ++i) {
+        doc["rows"].push_back({{"id", i}, {"name", "row " + std::to_string(i)}, {"value", 0}});
+    }
+    return doc;
+}
+
+/** 用临时文件代替请求内容的 IStream */
+class FileStream {
+public:
+    explicit FileStream(std::FILE* file)
+        : file_(file) {}
+    Expected<std::size_t, long> Read(void* buffer, std::size_t size) {
+        std::size_t read = std::fread(buffer, 1, size, file_);
+        if (read == 0 && std::ferror(file_)) {
+            return Unexpected{-1L};
+        }
+        return read;
+    }
+
+private:
+    std::FILE* file_;
+};
+
+/** 分块读取 body_size 字节的上传内容并计算校验和 */
+void AddBodyRead(const char* name, std::size_t body_size, std::size_t chunk_size) {
+    Register(std::string{"body/read_"} + name, [=](State& state) {
+        std::FILE* file = std::tmpfile();
+        if (!file) {
+            throw std::runtime_error("tmpfile failed");
+        }
+        std::vector<char> data(body_size);
+        std::mt19937 rng(7);
+        std::generate(data.begin(), data.end(), [&] { return static_cast<char>(rng()); });
+        std::fwrite(data.data(), 1, data.size(), file);
+        data = {};
+        auto upload = [&] {
+            std::rewind(file);
+            ChunkReader<FileStream> reader(FileStream{file}, chunk_size);
+            std::uint32_t sum = 0;
+            reader.ForEach([&](std::string_view chunk) {
+                for (char c : chunk) {
+                    sum = sum * 31 + static_cast<unsigned char>(c);
+                }
+            });
+            DoNotOptimize(sum);
+        };
+        // 内存占用只有一块, 与上传大小无关
+        state.SetCounter("heap_allocs", CountHeapAllocations(upload, 5));
+        state.SetCounter("buffer_kb", chunk_size / 1024.0);
+        state.SetBytes(body_size);
+        state.Measure(upload);
+        std::fclose(file);
+    });
+}
+
+/** 预取 ahead 页时模拟滚动的每次查询, 统计同步加载次数 */
+void AddScroll(std::size_t ahead) {
+    Register("page_cache/scroll_ahead" + std::to_string(ahead), [ahead](State& state) {
+        constexpr std::size_t kTotal = 1000000;
+        constexpr std::size_t kViewport = 50;
+        PageCache<int> cache(100, 16);
+        PrefetchPlanner planner;
+        planner.SetAhead(ahead);
+        planner.SetBehind(1);
+        std::mt19937 rng(1);
+        std::size_t pos = 0;
+        std::size_t step = 0;
+        std::size_t sync_loads = 0;
+        std::size_t prefetches = 0;
+        state.Measure([&] {
+            // 依次慢速下滚、快速下滚、上滚、随机跳动
+            int phase = static_cast<int>(step++ / 2000 % 4);
+            long delta = phase == 0   ? 30
+                         : phase == 1 ? 120
+                         : phase == 2 ? -40
+                                      : static_cast<long>(rng() % 200) - 100;
+            long next = static_cast<long>(pos) + delta;
+            pos = static_cast<std::size_t>(
+                std::clamp(next, 0L, static_cast<long>(kTotal - kViewport)));
+            auto first = cache.GetPage(pos);
+            auto last = cache.GetPage(pos + kViewport - 1);
+            for (auto page = first; page <= last; ++page) {
+                if (!cache.Find(0, page)) {
+                    cache.Put(0, page, std::vector<int>(100));
+                    ++sync_loads;
+                }
+            }
+            // 空闲时执行所有预取
+            for (auto page : planner.Plan(0, first, last, kTotal / 100)) {
+                if (!cache.Contains(0, page)) {
+                    cache.Put(0, page, std::vector<int>(100));
+                    ++prefetches;
+                }
+            }
+        });
+        state.SetCounter("sync_loads_per_1k", sync_loads * 1000.0 / step);
+        state.SetCounter("prefetches_per_1k", prefetches * 1000.0 / step);
+    });
+}
+
+}  // namespace
+
+CXXUI_BENCH_GROUP(request) {
+    for (bool escape : {false, true}) {
+        Register(std::string{"request/percent_decode_1k"} + (escape ? "_escaped" : "_plain"),
+                 [escape](State& state) {
+                     std::string input = MakeQueryValue(1024, escape);
+                     std::string output;
+                     state.SetBytes(input.size());
+                     state.Measure([&] {
+                         output.clear();
+                         PercentDecode(input, output, true);
+                         DoNotOptimize(output.data());
+                     });
+                 });
+    }
+    Register("request/split_url", [](State& state) {
+        std::string url = "http://localhost:8080/static/js/app.js?v=3&lang=zh-CN#top";
+        state.Measure([&] { DoNotOptimize(SplitUrl(url)); });
+    });
+    // 每个请求只取路径和一个参数, 解析结果指向原始 url
+    Register("request/path_and_query", [](State& state) {
+        std::string url = "http://localhost/api/rows?offset=100&count=50&sort=name&filter=a%20b";
+        state.SetCounter("heap_allocs", CountHeapAllocations([&] {
+                             RequestView view(url);
+                             DoNotOptimize(view.GetQuery("filter"));
+                         }));
+        state.Measure([&] {
+            RequestView view(url);
+            DoNotOptimize(view.GetPath());
+            DoNotOptimize(view.GetQuery("count"));
+        });
+    });
+}
+
+CXXUI_BENCH_GROUP(body) {
+    AddBodyRead("16m_chunk_4k", 16 << 20, 4 << 10);
+    AddBodyRead("16m_chunk_64k", 16 << 20, 64 << 10);
+    AddBodyRead("16m_chunk_1m", 16 << 20, 1 << 20);
+    AddBodyRead("64m_chunk_64k", 64 << 20, 64 << 10);
+}
+
+CXXUI_BENCH_GROUP(js_msg) {
+    AddHandle("64b", 64);
+    AddHandle("4k", 4096);
+    AddHandle("256k", 256 * 1024);
+    Register("js_msg/handle/no_method", [](State& state) {
+        BenchMsgMap map;
+        std::string msg = MakeRequest("/missing", 64);
+        state.Measure([&] { DoNotOptimize(map.Handle(msg)); });
+    });
+    Register("js_msg/handle/invalid", [](State& state) {
+        BenchMsgMap map;
+        std::string msg = R"({"url": "/echo", "data": )";
+        state.Measure([&] { DoNotOptimize(map.Handle(msg)); });
+    });
+    for (const ErrorCase& error : kErrorCases) {
+        AddError(error);
+    }
+    Register("js_msg/error/handler_throw", [](State& state) {
+        BenchMsgMap map;
+        map.bind("/fail", [](json&) -> json { throw std::runtime_error("用户名不存在"); });
+        std::string msg = R"({"url": "/fail", "data": {"id": 42}})";
+        state.Measure([&] { DoNotOptimize(map.Handle(msg)); });
+    });
+    for (std::size_t count : {10, 1000}) {
+        Register("js_msg/route/hit_" + std::to_string(count), [count](State& state) {
+            BenchMsgMap map;
+            auto routes = MakeRoutes(count);
+            for (const auto& route : routes) {
+                map.bind(route, [](json& data) { return data; });
+            }
+            std::size_t i = 0;
+            state.Measure([&] { DoNotOptimize(map.FindHandler(routes[i++ % routes.size()])); });
+        });
+    }
+}
+
+CXXUI_BENCH_GROUP(mime) {
+    Register("mime/hit_first", [](State& state) {
+        std::string ext = "html";
+        state.Measure([&] {
+            DoNotOptimize(ext);
+            DoNotOptimize(FindContentType(ext, ""));
+        });
+    });
+    Register("mime/hit_last", [](State& state) {
+        std::string ext = "htm";
+        state.Measure([&] {
+            DoNotOptimize(ext);
+            DoNotOptimize(FindContentType(ext, ""));
+        });
+    });
+    Register("mime/miss", [](State& state) {
+        std::string ext = "woff2";
+        state.Measure([&] {
+            DoNotOptimize(ext);
+            DoNotOptimize(FindContentType(ext, ""));
+        });
+    });
+}
+
+CXXUI_BENCH_GROUP(script_batch) {
+    // 每帧 10 次调用已注册的函数, 合并为一次提交
+    Register("script_batch/frame_10_calls", [](State& state) {
+        ScriptRegistry registry;
+        JsFunctionId id = registry.Register("add", "(a, b) => a + b");
+        ScriptBatch batch;
+        state.Measure([&] {
+            for (int i = 0; i < 10; ++i) {
+                batch.AddCall(id, "1, 2");
+            }
+            DoNotOptimize(batch.Take());
+        });
+    });
+    // 每帧 10 段普通脚本, 每段单独提交
+    Register("script_batch/frame_10_scripts", [](State& state) {
+        std::string code = "document.getElementById(\"status\").textContent = \"ready\";";
+        ScriptBatch batch;
+        state.SetBytes(code.size() * 10);
+        state.Measure([&] {
+            for (int i = 0; i < 10; ++i) {
+                batch.Add(code);
+            }
+            DoNotOptimize(batch.Take());
+        });
+    });
+}
+
+CXXUI_BENCH_GROUP(page_cache) {
+    AddScroll(0);
+    AddScroll(1);
+    AddScroll(2);
+}
+
+CXXUI_BENCH_GROUP(patch) {
+    // 10000 行的状态, 每帧修改 10 行, 对比增量记录和整体 diff
+    constexpr std::size_t kRows = 10000;
+    Register("patch/patch_log_10k_rows", [kRows](State& state) {
+        PatchLog log(MakeTable(kRows));
+        std::mt19937 rng(7);
+        int value = 0;
+        std::size_t bytes = 0;
+        std::size_t frames = 0;
+        state.Measure([&] {
+            for (int i = 0; i < 10; ++i) {
+                log.Set("/rows/" + std::to_string(rng() % kRows) + "/value", ++value);
+            }
+            bytes += log.TakePatch().size();
+            ++frames;
+        });
+        state.SetCounter("patch_bytes", static_cast<double>(bytes) / frames);
+    });
+    Register("patch/json_diff_10k_rows", [kRows](State& state) {
+        json doc = MakeTable(kRows);
+        std::mt19937 rng(7);
+        int value = 0;
+        std::size_t bytes = 0;
+        std::size_t frames = 0;
+        state.Measure([&] {
+            json prev = doc;
+            for (int i = 0; i < 10; ++i) {
+                doc["rows"][rng() % kRows]["value"] = ++value;
+            }
+            bytes += json::diff(prev, doc).dump().size();
+            ++frames;
+        });
+        state.SetCounter("patch_bytes", static_cast<double>(bytes) / frames);
+    });
+}
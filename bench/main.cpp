@@ -0,0 +1,149 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "bench.hpp"
+
+using namespace cxxui::bench;
+
+namespace {
+
+const char* GetCompiler() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc";
+#else
+    return "unknown";
+#endif
+}
+
+#ifdef NDEBUG
+constexpr bool kDebug = false;
+#else
+constexpr bool kDebug = true;
+#endif
+
+/** 名字只包含 ASCII, 只需转义引号和反斜杠 */
+std::string Quote(std::string_view str) {
+    std::string output = "\"";
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            output.push_back('\\');
+        }
+        output.push_back(c);
+    }
+    output.push_back('"');
+    return output;
+}
+
+double GetBytesPerSecond(const Result& result) {
+    return result.bytes_per_op && result.ns_per_op > 0.0
+               ? result.bytes_per_op * 1e9 / result.ns_per_op
+               : 0.0;
+}
+
+void PrintJson(const std::vector<Result>& results, const Options& options) {
+    std::printf("{\n  \"context\": {\"compiler\": %s, \"debug\": %s, \"cplusplus\": %ld, ",
+                Quote(GetCompiler()).c_str(), kDebug ? "true" : "false",
+                static_cast<long>(__cplusplus));
+    std::printf("\"min_time_ms\": %lld, \"samples\": %zu},\n  \"benchmarks\": [",
+                static_cast<long long>(options.min_time.count() / 1000000), options.samples);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::printf("%s\n    {\"name\": %s, \"iterations\": %zu, \"ns_per_op\": %.3f, "
+                    "\"min_ns_per_op\": %.3f",
+                    i ? "," : "", Quote(r.name).c_str(), r.iterations, r.ns_per_op,
+                    r.min_ns_per_op);
+        if (r.bytes_per_op) {
+            std::printf(", \"bytes_per_second\": %.0f", GetBytesPerSecond(r));
+        }
+        for (const auto& [name, value] : r.counters) {
+            std::printf(", %s: %.6g", Quote(name).c_str(), value);
+        }
+        std::printf("}");
+    }
+    std::printf("\n  ]\n}\n");
+}
+
+void PrintCsv(const std::vector<Result>& results) {
+    std::printf("name,iterations,ns_per_op,min_ns_per_op,bytes_per_second,counters\n");
+    for (const Result& r : results) {
+        std::printf("%s,%zu,%.3f,%.3f,%.0f,", r.name.c_str(), r.iterations, r.ns_per_op,
+                    r.min_ns_per_op, GetBytesPerSecond(r));
+        for (std::size_t i = 0; i < r.counters.size(); ++i) {
+            std::printf("%s%s=%.6g", i ? ";" : "", r.counters[i].first.c_str(),
+                        r.counters[i].second);
+        }
+        std::printf("\n");
+    }
+}
+
+void PrintUsage() {
+    std::fprintf(stderr,
+                 "usage: cxxui_bench [--filter=SUBSTR] [--format=json|csv] [--min-time=MS]\n"
+                 "                   [--samples=N] [--list]\n");
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    std::string_view filter;
+    bool csv = false;
+    bool list = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value = [&arg](std::string_view key) -> const char* {
+            return arg.substr(0, key.size()) == key ? arg.data() + key.size() : nullptr;
+        };
+        if (auto substr = value("--filter="); substr) {
+            filter = substr;
+        } else if (auto format = value("--format="); format) {
+            csv = std::strcmp(format, "csv") == 0;
+        } else if (auto ms = value("--min-time="); ms) {
+            options.min_time = std::chrono::milliseconds{std::atoll(ms)};
+        } else if (auto count = value("--samples="); count) {
+            options.samples = static_cast<std::size_t>(std::atoll(count));
+        } else if (arg == "--list") {
+            list = true;
+        } else {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    // 不同源文件的注册顺序不确定, 按名字排序使输出稳定
+    std::vector<Benchmark> benchmarks = GetBenchmarks();
+    std::stable_sort(benchmarks.begin(), benchmarks.end(),
+                     [](const Benchmark& a, const Benchmark& b) { return a.name < b.name; });
+    std::vector<Result> results;
+    for (const Benchmark& benchmark : benchmarks) {
+        if (benchmark.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        if (list) {
+            std::printf("%s\n", benchmark.name.c_str());
+            continue;
+        }
+        std::fprintf(stderr, "%s\n", benchmark.name.c_str());
+        Result result;
+        result.name = benchmark.name;
+        State state{options, result};
+        benchmark.fn(state);
+        results.push_back(std::move(result));
+    }
+    if (list) {
+        return 0;
+    }
+    if (csv) {
+        PrintCsv(results);
+    } else {
+        PrintJson(results, options);
+    }
+    return 0;
+}
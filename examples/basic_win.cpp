@@ -6,18 +6,11 @@ public:
     /**
      * 处理win32消息, 手动处理win32消息会失去跨平台性
      */
-    std::optional<LRESULT> OnWin32Msg(UINT msg, WPARAM wp, LPARAM) {
+    std::optional<LRESULT> OnWin32Msg(UINT msg, WPARAM, LPARAM) {
         switch (msg) {
-            // 设置背景颜色为红色
-            case WM_ERASEBKGND: {
-                HDC hdc = (HDC)wp;
-                RECT rc;
-                GetClientRect(hwnd_, &rc);
-                HBRUSH brush = CreateSolidBrush(RGB(255, 150, 150));
-                FillRect(hdc, &rc, brush);
-                DeleteObject(brush);
+            // 背景由 OnPaint 中的画布一次性绘制, 跳过系统擦除避免闪烁
+            case WM_ERASEBKGND:
                 return true;
-            }
             default:
                 break;
         }
@@ -35,8 +28,17 @@ public:
      */
     void OnSize(const cxxui::SizeEvent& event) {
         fprintf(stderr, "SizeEvent: [%d, %d]\n", event.GetWidth(), event.GetHeight());
+        canvas_.Resize(event.GetWidth(), event.GetHeight());
         cxxui::Window<EventWindow>::OnSize(event);
     }
+    /**
+     * 窗口重绘的事件, 使用画布绘制红色背景和半透明的矩形
+     */
+    void OnPaint(const cxxui::PaintEvent& event) {
+        canvas_.Clear({255, 150, 150});
+        canvas_.FillRect({50, 50, 250, 150}, {0, 0, 255, 128});
+        canvas_.Present(event);
+    }
     /**
      * 窗口激活或失去激活触发的事件
      */
@@ -44,6 +46,9 @@ public:
         fprintf(stderr, "ActivateEvent: %d\n", event.IsActive());
         cxxui::Window<EventWindow>::OnActivate(event);
     }
+
+private:
+    cxxui::Canvas canvas_;
 };
 
 int main() {
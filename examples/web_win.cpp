@@ -16,19 +16,16 @@ constexpr std::string_view HTML = R"html(
             * { background: white; }
         </style>
         <script>
-            function onClick() {
-                // 点击按钮发送当前值给C++
+            async function onClick() {
+                // 点击按钮发送当前值给C++, 并显示C++返回的值
                 const count = parseInt(document.getElementById("msg").innerHTML);
-                window.SendCppMsg({ url: "/count", data: { count } });
-            }
-            // 接收C++发送的消息并显示
-            window.SetCppMsgHandler((res) => {
-                if (res.code === 0) {
-                    document.getElementById("msg").innerHTML = res.data.count.toString();
-                } else {
-                    alert(res.error);
+                try {
+                    const res = await window.cxxui.call("/count", { count });
+                    document.getElementById("msg").innerHTML = res.count.toString();
+                } catch (e) {
+                    alert(e.message);
                 }
-            });
+            }
         </script>
     </head>
     <body>
@@ -55,8 +52,14 @@ public:
 };
 
 int main() {
-    EventWebWindow web_win{
-        cxxui::WindowOptions().SetTitle("WebWindow").SetWidth(400).SetHeight(400)};
+    /**
+     * 合并拖动改变大小时的 OnSize 事件，每帧只调整一次 webview 大小
+     */
+    EventWebWindow web_win{cxxui::WindowOptions()
+                               .SetTitle("WebWindow")
+                               .SetWidth(400)
+                               .SetHeight(400)
+                               .SetCoalesceSize(true)};
     /**
      * 进行WebWindow相关的操作前需要等待webview2创建完成
      */
@@ -79,6 +82,22 @@ int main() {
         // 在当前值的基础上 + 1 并返回
         return cxxui::json{{"count", count}};
     });
+#if CXXUI_HAS_COROUTINE
+    /**
+     * 耗时的计算放到共享的后台线程池，完成后回到UI线程返回响应
+     */
+    req_map.bind("/sum", [](cxxui::json& arg) -> cxxui::Task<cxxui::json> {
+        auto n = arg.at("n").get<std::uint64_t>();
+        std::uint64_t sum = co_await cxxui::Executor::GetDefault().Submit([n] {
+            std::uint64_t total = 0;
+            for (std::uint64_t i = 1; i <= n; ++i) {
+                total += i;
+            }
+            return total;
+        });
+        co_return cxxui::json{{"sum", sum}};
+    });
+#endif
     web_win.SetJsMsgHandler(req_map.GetHandler());
 
     web_win.SetUrl("http://localhost");
@@ -0,0 +1,193 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <cxxui/core/rect.hpp>
+
+namespace cxxui::detail {
+
+/**
+ * @brief 脏区域跟踪, 把失效的矩形合并成少量互不重叠的矩形
+ * @details 合并代价按面积估算：两个矩形合并后多绘制的像素不超过每个矩形的固定开销时合并，
+ *   否则把新矩形减去重叠部分后分别保留。矩形数量超过上限时合并浪费最少的一对。
+ *   不依赖平台。
+ */
+class DamageTracker {
+public:
+    /** 默认的单个矩形开销, 相当于多绘制的像素数 */
+    static constexpr std::int64_t kDefaultRectCost = 64 * 64;
+    static constexpr std::size_t kDefaultMaxRects = 16;
+
+    /** 设置单个矩形的开销, 越大越倾向合并 */
+    void SetRectCost(std::int64_t cost) noexcept { rect_cost_ = cost; }
+    /** 设置矩形数量上限 */
+    void SetMaxRects(std::size_t count) noexcept { max_rects_ = (std::max)(count, std::size_t{1}); }
+    bool IsEmpty() const noexcept { return rects_.empty(); }
+    const std::vector<Rect>& GetRects() const noexcept { return rects_; }
+    /** 所有矩形的外接矩形 */
+    Rect GetBounds() const noexcept {
+        if (rects_.empty()) {
+            return {};
+        }
+        Rect bounds = rects_.front();
+        for (const Rect& r : rects_) {
+            bounds = Union(bounds, r);
+        }
+        return bounds;
+    }
+    /** 矩形是否完全在某个已有矩形内 */
+    bool Covers(const Rect& rect) const noexcept {
+        return std::any_of(rects_.begin(), rects_.end(),
+                           [&rect](const Rect& r) { return Contains(r, rect); });
+    }
+    void Clear() noexcept { rects_.clear(); }
+    /** 取出所有矩形并清空 */
+    std::vector<Rect> Take() {
+        std::vector<Rect> rects;
+        rects.swap(rects_);
+        return rects;
+    }
+    /** 标记矩形失效 */
+    void Add(const Rect& rect) {
+        if (rect.IsEmpty()) {
+            return;
+        }
+        pending_.clear();
+        pending_.push_back(rect);
+        while (!pending_.empty()) {
+            Rect piece = pending_.back();
+            pending_.pop_back();
+            Insert(piece);
+        }
+        while (rects_.size() > max_rects_) {
+            MergeCheapest();
+        }
+    }
+
+    static std::int64_t Area(const Rect& r) noexcept {
+        return r.IsEmpty() ? 0 : static_cast<std::int64_t>(r.Width()) * r.Height();
+    }
+    static Rect Union(const Rect& a, const Rect& b) noexcept {
+        return {(std::min)(a.left, b.left), (std::min)(a.top, b.top), (std::max)(a.right, b.right),
+                (std::max)(a.bottom, b.bottom)};
+    }
+    static Rect Intersect(const Rect& a, const Rect& b) noexcept {
+        return {(std::max)(a.left, b.left), (std::max)(a.top, b.top), (std::min)(a.right, b.right),
+                (std::min)(a.bottom, b.bottom)};
+    }
+    static bool Contains(const Rect& outer, const Rect& inner) noexcept {
+        return outer.left <= inner.left && outer.top <= inner.top && outer.right >= inner.right &&
+               outer.bottom >= inner.bottom;
+    }
+
+private:
+    std::vector<Rect> rects_;
+    std::vector<Rect> pending_;
+    std::int64_t rect_cost_ = kDefaultRectCost;
+    std::size_t max_rects_ = kDefaultMaxRects;
+
+    /** 合并后多绘制的像素 */
+    static std::int64_t Waste(const Rect& a, const Rect& b) noexcept {
+        return Area(Union(a, b)) - Area(a) - Area(b) + Area(Intersect(a, b));
+    }
+    /** 合并结果是否与 except 以外的矩形重叠 */
+    bool OverlapsOthers(const Rect& rect, std::size_t except) const noexcept {
+        for (std::size_t i = 0; i < rects_.size(); ++i) {
+            if (i != except && !Intersect(rects_[i], rect).IsEmpty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+    /**
+     * 已有的矩形互不重叠。只在合并结果不与其他矩形重叠时合并, 否则切分新矩形,
+     * 已有的矩形只会被合并而不会被切分, 保证处理过程能结束
+     */
+    void Insert(const Rect& piece) {
+        for (const Rect& r : rects_) {
+            if (Contains(r, piece)) {
+                return;
+            }
+        }
+        rects_.erase(std::remove_if(rects_.begin(), rects_.end(),
+                                    [&piece](const Rect& r) { return Contains(piece, r); }),
+                     rects_.end());
+        std::size_t best = rects_.size();
+        std::int64_t best_waste = rect_cost_;
+        for (std::size_t i = 0; i < rects_.size(); ++i) {
+            const Rect& r = rects_[i];
+            bool overlap = !Intersect(r, piece).IsEmpty();
+            std::int64_t waste = Waste(r, piece);
+            if ((overlap || waste <= best_waste) && waste <= rect_cost_ &&
+                !OverlapsOthers(Union(r, piece), i)) {
+                best = i;
+                best_waste = waste;
+                if (overlap) {
+                    break;
+                }
+            } else if (overlap) {
+                Subtract(piece, r);
+                return;
+            }
+        }
+        if (best == rects_.size()) {
+            rects_.push_back(piece);
+            return;
+        }
+        // 合并后作为新矩形重新处理, 可能继续与相邻矩形合并
+        pending_.push_back(Union(rects_[best], piece));
+        rects_.erase(rects_.begin() + static_cast<std::ptrdiff_t>(best));
+    }
+    /** 把 piece 减去 hole 的部分放入待处理队列, 最多4块 */
+    void Subtract(const Rect& piece, const Rect& hole) {
+        Rect cut = Intersect(piece, hole);
+        if (piece.top < cut.top) {
+            pending_.push_back({piece.left, piece.top, piece.right, cut.top});
+        }
+        if (cut.bottom < piece.bottom) {
+            pending_.push_back({piece.left, cut.bottom, piece.right, piece.bottom});
+        }
+        if (piece.left < cut.left) {
+            pending_.push_back({piece.left, cut.top, cut.left, cut.bottom});
+        }
+        if (cut.right < piece.right) {
+            pending_.push_back({cut.right, cut.top, piece.right, cut.bottom});
+        }
+    }
+    /** 合并浪费最少的一对, 并吸收与结果重叠的矩形以保持互不重叠 */
+    void MergeCheapest() {
+        std::size_t best_i = 0;
+        std::size_t best_j = 1;
+        std::int64_t best = -1;
+        for (std::size_t i = 0; i < rects_.size(); ++i) {
+            for (std::size_t j = i + 1; j < rects_.size(); ++j) {
+                std::int64_t waste = Waste(rects_[i], rects_[j]);
+                if (best < 0 || waste < best) {
+                    best = waste;
+                    best_i = i;
+                    best_j = j;
+                }
+            }
+        }
+        Rect merged = Union(rects_[best_i], rects_[best_j]);
+        rects_.erase(rects_.begin() + static_cast<std::ptrdiff_t>(best_j));
+        rects_.erase(rects_.begin() + static_cast<std::ptrdiff_t>(best_i));
+        bool grown = true;
+        while (grown) {
+            grown = false;
+            for (std::size_t i = 0; i < rects_.size(); ++i) {
+                if (!Intersect(rects_[i], merged).IsEmpty()) {
+                    merged = Union(merged, rects_[i]);
+                    rects_.erase(rects_.begin() + static_cast<std::ptrdiff_t>(i));
+                    grown = true;
+                    break;
+                }
+            }
+        }
+        rects_.push_back(merged);
+    }
+};
+
+}  // namespace cxxui::detail
@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace cxxui::detail {
+
+/**
+ * @brief 判断子类是否重写了事件处理函数
+ * @details 子类没有重写时, &Derived::OnXxx 的类型是基类的成员函数指针，与默认处理函数的类型相同
+ */
+template <typename Handler, typename Default>
+constexpr bool IsOverridden = !std::is_same_v<Handler, Default>;
+
+/**
+ * @brief 编译期生成的消息派发表，只包含启用的表项
+ * @details 表项需要定义：
+ *   static constexpr std::uint32_t kMsg;   消息ID
+ *   static constexpr bool kEnabled;        是否启用
+ *   static void Invoke(Args...);           处理函数
+ * 未启用的表项不会生成任何代码，没有启用表项时 Dispatch 直接返回 false。
+ */
+template <typename... Entries>
+class DispatchTable {
+public:
+    /** 启用的表项数量 */
+    static constexpr std::size_t kSize = (std::size_t{0} + ... + (Entries::kEnabled ? 1 : 0));
+    /** 启用的消息ID */
+    static constexpr std::array<std::uint32_t, kSize> kMessages = [] {
+        std::array<std::uint32_t, kSize> messages{};
+        std::size_t i = 0;
+        ((Entries::kEnabled ? (messages[i++] = Entries::kMsg, 0) : 0), ...);
+        return messages;
+    }();
+    /** 消息是否有启用的表项 */
+    static constexpr bool Contains(std::uint32_t msg) noexcept {
+        for (auto m : kMessages) {
+            if (m == msg) {
+                return true;
+            }
+        }
+        return false;
+    }
+    /**
+     * @brief 派发消息到对应的表项
+     *
+     * @return bool 有表项处理了该消息返回true
+     */
+    template <typename... Args>
+    static bool Dispatch([[maybe_unused]] std::uint32_t msg, [[maybe_unused]] Args&&... args) {
+        if constexpr (kSize == 0) {
+            return false;
+        } else {
+            return (Try<Entries>(msg, args...) || ...);
+        }
+    }
+
+private:
+    template <typename Entry, typename... Args>
+    static bool Try([[maybe_unused]] std::uint32_t msg, [[maybe_unused]] Args&... args) {
+        if constexpr (Entry::kEnabled) {
+            if (msg == Entry::kMsg) {
+                Entry::Invoke(args...);
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+}  // namespace cxxui::detail
@@ -0,0 +1,92 @@
+#pragma once
+#include <chrono>
+#include <optional>
+#include <utility>
+
+namespace cxxui::detail {
+
+/** 帧时钟使用的时钟源 */
+using FrameClock = std::chrono::steady_clock;
+
+/**
+ * @brief 按显示器刷新率节流的帧调度器
+ * @details 不依赖平台，时间点由调用者传入，可以用模拟时钟驱动
+ */
+class FramePacer {
+public:
+    using TimePoint = FrameClock::time_point;
+    using Duration = FrameClock::duration;
+
+    explicit FramePacer(int refresh_rate = 60) { SetRefreshRate(refresh_rate); }
+    /** 设置刷新率, 无效值按 60Hz 处理 */
+    void SetRefreshRate(int refresh_rate) {
+        if (refresh_rate <= 1) {
+            refresh_rate = 60;
+        }
+        interval_ = std::chrono::duration_cast<Duration>(std::chrono::seconds(1)) / refresh_rate;
+    }
+    Duration GetInterval() const noexcept { return interval_; }
+    /** 请求下一帧, 距离上一帧不足一个周期时会等到下一个周期 */
+    void Request(TimePoint now) noexcept {
+        if (requested_) {
+            return;
+        }
+        requested_ = true;
+        if (next_ < now) {
+            next_ = now;
+        }
+    }
+    bool IsRequested() const noexcept { return requested_; }
+    /**
+     * @brief 是否到达帧时间点
+     * @details 允许提前半个周期，系统定时器的精度约 15.6ms，常常在时间点之前触发，
+     *   严格比较会把这一帧推迟一个周期，帧率减半。提前开始的帧不改变之后的相位
+     */
+    bool IsDue(TimePoint now) const noexcept { return requested_ && now + interval_ / 2 >= next_; }
+    /** 距离下一帧的等待时间, 未请求帧时返回空 */
+    std::optional<Duration> GetTimeout(TimePoint now) const noexcept {
+        if (!requested_) {
+            return std::nullopt;
+        }
+        return now >= next_ ? Duration::zero() : next_ - now;
+    }
+    /**
+     * @brief 开始一帧，并计算下一帧的时间点
+     *
+     * @return TimePoint 本帧的时间戳
+     */
+    TimePoint BeginFrame(TimePoint now) noexcept {
+        requested_ = false;
+        // 保持帧的相位, 落后超过一个周期则以当前时间重新对齐
+        next_ += interval_;
+        if (next_ <= now) {
+            next_ = now + interval_;
+        }
+        return now;
+    }
+
+private:
+    Duration interval_{};
+    TimePoint next_{};
+    bool requested_ = false;
+};
+
+/**
+ * @brief 合并同一帧内的多次事件, 只保留最新的值
+ */
+template <typename T>
+class Coalescer {
+public:
+    void Push(T value) { pending_ = std::move(value); }
+    bool HasPending() const noexcept { return pending_.has_value(); }
+    std::optional<T> Take() noexcept {
+        std::optional<T> value = std::move(pending_);
+        pending_.reset();
+        return value;
+    }
+
+private:
+    std::optional<T> pending_;
+};
+
+}  // namespace cxxui::detail
@@ -0,0 +1,104 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <utility>
+
+namespace cxxui::detail {
+
+/**
+ * @brief 空闲任务调度器
+ * @details 按优先级执行任务，同优先级先进先出；超过截止时间的任务提升到最前，避免低优先级任务饿死。
+ * 不依赖平台，时间和输入状态由调用者传入，可以用模拟的时钟和消息源驱动。
+ */
+class IdleScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+    using Duration = Clock::duration;
+
+    /**
+     * @brief 添加任务
+     *
+     * @param fn 任务函数
+     * @param priority 优先级, 越大越先执行
+     * @param deadline 截止时间, 超过后优先于所有未超时的任务执行
+     * @return std::uint64_t 任务ID
+     */
+    std::uint64_t Schedule(std::function<void()> fn, int priority, TimePoint deadline) {
+        std::uint64_t id = ++last_id_;
+        tasks_.emplace(id, Entry{std::move(fn), priority, deadline});
+        by_priority_.emplace(-priority, id);
+        by_deadline_.emplace(deadline, id);
+        return id;
+    }
+    /** 取消未执行的任务 */
+    bool Cancel(std::uint64_t id) {
+        auto it = tasks_.find(id);
+        if (it == tasks_.end()) {
+            return false;
+        }
+        Erase(it);
+        return true;
+    }
+    bool IsEmpty() const noexcept { return tasks_.empty(); }
+    std::size_t Size() const noexcept { return tasks_.size(); }
+    /** 设置每次空闲执行的时间预算 */
+    void SetBudget(Duration budget) noexcept { budget_ = budget; }
+    Duration GetBudget() const noexcept { return budget_; }
+    /**
+     * @brief 在一个空闲时间片内执行任务
+     * @details 每个任务执行前检查输入，有输入时立即让出；超时的任务在有输入时也会执行一个，
+     * 执行时间超过预算后让出。单个任务不可中断，任务应拆分得足够小。
+     *
+     * @param now 获取当前时间的函数
+     * @param has_input 检查是否有待处理输入的函数
+     * @return std::size_t 执行的任务数量
+     */
+    template <typename Now, typename HasInput>
+    std::size_t RunSlice(Now&& now, HasInput&& has_input) {
+        std::size_t count = 0;
+        TimePoint start = now();
+        TimePoint cur = start;
+        while (!tasks_.empty()) {
+            bool overdue = by_deadline_.begin()->first <= cur;
+            if (has_input() && (!overdue || count > 0)) {
+                break;
+            }
+            auto id = overdue ? by_deadline_.begin()->second : by_priority_.begin()->second;
+            auto it = tasks_.find(id);
+            std::function<void()> fn = std::move(it->second.fn);
+            Erase(it);
+            fn();
+            ++count;
+            cur = now();
+            if (cur - start >= budget_) {
+                break;
+            }
+        }
+        return count;
+    }
+
+private:
+    struct Entry {
+        std::function<void()> fn;
+        int priority;
+        TimePoint deadline;
+    };
+    std::uint64_t last_id_ = 0;
+    Duration budget_ = std::chrono::milliseconds(5);
+    std::map<std::uint64_t, Entry> tasks_;
+    std::set<std::pair<int, std::uint64_t>> by_priority_;
+    std::set<std::pair<TimePoint, std::uint64_t>> by_deadline_;
+
+    void Erase(std::map<std::uint64_t, Entry>::iterator it) {
+        by_priority_.erase({-it->second.priority, it->first});
+        by_deadline_.erase({it->second.deadline, it->first});
+        tasks_.erase(it);
+    }
+};
+
+}  // namespace cxxui::detail
@@ -1,29 +1,137 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
 #include <string_view>
-#include <windows.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <dlfcn.h>
+#endif
+
+#include <cxxui/core/trace.hpp>
 
 namespace cxxui::detail {
 
-class Library {
+/** 系统动态库加载接口, windows 使用 LoadLibrary, 其他平台使用 dlopen */
+struct DynamicLoader {
+    static void* Open(const char* name) noexcept {
+        CXXUI_TRACE_SCOPE("LoadLibrary");
+#ifdef _WIN32
+        return reinterpret_cast<void*>(LoadLibraryA(name));
+#else
+        return dlopen(name, RTLD_NOW | RTLD_LOCAL);
+#endif
+    }
+    static void* Find(void* module, const char* name) noexcept {
+#ifdef _WIN32
+        return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(module), name));
+#else
+        return dlsym(module, name);
+#endif
+    }
+    static void Close(void* module) noexcept {
+#ifdef _WIN32
+        FreeLibrary(static_cast<HMODULE>(module));
+#else
+        dlclose(module);
+#endif
+    }
+};
+
+/** 加载后的动态库, 析构时释放 */
+template <typename Loader = DynamicLoader>
+class BasicLibrary {
 public:
-    Library(std::string_view dll_name) { handle_ = LoadLibraryA(dll_name.data()); }
-    ~Library() {
+    BasicLibrary(std::string_view dll_name) {
+        handle_ = Loader::Open(std::string(dll_name).c_str());
+    }
+    ~BasicLibrary() {
         if (handle_) {
-            FreeLibrary(handle_);
+            Loader::Close(handle_);
         }
     }
+    BasicLibrary(const BasicLibrary&) = delete;
+    BasicLibrary& operator=(const BasicLibrary&) = delete;
     bool IsValid() const noexcept { return handle_ != nullptr; }
     template <typename T>
     T Get(std::string_view func_name) noexcept {
         if (!IsValid()) {
             return nullptr;
         }
-        return reinterpret_cast<T>(GetProcAddress(handle_, func_name.data()));
+        return reinterpret_cast<T>(Loader::Find(handle_, std::string(func_name).c_str()));
+    }
+
+private:
+    void* handle_;
+};
+using Library = BasicLibrary<>;
+
+/** 进程内共享的动态库, 每个库只加载一次, 进程结束前不释放 */
+template <typename Loader = DynamicLoader>
+class ModuleRegistry {
+public:
+    static void* Get(const char* name) {
+        static std::mutex mutex;
+        static std::map<std::string, void*, std::less<>> modules;
+        std::lock_guard lock(mutex);
+        auto it = modules.find(std::string_view(name));
+        if (it == modules.end()) {
+            it = modules.emplace(name, Loader::Open(name)).first;
+        }
+        return it->second;
+    }
+};
+
+/**
+ * @brief 可选的系统函数, 第一次调用 Get 时解析并缓存到静态槽位
+ * @details 构造函数是 constexpr，作为静态成员时在编译期初始化。
+ *   解析完成后 Get 只有一次原子读取；系统不提供该函数时返回 nullptr，调用者自行降级。
+ *
+ * @tparam T 函数指针类型
+ */
+template <typename T, typename Loader = DynamicLoader>
+class Symbol {
+public:
+    constexpr Symbol(const char* module, const char* name) noexcept
+        : module_(module),
+          name_(name) {}
+    Symbol(const Symbol&) = delete;
+    Symbol& operator=(const Symbol&) = delete;
+    T Get() noexcept {
+        std::uintptr_t value = value_.load(std::memory_order_acquire);
+        if (value == kUnresolved) {
+            value = Resolve();
+        }
+        return value == kMissing ? nullptr : reinterpret_cast<T>(value);
     }
+    explicit operator bool() noexcept { return Get() != nullptr; }
 
 private:
-    HMODULE handle_;
+    static constexpr std::uintptr_t kUnresolved = 0;
+    static constexpr std::uintptr_t kMissing = 1;
+
+    const char* module_;
+    const char* name_;
+    std::atomic<std::uintptr_t> value_{kUnresolved};
+
+    std::uintptr_t Resolve() noexcept {
+        void* func = nullptr;
+        try {
+            if (void* module = ModuleRegistry<Loader>::Get(module_)) {
+                func = Loader::Find(module, name_);
+            }
+        } catch (...) {
+            // 内存不足时按函数不存在处理
+        }
+        std::uintptr_t value = func ? reinterpret_cast<std::uintptr_t>(func) : kMissing;
+        value_.store(value, std::memory_order_release);
+        return value;
+    }
 };
 
-}  // namespace cxxui::detail
\ No newline at end of file
+}  // namespace cxxui::detail
@@ -0,0 +1,163 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cxxui::detail {
+
+/**
+ * @brief 只分配不释放的内存池, Reset 后重新使用
+ * @details 分配只移动指针，释放什么都不做，Reset 时一次性回收。
+ *   用满一块后分配更大的块，Reset 时合并为一块，之后相同大小的用量不再分配堆内存。不依赖平台。
+ */
+class MonotonicArena {
+public:
+    explicit MonotonicArena(std::size_t chunk_size = 16 * 1024)
+        : chunk_size_((std::max)(chunk_size, std::size_t{256})) {}
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    /** 分配 size 字节, align 为 2 的幂 */
+    void* Allocate(std::size_t size, std::size_t align) {
+        auto pos = (reinterpret_cast<std::uintptr_t>(cur_) + align - 1) & ~(align - 1);
+        if (chunks_.empty() || pos + size > reinterpret_cast<std::uintptr_t>(end_)) {
+            AddChunk(size + align);
+            pos = (reinterpret_cast<std::uintptr_t>(cur_) + align - 1) & ~(align - 1);
+        }
+        cur_ = reinterpret_cast<std::byte*>(pos + size);
+        used_ += size;
+        return reinterpret_cast<void*>(pos);
+    }
+    /**
+     * @brief p 是否在内存池中
+     * @details 先比较当前块，Reset 后只有一块，通常不需要查找其他块
+     */
+    bool Owns(const void* p) const noexcept {
+        if (chunks_.empty()) {
+            return false;
+        }
+        auto addr = reinterpret_cast<std::uintptr_t>(p);
+        auto in = [addr](const Chunk& chunk) {
+            auto begin = reinterpret_cast<std::uintptr_t>(chunk.data.get());
+            return addr >= begin && addr < begin + chunk.size;
+        };
+        if (in(chunks_.back())) {
+            return true;
+        }
+        for (std::size_t i = 0; i + 1 < chunks_.size(); ++i) {
+            if (in(chunks_[i])) {
+                return true;
+            }
+        }
+        return false;
+    }
+    /** 回收所有分配的内存, 之前分配的内存不能再使用 */
+    void Reset() noexcept {
+        if (chunks_.size() > 1) {
+            // 合并为一块, 避免每次都要分配后面的块
+            std::size_t total = 0;
+            for (const auto& chunk : chunks_) {
+                total += chunk.size;
+            }
+            chunks_.clear();
+            chunk_size_ = total;
+        }
+        if (!chunks_.empty()) {
+            cur_ = chunks_.front().data.get();
+            end_ = cur_ + chunks_.front().size;
+        }
+        used_ = 0;
+    }
+    /** 上次 Reset 后分配的字节数 */
+    std::size_t GetUsed() const noexcept { return used_; }
+    /** 占用的堆内存字节数 */
+    std::size_t GetCapacity() const noexcept {
+        std::size_t total = 0;
+        for (const auto& chunk : chunks_) {
+            total += chunk.size;
+        }
+        return total;
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size;
+    };
+    void AddChunk(std::size_t min_size) {
+        std::size_t size = (std::max)(chunk_size_, min_size);
+        chunks_.push_back(Chunk{std::make_unique<std::byte[]>(size), size});
+        cur_ = chunks_.back().data.get();
+        end_ = cur_ + size;
+        chunk_size_ = size * 2;
+    }
+
+    std::size_t chunk_size_;
+    std::vector<Chunk> chunks_;
+    std::byte* cur_ = nullptr;
+    std::byte* end_ = nullptr;
+    std::size_t used_ = 0;
+};
+
+/** 当前线程的消息内存池 */
+struct ArenaState {
+    MonotonicArena arena;
+    /** 嵌套的 ArenaScope 数量, 为 0 时从堆分配 */
+    int depth = 0;
+};
+inline ArenaState& GetArenaState() noexcept {
+    thread_local ArenaState state;
+    return state;
+}
+
+/**
+ * @brief 在作用域内从当前线程的内存池分配, 最外层的作用域结束时重置内存池
+ */
+class ArenaScope {
+public:
+    ArenaScope() noexcept { ++GetArenaState().depth; }
+    ~ArenaScope() {
+        auto& state = GetArenaState();
+        if (--state.depth == 0) {
+            state.arena.Reset();
+        }
+    }
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+};
+
+/**
+ * @brief 从当前线程内存池分配的无状态分配器
+ * @details ArenaScope 内从内存池分配，释放时不做任何事；作用域外从堆分配。
+ *   在作用域内分配的对象不能保存到作用域之外，也不能在其他线程释放。
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept = default;
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& /*other*/) noexcept {}
+
+    T* allocate(std::size_t n) {
+        auto& state = GetArenaState();
+        if (state.depth == 0) {
+            return std::allocator<T>{}.allocate(n);
+        }
+        return static_cast<T*>(state.arena.Allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, std::size_t n) noexcept {
+        // 作用域外不会有内存池分配的对象, 不需要检查
+        auto& state = GetArenaState();
+        if (state.depth == 0 || !state.arena.Owns(p)) {
+            std::allocator<T>{}.deallocate(p, n);
+        }
+    }
+    friend bool operator==(const ArenaAllocator&, const ArenaAllocator&) noexcept { return true; }
+    friend bool operator!=(const ArenaAllocator&, const ArenaAllocator&) noexcept { return false; }
+};
+
+}  // namespace cxxui::detail
@@ -0,0 +1,293 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cxxui::detail {
+
+/** 分页缓存的统计数据 */
+struct PageCacheStats {
+    /** 命中缓存的页数 */
+    std::size_t hits = 0;
+    /** 未命中需要加载的页数 */
+    std::size_t misses = 0;
+    /** 超过容量被淘汰的页数 */
+    std::size_t evictions = 0;
+    /** 因数据变化失效的页数 */
+    std::size_t invalidations = 0;
+    /** 当前缓存的页数 */
+    std::size_t pages = 0;
+    /** 当前的视图数 */
+    std::size_t views = 0;
+};
+
+/**
+ * @brief 按视图和页号缓存数据行, 容量有限, 淘汰最久未使用的页
+ * @details 相同排序和过滤条件的查询共享一个视图，视图0为不排序不过滤的原始顺序。
+ *   数据变化时原始视图只失效受影响的页，其他视图中行的位置可能任意变化，整体失效。
+ *   每次失效递增版本号，异步加载的数据在版本号变化后应丢弃。
+ *   视图数超过容量加2时淘汰最久未查询的、没有缓存页的视图，视图编号不会重复使用，
+ *   淘汰视图也递增版本号。不依赖平台。
+ */
+template <typename Row>
+class PageCache {
+public:
+    using ViewId = std::uint32_t;
+    using PageId = std::uint32_t;
+
+    explicit PageCache(std::size_t page_size = 100, std::size_t max_pages = 64)
+        : page_size_((std::max)(page_size, std::size_t{1})),
+          max_pages_((std::max)(max_pages, std::size_t{1})) {
+        views_.emplace(ViewId{0}, View{});
+    }
+    PageCache(const PageCache&) = delete;
+    PageCache& operator=(const PageCache&) = delete;
+
+    std::size_t GetPageSize() const noexcept { return page_size_; }
+    /** 设置容量, 超出的页立即淘汰, 超出的视图在下次新建视图时淘汰 */
+    void SetMaxPages(std::size_t max_pages) {
+        max_pages_ = (std::max)(max_pages, std::size_t{1});
+        Shrink();
+    }
+    std::size_t GetMaxPages() const noexcept { return max_pages_; }
+    /** 数据版本号, 每次失效时递增 */
+    std::uint64_t GetGeneration() const noexcept { return generation_; }
+    /** 排序和过滤条件对应的视图并标记为最近查询, 都为空时是原始视图 */
+    ViewId GetView(std::string_view sort, std::string_view filter) {
+        if (sort.empty() && filter.empty()) {
+            return 0;
+        }
+        std::string key;
+        key.reserve(sort.size() + filter.size() + 1);
+        key.append(sort).push_back('\0');
+        key.append(filter);
+        auto [it, inserted] = view_ids_.emplace(std::move(key), next_view_);
+        if (inserted) {
+            View& view = views_[next_view_++];
+            view.key = &it->first;
+            ShrinkViews(it->second);
+        }
+        views_.at(it->second).used = ++view_clock_;
+        return it->second;
+    }
+    /** 包含 offset 行的页号 */
+    PageId GetPage(std::size_t offset) const noexcept {
+        return static_cast<PageId>(offset / page_size_);
+    }
+    /** 查找页并标记为最近使用, 不存在时返回空 */
+    const std::vector<Row>* Find(ViewId view, PageId page) {
+        auto it = index_.find(Key(view, page));
+        if (it == index_.end()) {
+            ++stats_.misses;
+            return nullptr;
+        }
+        ++stats_.hits;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return &it->second->rows;
+    }
+    /** 页是否已缓存, 不影响淘汰顺序和统计 */
+    bool Contains(ViewId view, PageId page) const {
+        return index_.find(Key(view, page)) != index_.end();
+    }
+    /** 放入页, 已存在时替换, 返回缓存中的行, 视图已淘汰时抛出 std::out_of_range */
+    const std::vector<Row>& Put(ViewId view, PageId page, std::vector<Row> rows) {
+        std::uint64_t key = Key(view, page);
+        if (auto it = index_.find(key); it != index_.end()) {
+            it->second->rows = std::move(rows);
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->rows;
+        }
+        ++views_.at(view).pages;
+        lru_.push_front({key, std::move(rows)});
+        index_.emplace(key, lru_.begin());
+        Shrink();
+        return lru_.front().rows;
+    }
+    /** 视图的总行数, 未知时返回空 */
+    std::optional<std::size_t> GetTotal(ViewId view) const { return views_.at(view).total; }
+    void SetTotal(ViewId view, std::size_t total) { views_.at(view).total = total; }
+    /** 原始视图中 [offset, offset + count) 的行内容变化 */
+    void Invalidate(std::size_t offset, std::size_t count) {
+        if (count == 0) {
+            return;
+        }
+        PageId first = GetPage(offset);
+        PageId last = GetPage(offset + count - 1);
+        EraseIf([first, last](ViewId view, PageId page) {
+            return view != 0 || (page >= first && page <= last);
+        });
+        // 过滤后的行数可能变化
+        ResetTotals(1);
+    }
+    /** 在原始视图的 offset 处插入或删除了行, 之后的行全部移位 */
+    void InvalidateFrom(std::size_t offset) {
+        PageId first = GetPage(offset);
+        EraseIf([first](ViewId view, PageId page) { return view != 0 || page >= first; });
+        ResetTotals(0);
+    }
+    /** 所有数据失效 */
+    void Clear() {
+        EraseIf([](ViewId, PageId) { return true; });
+        ResetTotals(0);
+    }
+    PageCacheStats GetStats() const noexcept {
+        PageCacheStats stats = stats_;
+        stats.pages = index_.size();
+        stats.views = views_.size();
+        return stats;
+    }
+
+private:
+    struct Entry {
+        std::uint64_t key;
+        std::vector<Row> rows;
+    };
+    struct View {
+        /** view_ids_ 中的条件, 原始视图为空 */
+        const std::string* key = nullptr;
+        std::optional<std::size_t> total;
+        /** 缓存的页数 */
+        std::size_t pages = 0;
+        /** 最近查询的时间 */
+        std::uint64_t used = 0;
+    };
+    std::size_t page_size_;
+    std::size_t max_pages_;
+    std::uint64_t generation_ = 0;
+    std::list<Entry> lru_;
+    std::unordered_map<std::uint64_t, typename std::list<Entry>::iterator> index_;
+    std::unordered_map<ViewId, View> views_;
+    std::unordered_map<std::string, ViewId> view_ids_;
+    ViewId next_view_ = 1;
+    std::uint64_t view_clock_ = 0;
+    PageCacheStats stats_;
+
+    static std::uint64_t Key(ViewId view, PageId page) noexcept {
+        return (static_cast<std::uint64_t>(view) << 32) | page;
+    }
+    static ViewId GetViewOf(std::uint64_t key) noexcept { return static_cast<ViewId>(key >> 32); }
+    void Shrink() {
+        while (index_.size() > max_pages_) {
+            --views_.at(GetViewOf(lru_.back().key)).pages;
+            index_.erase(lru_.back().key);
+            lru_.pop_back();
+            ++stats_.evictions;
+        }
+    }
+    /**
+     * @brief 淘汰没有缓存页的视图直到不超过容量加2, 不淘汰原始视图和 keep
+     * @details 有缓存页的视图最多 max_pages_ 个，所以总能找到可以淘汰的视图
+     */
+    void ShrinkViews(ViewId keep) {
+        while (views_.size() > max_pages_ + 2) {
+            auto victim = views_.end();
+            for (auto it = views_.begin(); it != views_.end(); ++it) {
+                if (it->first != 0 && it->first != keep && it->second.pages == 0 &&
+                    (victim == views_.end() || it->second.used < victim->second.used)) {
+                    victim = it;
+                }
+            }
+            if (victim == views_.end()) {
+                return;
+            }
+            // 已安排的异步加载可能还持有这个视图
+            ++generation_;
+            view_ids_.erase(*victim->second.key);
+            views_.erase(victim);
+        }
+    }
+    template <typename Pred>
+    void EraseIf(Pred pred) {
+        ++generation_;
+        for (auto it = lru_.begin(); it != lru_.end();) {
+            ViewId view = GetViewOf(it->key);
+            auto page = static_cast<PageId>(it->key & 0xFFFFFFFFu);
+            if (pred(view, page)) {
+                --views_.at(view).pages;
+                index_.erase(it->key);
+                it = lru_.erase(it);
+                ++stats_.invalidations;
+            } else {
+                ++it;
+            }
+        }
+    }
+    /** 清除视图的总行数, first 为 1 时保留原始视图 */
+    void ResetTotals(ViewId first) {
+        for (auto& [id, view] : views_) {
+            if (id >= first) {
+                view.total.reset();
+            }
+        }
+    }
+};
+
+/**
+ * @brief 根据连续查询的位置推测滚动方向, 决定需要预取的相邻页
+ * @details 沿滚动方向预取 ahead 页，反方向预取 behind 页；方向未知时两侧都按 ahead 预取。
+ *   只给出页号，是否已缓存、何时加载由调用者决定。不依赖平台。
+ */
+class PrefetchPlanner {
+public:
+    using PageId = std::uint32_t;
+
+    void SetAhead(std::size_t pages) noexcept { ahead_ = pages; }
+    void SetBehind(std::size_t pages) noexcept { behind_ = pages; }
+    std::size_t GetAhead() const noexcept { return ahead_; }
+    std::size_t GetBehind() const noexcept { return behind_; }
+    /**
+     * @brief 记录一次查询, 返回按优先级排列的预取页号
+     *
+     * @param view 查询的视图, 视图变化时方向重新计算
+     * @param first 查询覆盖的第一页
+     * @param last 查询覆盖的最后一页
+     * @param page_count 视图的总页数, 预取不超过末尾
+     */
+    const std::vector<PageId>& Plan(std::uint32_t view,
+                                    PageId first,
+                                    PageId last,
+                                    std::size_t page_count) {
+        int direction = 0;
+        if (has_last_ && view == last_view_) {
+            direction = first > last_first_ ? 1 : (first < last_first_ ? -1 : last_direction_);
+        }
+        has_last_ = true;
+        last_view_ = view;
+        last_first_ = first;
+        last_direction_ = direction;
+
+        plan_.clear();
+        std::size_t forward = direction >= 0 ? ahead_ : behind_;
+        std::size_t backward = direction <= 0 ? ahead_ : behind_;
+        // 两侧交替, 近的页优先, 滚动方向一侧优先
+        for (std::size_t i = 1; i <= (std::max)(forward, backward); ++i) {
+            bool down_first = direction >= 0;
+            for (int side = 0; side < 2; ++side) {
+                bool down = (side == 0) == down_first;
+                if (down && i <= forward && last + i < page_count) {
+                    plan_.push_back(static_cast<PageId>(last + i));
+                } else if (!down && i <= backward && i <= first) {
+                    plan_.push_back(static_cast<PageId>(first - i));
+                }
+            }
+        }
+        return plan_;
+    }
+
+private:
+    std::size_t ahead_ = 2;
+    std::size_t behind_ = 1;
+    bool has_last_ = false;
+    std::uint32_t last_view_ = 0;
+    PageId last_first_ = 0;
+    int last_direction_ = 0;
+    std::vector<PageId> plan_;
+};
+
+}  // namespace cxxui::detail
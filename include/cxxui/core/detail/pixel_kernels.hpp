@@ -0,0 +1,273 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <cxxui/core/color.hpp>
+
+/**
+ * 像素处理的SIMD指令集按编译选项选择: AVX2 > SSE2 > NEON > 标量。
+ * 定义 CXXUI_DISABLE_SIMD 强制使用标量实现。
+ */
+#ifndef CXXUI_DISABLE_SIMD
+    #if defined(__AVX2__)
+        #define CXXUI_SIMD_AVX2
+    #endif
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define CXXUI_SIMD_SSE2
+        #include <emmintrin.h>
+        #ifdef CXXUI_SIMD_AVX2
+            #include <immintrin.h>
+        #endif
+    #elif defined(__ARM_NEON) || defined(_M_ARM64)
+        #define CXXUI_SIMD_NEON
+        #include <arm_neon.h>
+    #endif
+#endif
+
+namespace cxxui::detail {
+
+/**
+ * 像素格式为预乘alpha的32位BGRA, 小端下即 0xAARRGGBB, 与 Windows 32位DIB一致。
+ */
+static_assert(sizeof(Color) == 4, "Color must be 4 bytes");
+
+/** x / 255 四舍五入, x 不超过 255 * 255 */
+constexpr std::uint32_t Div255(std::uint32_t x) noexcept {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+/** 颜色转换为预乘alpha的像素 */
+constexpr std::uint32_t ToPixel(const Color& color) noexcept {
+    std::uint32_t a = color.alpha;
+    return (a << 24) | (Div255(color.red * a) << 16) | (Div255(color.green * a) << 8) |
+           Div255(color.blue * a);
+}
+/** 预乘alpha的 src over dst 混合 */
+inline std::uint32_t BlendPixel(std::uint32_t dst, std::uint32_t src) noexcept {
+    std::uint32_t inv = 255 - (src >> 24);
+    // 一次处理两个通道, 每个通道的乘积不超过16位
+    std::uint32_t rb = (dst & 0x00FF00FF) * inv + 0x00800080;
+    std::uint32_t ag = ((dst >> 8) & 0x00FF00FF) * inv + 0x00800080;
+    rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    ag = (ag + ((ag >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+    return src + (rb | ag);
+}
+
+namespace simd {
+
+#if defined(CXXUI_SIMD_SSE2)
+/** 逐字节相乘并除以255 */
+inline __m128i MulBytes(__m128i x, __m128i m) noexcept {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i half = _mm_set1_epi16(128);
+    __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(x, zero), _mm_unpacklo_epi8(m, zero));
+    __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(x, zero), _mm_unpackhi_epi8(m, zero));
+    lo = _mm_add_epi16(lo, half);
+    hi = _mm_add_epi16(hi, half);
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+    return _mm_packus_epi16(lo, hi);
+}
+/** 把每个像素的alpha复制到4个字节 */
+inline __m128i SplatAlpha(__m128i px) noexcept {
+    __m128i a = _mm_srli_epi32(px, 24);
+    a = _mm_or_si128(a, _mm_slli_epi32(a, 8));
+    return _mm_or_si128(a, _mm_slli_epi32(a, 16));
+}
+inline __m128i Blend(__m128i dst, __m128i src) noexcept {
+    __m128i inv = _mm_xor_si128(SplatAlpha(src), _mm_set1_epi32(-1));
+    return _mm_adds_epu8(src, MulBytes(dst, inv));
+}
+inline __m128i Premultiply(__m128i rgba) noexcept {
+    // RGBA 字节序转为 BGRA
+    const __m128i ga = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+    const __m128i low = _mm_set1_epi32(0xFF);
+    __m128i px = _mm_or_si128(
+        _mm_and_si128(rgba, ga),
+        _mm_or_si128(_mm_and_si128(_mm_srli_epi32(rgba, 16), low),
+                     _mm_slli_epi32(_mm_and_si128(rgba, low), 16)));
+    __m128i alpha = _mm_or_si128(_mm_srli_epi32(SplatAlpha(px), 8),
+                                 _mm_set1_epi32(static_cast<int>(0xFF000000u)));
+    return MulBytes(px, alpha);
+}
+#endif
+
+#if defined(CXXUI_SIMD_AVX2)
+inline __m256i MulBytes(__m256i x, __m256i m) noexcept {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i half = _mm256_set1_epi16(128);
+    __m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(x, zero), _mm256_unpacklo_epi8(m, zero));
+    __m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(x, zero), _mm256_unpackhi_epi8(m, zero));
+    lo = _mm256_add_epi16(lo, half);
+    hi = _mm256_add_epi16(hi, half);
+    lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+    hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+    return _mm256_packus_epi16(lo, hi);
+}
+inline __m256i SplatAlpha(__m256i px) noexcept {
+    __m256i a = _mm256_srli_epi32(px, 24);
+    a = _mm256_or_si256(a, _mm256_slli_epi32(a, 8));
+    return _mm256_or_si256(a, _mm256_slli_epi32(a, 16));
+}
+inline __m256i Blend(__m256i dst, __m256i src) noexcept {
+    __m256i inv = _mm256_xor_si256(SplatAlpha(src), _mm256_set1_epi32(-1));
+    return _mm256_adds_epu8(src, MulBytes(dst, inv));
+}
+inline __m256i Premultiply(__m256i rgba) noexcept {
+    const __m256i ga = _mm256_set1_epi32(static_cast<int>(0xFF00FF00u));
+    const __m256i low = _mm256_set1_epi32(0xFF);
+    __m256i px = _mm256_or_si256(
+        _mm256_and_si256(rgba, ga),
+        _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(rgba, 16), low),
+                        _mm256_slli_epi32(_mm256_and_si256(rgba, low), 16)));
+    __m256i alpha = _mm256_or_si256(_mm256_srli_epi32(SplatAlpha(px), 8),
+                                    _mm256_set1_epi32(static_cast<int>(0xFF000000u)));
+    return MulBytes(px, alpha);
+}
+#endif
+
+#if defined(CXXUI_SIMD_NEON)
+inline uint8x16_t MulBytes(uint8x16_t x, uint8x16_t m) noexcept {
+    uint16x8_t lo = vmull_u8(vget_low_u8(x), vget_low_u8(m));
+    uint16x8_t hi = vmull_u8(vget_high_u8(x), vget_high_u8(m));
+    // (x + ((x + 128) >> 8) + 128) >> 8
+    return vcombine_u8(vraddhn_u16(lo, vrshrq_n_u16(lo, 8)), vraddhn_u16(hi, vrshrq_n_u16(hi, 8)));
+}
+inline uint8x16_t SplatAlpha(uint8x16_t px) noexcept {
+    uint32x4_t a = vshrq_n_u32(vreinterpretq_u32_u8(px), 24);
+    return vreinterpretq_u8_u32(vmulq_n_u32(a, 0x01010101u));
+}
+inline uint8x16_t Blend(uint8x16_t dst, uint8x16_t src) noexcept {
+    return vqaddq_u8(src, MulBytes(dst, vmvnq_u8(SplatAlpha(src))));
+}
+inline uint8x16_t Premultiply(uint8x16_t rgba) noexcept {
+    // RGBA 字节序转为 BGRA
+    const uint32x4_t low = vdupq_n_u32(0xFF);
+    uint32x4_t v = vreinterpretq_u32_u8(rgba);
+    uint32x4_t px = vorrq_u32(vandq_u32(v, vdupq_n_u32(0xFF00FF00u)),
+                              vorrq_u32(vandq_u32(vshrq_n_u32(v, 16), low),
+                                        vshlq_n_u32(vandq_u32(v, low), 16)));
+    uint32x4_t a = vshrq_n_u32(px, 24);
+    uint32x4_t alpha = vorrq_u32(vmulq_n_u32(a, 0x00010101u), vdupq_n_u32(0xFF000000u));
+    return MulBytes(vreinterpretq_u8_u32(px), vreinterpretq_u8_u32(alpha));
+}
+#endif
+
+}  // namespace simd
+
+/** 用像素值填充 */
+inline void FillPixels(std::uint32_t* dst, std::size_t count, std::uint32_t pixel) noexcept {
+    std::size_t i = 0;
+#if defined(CXXUI_SIMD_AVX2)
+    const __m256i v8 = _mm256_set1_epi32(static_cast<int>(pixel));
+    for (std::size_t end = count / 8 * 8; i < end; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v8);
+    }
+#endif
+#if defined(CXXUI_SIMD_SSE2)
+    const __m128i v4 = _mm_set1_epi32(static_cast<int>(pixel));
+    for (std::size_t end = count / 4 * 4; i < end; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v4);
+    }
+#elif defined(CXXUI_SIMD_NEON)
+    const uint32x4_t v4 = vdupq_n_u32(pixel);
+    for (std::size_t end = count / 4 * 4; i < end; i += 4) {
+        vst1q_u32(dst + i, v4);
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = pixel;
+    }
+}
+/** 复制像素, 标准库的 memmove 已经向量化 */
+inline void CopyPixels(std::uint32_t* dst, const std::uint32_t* src, std::size_t count) noexcept {
+    std::memmove(dst, src, count * sizeof(std::uint32_t));
+}
+/** 预乘alpha的像素混合到 dst */
+inline void BlendPixels(std::uint32_t* dst, const std::uint32_t* src, std::size_t count) noexcept {
+    std::size_t i = 0;
+#if defined(CXXUI_SIMD_AVX2)
+    for (std::size_t end = count / 8 * 8; i < end; i += 8) {
+        auto* d = reinterpret_cast<__m256i*>(dst + i);
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(d, simd::Blend(_mm256_loadu_si256(d), s));
+    }
+#endif
+#if defined(CXXUI_SIMD_SSE2)
+    for (std::size_t end = count / 4 * 4; i < end; i += 4) {
+        auto* d = reinterpret_cast<__m128i*>(dst + i);
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(d, simd::Blend(_mm_loadu_si128(d), s));
+    }
+#elif defined(CXXUI_SIMD_NEON)
+    for (std::size_t end = count / 4 * 4; i < end; i += 4) {
+        auto* d = reinterpret_cast<std::uint8_t*>(dst + i);
+        uint8x16_t s = vld1q_u8(reinterpret_cast<const std::uint8_t*>(src + i));
+        vst1q_u8(d, simd::Blend(vld1q_u8(d), s));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = BlendPixel(dst[i], src[i]);
+    }
+}
+/** 用同一个预乘alpha的像素混合到 dst */
+inline void BlendFill(std::uint32_t* dst, std::size_t count, std::uint32_t pixel) noexcept {
+    if ((pixel >> 24) == 255) {
+        FillPixels(dst, count, pixel);
+        return;
+    }
+    if (pixel == 0) {
+        return;
+    }
+    std::size_t i = 0;
+#if defined(CXXUI_SIMD_AVX2)
+    const __m256i s8 = _mm256_set1_epi32(static_cast<int>(pixel));
+    for (std::size_t end = count / 8 * 8; i < end; i += 8) {
+        auto* d = reinterpret_cast<__m256i*>(dst + i);
+        _mm256_storeu_si256(d, simd::Blend(_mm256_loadu_si256(d), s8));
+    }
+#endif
+#if defined(CXXUI_SIMD_SSE2)
+    const __m128i s4 = _mm_set1_epi32(static_cast<int>(pixel));
+    for (std::size_t end = count / 4 * 4; i < end; i += 4) {
+        auto* d = reinterpret_cast<__m128i*>(dst + i);
+        _mm_storeu_si128(d, simd::Blend(_mm_loadu_si128(d), s4));
+    }
+#elif defined(CXXUI_SIMD_NEON)
+    const uint8x16_t s4 = vreinterpretq_u8_u32(vdupq_n_u32(pixel));
+    for (std::size_t end = count / 4 * 4; i < end; i += 4) {
+        auto* d = reinterpret_cast<std::uint8_t*>(dst + i);
+        vst1q_u8(d, simd::Blend(vld1q_u8(d), s4));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = BlendPixel(dst[i], pixel);
+    }
+}
+/** 颜色数组转换为预乘alpha的像素 */
+inline void ColorsToPixels(std::uint32_t* dst, const Color* src, std::size_t count) noexcept {
+    std::size_t i = 0;
+#if defined(CXXUI_SIMD_AVX2)
+    for (std::size_t end = count / 8 * 8; i < end; i += 8) {
+        __m256i rgba = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), simd::Premultiply(rgba));
+    }
+#endif
+#if defined(CXXUI_SIMD_SSE2)
+    for (std::size_t end = count / 4 * 4; i < end; i += 4) {
+        __m128i rgba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), simd::Premultiply(rgba));
+    }
+#elif defined(CXXUI_SIMD_NEON)
+    for (std::size_t end = count / 4 * 4; i < end; i += 4) {
+        uint8x16_t rgba = vld1q_u8(reinterpret_cast<const std::uint8_t*>(src + i));
+        vst1q_u8(reinterpret_cast<std::uint8_t*>(dst + i), simd::Premultiply(rgba));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = ToPixel(src[i]);
+    }
+}
+
+}  // namespace cxxui::detail
@@ -0,0 +1,136 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <cxxui/core/rect.hpp>
+
+namespace cxxui::detail {
+
+/** 显示器的区域和缩放比例 */
+struct MonitorInfo {
+    Rect rect;
+    /** DPI / 96 */
+    float scale = 1.0f;
+};
+
+/** 窗口位置和大小, 以及需要居中的方向 */
+struct Placement {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    bool center_x = false;
+    bool center_y = false;
+};
+
+/**
+ * @brief 查找坐标点所在的显示器, 不在任何显示器上时返回最近的显示器
+ *
+ * @return const MonitorInfo* 没有显示器时返回 nullptr
+ */
+inline const MonitorInfo* FindMonitor(const std::vector<MonitorInfo>& monitors, Point pt) noexcept {
+    const MonitorInfo* nearest = nullptr;
+    std::int64_t nearest_dist = 0;
+    for (const auto& monitor : monitors) {
+        const Rect& r = monitor.rect;
+        std::int64_t dx = pt.x < r.left ? r.left - pt.x : 0;
+        if (pt.x >= r.right) {
+            dx = pt.x - r.right + 1;
+        }
+        std::int64_t dy = pt.y < r.top ? r.top - pt.y : 0;
+        if (pt.y >= r.bottom) {
+            dy = pt.y - r.bottom + 1;
+        }
+        std::int64_t dist = dx * dx + dy * dy;
+        if (!dist) {
+            return &monitor;
+        }
+        if (!nearest || dist < nearest_dist) {
+            nearest = &monitor;
+            nearest_dist = dist;
+        }
+    }
+    return nearest;
+}
+
+/**
+ * @brief 计算窗口在显示器上的位置和大小
+ * @details 居中时以光标所在显示器为准；需要缩放时按窗口中心所在显示器的缩放比例放大，
+ *   放大后中心落到缩放比例更小的显示器时，改用该显示器的比例并保持中心不变。
+ *
+ * @param monitors 显示器快照
+ * @param cursor 光标位置
+ * @param place 请求的位置和大小, 居中方向的坐标会被忽略
+ * @param scale 是否按显示器的缩放比例放大窗口
+ * @return Placement 计算后的位置和大小
+ */
+inline Placement PlaceWindow(const std::vector<MonitorInfo>& monitors,
+                             Point cursor,
+                             Placement place,
+                             bool scale) noexcept {
+    // 与 MonitorFromPoint 的习惯一致, 右下边界上的点归入左上的显示器
+    auto find = [&monitors](Point pt) {
+        if (pt.x > 0) {
+            --pt.x;
+        }
+        if (pt.y > 0) {
+            --pt.y;
+        }
+        return FindMonitor(monitors, pt);
+    };
+    auto center_in = [&place](const Rect& screen, int width, int height) {
+        if (place.center_x) {
+            place.x = (screen.left + screen.right - width) / 2;
+        }
+        if (place.center_y) {
+            place.y = (screen.top + screen.bottom - height) / 2;
+        }
+    };
+    if (!scale && !place.center_x && !place.center_y) {
+        return place;
+    }
+    const MonitorInfo* cur = find(cursor);
+    if (!cur) {
+        return place;
+    }
+    // 显示在屏幕中央
+    if (place.center_x && place.center_y) {
+        if (scale && cur->scale != 1.0f) {
+            place.width = static_cast<int>(place.width * cur->scale);
+            place.height = static_cast<int>(place.height * cur->scale);
+        }
+        center_in(cur->rect, place.width, place.height);
+        return place;
+    }
+    // 计算窗口中心位置所在屏幕信息
+    center_in(cur->rect, place.width, place.height);
+    const MonitorInfo* target = find({place.x + place.width / 2, place.y + place.height / 2});
+    if (target->rect.left != cur->rect.left || target->rect.top != cur->rect.top) {
+        // 窗口不在鼠标所在屏幕, 重新计算中点
+        center_in(target->rect, place.width, place.height);
+    }
+    float factor = target->scale;
+    if (!scale || factor == 1.0f) {
+        return place;
+    }
+    int new_width = static_cast<int>(place.width * factor);
+    int new_height = static_cast<int>(place.height * factor);
+    center_in(target->rect, new_width, new_height);
+    // 检查改变后的中点
+    Point center{place.x + new_width / 2, place.y + new_height / 2};
+    float factor2 = find(center)->scale;
+    if (factor2 == factor) {
+        place.width = new_width;
+        place.height = new_height;
+        return place;
+    }
+    place.width = static_cast<int>(place.width * factor2);
+    place.height = static_cast<int>(place.height * factor2);
+    if (factor2 < factor) {
+        place.x = center.x - place.width / 2;
+        place.y = center.y - place.height / 2;
+    }
+    return place;
+}
+
+}  // namespace cxxui::detail
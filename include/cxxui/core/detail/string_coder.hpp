@@ -1,10 +1,15 @@
 #pragma once
 
 #include <string>
-#include <windows.h>
+#include <string_view>
+#ifdef _WIN32
+    #include <windows.h>
+#endif
 
 namespace cxxui::detail {
 
+#ifdef _WIN32
+
 /** UTF-8 转 Unicode */
 inline std::wstring U82W(std::string_view input) {
     std::wstring output;
@@ -42,4 +47,112 @@ inline std::string W2U8(std::wstring_view input) {
     return output;
 }
 
+#else
+
+/**
+ * @brief UTF-8 转 Unicode, 用于非 Windows 平台的可移植部分
+ * @details 与 MB_ERR_INVALID_CHARS 一致，遇到无效的 UTF-8 时返回空字符串。
+ *   wchar_t 为 16 位时输出 UTF-16，否则输出 UTF-32。
+ */
+inline std::wstring U82W(std::string_view input) {
+    std::wstring output;
+    output.reserve(input.size());
+    std::size_t i = 0;
+    while (i < input.size()) {
+        auto c = static_cast<unsigned char>(input[i]);
+        // 纯 ASCII 的部分直接复制
+        if (c < 0x80) {
+            output.push_back(static_cast<wchar_t>(c));
+            ++i;
+            continue;
+        }
+        std::size_t len = 0;
+        char32_t cp = 0;
+        char32_t min_cp = 0;
+        if (c >= 0xC2 && c <= 0xDF) {
+            len = 2;
+            cp = c & 0x1F;
+            min_cp = 0x80;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            len = 3;
+            cp = c & 0x0F;
+            min_cp = 0x800;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            len = 4;
+            cp = c & 0x07;
+            min_cp = 0x10000;
+        } else {
+            return {};
+        }
+        if (input.size() - i < len) {
+            return {};
+        }
+        for (std::size_t k = 1; k < len; ++k) {
+            auto next = static_cast<unsigned char>(input[i + k]);
+            if ((next & 0xC0) != 0x80) {
+                return {};
+            }
+            cp = (cp << 6) | (next & 0x3F);
+        }
+        // 过长编码、代理区和超出范围的码点都是无效的
+        if (cp < min_cp || (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+            return {};
+        }
+        if constexpr (sizeof(wchar_t) == 2) {
+            if (cp >= 0x10000) {
+                cp -= 0x10000;
+                output.push_back(static_cast<wchar_t>(0xD800 + (cp >> 10)));
+                output.push_back(static_cast<wchar_t>(0xDC00 + (cp & 0x3FF)));
+                i += len;
+                continue;
+            }
+        }
+        output.push_back(static_cast<wchar_t>(cp));
+        i += len;
+    }
+    return output;
+}
+
+/**
+ * @brief Unicode 转 UTF-8, 用于非 Windows 平台的可移植部分
+ * @details 与 WideCharToMultiByte 一致，无效的码点替换为 U+FFFD。
+ */
+inline std::string W2U8(std::wstring_view input) {
+    std::string output;
+    output.reserve(input.size());
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        auto cp = static_cast<char32_t>(input[i]);
+        if (cp < 0x80) {
+            output.push_back(static_cast<char>(cp));
+            continue;
+        }
+        if constexpr (sizeof(wchar_t) == 2) {
+            if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < input.size()) {
+                auto low = static_cast<char32_t>(input[i + 1]);
+                if (low >= 0xDC00 && low <= 0xDFFF) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    ++i;
+                }
+            }
+        }
+        if ((cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+            cp = 0xFFFD;
+        }
+        if (cp < 0x800) {
+            output.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        } else if (cp < 0x10000) {
+            output.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            output.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        } else {
+            output.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            output.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            output.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        }
+        output.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    return output;
+}
+
+#endif
+
 }  // namespace cxxui::detail
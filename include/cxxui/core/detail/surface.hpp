@@ -0,0 +1,93 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <cxxui/core/color.hpp>
+#include <cxxui/core/rect.hpp>
+#include "pixel_kernels.hpp"
+
+namespace cxxui::detail {
+
+/**
+ * @brief 预乘alpha的32位BGRA像素缓冲区, 不依赖平台
+ * @details 行紧密排列，没有填充。所有绘制操作都会裁剪到缓冲区范围内。
+ */
+class Surface {
+public:
+    /** 调整大小, 缓冲区只增不减, 调整后内容未定义 */
+    void Resize(int width, int height) {
+        width_ = (std::max)(width, 0);
+        height_ = (std::max)(height, 0);
+        std::size_t count = static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_);
+        if (pixels_.size() < count) {
+            pixels_.resize(count);
+        }
+    }
+    int GetWidth() const noexcept { return width_; }
+    int GetHeight() const noexcept { return height_; }
+    std::uint32_t* GetPixels() noexcept { return pixels_.data(); }
+    const std::uint32_t* GetPixels() const noexcept { return pixels_.data(); }
+    /** 用颜色填充整个缓冲区, 不与原内容混合 */
+    void Clear(const Color& color) noexcept {
+        FillPixels(pixels_.data(), static_cast<std::size_t>(width_) * height_, ToPixel(color));
+    }
+    /** 填充矩形, 半透明颜色与原内容混合 */
+    void FillRect(const Rect& rect, const Color& color) noexcept {
+        Rect r = Clip(rect);
+        if (r.IsEmpty()) {
+            return;
+        }
+        std::uint32_t pixel = ToPixel(color);
+        for (int y = r.top; y < r.bottom; ++y) {
+            BlendFill(Row(y) + r.left, static_cast<std::size_t>(r.Width()), pixel);
+        }
+    }
+    /**
+     * @brief 绘制像素块
+     *
+     * @param pos 绘制到的左上角位置
+     * @param pixels 预乘alpha的BGRA像素
+     * @param size 像素块的大小
+     * @param stride 像素块每行的像素数
+     * @param blend 是否与原内容混合, false 时直接覆盖
+     */
+    void DrawPixels(Point pos,
+                    const std::uint32_t* pixels,
+                    Size size,
+                    int stride,
+                    bool blend = true) noexcept {
+        Rect r = Clip({pos.x, pos.y, pos.x + size.width, pos.y + size.height});
+        if (r.IsEmpty()) {
+            return;
+        }
+        auto count = static_cast<std::size_t>(r.Width());
+        for (int y = r.top; y < r.bottom; ++y) {
+            const std::uint32_t* src = pixels + static_cast<std::ptrdiff_t>(y - pos.y) * stride +
+                                       (r.left - pos.x);
+            if (blend) {
+                BlendPixels(Row(y) + r.left, src, count);
+            } else {
+                CopyPixels(Row(y) + r.left, src, count);
+            }
+        }
+    }
+    void DrawSurface(Point pos, const Surface& src, bool blend = true) noexcept {
+        DrawPixels(pos, src.GetPixels(), {src.width_, src.height_}, src.width_, blend);
+    }
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<std::uint32_t> pixels_;
+
+    std::uint32_t* Row(int y) noexcept {
+        return pixels_.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(width_);
+    }
+    Rect Clip(const Rect& rect) const noexcept {
+        return {(std::max)(rect.left, 0), (std::max)(rect.top, 0), (std::min)(rect.right, width_),
+                (std::min)(rect.bottom, height_)};
+    }
+};
+
+}  // namespace cxxui::detail
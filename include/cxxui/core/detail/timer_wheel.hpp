@@ -0,0 +1,245 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+namespace cxxui::detail {
+
+/** 侵入式双向链表节点 */
+struct TimerLink {
+    TimerLink* prev = nullptr;
+    TimerLink* next = nullptr;
+};
+
+/**
+ * @brief 时间轮上的定时器节点, 由使用者持有内存, 插入和取消都不分配内存
+ */
+struct TimerNode : TimerLink {
+    /** 到期的 tick */
+    std::uint64_t expires = 0;
+    /** 重复周期, 0 表示只触发一次 */
+    std::uint64_t period = 0;
+    /** 所在的槽位, kNoSlot 表示未启动 */
+    std::uint16_t slot = 0xFFFF;
+    std::function<void()> callback;
+};
+
+/**
+ * @brief 分层时间轮
+ * @details 每层 64 个槽位，共 11 层覆盖 64 位 tick，插入和取消都是 O(1)。
+ * 每层用位图记录非空槽位，推进时直接跳到下一个有事件的 tick，空闲时间再长也不需要逐 tick 推进。
+ * 不依赖平台，tick 的单位和来源由调用者决定。
+ */
+class TimerWheel {
+public:
+    static constexpr std::uint16_t kNoSlot = 0xFFFF;
+
+    explicit TimerWheel(std::uint64_t now = 0)
+        : now_(now) {
+        for (auto& slot : slots_) {
+            slot.prev = slot.next = &slot;
+        }
+        expired_.prev = expired_.next = &expired_;
+    }
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+    ~TimerWheel() {
+        for (std::size_t i = 0; i < slots_.size(); ++i) {
+            while (slots_[i].next != &slots_[i]) {
+                Cancel(*static_cast<TimerNode*>(slots_[i].next));
+            }
+        }
+        while (expired_.next != &expired_) {
+            Cancel(*static_cast<TimerNode*>(expired_.next));
+        }
+    }
+    /** 当前的 tick */
+    std::uint64_t Now() const noexcept { return now_; }
+    /** 时间轮上的定时器数量 */
+    std::size_t Size() const noexcept { return size_; }
+    bool IsScheduled(const TimerNode& node) const noexcept { return node.slot != kNoSlot; }
+    /**
+     * @brief 启动定时器, 已启动的定时器会重新计时
+     *
+     * @param delay 延迟的 tick 数, 不足 1 按 1 处理
+     * @param period 重复周期, 0 表示只触发一次
+     */
+    void Schedule(TimerNode& node, std::uint64_t delay, std::uint64_t period = 0) noexcept {
+        Cancel(node);
+        node.period = period;
+        node.expires = now_ + (delay ? delay : 1);
+        ++size_;
+        Link(node);
+    }
+    /** 取消定时器 */
+    void Cancel(TimerNode& node) noexcept {
+        if (node.slot == kNoSlot) {
+            return;
+        }
+        Unlink(node);
+        --size_;
+    }
+    /**
+     * @brief 下一个需要处理的 tick, 没有定时器时返回空
+     * @details 返回值可能是高层槽位的降级时间点，早于真实的到期时间，但不会晚于它
+     */
+    std::optional<std::uint64_t> NextTick() const noexcept {
+        std::optional<std::uint64_t> next;
+        for (std::size_t level = 0; level < kLevels; ++level) {
+            std::uint64_t bitmap = bitmaps_[level];
+            if (!bitmap) {
+                continue;
+            }
+            auto cur = static_cast<unsigned>((now_ >> Shift(level)) & kSlotMask);
+            bitmap &= ~((std::uint64_t{2} << cur) - 1);
+            if (!bitmap) {
+                continue;
+            }
+            std::uint64_t tick = (now_ & HighMask(level + 1)) |
+                                 (static_cast<std::uint64_t>(CountZero(bitmap)) << Shift(level));
+            if (!next || tick < *next) {
+                next = tick;
+            }
+        }
+        return next;
+    }
+    /**
+     * @brief 推进时间轮到 now, 触发所有到期的定时器
+     *
+     * @return std::size_t 触发的定时器数量
+     */
+    std::size_t Advance(std::uint64_t now) {
+        std::size_t count = 0;
+        while (now_ < now) {
+            auto next = NextTick();
+            if (!next || *next > now) {
+                now_ = now;
+                break;
+            }
+            now_ = *next;
+            Cascade();
+            Splice(slots_[Index(0, now_)]);
+            count += RunExpired(now);
+        }
+        return count;
+    }
+
+private:
+    static constexpr std::size_t kBits = 6;
+    static constexpr std::size_t kSlots = std::size_t{1} << kBits;
+    static constexpr std::uint64_t kSlotMask = kSlots - 1;
+    static constexpr std::size_t kLevels = (64 + kBits - 1) / kBits;
+    static constexpr std::uint16_t kExpired = kNoSlot - 1;
+
+    std::uint64_t now_;
+    std::size_t size_ = 0;
+    std::array<TimerLink, kSlots * kLevels> slots_;
+    std::array<std::uint64_t, kLevels> bitmaps_{};
+    /** 已到期待执行的定时器 */
+    TimerLink expired_;
+
+    static constexpr unsigned Shift(std::size_t level) noexcept {
+        return static_cast<unsigned>(level * kBits);
+    }
+    /** 高于 level 层的位掩码 */
+    static constexpr std::uint64_t HighMask(std::size_t level) noexcept {
+        return Shift(level) >= 64 ? 0 : ~((std::uint64_t{1} << Shift(level)) - 1);
+    }
+    static std::size_t Index(std::size_t level, std::uint64_t tick) noexcept {
+        return level * kSlots + static_cast<std::size_t>((tick >> Shift(level)) & kSlotMask);
+    }
+    static unsigned CountZero(std::uint64_t value) noexcept {
+        unsigned n = 0;
+        while (!(value & 1)) {
+            value >>= 1;
+            ++n;
+        }
+        return n;
+    }
+    static void PushBack(TimerLink& head, TimerLink& node) noexcept {
+        node.prev = head.prev;
+        node.next = &head;
+        head.prev->next = &node;
+        head.prev = &node;
+    }
+    /** 按到期时间与当前时间的最高不同位选择层级 */
+    void Link(TimerNode& node) noexcept {
+        std::uint64_t diff = node.expires ^ now_;
+        std::size_t level = 0;
+        while (level + 1 < kLevels && (diff >> Shift(level + 1))) {
+            ++level;
+        }
+        std::size_t index = Index(level, node.expires);
+        node.slot = static_cast<std::uint16_t>(index);
+        PushBack(slots_[index], node);
+        bitmaps_[level] |= std::uint64_t{1} << (index & kSlotMask);
+    }
+    void Unlink(TimerNode& node) noexcept {
+        node.prev->next = node.next;
+        node.next->prev = node.prev;
+        if (node.slot != kExpired && slots_[node.slot].next == &slots_[node.slot]) {
+            bitmaps_[node.slot / kSlots] &= ~(std::uint64_t{1} << (node.slot & kSlotMask));
+        }
+        node.prev = node.next = nullptr;
+        node.slot = kNoSlot;
+    }
+    /** 到达高层槽位的时间点时，把该槽位的定时器降级到低层 */
+    void Cascade() noexcept {
+        for (std::size_t level = kLevels - 1; level > 0; --level) {
+            if (now_ & ~HighMask(level)) {
+                continue;
+            }
+            TimerLink& head = slots_[Index(level, now_)];
+            while (head.next != &head) {
+                auto& node = *static_cast<TimerNode*>(head.next);
+                Unlink(node);
+                if (node.expires <= now_) {
+                    node.slot = kExpired;
+                    PushBack(expired_, node);
+                } else {
+                    Link(node);
+                }
+            }
+        }
+    }
+    /** 把槽位的定时器移到待执行链表 */
+    void Splice(TimerLink& head) noexcept {
+        while (head.next != &head) {
+            auto& node = *static_cast<TimerNode*>(head.next);
+            Unlink(node);
+            node.slot = kExpired;
+            PushBack(expired_, node);
+        }
+    }
+    /**
+     * @brief 执行到期的定时器, 回调中可以安全地启动或取消任意定时器
+     * @details 重复的定时器按原来的相位在不早于 now 的第一个周期再次到期，
+     *   推进前停顿了很久时错过的周期只触发一次，不会连续补发
+     *
+     * @param now Advance 推进到的真实时间
+     */
+    std::size_t RunExpired(std::uint64_t now) {
+        std::size_t count = 0;
+        while (expired_.next != &expired_) {
+            auto& node = *static_cast<TimerNode*>(expired_.next);
+            Unlink(node);
+            if (node.period) {
+                // 跳过 now 之前错过的周期, 至少推迟一个周期
+                std::uint64_t missed = (now - node.expires + node.period - 1) / node.period;
+                node.expires += node.period * (missed ? missed : 1);
+                Link(node);
+            } else {
+                --size_;
+            }
+            ++count;
+            if (node.callback) {
+                node.callback();
+            }
+        }
+        return count;
+    }
+};
+
+}  // namespace cxxui::detail
@@ -0,0 +1,158 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace cxxui::detail {
+
+/**
+ * @brief 投递到UI线程执行的任务节点
+ * @details 侵入式节点，由投递者持有内存(通常位于协程帧中)，投递不分配内存。
+ * 队列关闭后任务不再执行，改为调用 drop 释放节点持有的资源，drop 为空时直接丢弃节点。
+ */
+struct UiTask {
+    UiTask* next = nullptr;
+    void (*run)(UiTask*) = nullptr;
+    void (*drop)(UiTask*) = nullptr;
+};
+
+/**
+ * @brief UI线程的任务队列
+ * @details 任意线程都可以投递任务，任务只在调用 RunPending 的UI线程执行。
+ * 队列从空变为非空时调用一次唤醒函数，平台层用它唤醒消息循环。
+ * UI线程退出时队列关闭，未执行的任务和之后投递的任务都被丢弃，不会在其他线程执行。
+ */
+class UiQueue {
+public:
+    UiQueue() = default;
+    UiQueue(const UiQueue&) = delete;
+    UiQueue& operator=(const UiQueue&) = delete;
+    ~UiQueue() { Close(); }
+
+    /** 设置唤醒UI线程的函数 */
+    void SetWake(std::function<void()> wake) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wake_ = std::move(wake);
+    }
+    /**
+     * @brief 投递任务, 可以在任意线程调用
+     *
+     * @return bool 队列已关闭时丢弃任务并返回 false
+     */
+    bool Post(UiTask& task) {
+        std::function<void()> wake;
+        bool closed;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed = closed_;
+            if (!closed) {
+                task.next = nullptr;
+                if (tail_) {
+                    tail_->next = &task;
+                } else {
+                    head_ = &task;
+                }
+                tail_ = &task;
+                if (!notified_) {
+                    notified_ = true;
+                    wake = wake_;
+                }
+            }
+        }
+        if (closed) {
+            Drop(&task);
+            return false;
+        }
+        if (wake) {
+            wake();
+        }
+        return true;
+    }
+    /**
+     * @brief 执行已投递的任务, 在UI线程调用
+     *
+     * @return std::size_t 执行的任务数量
+     */
+    std::size_t RunPending() {
+        UiTask* task;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task = head_;
+            head_ = tail_ = nullptr;
+            notified_ = false;
+        }
+        std::size_t count = 0;
+        while (task) {
+            // 任务执行后节点可能已被释放, 先取出下一个
+            UiTask* next = task->next;
+            task->run(task);
+            task = next;
+            ++count;
+        }
+        return count;
+    }
+    /**
+     * @brief 关闭队列, 丢弃未执行的任务, 之后投递的任务也被丢弃
+     *
+     * @return std::size_t 丢弃的任务数量
+     */
+    std::size_t Close() {
+        UiTask* task;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+            task = head_;
+            head_ = tail_ = nullptr;
+            wake_ = nullptr;
+        }
+        std::size_t count = 0;
+        while (task) {
+            UiTask* next = task->next;
+            Drop(task);
+            task = next;
+            ++count;
+        }
+        return count;
+    }
+    bool IsEmpty() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return head_ == nullptr;
+    }
+    bool IsClosed() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    UiTask* head_ = nullptr;
+    UiTask* tail_ = nullptr;
+    bool notified_ = false;
+    bool closed_ = false;
+    std::function<void()> wake_;
+
+    static void Drop(UiTask* task) {
+        if (task->drop) {
+            task->drop(task);
+        }
+    }
+};
+
+/**
+ * @brief 当前线程的UI任务队列, 其他线程持有它投递任务
+ * @details 线程退出时关闭队列，仍被持有的队列对象在最后一个持有者释放时销毁
+ */
+inline const std::shared_ptr<UiQueue>& GetSharedUiQueue() {
+    struct Holder {
+        std::shared_ptr<UiQueue> queue = std::make_shared<UiQueue>();
+        ~Holder() { queue->Close(); }
+    };
+    thread_local Holder holder;
+    return holder.queue;
+}
+
+/** 当前线程的UI任务队列 */
+inline UiQueue& GetUiQueue() { return *GetSharedUiQueue(); }
+
+}  // namespace cxxui::detail
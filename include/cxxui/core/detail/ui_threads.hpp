@@ -0,0 +1,136 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace cxxui::detail {
+
+/**
+ * @brief 记录运行消息循环的UI线程及其主窗口
+ * @details 退出策略：
+ *   - 每个线程调用 Run 的窗口是该线程的主窗口，主窗口销毁时结束该线程的消息循环；
+ *   - 第一个进入消息循环的线程是主UI线程，它的主窗口销毁时结束所有UI线程的消息循环；
+ *   - ExitAll 结束所有UI线程的消息循环。
+ * 平台相关的操作由 Backend 提供，Backend 需要定义：
+ *   using ThreadId;                        线程ID
+ *   using Window;                          窗口句柄
+ *   void Quit(ThreadId, int exit_code);    结束线程的消息循环
+ */
+template <typename Backend>
+class UiThreadRegistry {
+public:
+    using ThreadId = typename Backend::ThreadId;
+    using Window = typename Backend::Window;
+
+    UiThreadRegistry() = default;
+    explicit UiThreadRegistry(Backend backend)
+        : backend_(std::move(backend)) {}
+    Backend& GetBackend() noexcept { return backend_; }
+    /** 线程进入消息循环, 同一线程嵌套进入时替换主窗口 */
+    void Enter(ThreadId thread, Window main) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (auto it = Find(thread); it != threads_.end()) {
+            it->main = main;
+            return;
+        }
+        if (!primary_) {
+            primary_ = thread;
+        }
+        threads_.push_back({thread, main});
+    }
+    /** 线程退出消息循环 */
+    void Leave(ThreadId thread) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (auto it = Find(thread); it != threads_.end()) {
+            threads_.erase(it);
+        }
+        if (primary_ == thread) {
+            primary_.reset();
+        }
+    }
+    /**
+     * @brief 窗口销毁时调用, 按退出策略结束消息循环
+     *
+     * @return bool 销毁的是主窗口返回true
+     */
+    bool OnWindowDestroyed(ThreadId thread, Window window) {
+        std::vector<ThreadId> quits;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = Find(thread);
+            if (it == threads_.end() || it->main != window) {
+                return false;
+            }
+            // 置空主窗口, 防止重复结束消息循环
+            it->main = Window{};
+            if (primary_ == thread) {
+                quits = AllThreads();
+            } else {
+                quits.push_back(thread);
+            }
+        }
+        for (auto& id : quits) {
+            backend_.Quit(id, 0);
+        }
+        return true;
+    }
+    /**
+     * @brief 结束所有UI线程的消息循环
+     *
+     * @return std::size_t 结束的线程数量
+     */
+    std::size_t ExitAll(int exit_code) {
+        std::vector<ThreadId> quits;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            quits = AllThreads();
+        }
+        for (auto& id : quits) {
+            backend_.Quit(id, exit_code);
+        }
+        return quits.size();
+    }
+    bool IsMainWindow(ThreadId thread, Window window) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find_if(threads_.begin(), threads_.end(), [&](const Entry& entry) {
+            return entry.thread == thread;
+        });
+        return it != threads_.end() && it->main == window;
+    }
+    bool IsPrimary(ThreadId thread) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return primary_ == thread;
+    }
+    std::size_t Size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return threads_.size();
+    }
+
+private:
+    struct Entry {
+        ThreadId thread;
+        Window main;
+    };
+    mutable std::mutex mutex_;
+    std::vector<Entry> threads_;
+    std::optional<ThreadId> primary_;
+    Backend backend_;
+
+    typename std::vector<Entry>::iterator Find(ThreadId thread) {
+        return std::find_if(threads_.begin(), threads_.end(), [&](const Entry& entry) {
+            return entry.thread == thread;
+        });
+    }
+    std::vector<ThreadId> AllThreads() const {
+        std::vector<ThreadId> ids;
+        ids.reserve(threads_.size());
+        for (auto& entry : threads_) {
+            ids.push_back(entry.thread);
+        }
+        return ids;
+    }
+};
+
+}  // namespace cxxui::detail
@@ -6,4 +6,16 @@ namespace cxxui::detail {
 /** webview 创建完成的消息 */
 constexpr UINT UM_WEB_CREATED = WM_USER + 1000;
 
+/** 唤醒消息循环执行UI任务队列的线程消息 */
+constexpr UINT UM_WAKE = WM_USER + 1001;
+
+/** 结束其他UI线程消息循环的线程消息 */
+constexpr UINT UM_QUIT = WM_USER + 1002;
+
+/** 帧时钟的定时器ID */
+constexpr UINT_PTR TM_FRAME = 0xC000;
+
+/** 模态循环期间驱动时间轮的定时器ID */
+constexpr UINT_PTR TM_TIMER_WHEEL = 0xC001;
+
 }
\ No newline at end of file
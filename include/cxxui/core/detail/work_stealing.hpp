@@ -0,0 +1,238 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cxxui/core/log.hpp>
+
+namespace cxxui::detail {
+
+/**
+ * @brief 只能移动的无返回值函数, 可以保存不能复制的对象
+ */
+class Job {
+public:
+    Job() = default;
+    template <typename Func, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Func>, Job>>>
+    explicit Job(Func&& func)
+        : impl_(std::make_unique<Impl<std::decay_t<Func>>>(std::forward<Func>(func))) {}
+
+    explicit operator bool() const noexcept { return impl_ != nullptr; }
+    void operator()() { impl_->Run(); }
+
+private:
+    struct Base {
+        virtual ~Base() = default;
+        virtual void Run() = 0;
+    };
+    template <typename Func>
+    struct Impl : Base {
+        explicit Impl(Func&& f)
+            : func(std::move(f)) {}
+        explicit Impl(const Func& f)
+            : func(f) {}
+        void Run() override { func(); }
+        Func func;
+    };
+    std::unique_ptr<Base> impl_;
+};
+
+/** 线程池的统计数据 */
+struct WorkStealingStats {
+    /** 执行的任务数量 */
+    std::uint64_t executed = 0;
+    /** 从其他线程的队列中取得的任务数量 */
+    std::uint64_t stolen = 0;
+};
+
+/**
+ * @brief 任务窃取线程池
+ * @details 每个线程有自己的队列，每个优先级一个。池内线程投递的任务放到本线程的队列，
+ *   从末尾取出(后进先出，数据还在缓存中)；其他线程投递的任务放到共享队列，按投递顺序取出。
+ *   自己的队列和共享队列都为空时从其他线程的队列头部窃取。优先级高的任务总是先于优先级低的任务被取出。
+ *   没有任务时线程休眠，不占用CPU。析构时执行完所有已投递的任务再结束线程。不依赖平台。
+ */
+class WorkStealingPool {
+public:
+    /** 优先级数量, 0 为最高 */
+    static constexpr std::size_t kLevels = 3;
+
+    explicit WorkStealingPool(std::size_t threads) {
+        threads = (std::max)(threads, std::size_t{1});
+        for (std::size_t i = 0; i < threads; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+        for (std::size_t i = 0; i < threads; ++i) {
+            workers_[i]->thread = std::thread([this, i] { Run(i); });
+        }
+    }
+    ~WorkStealingPool() {
+        {
+            std::lock_guard lock(sleep_mutex_);
+            stop_ = true;
+        }
+        sleep_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker->thread.join();
+        }
+    }
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /** 投递任务, 可以在任意线程调用 */
+    void Push(Job job, std::size_t level) {
+        level = (std::min)(level, kLevels - 1);
+        const WorkerContext& context = GetWorkerContext();
+        Queue& queue = context.pool == this ? *workers_[context.index] : injector_;
+        {
+            std::lock_guard lock(queue.mutex);
+            queue.jobs[level].push_back(std::move(job));
+            queue.size.fetch_add(1, std::memory_order_release);
+        }
+        // 先增加任务数再检查休眠数, 与 Run 中相反的顺序保证不会错过唤醒
+        pending_.fetch_add(1);
+        if (sleeping_.load() > 0) {
+            std::lock_guard lock(sleep_mutex_);
+            sleep_cv_.notify_one();
+        }
+    }
+    std::size_t GetThreadCount() const noexcept { return workers_.size(); }
+    /** 当前线程是否是池内线程 */
+    bool IsWorkerThread() const noexcept { return GetWorkerContext().pool == this; }
+    WorkStealingStats GetStats() const noexcept {
+        WorkStealingStats stats;
+        for (const auto& worker : workers_) {
+            stats.executed += worker->executed.load(std::memory_order_relaxed);
+            stats.stolen += worker->stolen.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+private:
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::array<std::deque<Job>, kLevels> jobs;
+        /** 各优先级的任务总数, 取任务时先检查, 避免为空队列加锁 */
+        std::atomic<std::size_t> size{0};
+    };
+    struct Worker : Queue {
+        std::atomic<std::uint64_t> executed{0};
+        std::atomic<std::uint64_t> stolen{0};
+        std::thread thread;
+    };
+    /** 当前线程所属的线程池 */
+    struct WorkerContext {
+        const WorkStealingPool* pool = nullptr;
+        std::size_t index = 0;
+    };
+    static WorkerContext& GetWorkerContext() noexcept {
+        thread_local WorkerContext context;
+        return context;
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    /** 池外线程投递的任务 */
+    Queue injector_;
+    /** 已投递未取出的任务数量, 取出和投递的先后不定, 可能暂时为负 */
+    std::atomic<std::ptrdiff_t> pending_{0};
+    std::atomic<std::size_t> sleeping_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    bool stop_ = false;
+
+    void Run(std::size_t index) {
+        GetWorkerContext() = {this, index};
+        // 没有任务时先让出几次时间片再休眠, 连续投递的任务不必每次都唤醒线程
+        constexpr int kSpins = 16;
+        int spins = 0;
+        while (true) {
+            if (RunOne(index)) {
+                spins = 0;
+                continue;
+            }
+            if (spins++ < kSpins) {
+                std::this_thread::yield();
+                continue;
+            }
+            spins = 0;
+            std::unique_lock lock(sleep_mutex_);
+            if (stop_ && pending_.load() <= 0) {
+                break;
+            }
+            sleeping_.fetch_add(1);
+            sleep_cv_.wait(lock, [this] { return pending_.load() > 0 || stop_; });
+            sleeping_.fetch_sub(1);
+        }
+    }
+    /** 取出并执行一个任务, 没有任务时返回 false */
+    bool RunOne(std::size_t index) {
+        if (pending_.load(std::memory_order_relaxed) <= 0) {
+            return false;
+        }
+        Worker& self = *workers_[index];
+        for (std::size_t level = 0; level < kLevels; ++level) {
+            if (Job job = Take(self, level, false)) {
+                Execute(self, job);
+                return true;
+            }
+            if (Job job = Take(injector_, level, true)) {
+                Execute(self, job);
+                return true;
+            }
+            for (std::size_t i = 1; i < workers_.size(); ++i) {
+                Worker& victim = *workers_[(index + i) % workers_.size()];
+                if (Job job = Take(victim, level, true)) {
+                    self.stolen.fetch_add(1, std::memory_order_relaxed);
+                    Execute(self, job);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+    /** 自己的队列从末尾取, 共享队列和窃取从头部取 */
+    Job Take(Queue& queue, std::size_t level, bool front) {
+        if (queue.size.load(std::memory_order_acquire) == 0) {
+            return {};
+        }
+        std::lock_guard lock(queue.mutex);
+        auto& jobs = queue.jobs[level];
+        if (jobs.empty()) {
+            return {};
+        }
+        Job job;
+        if (front) {
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        } else {
+            job = std::move(jobs.back());
+            jobs.pop_back();
+        }
+        queue.size.fetch_sub(1, std::memory_order_relaxed);
+        pending_.fetch_sub(1);
+        return job;
+    }
+    static void Execute(Worker& self, Job& job) {
+        try {
+            job();
+        } catch (const std::exception& e) {
+            CXXUI_LOG_ERROR("Executor job threw", 0, e.what());
+        } catch (...) {
+            CXXUI_LOG_ERROR("Executor job threw");
+        }
+        self.executed.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+}  // namespace cxxui::detail
@@ -0,0 +1,377 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "task.hpp"
+#include "detail/ui_queue.hpp"
+#include "detail/work_stealing.hpp"
+
+namespace cxxui {
+
+/**
+ * @brief 后台任务的优先级
+ */
+enum class TaskPriority {
+    LOW = -1,
+    NORMAL = 0,
+    HIGH = 1,
+};
+
+/** 线程池的统计数据 */
+using ExecutorStats = detail::WorkStealingStats;
+
+template <typename T = void>
+class Future;
+class Executor;
+
+namespace detail {
+
+inline std::size_t GetPriorityLevel(TaskPriority priority) noexcept {
+    return static_cast<std::size_t>(1 - static_cast<int>(priority));
+}
+
+/** Future 的共享状态, 完成后执行唯一的后续任务 */
+class FutureStateBase {
+public:
+    /** 完成后在完成的线程执行 job, 已完成时立即执行 */
+    void OnReady(Job job) {
+        {
+            std::lock_guard lock(mutex_);
+            if (!ready_) {
+                continuation_ = std::move(job);
+                return;
+            }
+        }
+        job();
+    }
+    bool IsReady() const {
+        std::lock_guard lock(mutex_);
+        return ready_;
+    }
+    void Wait() const {
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [this] { return ready_; });
+    }
+    void SetError(std::exception_ptr error) {
+        error_ = std::move(error);
+        Complete();
+    }
+    const std::exception_ptr& GetError() const noexcept { return error_; }
+
+protected:
+    void Complete() {
+        Job continuation;
+        {
+            std::lock_guard lock(mutex_);
+            ready_ = true;
+            continuation = std::move(continuation_);
+        }
+        cv_.notify_all();
+        if (continuation) {
+            continuation();
+        }
+    }
+    void Rethrow() const {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    mutable std::mutex mutex_;
+    mutable std::condition_variable cv_;
+    bool ready_ = false;
+    std::exception_ptr error_;
+    Job continuation_;
+};
+
+template <typename T>
+class FutureState : public FutureStateBase {
+public:
+    template <typename U>
+    void SetValue(U&& value) {
+        value_.emplace(std::forward<U>(value));
+        Complete();
+    }
+    /** 取出结果, 失败时抛出任务的异常 */
+    T Take() {
+        Rethrow();
+        return std::move(*value_);
+    }
+
+private:
+    std::optional<T> value_;
+};
+
+template <>
+class FutureState<void> : public FutureStateBase {
+public:
+    void SetValue() { Complete(); }
+    void Take() { Rethrow(); }
+};
+
+/** 执行 func 并把结果或异常保存到 state */
+template <typename R, typename Func, typename... Args>
+void RunInto(FutureState<R>& state, Func& func, Args&&... args) noexcept {
+    try {
+        if constexpr (std::is_void_v<R>) {
+            std::invoke(func, std::forward<Args>(args)...);
+            state.SetValue();
+        } else {
+            state.SetValue(std::invoke(func, std::forward<Args>(args)...));
+        }
+    } catch (...) {
+        state.SetError(std::current_exception());
+    }
+}
+
+/** 用上一步的结果执行后续任务, 上一步失败时跳过, 传递异常 */
+template <typename T, typename R, typename Func>
+void RunContinuation(FutureState<T>& prev, FutureState<R>& next, Func& func) noexcept {
+    if (prev.GetError()) {
+        next.SetError(prev.GetError());
+    } else if constexpr (std::is_void_v<T>) {
+        RunInto(next, func);
+    } else {
+        RunInto(next, func, prev.Take());
+    }
+}
+
+template <typename T, typename Func>
+struct ContinuationResult {
+    using type = std::invoke_result_t<Func&, T>;
+};
+template <typename Func>
+struct ContinuationResult<void, Func> {
+    using type = std::invoke_result_t<Func&>;
+};
+
+/** 投递到UI线程执行一次后自行销毁的任务, 队列已关闭时改为执行 cancel 后销毁 */
+struct UiJob : UiTask {
+    explicit UiJob(Job j, Job c = {})
+        : job(std::move(j)),
+          cancel(std::move(c)) {
+        run = [](UiTask* task) {
+            std::unique_ptr<UiJob> self{static_cast<UiJob*>(task)};
+            self->job();
+        };
+        drop = [](UiTask* task) {
+            std::unique_ptr<UiJob> self{static_cast<UiJob*>(task)};
+            if (self->cancel) {
+                self->cancel();
+            }
+        };
+    }
+    Job job;
+    Job cancel;
+};
+
+#if CXXUI_HAS_COROUTINE
+/**
+ * @brief co_await Future 时由完成的回调和等待的协程共享
+ * @details 协程在完成之前被销毁时不再恢复它，队列已关闭时只释放自身
+ */
+struct FutureResume : ResumeTask {
+    std::shared_ptr<UiQueue> queue;
+    /** 在消息循环中排队期间持有自身 */
+    std::shared_ptr<FutureResume> self;
+    FutureResume() {
+        run = [](UiTask* task) {
+            auto resume = std::move(static_cast<FutureResume*>(task)->self);
+            if (resume->handle) {
+                resume->handle.resume();
+            }
+        };
+        drop = [](UiTask* task) { static_cast<FutureResume*>(task)->self.reset(); };
+    }
+};
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief 后台任务的结果
+ * @details 可以 Wait/Get 阻塞等待，也可以用 Then 在线程池中、用 ThenOnUi 在UI线程中接着执行，
+ *   或者在UI线程的协程中 co_await。任务抛出的异常保存在结果中，Get 或 co_await 时重新抛出，
+ *   后续任务被跳过，异常传递到最后一步。每个 Future 只能取一次结果或接一个后续任务。
+ */
+template <typename T>
+class Future {
+public:
+    Future() = default;
+
+    bool IsValid() const noexcept { return state_ != nullptr; }
+    bool IsReady() const { return state_->IsReady(); }
+    /** 阻塞等待完成, 不要在UI线程中等待耗时的任务, 也不要在同一线程池的任务中等待 */
+    void Wait() const { state_->Wait(); }
+    /** 阻塞等待并取出结果, 任务失败时抛出任务的异常 */
+    T Get() {
+        state_->Wait();
+        return state_->Take();
+    }
+    /**
+     * @brief 完成后在线程池中用结果调用 func
+     *
+     * @param func 参数为上一步的结果(void 时没有参数)，返回值作为新的结果
+     * @return 后续任务的结果
+     */
+    template <typename Func>
+    auto Then(Func&& func, TaskPriority priority = TaskPriority::NORMAL) && {
+        using R = typename detail::ContinuationResult<T, std::decay_t<Func>>::type;
+        auto next = std::make_shared<detail::FutureState<R>>();
+        detail::WorkStealingPool* pool = pool_;
+        std::size_t level = detail::GetPriorityLevel(priority);
+        auto prev = state_;
+        prev->OnReady(detail::Job{
+            [prev, next, pool, level, func = std::forward<Func>(func)]() mutable {
+                pool->Push(detail::Job{[prev = std::move(prev),
+                                        next = std::move(next),
+                                        func = std::move(func)]() mutable {
+                               detail::RunContinuation(*prev, *next, func);
+                           }},
+                           level);
+            }});
+        state_.reset();
+        return Future<R>{std::move(next), pool};
+    }
+    /**
+     * @brief 完成后回到当前线程(拥有窗口的UI线程)的消息循环中用结果调用 func
+     * @details 在UI线程调用，func 中可以直接操作窗口。UI线程退出后 func 不再执行，
+     *   返回的结果以 std::runtime_error 结束。
+     */
+    template <typename Func>
+    auto ThenOnUi(Func&& func) && {
+        using R = typename detail::ContinuationResult<T, std::decay_t<Func>>::type;
+        auto next = std::make_shared<detail::FutureState<R>>();
+        // 持有队列, UI线程退出后队列关闭但不会销毁
+        std::shared_ptr<detail::UiQueue> queue = detail::GetSharedUiQueue();
+        auto prev = state_;
+        prev->OnReady(detail::Job{[prev, next, queue, func = std::forward<Func>(func)]() mutable {
+            detail::Job cancel{[next] {
+                next->SetError(std::make_exception_ptr(std::runtime_error("UI thread exited")));
+            }};
+            auto job = std::make_unique<detail::UiJob>(
+                detail::Job{[prev = std::move(prev), next = std::move(next),
+                             func = std::move(func)]() mutable {
+                    detail::RunContinuation(*prev, *next, func);
+                }},
+                std::move(cancel));
+            // 队列已关闭时 Post 执行 cancel 并释放任务
+            queue->Post(*job.release());
+        }});
+        state_.reset();
+        return Future<R>{std::move(next), pool_};
+    }
+
+#if CXXUI_HAS_COROUTINE
+    /**
+     * @brief 在UI线程的协程中等待结果, 完成后在该线程的消息循环中恢复
+     * @details 用法：auto sum = co_await Executor::GetDefault().Submit([] { return Sum(); });
+     *   协程在完成前被销毁或UI线程已退出时不再恢复。
+     */
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::shared_ptr<detail::FutureState<T>> state;
+            std::shared_ptr<detail::FutureResume> resume;
+            Awaiter() = default;
+            Awaiter(Awaiter&&) = default;
+            ~Awaiter() {
+                // 协程已销毁, 之后的回调不再恢复它
+                if (resume) {
+                    resume->handle = nullptr;
+                }
+            }
+            bool await_ready() const { return state->IsReady(); }
+            void await_suspend(std::coroutine_handle<> h) {
+                resume = std::make_shared<detail::FutureResume>();
+                resume->handle = h;
+                resume->queue = detail::GetSharedUiQueue();
+                state->OnReady(detail::Job{[resume = resume] {
+                    resume->self = resume;
+                    resume->queue->Post(*resume);
+                }});
+            }
+            T await_resume() { return state->Take(); }
+        };
+        Awaiter awaiter;
+        awaiter.state = std::move(state_);
+        return awaiter;
+    }
+#endif
+
+private:
+    friend class Executor;
+    template <typename U>
+    friend class Future;
+
+    Future(std::shared_ptr<detail::FutureState<T>> state, detail::WorkStealingPool* pool) noexcept
+        : state_(std::move(state)),
+          pool_(pool) {}
+
+    std::shared_ptr<detail::FutureState<T>> state_;
+    detail::WorkStealingPool* pool_ = nullptr;
+};
+
+/**
+ * @brief 后台任务线程池
+ * @details 各窗口共享 GetDefault() 的线程池，线程数与CPU核数相同，避免各自创建线程。
+ *   空闲的线程从忙碌线程的队列中窃取任务，优先级高的任务先执行。
+ *   js 的协程响应函数可以 co_await Submit 的结果，web 请求的处理函数可以推迟响应
+ *   (RequestContext::Defer)，在后台准备好内容后用 ThenOnUi 回到UI线程设置响应。
+ *   线程池析构时执行完已投递的任务，Future 的后续任务不能在线程池析构后完成。不依赖平台。
+ */
+class Executor {
+public:
+    /**
+     * @param threads 线程数, 0 表示CPU核数
+     */
+    explicit Executor(std::size_t threads = 0)
+        : pool_(threads > 0 ? threads : (std::max)(std::thread::hardware_concurrency(), 1u)) {}
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /** 所有窗口共享的线程池 */
+    static Executor& GetDefault() {
+        static Executor instance;
+        return instance;
+    }
+    /**
+     * @brief 在线程池中执行 func
+     *
+     * @return 通过 Future 获取 func 的返回值或异常
+     */
+    template <typename Func>
+    auto Submit(Func&& func, TaskPriority priority = TaskPriority::NORMAL) {
+        using R = std::invoke_result_t<std::decay_t<Func>&>;
+        auto state = std::make_shared<detail::FutureState<R>>();
+        pool_.Push(detail::Job{[state, func = std::forward<Func>(func)]() mutable {
+                       detail::RunInto(*state, func);
+                   }},
+                   detail::GetPriorityLevel(priority));
+        return Future<R>{std::move(state), &pool_};
+    }
+    /** 在线程池中执行 func, 不需要结果, 异常只记录日志 */
+    template <typename Func>
+    void Post(Func&& func, TaskPriority priority = TaskPriority::NORMAL) {
+        pool_.Push(detail::Job{std::forward<Func>(func)}, detail::GetPriorityLevel(priority));
+    }
+    std::size_t GetThreadCount() const noexcept { return pool_.GetThreadCount(); }
+    /** 当前线程是否是该线程池的线程 */
+    bool IsWorkerThread() const noexcept { return pool_.IsWorkerThread(); }
+    ExecutorStats GetStats() const noexcept { return pool_.GetStats(); }
+
+private:
+    detail::WorkStealingPool pool_;
+};
+
+}  // namespace cxxui
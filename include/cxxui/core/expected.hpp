@@ -0,0 +1,67 @@
+#pragma once
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace cxxui {
+
+/**
+ * @brief 作为 Expected 的错误值
+ */
+template <typename E>
+class Unexpected {
+public:
+    explicit Unexpected(E error)
+        : error_(std::move(error)) {}
+    E& GetError() & noexcept { return error_; }
+    const E& GetError() const& noexcept { return error_; }
+    E&& GetError() && noexcept { return std::move(error_); }
+
+private:
+    E error_;
+};
+template <typename E>
+Unexpected(E) -> Unexpected<E>;
+
+/**
+ * @brief 值或错误, 用于不抛出异常的错误处理, 与 C++23 的 std::expected 类似
+ * @details 从 T 隐式构造为值，从 Unexpected<E> 构造为错误。访问值或错误前需要先检查 HasValue。
+ */
+template <typename T, typename E>
+class Expected {
+    template <typename U>
+    struct IsUnexpected : std::false_type {};
+    template <typename G>
+    struct IsUnexpected<Unexpected<G>> : std::true_type {};
+    template <typename U>
+    using Plain = std::remove_cv_t<std::remove_reference_t<U>>;
+
+public:
+    template <typename U = T,
+              typename = std::enable_if_t<!IsUnexpected<Plain<U>>::value &&
+                                          !std::is_same_v<Plain<U>, Expected> &&
+                                          std::is_constructible_v<T, U&&>>>
+    Expected(U&& value)
+        : storage_(std::in_place_index<0>, std::forward<U>(value)) {}
+    template <typename G>
+    Expected(Unexpected<G> error)
+        : storage_(std::in_place_index<1>, std::move(error).GetError()) {}
+
+    bool HasValue() const noexcept { return storage_.index() == 0; }
+    explicit operator bool() const noexcept { return HasValue(); }
+    T& GetValue() & noexcept { return *std::get_if<0>(&storage_); }
+    const T& GetValue() const& noexcept { return *std::get_if<0>(&storage_); }
+    T&& GetValue() && noexcept { return std::move(*std::get_if<0>(&storage_)); }
+    E& GetError() & noexcept { return *std::get_if<1>(&storage_); }
+    const E& GetError() const& noexcept { return *std::get_if<1>(&storage_); }
+    E&& GetError() && noexcept { return std::move(*std::get_if<1>(&storage_)); }
+    T& operator*() & noexcept { return GetValue(); }
+    const T& operator*() const& noexcept { return GetValue(); }
+    T* operator->() noexcept { return &GetValue(); }
+    const T* operator->() const noexcept { return &GetValue(); }
+
+private:
+    std::variant<T, E> storage_;
+};
+
+}  // namespace cxxui
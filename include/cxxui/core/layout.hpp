@@ -0,0 +1,274 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "rect.hpp"
+
+namespace cxxui {
+
+/** 子节点的排列方向 */
+enum class FlexDirection { ROW, COLUMN };
+/** 子节点在交叉轴上的对齐方式 */
+enum class FlexAlign { STRETCH, START, CENTER, END };
+/** 子节点在主轴上的分布方式 */
+enum class FlexJustify { START, CENTER, END, SPACE_BETWEEN };
+
+/** 四个方向的边距 */
+struct Edges {
+    int left = 0;
+    int top = 0;
+    int right = 0;
+    int bottom = 0;
+};
+
+/**
+ * @brief 类 flexbox 的单行布局节点, 不依赖平台
+ * @details 修改样式或子节点时只标记本节点及其祖先为脏，计算时跳过未标记且分配尺寸未变的子树，
+ *   只平移位置变化的子树。计算结果为相对根节点的绝对坐标，绑定了句柄且位置变化的节点会记录下来，
+ *   由平台层一次性批量应用。
+ */
+class LayoutNode {
+public:
+    /** 自动尺寸: 主轴上由 grow 分配, 交叉轴上由 FlexAlign::STRETCH 拉伸 */
+    static constexpr int kAuto = -1;
+
+    LayoutNode() = default;
+    LayoutNode(const LayoutNode&) = delete;
+    LayoutNode& operator=(const LayoutNode&) = delete;
+
+    /** 添加子节点, 返回的引用在节点被移除前一直有效 */
+    LayoutNode& AddChild() {
+        children_.push_back(std::make_unique<LayoutNode>());
+        children_.back()->parent_ = this;
+        MarkDirty();
+        return *children_.back();
+    }
+    /** 移除子节点及其子树 */
+    void RemoveChild(LayoutNode& child) {
+        auto it = std::find_if(children_.begin(), children_.end(),
+                               [&child](const auto& node) { return node.get() == &child; });
+        if (it != children_.end()) {
+            children_.erase(it);
+            MarkDirty();
+        }
+    }
+    std::size_t GetChildCount() const noexcept { return children_.size(); }
+    LayoutNode& GetChild(std::size_t index) const { return *children_.at(index); }
+    LayoutNode* GetParent() const noexcept { return parent_; }
+
+    LayoutNode& SetDirection(FlexDirection direction) { return Update(direction_, direction); }
+    LayoutNode& SetAlign(FlexAlign align) { return Update(align_, align); }
+    LayoutNode& SetJustify(FlexJustify justify) { return Update(justify_, justify); }
+    /** 设置宽度, kAuto 表示自动 */
+    LayoutNode& SetWidth(int width) { return Update(width_, width); }
+    /** 设置高度, kAuto 表示自动 */
+    LayoutNode& SetHeight(int height) { return Update(height_, height); }
+    LayoutNode& SetMinWidth(int width) { return Update(min_width_, width); }
+    LayoutNode& SetMinHeight(int height) { return Update(min_height_, height); }
+    /** 设置主轴上剩余空间的分配权重 */
+    LayoutNode& SetGrow(float grow) { return Update(grow_, grow); }
+    /** 设置主轴上空间不足时的收缩权重, 按权重乘以基础尺寸的比例收缩 */
+    LayoutNode& SetShrink(float shrink) { return Update(shrink_, shrink); }
+    LayoutNode& SetMargin(const Edges& margin) {
+        margin_ = margin;
+        MarkDirty();
+        return *this;
+    }
+    LayoutNode& SetMargin(int margin) { return SetMargin({margin, margin, margin, margin}); }
+    LayoutNode& SetPadding(const Edges& padding) {
+        padding_ = padding;
+        MarkDirty();
+        return *this;
+    }
+    LayoutNode& SetPadding(int padding) { return SetPadding({padding, padding, padding, padding}); }
+    /** 设置子节点之间的间距 */
+    LayoutNode& SetGap(int gap) { return Update(gap_, gap); }
+    /** 绑定平台句柄, 位置变化时会被记录到 Compute 的输出 */
+    LayoutNode& SetHandle(void* handle) {
+        handle_ = handle;
+        has_rect_ = false;
+        MarkDirty();
+        return *this;
+    }
+    void* GetHandle() const noexcept { return handle_; }
+    /** 最近一次计算的区域, 相对根节点的坐标系 */
+    const Rect& GetRect() const noexcept { return rect_; }
+    bool IsDirty() const noexcept { return dirty_; }
+    /**
+     * @brief 在 bounds 内计算布局
+     *
+     * @param bounds 本节点的区域
+     * @param changed 输出绑定了句柄且区域变化的节点, 可为空
+     */
+    void Compute(const Rect& bounds, std::vector<LayoutNode*>* changed = nullptr) {
+        Layout(bounds, changed);
+    }
+
+private:
+    LayoutNode* parent_ = nullptr;
+    std::vector<std::unique_ptr<LayoutNode>> children_;
+    FlexDirection direction_ = FlexDirection::ROW;
+    FlexAlign align_ = FlexAlign::STRETCH;
+    FlexJustify justify_ = FlexJustify::START;
+    int width_ = kAuto;
+    int height_ = kAuto;
+    int min_width_ = 0;
+    int min_height_ = 0;
+    float grow_ = 0.0f;
+    float shrink_ = 1.0f;
+    Edges margin_;
+    Edges padding_;
+    int gap_ = 0;
+    void* handle_ = nullptr;
+
+    bool dirty_ = true;
+    bool has_rect_ = false;
+    Rect rect_;
+    /** 计算过程中子节点在主轴上的尺寸 */
+    float main_ = 0.0f;
+
+    template <typename T>
+    LayoutNode& Update(T& field, T value) {
+        if (field != value) {
+            field = value;
+            MarkDirty();
+        }
+        return *this;
+    }
+    /** 标记本节点和祖先需要重新计算 */
+    void MarkDirty() noexcept {
+        for (LayoutNode* node = this; node && !node->dirty_; node = node->parent_) {
+            node->dirty_ = true;
+        }
+    }
+    void Layout(const Rect& rect, std::vector<LayoutNode*>* changed) {
+        bool same_size = has_rect_ && rect.Width() == rect_.Width() &&
+                         rect.Height() == rect_.Height();
+        if (!dirty_ && same_size) {
+            if (rect.left != rect_.left || rect.top != rect_.top) {
+                Offset(rect.left - rect_.left, rect.top - rect_.top, changed);
+            }
+            return;
+        }
+        bool moved = !has_rect_ || !same_size || rect.left != rect_.left || rect.top != rect_.top;
+        rect_ = rect;
+        has_rect_ = true;
+        dirty_ = false;
+        if (moved && handle_ && changed) {
+            changed->push_back(this);
+        }
+        LayoutChildren(changed);
+    }
+    /** 只平移子树, 不重新计算尺寸 */
+    void Offset(int dx, int dy, std::vector<LayoutNode*>* changed) {
+        rect_ = {rect_.left + dx, rect_.top + dy, rect_.right + dx, rect_.bottom + dy};
+        if (handle_ && changed) {
+            changed->push_back(this);
+        }
+        for (auto& child : children_) {
+            child->Offset(dx, dy, changed);
+        }
+    }
+    void LayoutChildren(std::vector<LayoutNode*>* changed) {
+        if (children_.empty()) {
+            return;
+        }
+        bool row = direction_ == FlexDirection::ROW;
+        int inner_left = rect_.left + padding_.left;
+        int inner_top = rect_.top + padding_.top;
+        float main = static_cast<float>(
+            (std::max)(0, row ? rect_.Width() - padding_.left - padding_.right
+                              : rect_.Height() - padding_.top - padding_.bottom));
+        float cross = static_cast<float>(
+            (std::max)(0, row ? rect_.Height() - padding_.top - padding_.bottom
+                              : rect_.Width() - padding_.left - padding_.right));
+        // 基础尺寸
+        float used = static_cast<float>(gap_) * static_cast<float>(children_.size() - 1);
+        float total_grow = 0.0f;
+        float total_shrink = 0.0f;
+        for (auto& child : children_) {
+            int basis = row ? child->width_ : child->height_;
+            int min_size = row ? child->min_width_ : child->min_height_;
+            child->main_ = static_cast<float>((std::max)((std::max)(basis, 0), min_size));
+            used += child->main_ + static_cast<float>(child->MainMargin(row));
+            total_grow += child->grow_;
+            total_shrink += child->shrink_ * child->main_;
+        }
+        // 分配剩余空间或收缩
+        float free = main - used;
+        if (free > 0.0f && total_grow > 0.0f) {
+            for (auto& child : children_) {
+                child->main_ += free * child->grow_ / total_grow;
+            }
+            free = 0.0f;
+        } else if (free < 0.0f && total_shrink > 0.0f) {
+            // 单次按比例收缩, 受最小尺寸限制时剩余部分溢出
+            float overflow = -free;
+            float shrunk = 0.0f;
+            for (auto& child : children_) {
+                float min_size = static_cast<float>(row ? child->min_width_ : child->min_height_);
+                float size = child->main_ - overflow * child->shrink_ * child->main_ / total_shrink;
+                size = (std::max)(size, min_size);
+                shrunk += child->main_ - size;
+                child->main_ = size;
+            }
+            free = shrunk - overflow;
+        }
+        // 主轴分布
+        float pos = static_cast<float>(row ? inner_left : inner_top);
+        float spacing = static_cast<float>(gap_);
+        if (free > 0.0f) {
+            switch (justify_) {
+                case FlexJustify::CENTER:
+                    pos += free / 2.0f;
+                    break;
+                case FlexJustify::END:
+                    pos += free;
+                    break;
+                case FlexJustify::SPACE_BETWEEN:
+                    if (children_.size() > 1) {
+                        spacing += free / static_cast<float>(children_.size() - 1);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        float cross_start = static_cast<float>(row ? inner_top : inner_left);
+        for (auto& child : children_) {
+            const Edges& m = child->margin_;
+            pos += static_cast<float>(row ? m.left : m.top);
+            // 交叉轴
+            float margin_before = static_cast<float>(row ? m.top : m.left);
+            float margin_after = static_cast<float>(row ? m.bottom : m.right);
+            float space = (std::max)(0.0f, cross - margin_before - margin_after);
+            int fixed = row ? child->height_ : child->width_;
+            float size = fixed == kAuto ? (align_ == FlexAlign::STRETCH ? space : 0.0f)
+                                        : static_cast<float>(fixed);
+            size = (std::max)(size, static_cast<float>(row ? child->min_height_ : child->min_width_));
+            float offset = 0.0f;
+            if (align_ == FlexAlign::CENTER) {
+                offset = (space - size) / 2.0f;
+            } else if (align_ == FlexAlign::END) {
+                offset = space - size;
+            }
+            float cross_pos = cross_start + margin_before + offset;
+            // 两端分别取整, 相邻节点之间不留缝隙
+            int main_begin = static_cast<int>(std::lround(pos));
+            int main_end = static_cast<int>(std::lround(pos + child->main_));
+            int cross_begin = static_cast<int>(std::lround(cross_pos));
+            int cross_end = static_cast<int>(std::lround(cross_pos + size));
+            child->Layout(row ? Rect{main_begin, cross_begin, main_end, cross_end}
+                              : Rect{cross_begin, main_begin, cross_end, main_end},
+                          changed);
+            pos += child->main_ + static_cast<float>(row ? m.right : m.bottom) + spacing;
+        }
+    }
+    int MainMargin(bool row) const noexcept {
+        return row ? margin_.left + margin_.right : margin_.top + margin_.bottom;
+    }
+};
+
+}  // namespace cxxui
@@ -0,0 +1,462 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * 库内部的日志级别，低于 CXXUI_LOG_LEVEL 的日志宏展开为空，默认只保留警告和错误。
+ * 调用 StartLog 之前日志宏只检查一个原子变量，不记录任何内容。
+ * message 必须是字符串字面量，记录时只保存指针；detail 为可选的动态内容，超长时截断。
+ */
+#define CXXUI_LOG_LEVEL_DEBUG 0
+#define CXXUI_LOG_LEVEL_INFO 1
+#define CXXUI_LOG_LEVEL_WARN 2
+#define CXXUI_LOG_LEVEL_ERROR 3
+#define CXXUI_LOG_LEVEL_OFF 4
+#ifndef CXXUI_LOG_LEVEL
+    #define CXXUI_LOG_LEVEL CXXUI_LOG_LEVEL_WARN
+#endif
+
+/** 参数: (message, code = 0, detail = {}) */
+#define CXXUI_LOG_WRITE(level, ...) ::cxxui::detail::LogWrite(::cxxui::LogLevel::level, __VA_ARGS__)
+/** 被过滤的日志不求值参数, 只用于避免未使用变量的警告 */
+#define CXXUI_LOG_DISCARD(level, ...) ((void)sizeof((CXXUI_LOG_WRITE(level, __VA_ARGS__), 0)))
+#if CXXUI_LOG_LEVEL <= CXXUI_LOG_LEVEL_DEBUG
+    #define CXXUI_LOG_DEBUG(...) CXXUI_LOG_WRITE(DEBUG, __VA_ARGS__)
+#else
+    #define CXXUI_LOG_DEBUG(...) CXXUI_LOG_DISCARD(DEBUG, __VA_ARGS__)
+#endif
+#if CXXUI_LOG_LEVEL <= CXXUI_LOG_LEVEL_INFO
+    #define CXXUI_LOG_INFO(...) CXXUI_LOG_WRITE(INFO, __VA_ARGS__)
+#else
+    #define CXXUI_LOG_INFO(...) CXXUI_LOG_DISCARD(INFO, __VA_ARGS__)
+#endif
+#if CXXUI_LOG_LEVEL <= CXXUI_LOG_LEVEL_WARN
+    #define CXXUI_LOG_WARN(...) CXXUI_LOG_WRITE(WARN, __VA_ARGS__)
+#else
+    #define CXXUI_LOG_WARN(...) CXXUI_LOG_DISCARD(WARN, __VA_ARGS__)
+#endif
+#if CXXUI_LOG_LEVEL <= CXXUI_LOG_LEVEL_ERROR
+    #define CXXUI_LOG_ERROR(...) CXXUI_LOG_WRITE(ERR, __VA_ARGS__)
+#else
+    #define CXXUI_LOG_ERROR(...) CXXUI_LOG_DISCARD(ERR, __VA_ARGS__)
+#endif
+
+namespace cxxui {
+
+/** 日志级别, ERROR 与 wingdi.h 的宏冲突, 使用 ERR */
+enum class LogLevel : std::uint8_t { DEBUG, INFO, WARN, ERR };
+
+/**
+ * @brief 日志的输出格式
+ */
+enum class LogFormat {
+    /**
+     * @brief 每条一行：2026-01-02T03:04:05.678901Z W t1 message code=0x80004005 detail
+     */
+    TEXT,
+    /**
+     * @brief 文件头 "CXXUILOG" + u32 版本号(1)，之后每条记录为：
+     *   u64 UTC 纳秒, i64 code, u32 线程号, u8 级别, u16 message 长度, message,
+     *   u8 detail 长度, detail。整数为本机字节序(小端)
+     */
+    BINARY,
+};
+
+/** 接收一批格式化后的日志, 在后台线程调用 */
+using LogSink = std::function<void(std::string_view)>;
+
+namespace detail {
+
+/** 一条日志记录, 大小为一个缓存行 */
+struct LogRecord {
+    static constexpr std::size_t kDetailSize = 38;
+
+    /** UTC 纳秒 */
+    std::uint64_t time;
+    const char* message;
+    std::int64_t code;
+    LogLevel level;
+    std::uint8_t detail_size;
+    char detail[kDetailSize];
+};
+
+/**
+ * @brief 单个线程的日志暂存区, 单生产者单消费者的无锁环形缓冲区
+ * @details 只由所属线程写入，由后台线程取出。写满时丢弃新记录并计数，不阻塞写入的线程。
+ */
+class LogRing {
+public:
+    static constexpr std::size_t kCapacity = 1024;
+
+    explicit LogRing(std::uint32_t tid) noexcept
+        : tid_(tid) {}
+    std::uint32_t GetTid() const noexcept { return tid_; }
+    bool Push(const LogRecord& record) noexcept {
+        std::uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= kCapacity) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        records_[head & (kCapacity - 1)] = record;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    /** 取出所有记录, 同一时间只能有一个消费者 */
+    template <typename Fn>
+    void Drain(Fn&& fn) {
+        std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        std::uint64_t head = head_.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            fn(records_[tail & (kCapacity - 1)]);
+        }
+        tail_.store(tail, std::memory_order_release);
+    }
+    bool IsEmpty() const noexcept {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_relaxed);
+    }
+    /** 取出并清零丢弃的记录数量 */
+    std::uint64_t TakeDropped() noexcept { return dropped_.exchange(0, std::memory_order_relaxed); }
+
+private:
+    std::uint32_t tid_;
+    /** 生产者和消费者的位置放在不同的缓存行, 避免伪共享 */
+    alignas(64) std::atomic<std::uint64_t> head_{0};
+    alignas(64) std::atomic<std::uint64_t> tail_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::array<LogRecord, kCapacity> records_{};
+};
+
+/**
+ * @brief 管理所有线程的暂存区和后台写入线程
+ * @details 后台线程按固定间隔取出所有暂存区的记录，按时间排序后格式化，整批交给 sink。
+ *   线程退出后暂存区保留到被取空。
+ */
+class Logger {
+public:
+    static Logger& GetInstance() {
+        static Logger instance;
+        return instance;
+    }
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+    ~Logger() { Stop(); }
+
+    bool IsEnabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+    /** 当前保留的暂存区数量, 包括已退出但还没取空的线程 */
+    std::size_t GetRingCount() {
+        std::lock_guard lock(rings_mutex_);
+        return rings_.size();
+    }
+    std::shared_ptr<LogRing> Register() {
+        std::lock_guard lock(rings_mutex_);
+        auto ring = std::make_shared<LogRing>(++next_tid_);
+        rings_.push_back(ring);
+        return ring;
+    }
+    void Start(LogSink sink, LogFormat format, std::chrono::milliseconds interval) {
+        Stop();
+        {
+            std::lock_guard lock(flush_mutex_);
+            sink_ = std::move(sink);
+            format_ = format;
+            if (format_ == LogFormat::BINARY) {
+                std::uint32_t version = 1;
+                std::string header = "CXXUILOG";
+                header.append(reinterpret_cast<const char*>(&version), sizeof(version));
+                Emit(header);
+            }
+        }
+        stop_ = false;
+        thread_ = std::thread([this, interval] {
+            std::unique_lock lock(thread_mutex_);
+            while (!stop_) {
+                cv_.wait_for(lock, interval, [this] { return stop_; });
+                lock.unlock();
+                Flush();
+                lock.lock();
+            }
+        });
+        enabled_.store(true, std::memory_order_relaxed);
+    }
+    void Stop() {
+        enabled_.store(false, std::memory_order_relaxed);
+        if (thread_.joinable()) {
+            {
+                std::lock_guard lock(thread_mutex_);
+                stop_ = true;
+            }
+            cv_.notify_one();
+            thread_.join();
+        }
+        Flush();
+        std::lock_guard lock(flush_mutex_);
+        sink_ = nullptr;
+    }
+    /** 立即取出并写入所有记录 */
+    void Flush() {
+        std::lock_guard lock(flush_mutex_);
+        if (!sink_) {
+            return;
+        }
+        {
+            std::vector<std::shared_ptr<LogRing>> rings;
+            {
+                std::lock_guard rings_lock(rings_mutex_);
+                rings = rings_;
+            }
+            for (const auto& ring : rings) {
+                ring->Drain([this, &ring](const LogRecord& record) {
+                    batch_.emplace_back(ring->GetTid(), record);
+                });
+                if (auto dropped = ring->TakeDropped(); dropped) {
+                    LogRecord record{};
+                    record.time = batch_.empty() ? Now() : batch_.back().second.time;
+                    record.message = "log records dropped";
+                    record.code = static_cast<std::int64_t>(dropped);
+                    record.level = LogLevel::WARN;
+                    batch_.emplace_back(ring->GetTid(), record);
+                }
+            }
+        }
+        // 先释放上面的副本, 否则引用计数不会降到 1
+        RemoveExited();
+        if (batch_.empty()) {
+            return;
+        }
+        std::stable_sort(batch_.begin(), batch_.end(), [](const auto& a, const auto& b) {
+            return a.second.time < b.second.time;
+        });
+        buffer_.clear();
+        for (const auto& [tid, record] : batch_) {
+            if (format_ == LogFormat::BINARY) {
+                AppendBinary(tid, record);
+            } else {
+                AppendText(tid, record);
+            }
+        }
+        batch_.clear();
+        Emit(buffer_);
+    }
+    static std::uint64_t Now() noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              std::chrono::system_clock::now().time_since_epoch())
+                                              .count());
+    }
+
+private:
+    Logger() = default;
+
+    std::atomic<bool> enabled_{false};
+    /** 保护 rings_ */
+    std::mutex rings_mutex_;
+    std::vector<std::shared_ptr<LogRing>> rings_;
+    std::uint32_t next_tid_ = 0;
+    /** 保证同一时间只有一个消费者, 保护以下成员 */
+    std::mutex flush_mutex_;
+    LogSink sink_;
+    LogFormat format_ = LogFormat::TEXT;
+    std::vector<std::pair<std::uint32_t, LogRecord>> batch_;
+    std::string buffer_;
+    /** 文本格式缓存的日期和时间 */
+    std::uint64_t text_second_ = 0;
+    std::string text_prefix_;
+    /** 后台线程 */
+    std::mutex thread_mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::thread thread_;
+
+    /** 移除所属线程已退出且已取空的暂存区 */
+    void RemoveExited() {
+        std::lock_guard lock(rings_mutex_);
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                    [](const std::shared_ptr<LogRing>& ring) {
+                                        return ring.use_count() == 1 && ring->IsEmpty();
+                                    }),
+                     rings_.end());
+    }
+    void Emit(std::string_view data) noexcept {
+        try {
+            sink_(data);
+        } catch (...) {
+            // 写日志失败时没有其他地方可以报告
+        }
+    }
+    template <typename T>
+    void AppendRaw(T value) {
+        buffer_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    void AppendBinary(std::uint32_t tid, const LogRecord& record) {
+        std::string_view message = record.message ? record.message : "";
+        message = message.substr(0, 0xFFFF);
+        AppendRaw(record.time);
+        AppendRaw(record.code);
+        AppendRaw(tid);
+        AppendRaw(static_cast<std::uint8_t>(record.level));
+        AppendRaw(static_cast<std::uint16_t>(message.size()));
+        buffer_.append(message);
+        AppendRaw(record.detail_size);
+        buffer_.append(record.detail, record.detail_size);
+    }
+    void AppendText(std::uint32_t tid, const LogRecord& record) {
+        static constexpr char kLevels[] = {'D', 'I', 'W', 'E'};
+        // 同一秒内的记录复用日期和时间部分
+        std::uint64_t second = record.time / 1000000000;
+        if (second != text_second_ || text_prefix_.empty()) {
+            auto seconds = static_cast<std::time_t>(second);
+            std::tm tm{};
+#ifdef _WIN32
+            gmtime_s(&tm, &seconds);
+#else
+            gmtime_r(&seconds, &tm);
+#endif
+            char prefix[32];
+            int size = std::snprintf(prefix, sizeof(prefix), "%04d-%02d-%02dT%02d:%02d:%02d.",
+                                     tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
+                                     tm.tm_min, tm.tm_sec);
+            text_prefix_.assign(prefix, static_cast<std::size_t>((std::max)(size, 0)));
+            text_second_ = second;
+        }
+        buffer_.append(text_prefix_);
+        AppendDigits(record.time % 1000000000 / 1000, 6);
+        buffer_.append("Z ").push_back(kLevels[static_cast<int>(record.level) & 3]);
+        buffer_.append(" t");
+        AppendDigits(tid, 0);
+        buffer_.push_back(' ');
+        buffer_.append(record.message ? record.message : "");
+        if (record.code) {
+            // 32 位以内的错误码一般为 HRESULT, 以十六进制显示
+            if (record.code >= (std::numeric_limits<std::int32_t>::min)() &&
+                record.code <= (std::numeric_limits<std::int32_t>::max)()) {
+                static constexpr char kHex[] = "0123456789ABCDEF";
+                auto code = static_cast<std::uint32_t>(record.code);
+                buffer_.append(" code=0x");
+                for (int shift = 28; shift >= 0; shift -= 4) {
+                    buffer_.push_back(kHex[(code >> shift) & 0xF]);
+                }
+            } else {
+                buffer_.append(" code=");
+                if (record.code < 0) {
+                    buffer_.push_back('-');
+                }
+                AppendDigits(record.code < 0 ? 0 - static_cast<std::uint64_t>(record.code)
+                                             : static_cast<std::uint64_t>(record.code),
+                             0);
+            }
+        }
+        if (record.detail_size) {
+            buffer_.push_back(' ');
+            buffer_.append(record.detail, record.detail_size);
+        }
+        buffer_.push_back('\n');
+    }
+    /** 追加十进制数字, 不足 width 位时补0 */
+    void AppendDigits(std::uint64_t value, int width) {
+        char digits[20];
+        int count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value);
+        for (int i = count; i < width; ++i) {
+            buffer_.push_back('0');
+        }
+        while (count) {
+            buffer_.push_back(digits[--count]);
+        }
+    }
+};
+
+inline LogRing& GetLogRing() {
+    thread_local std::shared_ptr<LogRing> ring = Logger::GetInstance().Register();
+    return *ring;
+}
+
+/** 记录日志, 未调用 StartLog 时直接返回 */
+inline void LogWrite(LogLevel level,
+                     const char* message,
+                     std::int64_t code = 0,
+                     std::string_view detail = {}) noexcept {
+    Logger& logger = Logger::GetInstance();
+    if (!logger.IsEnabled()) {
+        return;
+    }
+    LogRecord record;
+    record.time = Logger::Now();
+    record.message = message;
+    record.code = code;
+    record.level = level;
+    record.detail_size =
+        static_cast<std::uint8_t>((std::min)(detail.size(), LogRecord::kDetailSize));
+    if (record.detail_size) {
+        std::memcpy(record.detail, detail.data(), record.detail_size);
+    }
+    try {
+        GetLogRing().Push(record);
+    } catch (...) {
+        // 创建暂存区失败时丢弃
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief 开始记录库内部的日志, 已开始时替换原来的输出
+ *
+ * @param sink 接收格式化后的日志, 在后台线程调用
+ * @param format 输出格式
+ * @param interval 后台线程写入的间隔
+ */
+inline void StartLog(LogSink sink,
+                     LogFormat format = LogFormat::TEXT,
+                     std::chrono::milliseconds interval = std::chrono::milliseconds{100}) {
+    detail::Logger::GetInstance().Start(std::move(sink), format, interval);
+}
+/**
+ * @brief 开始记录库内部的日志到文件, 追加到文件末尾
+ *
+ * @param path 文件路径
+ * @param format 输出格式
+ * @return true 成功
+ */
+inline bool StartLog(const std::filesystem::path& path, LogFormat format = LogFormat::TEXT) {
+    auto file = std::make_shared<std::ofstream>(path, std::ios::binary | std::ios::app);
+    if (!*file) {
+        return false;
+    }
+    StartLog(
+        [file](std::string_view data) {
+            file->write(data.data(), static_cast<std::streamsize>(data.size()));
+            file->flush();
+        },
+        format);
+    return true;
+}
+/**
+ * @brief 立即写入所有线程暂存的日志
+ */
+inline void FlushLog() { detail::Logger::GetInstance().Flush(); }
+/**
+ * @brief 停止记录日志, 写入剩余的日志后返回
+ */
+inline void StopLog() { detail::Logger::GetInstance().Stop(); }
+
+}  // namespace cxxui
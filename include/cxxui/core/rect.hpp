@@ -12,4 +12,14 @@ struct Size {
     int height = 0;
 };
 
+struct Rect {
+    int left = 0;
+    int top = 0;
+    int right = 0;
+    int bottom = 0;
+    int Width() const noexcept { return right - left; }
+    int Height() const noexcept { return bottom - top; }
+    bool IsEmpty() const noexcept { return right <= left || bottom <= top; }
+};
+
 }  // namespace cxxui
\ No newline at end of file
@@ -0,0 +1,251 @@
+#pragma once
+
+/** 编译器是否支持 C++20 协程 */
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+    #define CXXUI_HAS_COROUTINE 1
+#else
+    #define CXXUI_HAS_COROUTINE 0
+#endif
+
+#if CXXUI_HAS_COROUTINE
+    #include <coroutine>
+    #include <exception>
+    #include <optional>
+    #include <stdexcept>
+    #include <type_traits>
+    #include <utility>
+
+    #include "log.hpp"
+    #include "detail/ui_queue.hpp"
+
+namespace cxxui {
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+class TaskPromiseBase {
+    template <typename T>
+    friend class cxxui::Task;
+
+public:
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            TaskPromiseBase& promise = handle.promise();
+            if (promise.detached_) {
+                // 没有等待者接收异常, 销毁前记录下来
+                if (promise.error_) {
+                    LogError(promise.error_);
+                }
+                handle.destroy();
+                return std::noop_coroutine();
+            }
+            return promise.continuation_ ? promise.continuation_ : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() noexcept { error_ = std::current_exception(); }
+
+    /**
+     * @brief 销毁挂起的协程所在的整条调用链
+     * @details 从 handle 沿着等待它的 Task 找到最外层的协程，分离运行的最外层协程连同
+     *   它等待的 Task 一起销毁。最外层不是 Task 时由它的所有者负责销毁，这里不处理。
+     */
+    static void DestroyChain(std::coroutine_handle<> handle, TaskPromiseBase* promise) noexcept {
+        while (promise->parent_) {
+            handle = promise->continuation_;
+            promise = promise->parent_;
+        }
+        if (promise->detached_) {
+            handle.destroy();
+        }
+    }
+
+protected:
+    static void LogError(const std::exception_ptr& error) noexcept {
+        try {
+            std::rethrow_exception(error);
+        } catch (const std::exception& e) {
+            CXXUI_LOG_ERROR("Detached task failed", 0, e.what());
+        } catch (...) {
+            CXXUI_LOG_ERROR("Detached task failed");
+        }
+    }
+
+    std::coroutine_handle<> continuation_;
+    /** 等待本任务的协程也是 Task 时的 promise */
+    TaskPromiseBase* parent_ = nullptr;
+    std::exception_ptr error_;
+    /** 分离运行的协程结束时自行销毁 */
+    bool detached_ = false;
+    void Rethrow() const {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+};
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase {
+public:
+    Task<T> get_return_object() noexcept;
+    template <typename U>
+    void return_value(U&& value) {
+        value_.emplace(std::forward<U>(value));
+    }
+    T Result() {
+        Rethrow();
+        return std::move(*value_);
+    }
+
+private:
+    std::optional<T> value_;
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+    Task<void> get_return_object() noexcept;
+    void return_void() noexcept {}
+    void Result() { Rethrow(); }
+};
+
+/**
+ * @brief 在UI线程的消息循环中恢复协程的任务节点
+ * @details 队列关闭时不再恢复，通过 SetHandle 挂起的 Task 连同等待它的整条调用链一起销毁
+ */
+struct ResumeTask : UiTask {
+    ResumeTask() {
+        run = [](UiTask* task) { static_cast<ResumeTask*>(task)->handle.resume(); };
+        drop = [](UiTask* task) {
+            // 销毁协程帧可能同时销毁本节点, 之后不再访问它
+            auto* self = static_cast<ResumeTask*>(task);
+            if (self->promise) {
+                TaskPromiseBase::DestroyChain(self->handle, self->promise);
+            }
+        };
+    }
+    /** 设置挂起的协程, 是 Task 时记录它的 promise */
+    template <typename Promise>
+    void SetHandle(std::coroutine_handle<Promise> h) noexcept {
+        handle = h;
+        if constexpr (std::is_base_of_v<TaskPromiseBase, Promise>) {
+            promise = &h.promise();
+        } else {
+            promise = nullptr;
+        }
+    }
+    std::coroutine_handle<> handle;
+    TaskPromiseBase* promise = nullptr;
+};
+
+/** Yield 的等待节点 */
+struct YieldAwaiter : ResumeTask {
+    bool await_ready() const noexcept { return false; }
+    template <typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> h) {
+        SetHandle(h);
+        // 队列已关闭时协程在这里被销毁, 之后不能再访问自身
+        GetUiQueue().Post(*this);
+    }
+    void await_resume() const noexcept {}
+};
+
+}  // namespace detail
+
+/**
+ * @brief 惰性启动的协程任务
+ * @details co_await 时才开始执行，执行完成后通过对称转移恢复等待者，不经过消息循环。
+ * 通过 Spawn 分离运行的任务在结束时自行销毁，未捕获的异常记录到日志。
+ */
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    Task() = default;
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+        : handle_(handle) {}
+    Task(Task&& other) noexcept
+        : handle_(std::exchange(other.handle_, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+    bool IsValid() const noexcept { return static_cast<bool>(handle_); }
+    /** 空的 Task 不挂起, 在 await_resume 中抛出 std::logic_error */
+    bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> continuation) noexcept {
+        auto& promise = handle_.promise();
+        promise.continuation_ = continuation;
+        if constexpr (std::is_base_of_v<detail::TaskPromiseBase, Promise>) {
+            promise.parent_ = &continuation.promise();
+        }
+        return handle_;
+    }
+    T await_resume() {
+        if (!handle_) {
+            throw std::logic_error("co_await an empty Task!");
+        }
+        return handle_.promise().Result();
+    }
+    /** 分离运行, 任务结束后自行销毁, 异常被忽略 */
+    void Detach() && {
+        if (auto handle = std::exchange(handle_, {}); handle) {
+            handle.promise().detached_ = true;
+            handle.resume();
+        }
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+}
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+}
+}  // namespace detail
+
+/**
+ * @brief 分离运行协程任务
+ * @details 任务中未捕获的异常没有等待者接收，记录为错误日志后丢弃
+ *
+ * @param task 要运行的任务, 立即开始执行直到第一个挂起点
+ */
+template <typename T>
+void Spawn(Task<T> task) {
+    std::move(task).Detach();
+}
+
+/**
+ * @brief 让出UI线程, 在消息循环处理完当前消息后恢复
+ */
+inline detail::YieldAwaiter Yield() noexcept {
+    return {};
+}
+
+}  // namespace cxxui
+#endif
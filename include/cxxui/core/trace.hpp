@@ -0,0 +1,299 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+/**
+ * 定义 CXXUI_ENABLE_TRACE 开启启动和生命周期的追踪，未定义时所有追踪宏展开为空。
+ * 事件名和分类必须是字符串字面量，记录时只保存指针。
+ */
+#ifdef CXXUI_ENABLE_TRACE
+    #define CXXUI_TRACE_CONCAT_IMPL(a, b) a##b
+    #define CXXUI_TRACE_CONCAT(a, b) CXXUI_TRACE_CONCAT_IMPL(a, b)
+    /** 记录当前作用域的耗时 */
+    #define CXXUI_TRACE_SCOPE(name) \
+        ::cxxui::detail::TraceScope CXXUI_TRACE_CONCAT(cxxui_trace_scope_, __LINE__) { name }
+    /** 记录一个时间点 */
+    #define CXXUI_TRACE_INSTANT(name) ::cxxui::detail::TraceRecord('i', name)
+    /** 只在进程内第一次执行时记录时间点 */
+    #define CXXUI_TRACE_INSTANT_ONCE(name)                          \
+        do {                                                        \
+            static std::atomic<bool> cxxui_trace_once_{false};      \
+            if (!cxxui_trace_once_.exchange(true)) {                \
+                ::cxxui::detail::TraceRecord('i', name);            \
+            }                                                       \
+        } while (0)
+    /** 记录跨回调的异步区间的开始和结束, id 用于配对 */
+    #define CXXUI_TRACE_ASYNC_BEGIN(name, id) ::cxxui::detail::TraceRecord('b', name, id)
+    #define CXXUI_TRACE_ASYNC_END(name, id) ::cxxui::detail::TraceRecord('e', name, id)
+#else
+    #define CXXUI_TRACE_SCOPE(name) ((void)0)
+    #define CXXUI_TRACE_INSTANT(name) ((void)0)
+    #define CXXUI_TRACE_INSTANT_ONCE(name) ((void)0)
+    #define CXXUI_TRACE_ASYNC_BEGIN(name, id) ((void)0)
+    #define CXXUI_TRACE_ASYNC_END(name, id) ((void)0)
+#endif
+
+namespace cxxui {
+
+namespace detail {
+
+using TraceClock = std::chrono::steady_clock;
+
+/** 追踪事件 */
+struct TraceEvent {
+    const char* name;
+    /** Chrome trace 的事件类型: X 区间, i 时间点, b/e 异步区间 */
+    char phase;
+    /** 相对追踪起点的微秒数 */
+    std::uint64_t ts;
+    /** 区间的持续微秒数 */
+    std::uint64_t dur;
+    /** 异步区间的配对 id */
+    std::uint64_t id;
+};
+
+/**
+ * @brief 单个线程的环形缓冲区, 写满后覆盖最旧的事件
+ * @details 只由所属线程写入，其他线程可以随时导出。每个槽位带有序号，
+ *   导出时跳过正在被覆盖的槽位，不会读到新旧混合的事件。
+ */
+class TraceRing {
+public:
+    static constexpr std::size_t kCapacity = 4096;
+
+    explicit TraceRing(std::uint32_t tid) noexcept
+        : tid_(tid) {}
+    std::uint32_t GetTid() const noexcept { return tid_; }
+    void Push(const TraceEvent& event) noexcept {
+        std::uint64_t head = head_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[head & (kCapacity - 1)];
+        // 序号为 0 表示正在写入
+        slot.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(event.name, std::memory_order_relaxed);
+        slot.phase.store(event.phase, std::memory_order_relaxed);
+        slot.ts.store(event.ts, std::memory_order_relaxed);
+        slot.dur.store(event.dur, std::memory_order_relaxed);
+        slot.id.store(event.id, std::memory_order_relaxed);
+        slot.seq.store(head + 1, std::memory_order_release);
+        head_.store(head + 1, std::memory_order_release);
+    }
+    /** 按时间顺序复制缓冲区中的事件, 跳过复制期间被覆盖的事件 */
+    std::vector<TraceEvent> Snapshot() const {
+        std::uint64_t head = head_.load(std::memory_order_acquire);
+        std::uint64_t begin = head > kCapacity ? head - kCapacity : 0;
+        std::vector<TraceEvent> events;
+        events.reserve(static_cast<std::size_t>(head - begin));
+        for (std::uint64_t i = begin; i < head; ++i) {
+            const Slot& slot = slots_[i & (kCapacity - 1)];
+            if (slot.seq.load(std::memory_order_acquire) != i + 1) {
+                continue;
+            }
+            TraceEvent event{slot.name.load(std::memory_order_relaxed),
+                             slot.phase.load(std::memory_order_relaxed),
+                             slot.ts.load(std::memory_order_relaxed),
+                             slot.dur.load(std::memory_order_relaxed),
+                             slot.id.load(std::memory_order_relaxed)};
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != i + 1) {
+                continue;
+            }
+            events.push_back(event);
+        }
+        return events;
+    }
+    /** 丢弃的事件数量 */
+    std::uint64_t GetDropped() const noexcept {
+        std::uint64_t head = head_.load(std::memory_order_acquire);
+        return head > kCapacity ? head - kCapacity : 0;
+    }
+
+private:
+    /** 事件的各个字段分别原子读写, 由序号判断是否完整 */
+    struct Slot {
+        std::atomic<std::uint64_t> seq{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<char> phase{0};
+        std::atomic<std::uint64_t> ts{0};
+        std::atomic<std::uint64_t> dur{0};
+        std::atomic<std::uint64_t> id{0};
+    };
+    std::uint32_t tid_;
+    std::atomic<std::uint64_t> head_{0};
+    std::array<Slot, kCapacity> slots_{};
+};
+
+/**
+ * @brief 记录所有线程的环形缓冲区
+ * @details 线程退出后缓冲区保留到下一次导出，最多保留 kMaxExited 个，超出时释放最早退出的
+ */
+class TraceRegistry {
+public:
+    static constexpr std::size_t kMaxExited = 64;
+
+    static TraceRegistry& GetInstance() {
+        static TraceRegistry instance;
+        return instance;
+    }
+    TraceClock::time_point GetEpoch() const noexcept { return epoch_; }
+    std::shared_ptr<TraceRing> Register() {
+        std::lock_guard lock(mutex_);
+        auto ring = std::make_shared<TraceRing>(++last_tid_);
+        rings_.push_back(ring);
+        return ring;
+    }
+    /** 线程退出时调用 */
+    void Unregister(const std::shared_ptr<TraceRing>& ring) {
+        std::lock_guard lock(mutex_);
+        exited_.push_back(ring);
+        if (exited_.size() > kMaxExited) {
+            Remove(exited_.front());
+            exited_.erase(exited_.begin());
+        }
+    }
+    /** 导出后释放已退出线程的缓冲区 */
+    void ReleaseExited() {
+        std::lock_guard lock(mutex_);
+        for (const auto& ring : exited_) {
+            Remove(ring);
+        }
+        exited_.clear();
+    }
+    std::vector<std::shared_ptr<TraceRing>> GetRings() const {
+        std::lock_guard lock(mutex_);
+        return rings_;
+    }
+
+private:
+    TraceClock::time_point epoch_ = TraceClock::now();
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<TraceRing>> rings_;
+    std::vector<std::shared_ptr<TraceRing>> exited_;
+    std::uint32_t last_tid_ = 0;
+
+    void Remove(const std::shared_ptr<TraceRing>& ring) {
+        rings_.erase(std::remove(rings_.begin(), rings_.end(), ring), rings_.end());
+    }
+};
+
+/** 线程的缓冲区, 线程退出时通知 TraceRegistry */
+struct TraceThread {
+    std::shared_ptr<TraceRing> ring = TraceRegistry::GetInstance().Register();
+    TraceThread() = default;
+    TraceThread(const TraceThread&) = delete;
+    TraceThread& operator=(const TraceThread&) = delete;
+    ~TraceThread() { TraceRegistry::GetInstance().Unregister(ring); }
+};
+
+inline TraceRing& GetTraceRing() {
+    thread_local TraceThread thread;
+    return *thread.ring;
+}
+
+inline std::uint64_t TraceNow() noexcept {
+    static const TraceClock::time_point epoch = TraceRegistry::GetInstance().GetEpoch();
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(TraceClock::now() - epoch).count());
+}
+
+inline void TraceRecord(char phase, const char* name, std::uint64_t id = 0) noexcept {
+    GetTraceRing().Push(TraceEvent{name, phase, TraceNow(), 0, id});
+}
+
+/** 作用域结束时记录一个区间事件 */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) noexcept
+        : name_(name),
+          start_(TraceNow()) {}
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+    ~TraceScope() {
+        GetTraceRing().Push(TraceEvent{name_, 'X', start_, TraceNow() - start_, 0});
+    }
+
+private:
+    const char* name_;
+    std::uint64_t start_;
+};
+
+/** 写入 json 字符串, 转义引号、反斜杠和控制字符 */
+inline void WriteTraceString(std::ostream& out, const char* str) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    out << '"';
+    for (const char* p = str; *p; ++p) {
+        auto ch = static_cast<unsigned char>(*p);
+        if (ch == '"' || ch == '\\') {
+            out << '\\' << *p;
+        } else if (ch < 0x20) {
+            out << "\\u00" << kHex[ch >> 4] << kHex[ch & 0xF];
+        } else {
+            out << *p;
+        }
+    }
+    out << '"';
+}
+
+/** 以 Chrome trace-event JSON 格式写入 rings 中的事件 */
+inline void WriteTraceEvents(std::ostream& out,
+                             const std::vector<std::shared_ptr<TraceRing>>& rings) {
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& ring : rings) {
+        for (const auto& event : ring->Snapshot()) {
+            out << (first ? "\n" : ",\n") << "{\"name\":";
+            first = false;
+            WriteTraceString(out, event.name ? event.name : "");
+            out << ",\"cat\":\"cxxui\",\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":"
+                << ring->GetTid() << ",\"ts\":" << event.ts;
+            if (event.phase == 'X') {
+                out << ",\"dur\":" << event.dur;
+            } else if (event.phase == 'i') {
+                out << ",\"s\":\"t\"";
+            } else {
+                out << ",\"id\":" << event.id;
+            }
+            out << '}';
+        }
+    }
+    out << "\n]}\n";
+}
+
+}  // namespace detail
+
+/**
+ * @brief 以 Chrome trace-event JSON 格式导出所有线程记录的事件, 可用 Perfetto 或 chrome://tracing 查看
+ * @details 导出后释放已退出线程的缓冲区
+ *
+ * @param out 输出流
+ */
+inline void WriteTrace(std::ostream& out) {
+    auto& registry = detail::TraceRegistry::GetInstance();
+    detail::WriteTraceEvents(out, registry.GetRings());
+    registry.ReleaseExited();
+}
+/**
+ * @brief 导出追踪事件到文件
+ *
+ * @param path 文件路径
+ * @return true 成功
+ */
+inline bool SaveTrace(const std::filesystem::path& path) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    WriteTrace(file);
+    return static_cast<bool>(file);
+}
+
+}  // namespace cxxui
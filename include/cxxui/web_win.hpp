@@ -4,6 +4,13 @@
 
 namespace cxxui {
 
+/** 已注册的javascript函数的编号 */
+using JsFunctionId = detail::JsFunctionId;
+/** 窗口不可见或不活动时节省资源的策略配置 */
+using VisibilityOptions = detail::VisibilityOptions;
+/** 策略当前要求的资源状态 */
+using VisibilityState = detail::VisibilityState;
+
 template <typename Derived = detail::DefaultWebWindow>
 class WebWindow : public detail::WebWindowBase<Derived> {
     using Base = detail::WebWindowBase<Derived>;
@@ -31,12 +38,14 @@ public:
     void WaitWebCreated() const { Base::WaitWebCreated(); }
     /**
      * @brief 设置html内容
+     * @details 先在当前页面提交累积的脚本，窗口暂停期间也一样
      *
      * @param html html内容
      */
     void SetHtml(std::string_view html) { Base::SetHtml(html); }
     /**
      * @brief 设置要访问的url
+     * @details 先在当前页面提交累积的脚本，窗口暂停期间也一样
      *
      * @param url 要访问的url
      */
@@ -56,19 +65,90 @@ public:
      */
     using JsMsgHandler = std::function<std::string(std::string)>;
     void SetJsMsgHandler(JsMsgHandler handler) { Base::SetJsMsgHandler(std::move(handler)); }
+    /**
+     * @brief 设置异步接收javascript消息的处理函数
+     *
+     * @param handler 接收js发送的字符串消息，处理完成后调用 reply 返回字符串消息给js，
+     *                reply 可以在处理函数返回后在UI线程调用，比如 JsMsgMap::GetAsyncHandler
+     */
+    using AsyncJsMsgHandler = std::function<void(std::string, std::function<void(std::string)>)>;
+    void SetJsMsgHandler(AsyncJsMsgHandler handler) { Base::SetJsMsgHandler(std::move(handler)); }
     /**
      * @brief 发送消息给 javascript
+     * @details 先提交之前累积的脚本，保持先后顺序。窗口暂停期间不提交，消息与之前的脚本一起排队，
+     *   恢复后按顺序提交
      */
     void SendJsMsg(std::string_view msg) { Base::SendJsMsg(msg); }
     /**
      * @brief 运行javascript代码
+     * @details 立即运行的脚本推迟到本帧结束时按顺序提交，SendJsMsg、EvalJs 和页面跳转前会先提交
+     *   (窗口暂停期间 SendJsMsg 改为排队)。每段脚本仍然原样单独调用一次 ExecuteScript，
+     *   不会与其他脚本合并；需要减少 ExecuteScript 次数时用 RegisterJs 和 CallJs
      *
      * @param js_code javascript代码
-     * @param on_created 是否在webview创建完成后运行, false则立即运行
+     * @param on_created 是否在每个页面创建时运行, false则立即运行
      */
     void RunJs(std::string_view js_code, bool on_created = false) {
         Base::RunJs(js_code, on_created);
     }
+    /**
+     * @brief 注册javascript函数, 函数定义只传给webview一次, 之后的页面也会自动定义
+     *
+     * @param name 函数名, 用于 CallJs 按名字调用
+     * @param function javascript函数表达式, 如 "(a, b) => { ... }"
+     * @return JsFunctionId 函数编号, 按编号调用可以省去名字查找
+     */
+    JsFunctionId RegisterJs(std::string_view name, std::string_view function) {
+        return Base::RegisterJs(name, function);
+    }
+    /**
+     * @brief 调用已注册的javascript函数, 在本帧结束时提交, 连续的调用合并成一次 ExecuteScript
+     *
+     * @param id RegisterJs 返回的函数编号
+     * @param args 参数列表的javascript源码, 如 R"(1, "text")"
+     */
+    void CallJs(JsFunctionId id, std::string_view args = {}) { Base::CallJs(id, args); }
+    void CallJs(std::string_view name, std::string_view args = {}) { Base::CallJs(name, args); }
+    /**
+     * @brief 立即提交本帧累积的脚本和暂停期间排队的消息, 窗口暂停期间也立即提交
+     */
+    void FlushJs() { Base::FlushJs(); }
+    /**
+     * @brief 添加在每一帧结束、提交脚本之前调用的函数
+     * @details 在其中调用 RunJs 的脚本会排在本帧的其他脚本之后、在同一时机提交，比如 Store 的补丁
+     */
+    void AddFrameHook(std::function<void()> hook) { Base::AddFrameHook(std::move(hook)); }
+    /**
+     * @brief 设置窗口不可见或不活动时节省资源的策略
+     * @details 默认启用：隐藏或最小化时暂停脚本提交和 Store 同步，立即降低 webview 内存目标，
+     *   30秒后尝试挂起渲染进程；重新可见时恢复并提交暂停期间累积的脚本。
+     *   累积的脚本和排队的消息超过 paused_script_limit 时全部丢弃，恢复时触发 OnJsDropped。
+     *   EvalJs、SetHtml 和 SetUrl 在暂停期间也会先提交累积的脚本，保证脚本在当前页面中按顺序执行。
+     *   系统内存不足时所有非前台窗口降低内存目标，并释放预创建的 webview
+     */
+    void SetVisibilityOptions(const VisibilityOptions& options) {
+        Base::SetVisibilityOptions(options);
+    }
+    VisibilityOptions GetVisibilityOptions() const { return Base::GetVisibilityOptions(); }
+    /**
+     * @brief 获取策略当前要求的资源状态
+     */
+    VisibilityState GetVisibilityState() const { return Base::GetVisibilityState(); }
+#if CXXUI_HAS_COROUTINE
+    /**
+     * @brief 等待webview创建完成的协程版本，在消息循环中恢复，不会嵌套消息循环
+     * @details 用法：co_await win.WebCreated(); 创建失败时抛出 WindowError
+     */
+    auto WebCreated() { return Base::WebCreated(); }
+    /**
+     * @brief 运行javascript代码并等待执行结果
+     * @details 用法：std::string result = co_await win.EvalJs("1 + 1");
+     *
+     * @param js_code javascript代码
+     * @return 执行结果的json字符串，执行失败时抛出 WindowError
+     */
+    auto EvalJs(std::string_view js_code) { return Base::EvalJs(js_code); }
+#endif
     /**
      * @brief 使窗口获得焦点
      */
@@ -91,8 +171,28 @@ protected:
      * @brief webview完成创建的事件
      */
     void OnWebCreated(std::optional<WindowError>) {}
+    /**
+     * @brief 暂停期间累积的脚本和消息超过上限被丢弃后, 恢复提交时的事件
+     * @details 已注册的函数会自动重新定义，页面的其他状态需要在这里重新同步，如 Store::Resync。
+     *   参数为丢弃的脚本和消息数量
+     */
+    void OnJsDropped(std::size_t) {}
 };
 
+/** 预创建webview池的统计数据 */
+using WebPoolStats = detail::WarmPoolStats;
+/**
+ * @brief 在当前UI线程预创建webview, 之后创建的WebWindow直接取用, 省去env和控件的创建等待
+ * @details 应在创建窗口之前尽早调用, 会立即开始异步创建env。池被取用后在空闲时补充。
+ *
+ * @param count 预创建的数量, 0 表示停止补充
+ */
+inline void PrewarmWeb(std::size_t count = 1) { detail::WebFactory::GetInstance().Prewarm(count); }
+/**
+ * @brief 获取当前UI线程预创建池的统计数据
+ */
+inline WebPoolStats GetWebPoolStats() { return detail::WebFactory::GetInstance().GetPoolStats(); }
+
 namespace detail {
 class DefaultWebWindow : public WebWindow<DefaultWebWindow> {};
 }  // namespace detail
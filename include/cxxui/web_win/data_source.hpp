@@ -0,0 +1,290 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cxxui/win/idle.hpp>
+#include <cxxui/core/log.hpp>
+#include <cxxui/core/detail/page_cache.hpp>
+#include "js_msg_map.hpp"
+
+namespace cxxui {
+
+/**
+ * @brief 数据源的查询窗口
+ */
+struct DataQuery {
+    /** 第一行的位置 */
+    std::size_t offset = 0;
+    /** 行数 */
+    std::size_t count = 0;
+    /** 排序条件, 格式由加载函数约定, 空表示原始顺序 */
+    std::string sort;
+    /** 过滤条件, 格式由加载函数约定, 空表示不过滤 */
+    std::string filter;
+};
+
+/** 数据源分页缓存的统计数据 */
+using DataSourceStats = detail::PageCacheStats;
+
+/**
+ * @brief 供 javascript 按需拉取的大表格数据源
+ * @details js 按窗口(offset, count, sort, filter)查询，C++ 按页加载并缓存，容量有限。
+ *   每次查询后在空闲时预取滚动方向上的相邻页。数据变化时调用 Notify* 只失效受影响的页，
+ *   并通知 js 重新查询。只能在UI线程使用。
+ *
+ *   请求：{ "url": "/rows", "data": { "offset": 0, "count": 50, "sort": "", "filter": "" } }，
+ *   offset 和 count 必须是非负整数，count 最多为 最多缓存的页数 * 每页的行数，否则截断
+ *   响应 data：{ "offset": 0, "total": 1000000, "rows": [...] }
+ *   变化通知：{ "url": "/rows", "event": "changed", "offset": 10, "count": 1 }，
+ *   event 为 changed、inserted、removed 或 reset
+ */
+class DataSource {
+public:
+    using Rows = std::vector<json>;
+    /** 加载行的函数, 返回 [offset, offset + count) 的行, 末尾不足时返回实际的行 */
+    using Loader = std::function<Rows(const DataQuery&)>;
+    /** 获取总行数的函数, 只使用 sort 和 filter */
+    using Counter = std::function<std::size_t(const DataQuery&)>;
+
+    /**
+     * @brief 创建数据源
+     *
+     * @param loader 加载函数, 每次加载一整页
+     * @param counter 总行数函数
+     * @param page_size 每页的行数
+     * @param max_pages 最多缓存的页数
+     */
+    DataSource(Loader loader,
+               Counter counter,
+               std::size_t page_size = 100,
+               std::size_t max_pages = 64)
+        : state_(std::make_shared<State>(std::move(loader), std::move(counter), page_size,
+                                         max_pages)) {}
+    /**
+     * @brief 设置预取的页数
+     *
+     * @param ahead 滚动方向上预取的页数, 0 表示不预取
+     * @param behind 反方向预取的页数
+     */
+    void SetPrefetch(std::size_t ahead, std::size_t behind = 1) {
+        state_->planner.SetAhead(ahead);
+        state_->planner.SetBehind(behind);
+    }
+    /** 设置最多缓存的页数 */
+    void SetMaxPages(std::size_t max_pages) { state_->cache.SetMaxPages(max_pages); }
+    /**
+     * @brief 设置发送变化通知的函数, 一般为 WebWindow::SendJsMsg
+     */
+    void SetNotifier(std::function<void(std::string)> notifier) {
+        state_->notifier = std::move(notifier);
+    }
+    /**
+     * @brief 绑定到 JsMsgMap 的 url
+     */
+    template <typename Derived>
+    void Bind(JsMsgMap<Derived>& map, std::string url) {
+        state_->url = url;
+        map.bind(std::move(url), [state = state_](json& data) -> JsMsgResult {
+            auto query = ParseQuery(data, state->cache);
+            if (!query) {
+                return Unexpected{std::move(query).GetError()};
+            }
+            return state->Query(state, *query);
+        });
+    }
+    /**
+     * @brief 处理查询请求
+     * @details count 最多为 最多缓存的页数 * 每页的行数，超出时截断
+     *
+     * @param req 请求数据 { offset, count, sort, filter }
+     * @return json 响应数据 { offset, total, rows }
+     * @throw std::invalid_argument offset 或 count 不是非负整数, sort 或 filter 不是字符串
+     */
+    json Query(const json& req) {
+        auto query = ParseQuery(req, state_->cache);
+        if (!query) {
+            throw std::invalid_argument(std::move(query).GetError().error);
+        }
+        return state_->Query(state_, *query);
+    }
+    /** 原始顺序中 [offset, offset + count) 的行内容变化 */
+    void NotifyChanged(std::size_t offset, std::size_t count) {
+        state_->cache.Invalidate(offset, count);
+        state_->Notify("changed", offset, count);
+    }
+    /** 在原始顺序的 offset 处插入了 count 行 */
+    void NotifyInserted(std::size_t offset, std::size_t count) {
+        state_->cache.InvalidateFrom(offset);
+        state_->Notify("inserted", offset, count);
+    }
+    /** 从原始顺序的 offset 处删除了 count 行 */
+    void NotifyRemoved(std::size_t offset, std::size_t count) {
+        state_->cache.InvalidateFrom(offset);
+        state_->Notify("removed", offset, count);
+    }
+    /** 所有数据都可能变化 */
+    void NotifyReset() {
+        state_->cache.Clear();
+        state_->Notify("reset", 0, 0);
+    }
+    DataSourceStats GetStats() const noexcept { return state_->cache.GetStats(); }
+
+private:
+    /** 空闲任务持有弱引用, 数据源销毁后不再执行预取 */
+    struct State {
+        using Cache = detail::PageCache<json>;
+
+        Loader loader;
+        Counter counter;
+        Cache cache;
+        detail::PrefetchPlanner planner;
+        std::string url;
+        std::function<void(std::string)> notifier;
+        /** 已安排预取的页, 避免重复安排 */
+        std::set<std::pair<Cache::ViewId, Cache::PageId>> scheduled;
+
+        State(Loader l, Counter c, std::size_t page_size, std::size_t max_pages)
+            : loader(std::move(l)), counter(std::move(c)), cache(page_size, max_pages) {}
+
+        json Query(const std::shared_ptr<State>& self, DataQuery& query) {
+            Cache::ViewId view = cache.GetView(query.sort, query.filter);
+            std::size_t total = GetTotal(view, query);
+            std::size_t begin = (std::min)(query.offset, total);
+            std::size_t end = begin + (std::min)(query.count, total - begin);
+            json rows = json::array();
+            if (begin < end) {
+                Cache::PageId first = cache.GetPage(begin);
+                Cache::PageId last = cache.GetPage(end - 1);
+                for (Cache::PageId page = first; page <= last; ++page) {
+                    const Rows& page_rows = LoadPage(view, page, query);
+                    std::size_t page_begin = std::size_t{page} * cache.GetPageSize();
+                    std::size_t from = (std::max)(begin, page_begin) - page_begin;
+                    std::size_t to = (std::min)(end - page_begin, page_rows.size());
+                    for (std::size_t i = from; i < to; ++i) {
+                        rows.push_back(page_rows[i]);
+                    }
+                }
+                std::size_t page_count = (total + cache.GetPageSize() - 1) / cache.GetPageSize();
+                Prefetch(self, view, first, last, page_count, query);
+            }
+            return {{"offset", begin}, {"total", total}, {"rows", std::move(rows)}};
+        }
+        std::size_t GetTotal(Cache::ViewId view, const DataQuery& query) {
+            if (auto total = cache.GetTotal(view); total) {
+                return *total;
+            }
+            std::size_t total = counter(query);
+            cache.SetTotal(view, total);
+            return total;
+        }
+        const Rows& LoadPage(Cache::ViewId view, Cache::PageId page, DataQuery query) {
+            if (const Rows* rows = cache.Find(view, page); rows) {
+                return *rows;
+            }
+            query.offset = std::size_t{page} * cache.GetPageSize();
+            query.count = cache.GetPageSize();
+            return cache.Put(view, page, loader(query));
+        }
+        void Prefetch(const std::shared_ptr<State>& self,
+                      Cache::ViewId view,
+                      Cache::PageId first,
+                      Cache::PageId last,
+                      std::size_t page_count,
+                      const DataQuery& query) {
+            for (Cache::PageId page : planner.Plan(view, first, last, page_count)) {
+                if (cache.Contains(view, page) || !scheduled.emplace(view, page).second) {
+                    continue;
+                }
+                std::weak_ptr<State> weak = self;
+                ScheduleIdle(
+                    [weak, view, page, generation = cache.GetGeneration(), query]() {
+                        auto state = weak.lock();
+                        if (!state) {
+                            return;
+                        }
+                        state->scheduled.erase({view, page});
+                        // 安排后数据已失效或页已被加载
+                        if (state->cache.GetGeneration() != generation ||
+                            state->cache.Contains(view, page)) {
+                            return;
+                        }
+                        DataQuery page_query = query;
+                        page_query.offset = std::size_t{page} * state->cache.GetPageSize();
+                        page_query.count = state->cache.GetPageSize();
+                        try {
+                            state->cache.Put(view, page, state->loader(page_query));
+                        } catch (const std::exception& e) {
+                            // 预取失败不影响之后的查询, 查询时会重新加载
+                            CXXUI_LOG_WARN("DataSource prefetch failed", page, e.what());
+                        } catch (...) {
+                            CXXUI_LOG_WARN("DataSource prefetch failed", page);
+                        }
+                    },
+                    IdlePriority::LOW);
+            }
+        }
+        void Notify(const char* event, std::size_t offset, std::size_t count) const {
+            if (notifier) {
+                json msg{{"url", url}, {"event", event}, {"offset", offset}, {"count", count}};
+                notifier(msg.dump());
+            }
+        }
+    };
+    std::shared_ptr<State> state_;
+
+    /** 解析 js 传入的查询, count 截断到缓存能容纳的行数 */
+    static Expected<DataQuery, JsMsgFailure> ParseQuery(const json& req,
+                                                        const State::Cache& cache) {
+        if (!req.is_null() && !req.is_object()) {
+            return FailJsMsg("query must be an object", JsMsgError::INVALID_REQ);
+        }
+        DataQuery query;
+        query.count = cache.GetPageSize();
+        if (!ReadIndex(req, "offset", query.offset) || !ReadIndex(req, "count", query.count)) {
+            return FailJsMsg("offset and count must be non-negative integers",
+                             JsMsgError::INVALID_REQ);
+        }
+        query.count = (std::min)(query.count, cache.GetMaxPages() * cache.GetPageSize());
+        if (!ReadString(req, "sort", query.sort) || !ReadString(req, "filter", query.filter)) {
+            return FailJsMsg("sort and filter must be strings", JsMsgError::INVALID_REQ);
+        }
+        return query;
+    }
+    /** 读取非负整数, 没有时保留 value, 类型不对时返回 false */
+    static bool ReadIndex(const json& req, const char* key, std::size_t& value) {
+        auto it = req.find(key);
+        if (it == req.end()) {
+            return true;
+        }
+        if (it->is_number_unsigned()) {
+            value = it->get<std::size_t>();
+        } else if (it->is_number_integer() && it->get<std::int64_t>() >= 0) {
+            value = static_cast<std::size_t>(it->get<std::int64_t>());
+        } else {
+            return false;
+        }
+        return true;
+    }
+    /** 读取字符串, 没有时保留 value, 类型不对时返回 false */
+    static bool ReadString(const json& req, const char* key, std::string& value) {
+        auto it = req.find(key);
+        if (it == req.end()) {
+            return true;
+        }
+        if (!it->is_string()) {
+            return false;
+        }
+        value = it->get<std::string>();
+        return true;
+    }
+};
+
+}  // namespace cxxui
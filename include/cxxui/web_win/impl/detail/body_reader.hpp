@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <cxxui/core/expected.hpp>
+
+namespace cxxui::detail {
+
+/**
+ * @brief 从字节流按固定大小分块读取
+ * @details 调用者处理完一块后再读取下一块，流的生产者由读取速度限流，内存占用只有一块的大小。
+ *   Stream 需要提供 Expected<std::size_t, long> Read(void* buffer, std::size_t size)，
+ *   返回实际读取的字节数，可以少于 size，返回 0 表示结束，失败时返回错误码。
+ *   缓冲区在第一次读取时分配，之后重复使用。不依赖平台。
+ */
+template <typename Stream>
+class ChunkReader {
+public:
+    static constexpr std::size_t kDefaultChunkSize = 64 * 1024;
+
+    explicit ChunkReader(Stream stream, std::size_t chunk_size = kDefaultChunkSize)
+        : stream_(std::move(stream)),
+          chunk_size_(chunk_size > 0 ? chunk_size : kDefaultChunkSize) {}
+
+    /**
+     * @brief 读取下一块
+     * @details 除最后一块外每块都是 chunk_size 字节，读完后返回空块。
+     *   返回的数据在下次调用前有效。失败后不再读取，之后每次都返回同一个错误码。
+     */
+    Expected<std::string_view, long> Next() {
+        if (error_) {
+            return Unexpected{*error_};
+        }
+        if (end_) {
+            return std::string_view{};
+        }
+        if (!buffer_) {
+            buffer_.reset(new char[chunk_size_]);
+        }
+        std::size_t size = 0;
+        while (size < chunk_size_) {
+            auto read = stream_.Read(buffer_.get() + size, chunk_size_ - size);
+            if (!read) {
+                error_ = read.GetError();
+                return Unexpected{*error_};
+            }
+            if (*read == 0) {
+                end_ = true;
+                break;
+            }
+            size += *read;
+        }
+        bytes_read_ += size;
+        return std::string_view{buffer_.get(), size};
+    }
+    /**
+     * @brief 依次用每一块调用 func, 直到读完
+     *
+     * @param func void(std::string_view) 或 bool(std::string_view)，返回 false 时停止读取
+     * @return 本次读取的字节数，失败时返回错误码
+     */
+    template <typename Func>
+    Expected<std::uint64_t, long> ForEach(Func&& func) {
+        std::uint64_t begin = bytes_read_;
+        while (true) {
+            auto chunk = Next();
+            if (!chunk) {
+                return Unexpected{chunk.GetError()};
+            }
+            if (chunk->empty()) {
+                break;
+            }
+            if constexpr (std::is_void_v<std::invoke_result_t<Func&, std::string_view>>) {
+                func(*chunk);
+            } else if (!func(*chunk)) {
+                break;
+            }
+        }
+        return bytes_read_ - begin;
+    }
+    /** 是否已读完, 读到最后一块时即为 true */
+    bool IsEnd() const noexcept { return end_; }
+    /** 已读取的字节数 */
+    std::uint64_t GetBytesRead() const noexcept { return bytes_read_; }
+    std::size_t GetChunkSize() const noexcept { return chunk_size_; }
+
+private:
+    Stream stream_;
+    std::size_t chunk_size_;
+    std::unique_ptr<char[]> buffer_;
+    std::uint64_t bytes_read_ = 0;
+    bool end_ = false;
+    std::optional<long> error_;
+};
+
+}  // namespace cxxui::detail
@@ -0,0 +1,52 @@
+#pragma once
+#include <string_view>
+
+namespace cxxui::detail {
+
+/**
+ * @brief 页面创建时注入的收发消息接口
+ * @details SendCppMsg/SetCppMsgHandler 收发原始消息。
+ *   cxxui.call(url, data) 返回 Promise，请求的保留字段 __cxxui_id 为递增的编号，
+ *   JsMsgHandler::Handle 在响应中原样返回，按编号找到对应的请求，可以同时有多个请求，完成顺序不限。
+ *   其他消息即使带有 id 等字段也不会被当作响应。
+ *   code 为 0 时 resolve(data)，否则 reject(Error)，Error.code 为响应码。
+ *   cxxui.call 的响应不会传给 SetCppMsgHandler 设置的处理函数。
+ *   只依赖 window.chrome.webview 的 postMessage 和 message 事件，可以在其他环境中模拟测试。
+ */
+inline constexpr std::string_view kJsBridgeScript = R"JS(
+window.cxxui = window.cxxui || {};
+(() => {
+    const webview = window.chrome.webview;
+    const pending = new Map();
+    const handlers = [];
+    let lastId = 0;
+    webview.addEventListener('message', (e) => {
+        const msg = e.data;
+        const isObject = msg !== null && typeof msg === 'object';
+        const call = isObject ? pending.get(msg.__cxxui_id) : undefined;
+        if (call === undefined) {
+            handlers.forEach((handler) => handler(msg));
+            return;
+        }
+        pending.delete(msg.__cxxui_id);
+        if (msg.code === 0) {
+            call.resolve(msg.data);
+        } else {
+            const error = new Error(msg.error);
+            error.code = msg.code;
+            call.reject(error);
+        }
+    });
+    window.SendCppMsg = (msg) => webview.postMessage(msg);
+    window.SetCppMsgHandler = (handler) => {
+        handlers.push(handler);
+    };
+    window.cxxui.call = (url, data) => new Promise((resolve, reject) => {
+        const id = ++lastId;
+        pending.set(id, { resolve, reject });
+        webview.postMessage({ __cxxui_id: id, url, data });
+    });
+})();
+)JS";
+
+}  // namespace cxxui::detail
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <nlohmann/json.hpp>
+
+#include <cxxui/core/expected.hpp>
+
+namespace cxxui::detail {
+
+/**
+ * @brief 只记录错误信息的 SAX 处理器
+ * @details 格式错误时 nlohmann 把构造好的异常交给 parse_error，这里保存信息而不抛出
+ */
+class JsonErrorSax : public nlohmann::json_sax<nlohmann::json> {
+public:
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+    bool number_integer(number_integer_t) override { return true; }
+    bool number_unsigned(number_unsigned_t) override { return true; }
+    bool number_float(number_float_t, const string_t&) override { return true; }
+    bool string(string_t&) override { return true; }
+    bool binary(binary_t&) override { return true; }
+    bool start_object(std::size_t) override { return true; }
+    bool key(string_t&) override { return true; }
+    bool end_object() override { return true; }
+    bool start_array(std::size_t) override { return true; }
+    bool end_array() override { return true; }
+    bool parse_error(std::size_t,
+                     const std::string&,
+                     const nlohmann::json::exception& ex) override {
+        error_ = ex.what();
+        return false;
+    }
+    std::string& GetError() noexcept { return error_; }
+
+private:
+    std::string error_;
+};
+
+/**
+ * @brief 解析 json 文本, 格式错误时不抛出异常
+ * @details 用 BasicJson::parse 的不抛出异常版本构造 DOM，节点在 BasicJson 的分配器上分配。
+ *   失败时再用只记录错误的 SAX 处理器扫描一次，取得库的错误信息
+ *
+ * @param text json 文本
+ * @param root 解析结果, 失败时内容不确定
+ * @return 失败时返回与 json::parse 异常相同的错误信息
+ */
+template <typename BasicJson>
+Expected<bool, std::string> ParseJson(std::string_view text, BasicJson& root) {
+    root = BasicJson::parse(text.begin(), text.end(), nullptr, false);
+    if (!root.is_discarded()) {
+        return true;
+    }
+    JsonErrorSax sax;
+    nlohmann::json::sax_parse(text.begin(), text.end(), &sax);
+    return Unexpected{std::move(sax.GetError())};
+}
+
+}  // namespace cxxui::detail
@@ -0,0 +1,42 @@
+#pragma once
+#include <string_view>
+
+namespace cxxui::detail {
+
+/** 扩展名对应的 Content-Type 响应头 */
+struct MimeType {
+    std::string_view ext;
+    std::string_view header;
+};
+
+/** 常用扩展名, 常用的放在前面 */
+inline constexpr MimeType kMimeTypes[] = {
+    {"html", "Content-Type: text/html; charset=utf-8\r\n"},
+    {"js", "Content-Type: application/javascript; charset=utf-8\r\n"},
+    {"css", "Content-Type: text/css; charset=utf-8\r\n"},
+    {"json", "Content-Type: application/json; charset=utf-8\r\n"},
+    {"png", "Content-Type: image/png\r\n"},
+    {"jpg", "Content-Type: image/jpeg\r\n"},
+    {"jpeg", "Content-Type: image/jpeg\r\n"},
+    {"ico", "Content-Type: image/x-icon\r\n"},
+    {"htm", "Content-Type: text/html; charset=utf-8\r\n"},
+};
+
+/**
+ * @brief 查找扩展名对应的 Content-Type 响应头
+ * @details 表很小，顺序比较比哈希表快，也不需要静态初始化。不依赖平台。
+ *
+ * @param ext_name 不带点的扩展名, 区分大小写
+ * @param default_type 找不到时返回的值
+ */
+constexpr std::string_view FindContentType(std::string_view ext_name,
+                                           std::string_view default_type) noexcept {
+    for (const MimeType& type : kMimeTypes) {
+        if (type.ext == ext_name) {
+            return type.header;
+        }
+    }
+    return default_type;
+}
+
+}  // namespace cxxui::detail
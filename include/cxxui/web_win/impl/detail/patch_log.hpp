@@ -0,0 +1,210 @@
+#pragma once
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace cxxui::detail {
+
+/**
+ * @brief 记录对 json 文档的修改, 增量生成 RFC 6902 补丁
+ * @details 每次修改直接记录为一个补丁操作，不需要对整个文档做 diff。记录时向前查找可以合并的操作：
+ *   新操作覆盖的子路径上的操作和同一路径上的 replace 会被删除，遇到移动了新路径所在数组下标的操作时
+ *   停止查找。值没有变化的基本类型赋值不产生操作。路径格式错误或不存在时抛出 std::out_of_range。不依赖平台。
+ */
+class PatchLog {
+public:
+    using json = nlohmann::json;
+
+    explicit PatchLog(json doc = json::object())
+        : doc_(std::move(doc)) {}
+
+    const json& Get() const noexcept { return doc_; }
+    const json& Get(std::string_view path) const { return At(doc_, Pointer(path)); }
+    bool Contains(std::string_view path) const { return doc_.contains(Pointer(path)); }
+    bool IsDirty() const noexcept { return !ops_.empty(); }
+    /** 未提交的操作数量 */
+    std::size_t GetCount() const noexcept { return ops_.size(); }
+    /**
+     * @brief 设置值, 对象成员不存在时添加, 存在时替换
+     *
+     * @param path json pointer, 父节点必须存在
+     */
+    void Set(std::string_view path, json value) {
+        if (path.empty()) {
+            Reset(std::move(value));
+            return;
+        }
+        json::json_pointer ptr = Pointer(path);
+        json& parent = Parent(ptr);
+        const std::string& key = ptr.back();
+        if (parent.is_array()) {
+            std::size_t index = Index(parent, key, false);
+            if (index == parent.size()) {
+                parent.push_back(value);
+                Record(Op::ADD, path, std::move(value), true);
+                return;
+            }
+            Replace(parent[index], path, std::move(value));
+        } else if (parent.is_object()) {
+            if (auto it = parent.find(key); it != parent.end()) {
+                Replace(*it, path, std::move(value));
+                return;
+            }
+            parent[key] = value;
+            Record(Op::ADD, path, std::move(value), false);
+        } else {
+            throw std::out_of_range("PatchLog: parent is not a container");
+        }
+    }
+    /**
+     * @brief 在数组中插入值, 之后的元素后移
+     *
+     * @param path 数组元素的 json pointer, 最后一段为下标或 "-"
+     */
+    void Insert(std::string_view path, json value) {
+        json::json_pointer ptr = Pointer(path);
+        json& parent = Parent(ptr);
+        if (!parent.is_array()) {
+            throw std::out_of_range("PatchLog: parent is not an array");
+        }
+        std::size_t index = Index(parent, ptr.back(), false);
+        parent.insert(parent.begin() + static_cast<std::ptrdiff_t>(index), value);
+        Record(Op::ADD, path, std::move(value), true);
+    }
+    /** 删除值, 数组中之后的元素前移 */
+    void Remove(std::string_view path) {
+        if (path.empty()) {
+            throw std::out_of_range("PatchLog: cannot remove the root");
+        }
+        json::json_pointer ptr = Pointer(path);
+        json& parent = Parent(ptr);
+        const std::string& key = ptr.back();
+        if (parent.is_array()) {
+            parent.erase(Index(parent, key, true));
+            Record(Op::REMOVE, path, nullptr, true);
+        } else if (parent.is_object() && parent.erase(key)) {
+            Record(Op::REMOVE, path, nullptr, false);
+        } else {
+            throw std::out_of_range("PatchLog: path not found");
+        }
+    }
+    /** 替换整个文档, 之前未提交的操作全部丢弃 */
+    void Reset(json doc) {
+        doc_ = std::move(doc);
+        ops_.clear();
+        ops_.push_back({Op::REPLACE, std::string{}, doc_, false});
+    }
+    /** 取出未提交的操作, 序列化为 RFC 6902 补丁数组 */
+    std::string TakePatch() {
+        std::string patch = "[";
+        for (const Entry& op : ops_) {
+            if (patch.size() > 1) {
+                patch.push_back(',');
+            }
+            patch.append(R"({"op":")").append(kOpNames[static_cast<int>(op.op)]);
+            patch.append(R"(","path":)").append(json(op.path).dump());
+            if (op.op != Op::REMOVE) {
+                patch.append(R"(,"value":)").append(op.value.dump());
+            }
+            patch.push_back('}');
+        }
+        patch.push_back(']');
+        ops_.clear();
+        return patch;
+    }
+
+private:
+    enum class Op { ADD, REMOVE, REPLACE };
+    static constexpr const char* kOpNames[] = {"add", "remove", "replace"};
+    /** 向前查找可合并操作的最大数量, 避免大量操作时退化为平方复杂度 */
+    static constexpr std::size_t kMaxScan = 64;
+
+    struct Entry {
+        Op op;
+        std::string path;
+        json value;
+        /** 是否移动了数组中其他元素的下标 */
+        bool shifts;
+    };
+    json doc_;
+    std::vector<Entry> ops_;
+
+    static json::json_pointer Pointer(std::string_view path) {
+        try {
+            return json::json_pointer{std::string{path}};
+        } catch (const json::exception& e) {
+            throw std::out_of_range(std::string{"PatchLog: "} + e.what());
+        }
+    }
+    /** 与 json::at 相同, 路径不存在时抛出 std::out_of_range */
+    template <typename Json>
+    static Json& At(Json& doc, const json::json_pointer& ptr) {
+        try {
+            return doc.at(ptr);
+        } catch (const json::exception& e) {
+            throw std::out_of_range(std::string{"PatchLog: "} + e.what());
+        }
+    }
+    json& Parent(const json::json_pointer& ptr) {
+        if (ptr.empty()) {
+            throw std::out_of_range("PatchLog: root has no parent");
+        }
+        return At(doc_, ptr.parent_pointer());
+    }
+    /** 解析数组下标, "-" 表示末尾 */
+    static std::size_t Index(const json& array, const std::string& key, bool existing) {
+        std::size_t index = array.size();
+        if (key != "-") {
+            // 只接受十进制数字, std::stoul 会接受空白和正负号
+            bool digits = !key.empty() && key.size() <= 18;
+            for (char ch : key) {
+                digits = digits && ch >= '0' && ch <= '9';
+            }
+            if (!digits) {
+                throw std::out_of_range("PatchLog: invalid array index");
+            }
+            index = static_cast<std::size_t>(std::stoull(key));
+        }
+        if (index > array.size() || (existing && index == array.size())) {
+            throw std::out_of_range("PatchLog: array index out of range");
+        }
+        return index;
+    }
+    void Replace(json& target, std::string_view path, json value) {
+        // 基本类型的值没有变化时不产生操作, 容器的比较开销较大, 不做比较
+        if (target.is_primitive() && value.is_primitive() && target == value) {
+            return;
+        }
+        target = value;
+        Record(Op::REPLACE, path, std::move(value), false);
+    }
+    static bool IsDescendant(std::string_view path, std::string_view parent) {
+        return path.size() > parent.size() && path.compare(0, parent.size(), parent) == 0 &&
+               path[parent.size()] == '/';
+    }
+    void Record(Op op, std::string_view path, json value, bool shifts) {
+        if (!shifts) {
+            std::size_t end = ops_.size();
+            std::size_t begin = end > kMaxScan ? end - kMaxScan : 0;
+            for (std::size_t i = end; i-- > begin;) {
+                const Entry& prev = ops_[i];
+                if (IsDescendant(prev.path, path) ||
+                    (prev.op == Op::REPLACE && prev.path == path)) {
+                    ops_.erase(ops_.begin() + static_cast<std::ptrdiff_t>(i));
+                } else if (prev.shifts &&
+                           IsDescendant(path, std::string_view{prev.path}.substr(
+                                                  0, prev.path.rfind('/')))) {
+                    // 之前的操作中 path 指向的可能是另一个数组元素
+                    break;
+                }
+            }
+        }
+        ops_.push_back({op, std::string{path}, std::move(value), shifts});
+    }
+};
+
+}  // namespace cxxui::detail
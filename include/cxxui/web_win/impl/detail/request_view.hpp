@@ -0,0 +1,287 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cxxui::detail {
+
+/** url 的各个部分, 指向原始 url, 不解码 */
+struct UrlParts {
+    std::string_view scheme;
+    /** 主机和端口, 如 localhost:8080 */
+    std::string_view authority;
+    std::string_view path;
+    /** ? 之后 # 之前的部分, 不包括 ? */
+    std::string_view query;
+    /** # 之后的部分, 不包括 # */
+    std::string_view fragment;
+};
+
+/**
+ * @brief 按 RFC 3986 拆分 url, 不解码也不检查字符是否合法
+ */
+constexpr UrlParts SplitUrl(std::string_view url) noexcept {
+    UrlParts parts;
+    // scheme = ALPHA *( ALPHA / DIGIT / "+" / "-" / "." ), 以 : 结束
+    for (std::size_t i = 0; i < url.size(); ++i) {
+        char c = url[i];
+        bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        if (c == ':' && i > 0) {
+            parts.scheme = url.substr(0, i);
+            url.remove_prefix(i + 1);
+            break;
+        }
+        if (!alpha && (i == 0 || !((c >= '0' && c <= '9') || c == '+' || c == '-' || c == '.'))) {
+            break;
+        }
+    }
+    if (url.substr(0, 2) == "//") {
+        url.remove_prefix(2);
+        std::size_t end = (std::min)(url.find_first_of("/?#"), url.size());
+        parts.authority = url.substr(0, end);
+        url.remove_prefix(end);
+    }
+    if (std::size_t hash = url.find('#'); hash != std::string_view::npos) {
+        parts.fragment = url.substr(hash + 1);
+        url = url.substr(0, hash);
+    }
+    if (std::size_t question = url.find('?'); question != std::string_view::npos) {
+        parts.query = url.substr(question + 1);
+        url = url.substr(0, question);
+    }
+    parts.path = url;
+    return parts;
+}
+
+/** 十六进制字符的值, 不是十六进制字符时返回 -1 */
+constexpr int HexValue(char c) noexcept {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/** 第一个需要解码的字符的位置, 没有时返回 input.size() */
+inline std::size_t FindPercentEscape(std::string_view input, bool plus_as_space) noexcept {
+    // 每次比较 8 个字节: 与目标字符异或后为 0 的字节, 减 1 时最高位由 0 变为 1
+    constexpr std::uint64_t kOnes = 0x0101010101010101ull;
+    constexpr std::uint64_t kHighs = 0x8080808080808080ull;
+    auto has_byte = [](std::uint64_t word, char byte) {
+        std::uint64_t x = word ^ (kOnes * static_cast<unsigned char>(byte));
+        return ((x - kOnes) & ~x & kHighs) != 0;
+    };
+    std::size_t i = 0;
+    for (; i + 8 <= input.size(); i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, input.data() + i, sizeof(word));
+        if (has_byte(word, '%') || (plus_as_space && has_byte(word, '+'))) {
+            break;
+        }
+    }
+    for (; i < input.size(); ++i) {
+        if (input[i] == '%' || (plus_as_space && input[i] == '+')) {
+            return i;
+        }
+    }
+    return input.size();
+}
+/** 是否包含需要解码的字符 */
+inline bool NeedsPercentDecode(std::string_view input, bool plus_as_space) noexcept {
+    return FindPercentEscape(input, plus_as_space) != input.size();
+}
+
+/**
+ * @brief 百分号解码, 追加到 output
+ * @details 不需要转换的连续字符整段复制。无效的转义(如 %zz 或末尾的 %)原样保留，与浏览器一致。
+ *   解码后的长度不会超过输入的长度，output 的容量足够时不会重新分配。
+ *
+ * @param plus_as_space 查询参数中 + 表示空格
+ */
+inline void PercentDecode(std::string_view input, std::string& output, bool plus_as_space) {
+    std::size_t begin = output.size();
+    output.resize(begin + input.size());
+    char* out = output.data() + begin;
+    while (!input.empty()) {
+        std::size_t pos = FindPercentEscape(input, plus_as_space);
+        std::memcpy(out, input.data(), pos);
+        out += pos;
+        if (pos == input.size()) {
+            break;
+        }
+        if (input[pos] == '+') {
+            *out++ = ' ';
+            input.remove_prefix(pos + 1);
+            continue;
+        }
+        int high = pos + 2 < input.size() ? HexValue(input[pos + 1]) : -1;
+        int low = high >= 0 ? HexValue(input[pos + 2]) : -1;
+        if (low < 0) {
+            *out++ = '%';
+            input.remove_prefix(pos + 1);
+            continue;
+        }
+        *out++ = static_cast<char>(high * 16 + low);
+        input.remove_prefix(pos + 3);
+    }
+    output.resize(static_cast<std::size_t>(out - output.data()));
+}
+
+/**
+ * @brief 请求的 url、方法和请求头, 在第一次访问时解析
+ * @details 解码后的路径和查询参数保存在同一块缓冲区中，不需要解码的部分直接指向原始 url，
+ *   返回的 string_view 在对象销毁前一直有效。不是线程安全的。不依赖平台。
+ */
+class RequestView {
+public:
+    /** 名字和值 */
+    using Field = std::pair<std::string_view, std::string_view>;
+
+    explicit RequestView(std::string url)
+        : url_(std::move(url)),
+          parts_(SplitUrl(url_)) {}
+    // 解析结果指向自身的缓冲区
+    RequestView(const RequestView&) = delete;
+    RequestView& operator=(const RequestView&) = delete;
+
+    /** 原始 url */
+    std::string_view GetUrl() const noexcept { return url_; }
+    std::string_view GetScheme() const noexcept { return parts_.scheme; }
+    /** 主机和端口, 如 localhost:8080 */
+    std::string_view GetHost() const noexcept { return parts_.authority; }
+    /** 解码后的路径, 如 /docs/a b.html */
+    std::string_view GetPath() const {
+        if (!path_) {
+            path_ = Decode(parts_.path, false);
+        }
+        return *path_;
+    }
+    /** 未解码的查询字符串, 不包括 ? */
+    std::string_view GetRawQuery() const noexcept { return parts_.query; }
+    std::string_view GetFragment() const noexcept { return parts_.fragment; }
+    /** 解码后的所有查询参数, 按出现顺序 */
+    const std::vector<Field>& GetQueries() const {
+        if (!queries_parsed_) {
+            ParseQueries();
+        }
+        return queries_;
+    }
+    /** 第一个名为 name 的查询参数的值 */
+    std::optional<std::string_view> GetQuery(std::string_view name) const {
+        return Find(GetQueries(), name, false);
+    }
+
+    std::string_view GetMethod() const noexcept { return method_; }
+    void SetMethod(std::string method) { method_ = std::move(method); }
+    /** 添加请求头, 在访问 GetHeaders 之前添加 */
+    void AddHeader(std::string_view name, std::string_view value) {
+        header_offsets_.push_back({headers_.size(), name.size(), value.size()});
+        headers_.append(name).append(value);
+        header_views_.clear();
+    }
+    /** 所有请求头, 按添加顺序 */
+    const std::vector<Field>& GetHeaders() const {
+        if (header_views_.size() != header_offsets_.size()) {
+            header_views_.clear();
+            std::string_view all = headers_;
+            for (const auto& header : header_offsets_) {
+                header_views_.emplace_back(all.substr(header.pos, header.name_size),
+                                           all.substr(header.pos + header.name_size,
+                                                      header.value_size));
+            }
+        }
+        return header_views_;
+    }
+    /** 第一个名为 name 的请求头的值, 名字不区分大小写 */
+    std::optional<std::string_view> GetHeader(std::string_view name) const {
+        return Find(GetHeaders(), name, true);
+    }
+
+private:
+    struct HeaderOffset {
+        std::size_t pos;
+        std::size_t name_size;
+        std::size_t value_size;
+    };
+
+    /** 需要解码时解码到缓冲区, 否则直接返回原始字符串 */
+    std::string_view Decode(std::string_view input, bool plus_as_space) const {
+        if (!NeedsPercentDecode(input, plus_as_space)) {
+            return input;
+        }
+        if (decoded_.capacity() < url_.size()) {
+            // 解码后不会变长, 预留 url 的长度后不会重新分配, 之前返回的 string_view 保持有效
+            decoded_.reserve(url_.size());
+        }
+        std::size_t begin = decoded_.size();
+        PercentDecode(input, decoded_, plus_as_space);
+        return std::string_view{decoded_}.substr(begin);
+    }
+    void ParseQueries() const {
+        queries_parsed_ = true;
+        std::string_view query = parts_.query;
+        if (query.empty()) {
+            return;
+        }
+        queries_.reserve(std::count(query.begin(), query.end(), '&') + 1);
+        while (!query.empty()) {
+            std::size_t end = (std::min)(query.find('&'), query.size());
+            std::string_view pair = query.substr(0, end);
+            query.remove_prefix((std::min)(end + 1, query.size()));
+            if (pair.empty()) {
+                continue;
+            }
+            std::size_t eq = (std::min)(pair.find('='), pair.size());
+            std::string_view name = Decode(pair.substr(0, eq), true);
+            std::string_view value = Decode(pair.substr((std::min)(eq + 1, pair.size())), true);
+            queries_.emplace_back(name, value);
+        }
+    }
+    static bool EqualsIgnoreCase(std::string_view a, std::string_view b) noexcept {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            char x = a[i];
+            char y = b[i];
+            if (x != y && ((x | 0x20) != (y | 0x20) || (x | 0x20) < 'a' || (x | 0x20) > 'z')) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static std::optional<std::string_view> Find(const std::vector<Field>& fields,
+                                                std::string_view name,
+                                                bool ignore_case) noexcept {
+        for (const auto& [key, value] : fields) {
+            if (ignore_case ? EqualsIgnoreCase(key, name) : key == name) {
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::string url_;
+    UrlParts parts_;
+    std::string method_;
+    mutable std::string decoded_;
+    mutable std::optional<std::string_view> path_;
+    mutable std::vector<Field> queries_;
+    mutable bool queries_parsed_ = false;
+    std::string headers_;
+    std::vector<HeaderOffset> header_offsets_;
+    mutable std::vector<Field> header_views_;
+};
+
+}  // namespace cxxui::detail
@@ -0,0 +1,199 @@
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cxxui::detail {
+
+/** 已注册的 javascript 函数的编号 */
+using JsFunctionId = std::size_t;
+
+/** 页面中保存已注册函数的全局数组 */
+inline constexpr std::string_view kJsFunctionTable = "window.__cxxui_fn";
+
+/**
+ * @brief javascript 函数注册表
+ * @details 较长的脚本只在注册时传给 webview 一次，保存到页面的全局数组中，
+ *   之后的调用只需要传递编号和参数。不依赖平台。
+ */
+class ScriptRegistry {
+public:
+    /**
+     * @brief 注册函数, 同名函数会被替换并使用新的编号
+     *
+     * @param name 函数名, 用于按名字调用
+     * @param function javascript 函数表达式, 如 "(a, b) => { ... }"
+     * @return JsFunctionId 函数编号
+     */
+    JsFunctionId Register(std::string_view name, std::string_view function) {
+        JsFunctionId id = definitions_.size();
+        std::string def;
+        def.reserve(kJsFunctionTable.size() * 2 + function.size() + 32);
+        def.append(kJsFunctionTable).append(" = ").append(kJsFunctionTable).append(" || [];\n");
+        def.append(kJsFunctionTable).append("[").append(std::to_string(id)).append("] = (");
+        def.append(function).append("\n);\n");
+        definitions_.push_back(std::move(def));
+        names_[std::string{name}] = id;
+        return id;
+    }
+    std::optional<JsFunctionId> Find(std::string_view name) const {
+        auto it = names_.find(std::string{name});
+        if (it == names_.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+    bool Contains(JsFunctionId id) const noexcept { return id < definitions_.size(); }
+    std::size_t GetCount() const noexcept { return definitions_.size(); }
+    /** 定义函数的脚本, 可以在同一个页面中重复执行 */
+    const std::string& GetDefinition(JsFunctionId id) const { return definitions_.at(id); }
+
+private:
+    std::vector<std::string> definitions_;
+    std::unordered_map<std::string, JsFunctionId> names_;
+};
+
+/**
+ * @brief 累积一段时间内的多次脚本调用, 按添加顺序分成若干次提交
+ * @details 每段普通脚本原样单独提交，仍然各自占用一次 ExecuteScript，只是推迟到统一的时机；
+ *   这样与直接调用 ExecuteScript 一样在全局作用域解析，顶层的 let/const/class 在之后的脚本中
+ *   仍然有效，一段脚本的语法错误不影响其他脚本。只有连续的已注册函数调用合并成一次提交，
+ *   每个调用包在 try/catch 中。不依赖平台。
+ */
+class ScriptBatch {
+public:
+    bool IsEmpty() const noexcept { return count_ == 0; }
+    /** 脚本和调用的数量 */
+    std::size_t GetCount() const noexcept { return count_; }
+    /** 所有脚本的字节数 */
+    std::size_t GetSize() const noexcept { return size_; }
+    /** 添加普通脚本, 单独提交, 不与其他脚本合并 */
+    void Add(std::string_view code) {
+        scripts_.emplace_back(code);
+        size_ += code.size();
+        calls_open_ = false;
+        ++count_;
+    }
+    /**
+     * @brief 添加已注册函数的调用, 与前面连续的调用合并提交
+     *
+     * @param id 函数编号
+     * @param args 参数列表的 javascript 源码, 如 R"(1, "text", {"a": 2})"
+     */
+    void AddCall(JsFunctionId id, std::string_view args) {
+        if (!calls_open_) {
+            scripts_.emplace_back();
+            calls_open_ = true;
+        }
+        std::string& script = scripts_.back();
+        std::size_t old_size = script.size();
+        script.append("try { ").append(kJsFunctionTable).append("[");
+        script.append(std::to_string(id)).append("](").append(args);
+        script.append("); } catch (e) { console.error(e); }\n");
+        size_ += script.size() - old_size;
+        ++count_;
+    }
+    /**
+     * @brief 脚本超过 limit 字节时丢弃所有脚本并释放缓冲区
+     *
+     * @param limit 字节数上限, 0 表示不限制
+     * @return 丢弃的脚本数量
+     */
+    std::size_t DropIfOver(std::size_t limit) noexcept {
+        if (limit == 0 || size_ <= limit) {
+            return 0;
+        }
+        std::size_t dropped = count_;
+        Clear();
+        return dropped;
+    }
+    /** 丢弃所有脚本并释放缓冲区 */
+    void Clear() noexcept {
+        std::vector<std::string>{}.swap(scripts_);
+        size_ = 0;
+        count_ = 0;
+        calls_open_ = false;
+    }
+    /** 按提交顺序取出每次提交的脚本并清空 */
+    std::vector<std::string> Take() {
+        std::vector<std::string> scripts;
+        scripts.reserve(scripts_.capacity());
+        scripts.swap(scripts_);
+        size_ = 0;
+        count_ = 0;
+        calls_open_ = false;
+        return scripts;
+    }
+
+private:
+    std::vector<std::string> scripts_;
+    std::size_t size_ = 0;
+    std::size_t count_ = 0;
+    /** 最后一次提交是否是已注册函数的调用, 之后的调用可以合并进去 */
+    bool calls_open_ = false;
+};
+
+/**
+ * @brief 窗口暂停期间发送的消息
+ * @details 消息不能合并到脚本中，发送时取出之前累积的脚本和消息一起排队，
+ *   恢复后按顺序先执行脚本再发送消息，保持脚本和消息的先后顺序。不依赖平台。
+ */
+class JsMsgQueue {
+public:
+    /** 排队的消息和它之前的脚本 */
+    struct Entry {
+        std::vector<std::string> scripts;
+        std::size_t script_count = 0;
+        std::string msg;
+    };
+
+    bool IsEmpty() const noexcept { return entries_.empty(); }
+    /** 排队的脚本和消息的总数 */
+    std::size_t GetCount() const noexcept { return count_; }
+    /** 排队的脚本和消息的字节数 */
+    std::size_t GetSize() const noexcept { return size_; }
+    /** 取出 batch 中累积的脚本, 与消息一起排在队尾 */
+    void Push(ScriptBatch& batch, std::string_view msg) {
+        Entry entry;
+        entry.script_count = batch.GetCount();
+        size_ += batch.GetSize() + msg.size();
+        entry.scripts = batch.Take();
+        entry.msg = msg;
+        count_ += entry.script_count + 1;
+        entries_.push_back(std::move(entry));
+    }
+    /**
+     * @brief 与 batch 中的脚本合计超过 limit 字节时丢弃所有消息和脚本
+     *
+     * @param limit 字节数上限, 0 表示不限制
+     * @return 丢弃的脚本和消息数量
+     */
+    std::size_t DropIfOver(ScriptBatch& batch, std::size_t limit) noexcept {
+        if (limit == 0 || size_ + batch.GetSize() <= limit) {
+            return 0;
+        }
+        std::size_t dropped = count_ + batch.GetCount();
+        batch.Clear();
+        std::vector<Entry>{}.swap(entries_);
+        count_ = 0;
+        size_ = 0;
+        return dropped;
+    }
+    /** 按排队顺序取出并清空 */
+    std::vector<Entry> Take() {
+        count_ = 0;
+        size_ = 0;
+        return std::exchange(entries_, {});
+    }
+
+private:
+    std::vector<Entry> entries_;
+    std::size_t count_ = 0;
+    std::size_t size_ = 0;
+};
+
+}  // namespace cxxui::detail
@@ -0,0 +1,61 @@
+#pragma once
+#include <string_view>
+
+namespace cxxui::detail {
+
+/**
+ * @brief 页面创建时注入的 cxxui::Store 状态副本
+ * @details window.cxxui.store.apply(name, patch) 按 RFC 6902 补丁更新状态并通知订阅者，
+ *   只支持 PatchLog 生成的 add/remove/replace 操作。get(name) 获取状态，
+ *   subscribe(name, (state, patch) => {}) 返回取消订阅的函数。不依赖 webview，可以在其他环境中测试。
+ */
+inline constexpr std::string_view kStoreScript = R"JS(
+window.cxxui = window.cxxui || {};
+window.cxxui.store = (() => {
+    const states = {};
+    const listeners = {};
+    const parse = (path) => path === '' ? [] : path.slice(1).split('/')
+        .map((key) => key.replace(/~1/g, '/').replace(/~0/g, '~'));
+    function apply(name, patch) {
+        let state = states[name];
+        for (const op of patch) {
+            const keys = parse(op.path);
+            if (keys.length === 0) {
+                state = op.value;
+                continue;
+            }
+            let parent = state;
+            for (let i = 0; i < keys.length - 1; ++i) {
+                parent = parent[keys[i]];
+            }
+            const key = keys[keys.length - 1];
+            if (Array.isArray(parent)) {
+                const index = key === '-' ? parent.length : Number(key);
+                if (op.op === 'add') {
+                    parent.splice(index, 0, op.value);
+                } else if (op.op === 'remove') {
+                    parent.splice(index, 1);
+                } else {
+                    parent[index] = op.value;
+                }
+            } else if (op.op === 'remove') {
+                delete parent[key];
+            } else {
+                parent[key] = op.value;
+            }
+        }
+        states[name] = state;
+        (listeners[name] || []).forEach((fn) => fn(state, patch));
+    }
+    return {
+        apply,
+        get: (name) => states[name],
+        subscribe(name, fn) {
+            (listeners[name] = listeners[name] || []).push(fn);
+            return () => { listeners[name] = listeners[name].filter((f) => f !== fn); };
+        },
+    };
+})();
+)JS";
+
+}  // namespace cxxui::detail
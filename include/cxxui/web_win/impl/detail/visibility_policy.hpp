@@ -0,0 +1,142 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
+namespace cxxui::detail {
+
+/** 窗口不可见或不活动时节省资源的策略配置 */
+struct VisibilityOptions {
+    using Duration = std::chrono::milliseconds;
+    /** 表示从不触发 */
+    static constexpr Duration kNever = Duration{-1};
+
+    /** 是否启用 */
+    bool enabled = true;
+    /** 不可见时是否暂停脚本提交和状态同步 */
+    bool pause_when_hidden = true;
+    /** 不可见多久后降低内存目标 */
+    Duration hidden_low_memory = Duration{0};
+    /** 不可见多久后尝试挂起渲染进程 */
+    Duration hidden_suspend = std::chrono::seconds{30};
+    /** 可见但失去焦点多久后降低内存目标 */
+    Duration inactive_low_memory = kNever;
+    /** 暂停期间累积的脚本和消息超过多少字节后全部丢弃, 恢复时通知窗口重新同步, 0 表示不限制 */
+    std::size_t paused_script_limit = 4 * 1024 * 1024;
+};
+
+/** 策略要求的资源状态 */
+struct VisibilityState {
+    /** 暂停脚本提交和状态同步 */
+    bool paused = false;
+    /** 降低内存目标 */
+    bool low_memory = false;
+    /** 挂起渲染进程 */
+    bool suspended = false;
+
+    bool operator==(const VisibilityState& other) const noexcept {
+        return paused == other.paused && low_memory == other.low_memory &&
+               suspended == other.suspended;
+    }
+    bool operator!=(const VisibilityState& other) const noexcept { return !(*this == other); }
+};
+
+/**
+ * @brief 根据可见性、最小化、焦点和系统内存压力计算窗口的资源状态
+ * @details 不可见(隐藏或最小化)时立即暂停，超过配置的时间后依次降低内存目标和挂起；
+ *   可见但不活动时超过配置的时间后降低内存目标。系统内存不足时所有非前台窗口立即降低内存目标。
+ *   回到前台时恢复所有资源。事件和时间由调用者传入，不依赖平台。
+ */
+class VisibilityPolicy {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    void SetOptions(const VisibilityOptions& options) noexcept { options_ = options; }
+    const VisibilityOptions& GetOptions() const noexcept { return options_; }
+    /** 以下输入函数返回输入是否变化 */
+    bool SetVisible(bool visible, TimePoint now) noexcept {
+        return Change(visible_, visible, now);
+    }
+    bool SetMinimized(bool minimized, TimePoint now) noexcept {
+        return Change(minimized_, minimized, now);
+    }
+    bool SetActive(bool active, TimePoint now) noexcept {
+        if (active_ == active) {
+            return false;
+        }
+        active_ = active;
+        inactive_since_ = now;
+        return true;
+    }
+    /** 设置系统内存压力 */
+    void SetMemoryPressure(bool pressure) noexcept { pressure_ = pressure; }
+    bool IsHidden() const noexcept { return !visible_ || minimized_; }
+    /** 计算 now 时刻应处的状态 */
+    VisibilityState Update(TimePoint now) const noexcept {
+        VisibilityState state;
+        if (!options_.enabled) {
+            return state;
+        }
+        if (IsHidden()) {
+            state.paused = options_.pause_when_hidden;
+            state.low_memory = pressure_ || Elapsed(hidden_since_, options_.hidden_low_memory, now);
+            state.suspended = Elapsed(hidden_since_, options_.hidden_suspend, now);
+        } else if (!active_) {
+            state.low_memory =
+                pressure_ || Elapsed(inactive_since_, options_.inactive_low_memory, now);
+        }
+        return state;
+    }
+    /** 下一个会改变状态的时间点, 没有时返回空 */
+    std::optional<TimePoint> GetNextDeadline(TimePoint now) const noexcept {
+        std::optional<TimePoint> next;
+        auto consider = [&next, now](TimePoint since, VisibilityOptions::Duration delay) {
+            if (delay < VisibilityOptions::Duration::zero()) {
+                return;
+            }
+            TimePoint at = since + delay;
+            if (at > now && (!next || at < *next)) {
+                next = at;
+            }
+        };
+        if (!options_.enabled) {
+            return next;
+        }
+        if (IsHidden()) {
+            consider(hidden_since_, options_.hidden_low_memory);
+            consider(hidden_since_, options_.hidden_suspend);
+        } else if (!active_) {
+            consider(inactive_since_, options_.inactive_low_memory);
+        }
+        return next;
+    }
+
+private:
+    VisibilityOptions options_;
+    bool visible_ = true;
+    bool minimized_ = false;
+    bool active_ = true;
+    bool pressure_ = false;
+    TimePoint hidden_since_{};
+    TimePoint inactive_since_{};
+
+    bool Change(bool& field, bool value, TimePoint now) noexcept {
+        if (field == value) {
+            return false;
+        }
+        bool was_hidden = IsHidden();
+        field = value;
+        if (!was_hidden && IsHidden()) {
+            hidden_since_ = now;
+        }
+        return true;
+    }
+    static bool Elapsed(TimePoint since,
+                        VisibilityOptions::Duration delay,
+                        TimePoint now) noexcept {
+        return delay >= VisibilityOptions::Duration::zero() && now - since >= delay;
+    }
+};
+
+}  // namespace cxxui::detail
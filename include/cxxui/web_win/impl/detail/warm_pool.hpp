@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <utility>
+
+namespace cxxui::detail {
+
+/** 预创建对象池的统计数据 */
+struct WarmPoolStats {
+    /** 从池中直接取得对象的次数 */
+    std::size_t hits = 0;
+    /** 池为空需要现场创建的次数 */
+    std::size_t misses = 0;
+    /** 创建失败的次数 */
+    std::size_t failures = 0;
+    /** 池中可用的对象数量 */
+    std::size_t ready = 0;
+    /** 正在后台创建的对象数量 */
+    std::size_t pending = 0;
+};
+
+/**
+ * @brief 预创建对象池的策略
+ * @details 只负责计数和决定补充数量，对象的异步创建由调用者完成：
+ *   NeedRefill() 返回需要补充的数量，每开始创建一个调用 OnCreateStarted，
+ *   完成后调用 OnCreated 或 OnCreateFailed。连续失败达到上限后停止补充，避免反复失败。
+ */
+template <typename T>
+class WarmPool {
+public:
+    static constexpr std::size_t kMaxFailures = 3;
+
+    /** 设置池的目标大小, 0 表示不预创建 */
+    void SetTarget(std::size_t target) noexcept {
+        target_ = target;
+        failures_in_row_ = 0;
+    }
+    std::size_t GetTarget() const noexcept { return target_; }
+    /** 取出一个预创建对象, 池为空时返回空 */
+    std::optional<T> Acquire() {
+        if (ready_.empty()) {
+            if (target_ > 0) {
+                ++stats_.misses;
+            }
+            return std::nullopt;
+        }
+        ++stats_.hits;
+        std::optional<T> value{std::move(ready_.front())};
+        ready_.pop_front();
+        return value;
+    }
+    /** 需要补充创建的数量 */
+    std::size_t NeedRefill() const noexcept {
+        if (failures_in_row_ >= kMaxFailures) {
+            return 0;
+        }
+        std::size_t have = ready_.size() + pending_;
+        return have >= target_ ? 0 : target_ - have;
+    }
+    void OnCreateStarted() noexcept { ++pending_; }
+    void OnCreated(T value) {
+        if (pending_) {
+            --pending_;
+        }
+        failures_in_row_ = 0;
+        ready_.push_back(std::move(value));
+    }
+    void OnCreateFailed() noexcept {
+        if (pending_) {
+            --pending_;
+        }
+        ++failures_in_row_;
+        ++stats_.failures;
+    }
+    /** 取出池中所有对象, 用于释放 */
+    std::deque<T> Drain() noexcept { return std::exchange(ready_, {}); }
+    WarmPoolStats GetStats() const noexcept {
+        WarmPoolStats stats = stats_;
+        stats.ready = ready_.size();
+        stats.pending = pending_;
+        return stats;
+    }
+
+private:
+    std::size_t target_ = 0;
+    std::size_t pending_ = 0;
+    std::size_t failures_in_row_ = 0;
+    std::deque<T> ready_;
+    WarmPoolStats stats_;
+};
+
+}  // namespace cxxui::detail
@@ -1,5 +1,11 @@
+#include <algorithm>
+#include <climits>
+#include <memory>
+#include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include <windows.h>
 #include <wrl.h>
@@ -10,12 +16,41 @@
 #endif
 
 #include <cxxui/win/error.hpp>
+#include <cxxui/core/executor.hpp>
+#include <cxxui/core/log.hpp>
 #include <cxxui/core/detail/string_coder.hpp>
+#include "detail/body_reader.hpp"
+#include "detail/mime_types.hpp"
+#include "detail/request_view.hpp"
 
 namespace cxxui::detail {
 
 using namespace Microsoft::WRL;
 
+/** 请求内容的 IStream, 没有内容时为空 */
+class ComReadStream {
+public:
+    explicit ComReadStream(ComPtr<IStream> stream)
+        : stream_(std::move(stream)) {}
+    Expected<std::size_t, long> Read(void* buffer, std::size_t size) {
+        if (!stream_) {
+            return std::size_t{0};
+        }
+        ULONG read = 0;
+        // S_FALSE 表示读到的少于请求的字节数, 下次读取返回 0
+        HRESULT hr = stream_->Read(
+            buffer, static_cast<ULONG>((std::min)(size, std::size_t{ULONG_MAX})), &read);
+        if (FAILED(hr)) {
+            return Unexpected{static_cast<long>(hr)};
+        }
+        return std::size_t{read};
+    }
+
+private:
+    ComPtr<IStream> stream_;
+};
+using BodyReader = ChunkReader<ComReadStream>;
+
 class RequestContextBase {
     template <typename T>
     friend class WebWindowBase;
@@ -30,31 +65,47 @@ protected:
             throw WindowError(hr, "get_Request failed!");
         }
     }
-    std::string GetUrl() const {
-        std::string output;
-        LPWSTR url_str;
-        if (FAILED(req_->get_Uri(&url_str))) {
-            return output;
-        }
-        output = W2U8(url_str);
-        CoTaskMemFree(url_str);
-        return output;
+    std::string GetUrl() const { return std::string{GetRequest().GetUrl()}; }
+    std::string_view GetMethod() const { return GetRequest().GetMethod(); }
+    std::string_view GetPath() const { return GetRequest().GetPath(); }
+    const std::vector<RequestView::Field>& GetQueries() const { return GetRequest().GetQueries(); }
+    std::optional<std::string_view> GetQuery(std::string_view name) const {
+        return GetRequest().GetQuery(name);
+    }
+    const std::vector<RequestView::Field>& GetHeaders() const {
+        LoadHeaders();
+        return request_->GetHeaders();
+    }
+    std::optional<std::string_view> GetHeader(std::string_view name) const {
+        LoadHeaders();
+        return request_->GetHeader(name);
+    }
+    BodyReader GetBody(std::size_t chunk_size) const {
+        ComPtr<IStream> stream;
+        HRESULT hr = req_->get_Content(&stream);
+        if (FAILED(hr)) {
+            CXXUI_LOG_WARN("get_Content failed", hr, GetRequest().GetUrl());
+            stream.Reset();
+        }
+        return BodyReader{ComReadStream{std::move(stream)}, chunk_size};
+    }
+    /** 取得 deferral, 返回的对象持有 self, 全部释放时完成请求 */
+    template <typename Context>
+    std::shared_ptr<Context> Defer(std::shared_ptr<Context> self) {
+        ComPtr<ICoreWebView2Deferral> deferral;
+        HRESULT hr = args_->GetDeferral(&deferral);
+        if (FAILED(hr)) {
+            throw WindowError(hr, "GetDeferral failed!");
+        }
+        Context* context = self.get();
+        auto holder = std::make_shared<DeferralHolder>();
+        holder->context = std::move(self);
+        holder->deferral = std::move(deferral);
+        return std::shared_ptr<Context>(std::move(holder), context);
     }
     void SetHeaders(std::string headers) { headers_ = std::move(headers); }
     std::string_view GetContentType(std::string_view ext_name, std::string_view default_type) {
-        static const std::unordered_map<std::string_view, std::string_view> mime_map = {
-            {"html", "Content-Type: text/html; charset=utf-8\r\n"},
-            {"htm", "Content-Type: text/html; charset=utf-8\r\n"},
-            {"css", "Content-Type: text/css; charset=utf-8\r\n"},
-            {"js", "Content-Type: application/javascript; charset=utf-8\r\n"},
-            {"json", "Content-Type: application/json; charset=utf-8\r\n"},
-            {"png", "Content-Type: image/png\r\n"},
-            {"jpg", "Content-Type: image/jpeg\r\n"},
-            {"jpeg", "Content-Type: image/jpeg\r\n"},
-            {"ico", "Content-Type: image/x-icon\r\n"},
-        };
-        auto it = mime_map.find(ext_name);
-        return it != mime_map.end() ? it->second : default_type;
+        return FindContentType(ext_name, default_type);
     }
     void SetResponse(int status_code) { SetResponse(status_code, nullptr); }
     void SetResponse(const void* data, std::size_t size, int status_code) {
@@ -78,15 +129,118 @@ protected:
     }
 
 private:
-    ICoreWebView2WebResourceRequestedEventArgs* args_;
-    ICoreWebView2Environment* env_;
+    /** 推迟的请求, 在UI线程完成后释放上下文 */
+    struct DeferralHolder {
+        /** 上下文和 deferral 都是UI线程的 COM 对象, 只能在UI线程释放 */
+        struct Pending {
+            std::shared_ptr<void> context;
+            ComPtr<ICoreWebView2Deferral> deferral;
+        };
+        std::shared_ptr<void> context;
+        ComPtr<ICoreWebView2Deferral> deferral;
+        std::shared_ptr<UiQueue> queue = GetSharedUiQueue();
+        std::thread::id thread = std::this_thread::get_id();
+        ~DeferralHolder() {
+            if (std::this_thread::get_id() == thread) {
+                Complete(deferral.Get());
+                return;
+            }
+            // 在其他线程释放时回到UI线程完成
+            auto* pending = new Pending{std::move(context), std::move(deferral)};
+            auto job = std::make_unique<UiJob>(
+                Job{[pending] {
+                    std::unique_ptr<Pending> owned{pending};
+                    Complete(owned->deferral.Get());
+                }},
+                Job{[pending, thread = thread] {
+                    // 队列关闭时可能在UI线程丢弃, 此时可以正常释放
+                    if (std::this_thread::get_id() == thread) {
+                        delete pending;
+                        return;
+                    }
+                    // UI线程已退出, 不能在当前线程 Release, 有意泄漏
+                    CXXUI_LOG_WARN("Deferred request abandoned after the UI thread exited", 0);
+                }});
+            queue->Post(*job.release());
+        }
+        static void Complete(ICoreWebView2Deferral* deferral) {
+            HRESULT hr = deferral->Complete();
+            if (FAILED(hr)) {
+                CXXUI_LOG_WARN("Complete deferral failed", hr);
+            }
+        }
+    };
+
+    /** 推迟的请求在事件返回后仍然访问它们 */
+    ComPtr<ICoreWebView2WebResourceRequestedEventArgs> args_;
+    ComPtr<ICoreWebView2Environment> env_;
     ComPtr<ICoreWebView2WebResourceRequest> req_;
     std::string headers_;
+    /** 第一次访问时才获取 url 和方法, 请求头单独加载 */
+    mutable std::optional<RequestView> request_;
+    mutable bool headers_loaded_ = false;
+
+    const RequestView& GetRequest() const {
+        if (!request_) {
+            std::string url;
+            LPWSTR url_str;
+            if (SUCCEEDED(req_->get_Uri(&url_str))) {
+                url = W2U8(url_str);
+                CoTaskMemFree(url_str);
+            }
+            request_.emplace(std::move(url));
+            LPWSTR method;
+            if (SUCCEEDED(req_->get_Method(&method))) {
+                request_->SetMethod(W2U8(method));
+                CoTaskMemFree(method);
+            }
+        }
+        return *request_;
+    }
+    void LoadHeaders() const {
+        GetRequest();
+        if (headers_loaded_) {
+            return;
+        }
+        headers_loaded_ = true;
+        ComPtr<ICoreWebView2HttpRequestHeaders> headers;
+        HRESULT hr = req_->get_Headers(&headers);
+        if (FAILED(hr)) {
+            CXXUI_LOG_WARN("get_Headers failed", hr, request_->GetUrl());
+            return;
+        }
+        ComPtr<ICoreWebView2HttpHeadersCollectionIterator> it;
+        hr = headers->GetIterator(&it);
+        if (FAILED(hr)) {
+            CXXUI_LOG_WARN("GetIterator failed", hr, request_->GetUrl());
+            return;
+        }
+        BOOL has_header = FALSE;
+        while (SUCCEEDED(it->get_HasCurrentHeader(&has_header)) && has_header) {
+            LPWSTR name;
+            LPWSTR value;
+            if (SUCCEEDED(it->GetCurrentHeader(&name, &value))) {
+                request_->AddHeader(W2U8(name), W2U8(value));
+                CoTaskMemFree(name);
+                CoTaskMemFree(value);
+            }
+            if (FAILED(it->MoveNext(&has_header))) {
+                break;
+            }
+        }
+    }
     void SetResponse(int status_code, IStream* stream) {
         ComPtr<ICoreWebView2WebResourceResponse> response;
-        env_->CreateWebResourceResponse(
+        HRESULT hr = env_->CreateWebResourceResponse(
             stream, status_code, GetReasonPhrase(status_code), U82W(headers_).data(), &response);
-        args_->put_Response(response.Get());
+        if (FAILED(hr)) {
+            CXXUI_LOG_ERROR("CreateWebResourceResponse failed", hr, GetRequest().GetUrl());
+            return;
+        }
+        hr = args_->put_Response(response.Get());
+        if (FAILED(hr)) {
+            CXXUI_LOG_ERROR("put_Response failed", hr, GetRequest().GetUrl());
+        }
     }
     static LPCWSTR GetReasonPhrase(int status_code) {
         switch (status_code) {
@@ -1,13 +1,25 @@
 #include <memory>
 #include <functional>
 #include <array>
+#include <chrono>
 #include <filesystem>
+#include <map>
+#include <vector>
 
 #include <wrl.h>
 #include <WebView2.h>
 
 #include <cxxui/win.hpp>
+#include <cxxui/core/task.hpp>
+#include <cxxui/core/executor.hpp>
+#include <cxxui/core/log.hpp>
+#include <cxxui/core/trace.hpp>
 #include <cxxui/core/detail/wm_msg.h>
+#include <cxxui/web_win/impl/detail/js_bridge.hpp>
+#include <cxxui/web_win/impl/detail/warm_pool.hpp>
+#include <cxxui/web_win/impl/detail/script_batch.hpp>
+#include <cxxui/web_win/impl/detail/store_runtime.hpp>
+#include <cxxui/web_win/impl/detail/visibility_policy.hpp>
 
 /** 定义 webview2 runtime 的目录，以制作便携版。
  * 如果目录不存在，则退化为查找系统安装的 webview2 runtime
@@ -22,7 +34,7 @@ class DefaultWebWindow;
 
 using namespace Microsoft::WRL;
 
-/** 全局管理env, 创建webview */
+/** 按线程管理env, 创建webview */
 class WebFactory {
     using WebCallback = std::function<void(HRESULT, ComPtr<ICoreWebView2Controller>)>;
 
@@ -32,22 +44,53 @@ class WebFactory {
     };
 
 public:
-    ~WebFactory() { CoUninitialize(); }
-    /** 获取单例实例 */
+    ~WebFactory() {
+        if (memory_wait_) {
+            // 等待正在执行的回调结束
+            UnregisterWaitEx(memory_wait_, INVALID_HANDLE_VALUE);
+        }
+        for (HANDLE handle : {low_memory_, high_memory_}) {
+            if (handle) {
+                CloseHandle(handle);
+            }
+        }
+        for (auto& ctrl : pool_.Drain()) {
+            ctrl->Close();
+        }
+        if (parking_) {
+            DestroyWindow(parking_);
+        }
+        env_.Reset();
+        CoUninitialize();
+    }
+    /** 获取当前线程的实例, 每个UI线程有独立的COM套间和env */
     static WebFactory& GetInstance() {
-        static WebFactory instance;
+        thread_local WebFactory instance;
         return instance;
     }
     /** 获取env */
     ComPtr<ICoreWebView2Environment> GetEnv() { return env_; }
-    /** 创建webview */
+    /** 创建webview, 预创建池中有可用的webview时直接移交给窗口 */
     HRESULT CreateWebView(HWND hwnd, WebCallback callback) {
         if (env_) {
+            auto ctrl = pool_.Acquire();
+            ScheduleRefill();
+            if (ctrl) {
+                CXXUI_TRACE_INSTANT("AdoptPooledController");
+                if (SUCCEEDED((*ctrl)->put_ParentWindow(hwnd))) {
+                    callback(S_OK, std::move(*ctrl));
+                    return S_OK;
+                }
+                (*ctrl)->Close();
+            }
+            CXXUI_TRACE_ASYNC_BEGIN("CreateController", reinterpret_cast<std::uintptr_t>(hwnd));
             return env_->CreateCoreWebView2Controller(
                 hwnd,
                 Callback<ICoreWebView2CreateCoreWebView2ControllerCompletedHandler>(
                     [hwnd, callback = std::move(callback)](
                         HRESULT result, ICoreWebView2Controller* ctrl) -> HRESULT {
+                        CXXUI_TRACE_ASYNC_END("CreateController",
+                                              reinterpret_cast<std::uintptr_t>(hwnd));
                         if (IsWindow(hwnd)) {
                             callback(result, ctrl);
                         }
@@ -55,27 +98,48 @@ public:
                     })
                     .Get());
         }
-        // 设置 webview2 缓存路径
-        wchar_t exe_path[MAX_PATH];
-        GetModuleFileNameW(nullptr, exe_path, MAX_PATH);
-        auto udf = std::filesystem::path(exe_path).parent_path() / L".cache";
         // 异步创建 env，创建期间缓存创建任务到queue
         // env 创建完成后在 OnEnvCreated 处理 queue
+        if (queue_) {
+            queue_->emplace_back(QueueData{hwnd, std::move(callback)});
+            return S_OK;
+        }
         queue_ = std::make_unique<std::vector<QueueData>>();
-        queue_->emplace_back(QueueData{hwnd, callback});
-        std::filesystem::path webview2_dir = GetWebView2Dir();
-        HRESULT hr = CreateCoreWebView2EnvironmentWithOptions(
-            std::filesystem::exists(webview2_dir) ? webview2_dir.c_str() : nullptr,
-            udf.c_str(),
-            nullptr,
-            Callback<ICoreWebView2CreateCoreWebView2EnvironmentCompletedHandler>(OnEnvCreated)
-                .Get());
+        queue_->emplace_back(QueueData{hwnd, std::move(callback)});
+        HRESULT hr = CreateEnv();
         if (FAILED(hr)) {
             queue_.reset();
             return hr;
         }
         return S_OK;
     }
+    /** 设置预创建webview的数量, 尚未创建env时立即开始创建 */
+    void Prewarm(std::size_t count) {
+        pool_.SetTarget(count);
+        if (env_) {
+            Refill();
+        } else if (!queue_ && count > 0) {
+            queue_ = std::make_unique<std::vector<QueueData>>();
+            if (FAILED(CreateEnv())) {
+                queue_.reset();
+            }
+        }
+    }
+    /** 获取预创建池的统计数据 */
+    WarmPoolStats GetPoolStats() const { return pool_.GetStats(); }
+    /**
+     * @brief 注册窗口的系统内存压力处理函数, 第一次注册时开始监听系统内存通知
+     *
+     * @param handler 内存不足时以 true 调用, 恢复时以 false 调用
+     */
+    void AddMemoryHandler(HWND hwnd, std::function<void(bool)> handler) {
+        if (memory_pressure_) {
+            handler(true);
+        }
+        memory_handlers_[hwnd] = std::move(handler);
+        WatchMemory();
+    }
+    void RemoveMemoryHandler(HWND hwnd) { memory_handlers_.erase(hwnd); }
     std::filesystem::path GetWebView2Dir() {
         std::filesystem::path dir;
         if constexpr (CXXUI_WEBVIEW2_DIR[0] == '.') {
@@ -96,8 +160,147 @@ private:
 private:
     ComPtr<ICoreWebView2Environment> env_;
     std::unique_ptr<std::vector<QueueData>> queue_;
+    WarmPool<ComPtr<ICoreWebView2Controller>> pool_;
+    /** 预创建的webview挂在这个隐藏窗口下, 取用时再移交给目标窗口 */
+    HWND parking_ = nullptr;
+    bool refill_scheduled_ = false;
+    /** 系统内存不足和充足的通知, 同一时刻只等待其中一个 */
+    HANDLE low_memory_ = nullptr;
+    HANDLE high_memory_ = nullptr;
+    HANDLE memory_wait_ = nullptr;
+    /** 线程池回调通过它回到UI线程, 持有它使UI线程退出后投递被丢弃而不是访问已销毁的队列 */
+    std::shared_ptr<UiQueue> ui_queue_;
+    UiTask memory_task_;
+    bool memory_pressure_ = false;
+    /** 内存不足时暂停预创建, 恢复后还原 */
+    std::size_t saved_target_ = 0;
+    std::map<HWND, std::function<void(bool)>> memory_handlers_;
+
+    void WatchMemory() {
+        if (low_memory_) {
+            return;
+        }
+        low_memory_ = CreateMemoryResourceNotification(LowMemoryResourceNotification);
+        high_memory_ = CreateMemoryResourceNotification(HighMemoryResourceNotification);
+        if (!low_memory_ || !high_memory_) {
+            return;
+        }
+        ui_queue_ = GetSharedUiQueue();
+        memory_task_.run = [](UiTask*) { GetInstance().OnMemoryChanged(); };
+        WaitMemory();
+    }
+    /** 内存不足时等待恢复, 否则等待内存不足, 通知对象在条件满足期间保持触发状态 */
+    void WaitMemory() {
+        HANDLE handle = memory_pressure_ ? high_memory_ : low_memory_;
+        RegisterWaitForSingleObject(
+            &memory_wait_, handle,
+            [](PVOID context, BOOLEAN) {
+                auto* factory = static_cast<WebFactory*>(context);
+                factory->ui_queue_->Post(factory->memory_task_);
+            },
+            this, INFINITE, WT_EXECUTEONLYONCE);
+    }
+    void OnMemoryChanged() {
+        UnregisterWait(memory_wait_);
+        memory_wait_ = nullptr;
+        memory_pressure_ = !memory_pressure_;
+        CXXUI_TRACE_INSTANT(memory_pressure_ ? "LowMemory" : "MemoryRecovered");
+        if (memory_pressure_) {
+            saved_target_ = pool_.GetTarget();
+            pool_.SetTarget(0);
+            for (auto& ctrl : pool_.Drain()) {
+                ctrl->Close();
+            }
+        } else {
+            pool_.SetTarget(saved_target_);
+            if (env_) {
+                ScheduleRefill();
+            }
+        }
+        // 处理函数中可能关闭窗口并注销其他窗口的处理函数, 先取出窗口列表, 调用前重新查找
+        std::vector<HWND> hwnds;
+        hwnds.reserve(memory_handlers_.size());
+        for (const auto& entry : memory_handlers_) {
+            hwnds.push_back(entry.first);
+        }
+        for (HWND hwnd : hwnds) {
+            auto it = memory_handlers_.find(hwnd);
+            if (it == memory_handlers_.end()) {
+                continue;
+            }
+            // 复制一份, 处理函数注销自己时不会在调用中被销毁
+            auto handler = it->second;
+            handler(memory_pressure_);
+        }
+        WaitMemory();
+    }
+
+    HRESULT CreateEnv() {
+        // 设置 webview2 缓存路径
+        wchar_t exe_path[MAX_PATH];
+        GetModuleFileNameW(nullptr, exe_path, MAX_PATH);
+        auto udf = std::filesystem::path(exe_path).parent_path() / L".cache";
+        std::filesystem::path webview2_dir = GetWebView2Dir();
+        CXXUI_TRACE_ASYNC_BEGIN("CreateEnvironment", GetCurrentThreadId());
+        return CreateCoreWebView2EnvironmentWithOptions(
+            std::filesystem::exists(webview2_dir) ? webview2_dir.c_str() : nullptr,
+            udf.c_str(),
+            nullptr,
+            Callback<ICoreWebView2CreateCoreWebView2EnvironmentCompletedHandler>(OnEnvCreated)
+                .Get());
+    }
+    /** 在空闲时补充预创建池, 避免和正在显示的窗口争抢 */
+    void ScheduleRefill() {
+        if (refill_scheduled_ || !pool_.NeedRefill()) {
+            return;
+        }
+        refill_scheduled_ = true;
+        ScheduleIdle(
+            [] {
+                WebFactory& factory = GetInstance();
+                factory.refill_scheduled_ = false;
+                factory.Refill();
+            },
+            IdlePriority::LOW);
+    }
+    void Refill() {
+        std::size_t count = pool_.NeedRefill();
+        if (!count) {
+            return;
+        }
+        if (!parking_) {
+            parking_ = CreateWindowExW(0, L"STATIC", L"", WS_POPUP, 0, 0, 0, 0, nullptr, nullptr,
+                                       GetModuleHandleW(nullptr), nullptr);
+            if (!parking_) {
+                pool_.OnCreateFailed();
+                return;
+            }
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            pool_.OnCreateStarted();
+            HRESULT hr = env_->CreateCoreWebView2Controller(
+                parking_,
+                Callback<ICoreWebView2CreateCoreWebView2ControllerCompletedHandler>(
+                    [](HRESULT result, ICoreWebView2Controller* ctrl) -> HRESULT {
+                        WebFactory& factory = GetInstance();
+                        if (FAILED(result) || !ctrl) {
+                            factory.pool_.OnCreateFailed();
+                            factory.ScheduleRefill();
+                        } else {
+                            ctrl->put_IsVisible(FALSE);
+                            factory.pool_.OnCreated(ctrl);
+                        }
+                        return S_OK;
+                    })
+                    .Get());
+            if (FAILED(hr)) {
+                pool_.OnCreateFailed();
+            }
+        }
+    }
     static HRESULT OnEnvCreated(HRESULT result, ICoreWebView2Environment* env) {
         WebFactory& factory = GetInstance();
+        CXXUI_TRACE_ASYNC_END("CreateEnvironment", GetCurrentThreadId());
         auto queue = std::move(factory.queue_);
         if (FAILED(result)) {
             for (auto& data : *queue) {
@@ -111,6 +314,7 @@ private:
                     data.callback(hr, nullptr);
                 }
             }
+            factory.Refill();
         }
         return S_OK;
     }
@@ -120,6 +324,14 @@ template <typename Derived>
 class WebWindowBase : public Window<Derived> {
     friend class detail::WindowBase<Derived>;
 
+public:
+    ~WebWindowBase() {
+        // 没有收到 WM_DESTROY 就析构时, 内存处理函数不能再引用这个窗口
+        if (this->hwnd_) {
+            WebFactory::GetInstance().RemoveMemoryHandler(this->hwnd_);
+        }
+    }
+
 protected:
     void WaitWebCreated() const {
         if (this->ctrl_) {
@@ -127,27 +339,33 @@ protected:
         } else if (!this->hwnd_) {
             throw WindowError(ERROR_INVALID_HANDLE, "Window is not created!");
         }
-        MSG msg;
-        while (GetMessageW(&msg, nullptr, 0, 0) > 0) {
-            TranslateMessage(&msg);
-            DispatchMessageW(&msg);
+        HRESULT result = S_OK;
+        auto exit_code = RunMessageLoop([this, &result](const MSG& msg) {
             if (msg.message != UM_WEB_CREATED || msg.hwnd != this->hwnd_) {
-                continue;
+                return false;
             }
-            if (FAILED(msg.wParam)) {
-                throw WindowError(static_cast<long>(msg.wParam), "CreateWebView failed!");
-            }
-            return;
+            result = static_cast<HRESULT>(msg.wParam);
+            return true;
+        });
+        if (exit_code) {
+            PostQuitMessage(*exit_code);  // 交还 WM_QUIT 给外层的消息循环
+            throw WindowError(0, "GetMessage failed!");
+        }
+        if (FAILED(result)) {
+            throw WindowError(static_cast<long>(result), "CreateWebView failed!");
         }
-        throw WindowError(0, "GetMessage failed!");
     }
     void SetHtml(std::string_view html) {
+        CXXUI_TRACE_INSTANT_ONCE("FirstNavigate");
+        FlushJs();
         HRESULT hr = GetWebView()->NavigateToString(U82W(html).c_str());
         if (FAILED(hr)) {
             throw WindowError(hr, "NavigateToString failed!");
         }
     }
     void SetUrl(std::string_view url) {
+        CXXUI_TRACE_INSTANT_ONCE("FirstNavigate");
+        FlushJs();
         HRESULT hr = GetWebView()->Navigate(U82W(url).c_str());
         if (FAILED(hr)) {
             throw WindowError(hr, "Navigate failed!");
@@ -165,26 +383,66 @@ protected:
         }
     }
     void SetJsMsgHandler(std::function<std::string(std::string)> handler) {
-        GetWebView()->add_WebMessageReceived(
-            Callback<ICoreWebView2WebMessageReceivedEventHandler>(
-                [handler = std::move(handler)](
-                    ICoreWebView2* sender,
-                    ICoreWebView2WebMessageReceivedEventArgs* args) -> HRESULT {
-                    LPWSTR msg;
-                    HRESULT hr = args->get_WebMessageAsJson(&msg);
-                    if (FAILED(hr)) {
-                        return hr;
+        auto callback = Callback<ICoreWebView2WebMessageReceivedEventHandler>(
+            [handler = std::move(handler)](
+                ICoreWebView2* sender,
+                ICoreWebView2WebMessageReceivedEventArgs* args) -> HRESULT {
+                CXXUI_TRACE_INSTANT_ONCE("FirstWebMessageReceived");
+                LPWSTR msg;
+                HRESULT hr = args->get_WebMessageAsJson(&msg);
+                if (FAILED(hr)) {
+                    return hr;
+                }
+                std::string req = W2U8(msg);
+                CoTaskMemFree(msg);
+                std::string resp = handler(std::move(req));
+                hr = sender->PostWebMessageAsJson(U82W(resp).c_str());
+                if (FAILED(hr)) {
+                    CXXUI_LOG_WARN("PostWebMessageAsJson failed", hr);
+                }
+                return S_OK;
+            });
+        HRESULT hr = GetWebView()->add_WebMessageReceived(callback.Get(), nullptr);
+        if (FAILED(hr)) {
+            CXXUI_LOG_ERROR("add_WebMessageReceived failed", hr);
+        }
+    }
+    void SetJsMsgHandler(
+        std::function<void(std::string, std::function<void(std::string)>)> handler) {
+        auto callback = Callback<ICoreWebView2WebMessageReceivedEventHandler>(
+            [handler = std::move(handler)](
+                ICoreWebView2* sender,
+                ICoreWebView2WebMessageReceivedEventArgs* args) -> HRESULT {
+                CXXUI_TRACE_INSTANT_ONCE("FirstWebMessageReceived");
+                LPWSTR msg;
+                HRESULT hr = args->get_WebMessageAsJson(&msg);
+                if (FAILED(hr)) {
+                    return hr;
+                }
+                std::string req = W2U8(msg);
+                CoTaskMemFree(msg);
+                ComPtr<ICoreWebView2> webview = sender;
+                handler(std::move(req), [webview](std::string resp) {
+                    HRESULT post_hr = webview->PostWebMessageAsJson(U82W(resp).c_str());
+                    if (FAILED(post_hr)) {
+                        CXXUI_LOG_WARN("PostWebMessageAsJson failed", post_hr);
                     }
-                    std::string req = W2U8(msg);
-                    CoTaskMemFree(msg);
-                    std::string resp = handler(std::move(req));
-                    sender->PostWebMessageAsJson(U82W(resp).c_str());
-                    return S_OK;
-                })
-                .Get(),
-            nullptr);
+                });
+                return S_OK;
+            });
+        HRESULT hr = GetWebView()->add_WebMessageReceived(callback.Get(), nullptr);
+        if (FAILED(hr)) {
+            CXXUI_LOG_ERROR("add_WebMessageReceived failed", hr);
+        }
     }
     void SendJsMsg(std::string_view msg) {
+        if (visibility_state_.paused) {
+            // 暂停期间不提交, 与之前的脚本一起排队, 恢复时按顺序提交
+            js_msgs_.Push(js_batch_, msg);
+            DropPausedJs();
+            return;
+        }
+        FlushJs();  // 保持与之前的脚本的先后顺序
         HRESULT hr = GetWebView()->PostWebMessageAsJson(U82W(msg).c_str());
         if (FAILED(hr)) {
             throw WindowError(hr, "PostWebMessageAsJson failed!");
@@ -192,10 +450,68 @@ protected:
     }
     void RunJs(std::string_view js_code, bool on_created) {
         if (on_created) {
-            GetWebView()->AddScriptToExecuteOnDocumentCreated(U82W(js_code).c_str(), nullptr);
+            HRESULT hr = GetWebView()->AddScriptToExecuteOnDocumentCreated(
+                U82W(js_code).c_str(), nullptr);
+            if (FAILED(hr)) {
+                CXXUI_LOG_WARN("AddScriptToExecuteOnDocumentCreated failed", hr);
+            }
         } else {
-            GetWebView()->ExecuteScript(U82W(js_code).c_str(), nullptr);
+            GetJsBatch().Add(js_code);
+        }
+    }
+    JsFunctionId RegisterJs(std::string_view name, std::string_view function) {
+        if (!this->hwnd_) {
+            throw WindowError(ERROR_INVALID_HANDLE, "Window is not created!");
+        }
+        JsFunctionId id = scripts_.Register(name, function);
+        const std::string& definition = scripts_.GetDefinition(id);
+        // webview 创建前注册的函数在创建完成后统一添加
+        if (ctrl_) {
+            HRESULT hr = GetWebView()->AddScriptToExecuteOnDocumentCreated(
+                U82W(definition).c_str(), nullptr);
+            if (FAILED(hr)) {
+                CXXUI_LOG_WARN("AddScriptToExecuteOnDocumentCreated failed", hr, name);
+            }
         }
+        // 当前页面也需要定义
+        GetJsBatch().Add(definition);
+        return id;
+    }
+    void CallJs(JsFunctionId id, std::string_view args) {
+        if (!scripts_.Contains(id)) {
+            throw WindowError(ERROR_NOT_FOUND, "Js function is not registered!");
+        }
+        GetJsBatch().AddCall(id, args);
+    }
+    void CallJs(std::string_view name, std::string_view args) {
+        auto id = scripts_.Find(name);
+        if (!id) {
+            throw WindowError(ERROR_NOT_FOUND, "Js function is not registered!");
+        }
+        GetJsBatch().AddCall(*id, args);
+    }
+    void AddFrameHook(std::function<void()> hook) { frame_hooks_.push_back(std::move(hook)); }
+    void SetVisibilityOptions(const VisibilityOptions& options) {
+        visibility_.SetOptions(options);
+        ApplyVisibility();
+    }
+    VisibilityOptions GetVisibilityOptions() const { return visibility_.GetOptions(); }
+    VisibilityState GetVisibilityState() const { return visibility_state_; }
+    /** 立即按顺序提交排队的消息和本帧累积的脚本, webview 创建前不提交 */
+    void FlushJs() {
+        if ((js_batch_.IsEmpty() && js_msgs_.IsEmpty()) || !ctrl_) {
+            return;
+        }
+        CXXUI_TRACE_SCOPE("FlushJs");
+        ComPtr<ICoreWebView2> webview = GetWebView();
+        for (const auto& entry : js_msgs_.Take()) {
+            ExecuteBatch(webview.Get(), entry.scripts);
+            HRESULT hr = webview->PostWebMessageAsJson(U82W(entry.msg).c_str());
+            if (FAILED(hr)) {
+                CXXUI_LOG_WARN("PostWebMessageAsJson failed", hr);
+            }
+        }
+        ExecuteBatch(webview.Get(), js_batch_.Take());
     }
     /**
      * webview 官方不支持设置焦点到 webview 窗口
@@ -240,16 +556,184 @@ protected:
             Callback<ICoreWebView2WebResourceRequestedEventHandler>(
                 [this, handler = std::move(handler)](
                     ICoreWebView2*, ICoreWebView2WebResourceRequestedEventArgs* args) -> HRESULT {
-                    RequestContext ctx{args, WebFactory::GetInstance().GetEnv().Get()};
-                    handler(ctx);
+                    // 处理函数可能推迟响应, 上下文由 shared_ptr 持有
+                    std::shared_ptr<RequestContext> ctx{
+                        new RequestContext{args, WebFactory::GetInstance().GetEnv().Get()}};
+                    handler(*ctx);
                     return S_OK;
                 })
                 .Get(),
             nullptr);
     }
 
+#if CXXUI_HAS_COROUTINE
+    /** 等待 webview 创建完成的协程节点 */
+    struct WebCreatedAwaiter : ResumeTask {
+        WebWindowBase* win;
+        WebCreatedAwaiter* next_waiter = nullptr;
+        HRESULT result = S_OK;
+        explicit WebCreatedAwaiter(WebWindowBase* w)
+            : win(w) {}
+        bool await_ready() const {
+            if (!win->hwnd_) {
+                throw WindowError(ERROR_INVALID_HANDLE, "Window is not created!");
+            }
+            return win->ctrl_ != nullptr;
+        }
+        template <typename Promise>
+        void await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            SetHandle(h);
+            next_waiter = win->web_waiters_;
+            win->web_waiters_ = this;
+        }
+        void await_resume() const {
+            if (FAILED(result)) {
+                throw WindowError(result, "CreateWebView failed!");
+            }
+        }
+    };
+    /**
+     * @brief javascript 的执行结果, 由 webview 的回调和等待的协程共享
+     * @details 协程在回调之前被销毁时不再恢复它，回调和排队中的任务仍然可以安全地访问结果
+     */
+    struct EvalJsState : ResumeTask {
+        HRESULT result = S_OK;
+        std::string value;
+        /** 在消息循环中排队期间持有自身 */
+        std::shared_ptr<EvalJsState> self;
+        EvalJsState() {
+            run = [](UiTask* task) {
+                auto state = std::move(static_cast<EvalJsState*>(task)->self);
+                if (state->handle) {
+                    state->handle.resume();
+                }
+            };
+            drop = [](UiTask* task) { static_cast<EvalJsState*>(task)->self.reset(); };
+        }
+    };
+    /** 等待 javascript 执行结果的协程节点 */
+    struct EvalJsAwaiter {
+        WebWindowBase* win;
+        ComPtr<ICoreWebView2> webview;
+        std::wstring code;
+        std::shared_ptr<EvalJsState> state = std::make_shared<EvalJsState>();
+        EvalJsAwaiter(WebWindowBase* w, ComPtr<ICoreWebView2> view, std::wstring js_code)
+            : win(w),
+              webview(std::move(view)),
+              code(std::move(js_code)) {}
+        EvalJsAwaiter(EvalJsAwaiter&&) = default;
+        ~EvalJsAwaiter() {
+            // 协程已销毁, 之后的回调不再恢复它
+            if (state) {
+                state->handle = nullptr;
+            }
+        }
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h) {
+            state->handle = h;
+            win->FlushJs();  // 保持与之前的脚本的先后顺序
+            HRESULT hr = webview->ExecuteScript(
+                code.c_str(),
+                Callback<ICoreWebView2ExecuteScriptCompletedHandler>(
+                    [state = state](HRESULT error, LPCWSTR json) -> HRESULT {
+                        if (!state->handle) {
+                            return S_OK;
+                        }
+                        state->result = error;
+                        if (SUCCEEDED(error) && json) {
+                            state->value = W2U8(json);
+                        }
+                        // 不在 webview 的回调中恢复协程, 交给消息循环
+                        state->self = state;
+                        GetUiQueue().Post(*state);
+                        return S_OK;
+                    })
+                    .Get());
+            if (FAILED(hr)) {
+                state->result = hr;
+                return false;
+            }
+            return true;
+        }
+        std::string await_resume() {
+            if (FAILED(state->result)) {
+                throw WindowError(state->result, "ExecuteScript failed!");
+            }
+            return std::move(state->value);
+        }
+    };
+    WebCreatedAwaiter WebCreated() { return WebCreatedAwaiter{this}; }
+    EvalJsAwaiter EvalJs(std::string_view js_code) {
+        return EvalJsAwaiter{this, GetWebView(), U82W(js_code)};
+    }
+#endif
+
 protected:
     ComPtr<ICoreWebView2Controller> ctrl_;
+    /** 已注册的 javascript 函数 */
+    ScriptRegistry scripts_;
+    /** 本帧累积的脚本, 在帧结束时按顺序提交 */
+    ScriptBatch js_batch_;
+    /** 暂停期间发送的消息, 恢复时与脚本按顺序提交 */
+    JsMsgQueue js_msgs_;
+    /** 每一帧提交脚本前调用的函数 */
+    std::vector<std::function<void()>> frame_hooks_;
+    /** 不可见或不活动时节省资源的策略 */
+    VisibilityPolicy visibility_;
+    VisibilityState visibility_state_;
+    /** 已应用到 webview 的状态 */
+    bool web_low_memory_ = false;
+    bool web_suspended_ = false;
+    /** 暂停期间丢弃的脚本数量, 恢复时通知窗口 */
+    std::size_t js_dropped_ = 0;
+    Timer visibility_timer_;
+#if CXXUI_HAS_COROUTINE
+    WebCreatedAwaiter* web_waiters_ = nullptr;
+#endif
+    /** 在消息循环中恢复等待 webview 创建的协程 */
+    void ResumeWebWaiters([[maybe_unused]] HRESULT result) {
+#if CXXUI_HAS_COROUTINE
+        auto waiter = std::exchange(web_waiters_, nullptr);
+        while (waiter) {
+            auto next = waiter->next_waiter;
+            waiter->result = result;
+            GetUiQueue().Post(*waiter);
+            waiter = next;
+        }
+#endif
+    }
+    /** 本帧的脚本批次, 第一个脚本请求下一帧 */
+    ScriptBatch& GetJsBatch() {
+        if (!this->hwnd_) {
+            throw WindowError(ERROR_INVALID_HANDLE, "Window is not created!");
+        }
+        // 暂停期间只累积, 恢复时再请求帧
+        if (visibility_state_.paused) {
+            DropPausedJs();
+        } else if (js_batch_.IsEmpty()) {
+            this->RequestFrame();
+        }
+        return js_batch_;
+    }
+    /** 长时间隐藏时不再无限累积脚本和消息, 恢复时由窗口重新同步页面 */
+    void DropPausedJs() {
+        std::size_t limit = visibility_.GetOptions().paused_script_limit;
+        if (std::size_t dropped = js_msgs_.DropIfOver(js_batch_, limit)) {
+            if (js_dropped_ == 0) {
+                CXXUI_LOG_WARN("Paused scripts exceeded the limit and were dropped", 0,
+                               std::to_string(dropped));
+            }
+            js_dropped_ += dropped;
+        }
+    }
+    static void ExecuteBatch(ICoreWebView2* webview, const std::vector<std::string>& scripts) {
+        for (const std::string& script : scripts) {
+            HRESULT hr = webview->ExecuteScript(U82W(script).c_str(), nullptr);
+            if (FAILED(hr)) {
+                CXXUI_LOG_WARN("ExecuteScript failed", hr);
+            }
+        }
+    }
     ComPtr<ICoreWebView2> GetWebView() const {
         ComPtr<ICoreWebView2> webview;
         HRESULT hr = ctrl_->get_CoreWebView2(&webview);
@@ -273,6 +757,7 @@ protected:
                 ctrl_->put_IsVisible(true);  // webview默认可见, 隐藏操作由父窗口控制
                 Focus();                     // 创建 webview 后默认获取焦点, 跟其他控件/窗口对齐
                 InitSetting();               // 其他的默认设置
+                InitScripts();               // 创建前注册的函数
                 PostMessageW(this->hwnd_, UM_WEB_CREATED, S_OK, 0);  // 发送创建完成的消息
             });
         if (FAILED(hr)) {
@@ -281,51 +766,215 @@ protected:
     }
     void InitSetting() {
         ComPtr<ICoreWebView2> webview;
-        if (FAILED(ctrl_->get_CoreWebView2(&webview))) {
+        HRESULT hr = ctrl_->get_CoreWebView2(&webview);
+        if (FAILED(hr)) {
+            CXXUI_LOG_ERROR("get_CoreWebView2 failed", hr);
             return;
         }
         // 统一web端收发消息接口
-        webview->AddScriptToExecuteOnDocumentCreated(
-            LR"JS(
-window.SendCppMsg = window.chrome.webview.postMessage;
-window.SetCppMsgHandler = function (handler) {
-    window.chrome.webview.addEventListener('message', (e) => handler(e.data));
-};
-)JS",
-            nullptr);
+        hr = webview->AddScriptToExecuteOnDocumentCreated(U82W(kJsBridgeScript).c_str(), nullptr);
+        if (FAILED(hr)) {
+            CXXUI_LOG_ERROR("AddScriptToExecuteOnDocumentCreated failed", hr, "message api");
+        }
+        // cxxui::Store 的状态副本, 按 RFC 6902 补丁更新
+        hr = webview->AddScriptToExecuteOnDocumentCreated(U82W(kStoreScript).c_str(), nullptr);
+        if (FAILED(hr)) {
+            CXXUI_LOG_ERROR("AddScriptToExecuteOnDocumentCreated failed", hr, "store runtime");
+        }
 
         ComPtr<ICoreWebView2Settings> settings;
-        if (FAILED(webview->get_Settings(&settings))) {
+        hr = webview->get_Settings(&settings);
+        if (FAILED(hr)) {
+            CXXUI_LOG_ERROR("get_Settings failed", hr);
             return;
         }
         ComPtr<ICoreWebView2Settings9> settings9;
-        if (FAILED(settings.As<ICoreWebView2Settings9>(&settings9))) {
+        hr = settings.As<ICoreWebView2Settings9>(&settings9);
+        if (FAILED(hr)) {
+            // 旧版本的运行时不支持
+            CXXUI_LOG_INFO("ICoreWebView2Settings9 is not supported", hr);
             return;
         }
         // 让 js 可以自行控制拖拽区域
-        settings9->put_IsNonClientRegionSupportEnabled(true);
+        hr = settings9->put_IsNonClientRegionSupportEnabled(true);
+        if (FAILED(hr)) {
+            CXXUI_LOG_WARN("put_IsNonClientRegionSupportEnabled failed", hr);
+        }
         // 发布版本禁用浏览器的各种快捷键
 #ifndef _DEBUG
-        settings9->put_AreBrowserAcceleratorKeysEnabled(false);
+        hr = settings9->put_AreBrowserAcceleratorKeysEnabled(false);
+        if (FAILED(hr)) {
+            CXXUI_LOG_WARN("put_AreBrowserAcceleratorKeysEnabled failed", hr);
+        }
 #endif
     }
+    void InitVisibility() {
+        auto now = VisibilityPolicy::Clock::now();
+        visibility_.SetVisible(IsWindowVisible(this->hwnd_), now);
+        visibility_.SetMinimized(IsIconic(this->hwnd_), now);
+        visibility_.SetActive(GetActiveWindow() == this->hwnd_, now);
+        WebFactory::GetInstance().AddMemoryHandler(this->hwnd_, [this](bool pressure) {
+            visibility_.SetMemoryPressure(pressure);
+            if (pressure && js_batch_.IsEmpty()) {
+                js_batch_ = ScriptBatch{};  // 释放脚本缓冲区
+            }
+            ApplyVisibility();
+        });
+        ApplyVisibility();
+    }
+    void InitScripts() {
+        ComPtr<ICoreWebView2> webview;
+        HRESULT hr = ctrl_->get_CoreWebView2(&webview);
+        if (FAILED(hr)) {
+            CXXUI_LOG_ERROR("get_CoreWebView2 failed", hr);
+            return;
+        }
+        for (JsFunctionId id = 0; id < scripts_.GetCount(); ++id) {
+            hr = webview->AddScriptToExecuteOnDocumentCreated(
+                U82W(scripts_.GetDefinition(id)).c_str(), nullptr);
+            if (FAILED(hr)) {
+                CXXUI_LOG_ERROR("AddScriptToExecuteOnDocumentCreated failed", hr,
+                                std::to_string(id));
+            }
+        }
+    }
+    void OnFrameEnd() {
+        if (visibility_state_.paused) {
+            Window<Derived>::OnFrameEnd();
+            return;
+        }
+        if (!frame_hooks_.empty()) {
+            // 函数中可能关闭窗口并清空列表
+            auto hooks = frame_hooks_;
+            for (const auto& hook : hooks) {
+                hook();
+            }
+        }
+        FlushJs();
+        Window<Derived>::OnFrameEnd();
+    }
+    /** 按当前的可见性计算资源状态并应用, 在下一个状态变化的时间点再次计算 */
+    void ApplyVisibility() {
+        auto now = VisibilityPolicy::Clock::now();
+        VisibilityState state = visibility_.Update(now);
+        bool resumed = visibility_state_.paused && !state.paused;
+        visibility_state_ = state;
+        if (ctrl_) {
+            ApplyWebResources(state);
+        }
+        if (resumed) {
+            // 提交暂停期间累积的脚本和状态
+            this->RequestFrame();
+            if (std::size_t dropped = std::exchange(js_dropped_, 0)) {
+                // 丢弃的脚本中可能有函数定义, 重新定义所有已注册的函数
+                for (JsFunctionId id = 0; id < scripts_.GetCount(); ++id) {
+                    js_batch_.Add(scripts_.GetDefinition(id));
+                }
+                static_cast<Derived*>(this)->OnJsDropped(dropped);
+            }
+        }
+        if (auto next = visibility_.GetNextDeadline(now); next) {
+            auto timeout = std::chrono::ceil<std::chrono::milliseconds>(*next - now);
+            visibility_timer_.Start(timeout, [this] { ApplyVisibility(); });
+        } else {
+            visibility_timer_.Stop();
+        }
+    }
+    void ApplyWebResources(const VisibilityState& state) {
+        ComPtr<ICoreWebView2> webview;
+        if (FAILED(ctrl_->get_CoreWebView2(&webview))) {
+            return;
+        }
+        if (state.low_memory != web_low_memory_) {
+            web_low_memory_ = state.low_memory;
+            ComPtr<ICoreWebView2_19> webview19;
+            if (SUCCEEDED(webview.As(&webview19))) {
+                HRESULT hr = webview19->put_MemoryUsageTargetLevel(
+                    state.low_memory ? COREWEBVIEW2_MEMORY_USAGE_TARGET_LEVEL_LOW
+                                     : COREWEBVIEW2_MEMORY_USAGE_TARGET_LEVEL_NORMAL);
+                if (FAILED(hr)) {
+                    CXXUI_LOG_WARN("put_MemoryUsageTargetLevel failed", hr);
+                }
+            }
+        }
+        if (state.suspended != web_suspended_) {
+            web_suspended_ = state.suspended;
+            ComPtr<ICoreWebView2_3> webview3;
+            if (FAILED(webview.As(&webview3))) {
+                return;
+            }
+            if (state.suspended) {
+                // 只有不可见的 webview 才能挂起
+                ctrl_->put_IsVisible(FALSE);
+                webview3->TrySuspend(
+                    Callback<ICoreWebView2TrySuspendCompletedHandler>(
+                        [](HRESULT result, BOOL suspended) -> HRESULT {
+                            if (FAILED(result) || !suspended) {
+                                CXXUI_LOG_INFO("TrySuspend did not suspend", result);
+                            }
+                            return S_OK;
+                        })
+                        .Get());
+            } else {
+                ctrl_->put_IsVisible(TRUE);
+                HRESULT hr = webview3->Resume();
+                if (FAILED(hr)) {
+                    CXXUI_LOG_WARN("Resume failed", hr);
+                }
+            }
+        }
+    }
     void OnSize(const SizeEvent& event) {
         if (ctrl_) {
             ctrl_->put_Bounds({0, 0, event.GetWidth(), event.GetHeight()});
         }
         Window<Derived>::OnSize(event);
     }
-    std::optional<LRESULT> OnWin32Msg(UINT msg, WPARAM wp, LPARAM lp) {
+    void OnFrameworkMsg(UINT msg, WPARAM wp, LPARAM lp) override final {
         switch (msg) {
             case UM_WEB_CREATED:
+                ResumeWebWaiters(static_cast<HRESULT>(wp));
                 if (FAILED(wp)) {
+                    js_batch_.Take();
+                    js_msgs_.Take();
                     WindowError err{static_cast<long>(wp), "CreateWebView failed!"};
                     static_cast<Derived*>(this)->OnWebCreated(err);
                 } else {
+                    InitVisibility();
+                    FlushJs();  // 提交创建完成前的脚本
                     static_cast<Derived*>(this)->OnWebCreated(std::nullopt);
                 }
+                break;
+            case WM_DESTROY:
+                ResumeWebWaiters(E_ABORT);
+                js_batch_.Take();
+                js_msgs_.Take();
+                js_dropped_ = 0;
+                frame_hooks_.clear();
+                visibility_timer_.Stop();
+                WebFactory::GetInstance().RemoveMemoryHandler(this->hwnd_);
+                break;
+            case WM_ACTIVATE:
+                if (visibility_.SetActive(LOWORD(wp) != WA_INACTIVE,
+                                          VisibilityPolicy::Clock::now())) {
+                    ApplyVisibility();
+                }
+                break;
+            case WM_SHOWWINDOW:
+                if (visibility_.SetVisible(wp != FALSE, VisibilityPolicy::Clock::now())) {
+                    ApplyVisibility();
+                }
+                break;
+            case WM_SIZE:
+                if (wp == SIZE_MINIMIZED || wp == SIZE_RESTORED || wp == SIZE_MAXIMIZED) {
+                    if (visibility_.SetMinimized(wp == SIZE_MINIMIZED,
+                                                 VisibilityPolicy::Clock::now())) {
+                        ApplyVisibility();
+                    }
+                }
+                break;
         }
-        return Window<Derived>::OnWin32Msg(msg, wp, lp);
+        Window<Derived>::OnFrameworkMsg(msg, wp, lp);
     }
 };
 
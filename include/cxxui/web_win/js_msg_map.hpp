@@ -2,11 +2,32 @@
 
 #include <string>
 #include <functional>
+#include <cstdint>
+#include <map>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 #include <nlohmann/json.hpp>
 
+#include <cxxui/core/expected.hpp>
+#include <cxxui/core/task.hpp>
+#include <cxxui/core/detail/monotonic_arena.hpp>
+#include <cxxui/web_win/impl/detail/json_parse.hpp>
+
 namespace cxxui {
 
 using json = nlohmann::json;
+/**
+ * @brief 在当前消息的内存池上分配的字符串
+ */
+using ArenaString = std::basic_string<char, std::char_traits<char>, detail::ArenaAllocator<char>>;
+/**
+ * @brief 在当前消息的内存池上分配的 json, 用于 JsMsgMap<Derived, ArenaJson>
+ * @details 每条消息处理完成后内存池整体重置，请求和响应不再逐个分配和释放堆内存。
+ *   只能在响应函数中使用，不能保存到响应函数之外，也不能传给其他线程。
+ */
+using ArenaJson = nlohmann::basic_json<std::map, std::vector, ArenaString, bool, std::int64_t,
+                                       std::uint64_t, double, detail::ArenaAllocator>;
 
 /**
  * @brief 响应码
@@ -30,14 +51,70 @@ enum class JsMsgError {
     EXEC_ERROR,
 };
 
-template <typename Derived>
+/**
+ * @brief 响应函数返回的错误, 对应响应中的 code 和 error
+ */
+struct JsMsgFailure {
+    JsMsgError code = JsMsgError::EXEC_ERROR;
+    std::string error;
+};
+/**
+ * @brief 响应函数的结果, 响应函数可以返回错误而不抛出异常
+ */
+template <typename Json>
+using BasicJsMsgResult = Expected<Json, JsMsgFailure>;
+using JsMsgResult = BasicJsMsgResult<json>;
+/**
+ * @brief 响应函数
+ */
+template <typename Json>
+using BasicJsMsgFunction = std::function<BasicJsMsgResult<Json>(Json&)>;
+using JsMsgFunction = BasicJsMsgFunction<json>;
+
+/**
+ * @brief 创建响应函数返回的错误, 示例：return FailJsMsg("用户名不存在");
+ */
+inline Unexpected<JsMsgFailure> FailJsMsg(std::string error,
+                                          JsMsgError code = JsMsgError::EXEC_ERROR) {
+    return Unexpected{JsMsgFailure{code, std::move(error)}};
+}
+
+namespace detail {
+/** 是否在消息内存池上分配 */
+template <typename Json>
+inline constexpr bool kIsArenaJson =
+    std::is_same_v<typename Json::allocator_type, ArenaAllocator<Json>>;
+/** 不使用内存池时什么都不做 */
+struct NullArenaScope {
+    NullArenaScope() noexcept {}
+};
+/** 处理一条消息期间的内存池作用域 */
+template <typename Json>
+using JsMsgArenaScope = std::conditional_t<kIsArenaJson<Json>, ArenaScope, NullArenaScope>;
+/** 是否为协程响应函数的返回值 */
+template <typename Result, typename Json>
+inline constexpr bool kIsJsMsgTask =
+#if CXXUI_HAS_COROUTINE
+    std::is_same_v<Result, Task<Json>>;
+#else
+    false;
+#endif
+}  // namespace detail
+
+template <typename Derived, typename Json = json>
 class JsMsgHandler {
 protected:
+    using Result = BasicJsMsgResult<Json>;
     /**
      * @brief 处理请求数据的处理函数
+     * @details 请求格式错误、找不到响应函数、响应函数返回错误都不会抛出异常，
+     * 只有响应函数抛出的异常才需要捕获。
+     * 请求中的其他字段原样返回，js 的 cxxui.call 按 __cxxui_id 找到响应对应的请求，
+     * 协程响应函数的响应可以不按请求顺序返回
      *
      * @param msg js 传入的 json 字符串，示例：
     {
+        "__cxxui_id": 1,
         "url": "/user/login",
         "data": {
             "username": "admin",
@@ -46,59 +123,149 @@ protected:
     }
      * @return std::string 返回给 js 的响应 json 字符串，示例：
     {
+         "__cxxui_id": 1,
          "code": 3,
          "error": "用户名不存在",
          "data": ...
     }
      */
     std::string Handle(std::string msg) const noexcept {
-        json ctx;
-        std::string url;
-        try {
-            ctx = json::parse(std::move(msg));
-            url = ctx.at("url").get<std::string>();
-        } catch (const std::exception& e) {
-            ctx["code"] = static_cast<int>(JsMsgError::INVALID_REQ);
-            ctx["error"] = e.what();
-            return ctx.dump();
+        // 先于 ctx 构造, ctx 释放后才重置内存池
+        detail::JsMsgArenaScope<Json> scope;
+        Json ctx;
+        auto url = Parse(msg, ctx);
+        if (!url) {
+            return Reply(ctx, Unexpected{std::move(url).GetError()});
+        }
+        return Dispatch(ctx, *url);
+    }
+    /** 解析请求, 返回请求的 url, 指向 ctx 中的字符串 */
+    static Expected<std::string_view, JsMsgFailure> Parse(std::string_view msg,
+                                                          Json& ctx) noexcept {
+        auto parsed = detail::ParseJson(msg, ctx);
+        if (!parsed) {
+            ctx = Json::object();
+            return FailJsMsg(std::move(parsed).GetError(), JsMsgError::INVALID_REQ);
+        }
+        auto it = ctx.find("url");
+        if (it == ctx.end() || !it->is_string()) {
+            auto failure = FailUrl(ctx);
+            if (!ctx.is_object()) {
+                ctx = Json::object();
+            }
+            return failure;
+        }
+        const auto& url = it->template get_ref<const typename Json::string_t&>();
+        return std::string_view{url.data(), url.size()};
+    }
+    /** 请求中没有字符串 url 时的错误, 不是对象的请求按没有 url 处理 */
+    static Unexpected<JsMsgFailure> FailUrl(const Json& ctx) noexcept {
+        auto it = ctx.find("url");
+        if (it == ctx.end()) {
+            return FailJsMsg("missing url", JsMsgError::INVALID_REQ);
         }
-        std::function<json(json&)> func;
+        return FailJsMsg(std::string{"url must be a string, but is "} + it->type_name(),
+                         JsMsgError::INVALID_REQ);
+    }
+    /** 调用 url 对应的响应函数, 返回响应 */
+    std::string Dispatch(Json& ctx, std::string_view url) const noexcept {
+        return Reply(ctx, Invoke(ctx, url));
+    }
+    /** 调用 url 对应的响应函数 */
+    Result Invoke(Json& ctx, std::string_view url) const noexcept {
+        const auto* derived = static_cast<const Derived*>(this);
+        using Found = decltype(derived->FindHandler(std::declval<const std::string&>()));
+        if constexpr (std::is_pointer_v<Found>) {
+            const auto* func = derived->FindHandler(url);
+            if (!func) {
+                return FailJsMsg("Method not found!", JsMsgError::NO_METHOD);
+            }
+            return Call(*func, ctx["data"]);
+        } else {
+            // 兼容找不到时抛出异常的 FindHandler
+            Found func;
+            try {
+                func = derived->FindHandler(std::string{url});
+            } catch (const std::exception& e) {
+                return FailJsMsg(e.what(), JsMsgError::NO_METHOD);
+            }
+            return Call(func, ctx["data"]);
+        }
+    }
+    /** 调用响应函数, 响应函数抛出的异常转换为错误 */
+    template <typename Func>
+    static Result Call(const Func& func, Json& data) noexcept {
         try {
-            func = static_cast<const Derived*>(this)->FindHandler(url);
+            return func(data);
         } catch (const std::exception& e) {
-            ctx["code"] = static_cast<int>(JsMsgError::NO_METHOD);
-            ctx["error"] = e.what();
-            return ctx.dump();
+            return FailJsMsg(e.what());
+        } catch (...) {
+            return FailJsMsg("unknown exception");
         }
-        try {
-            auto data = func(ctx["data"]);
-            ctx["data"] = data;
+    }
+    /** 把结果写入请求, 返回响应 */
+    static std::string Reply(Json& ctx, Result result) noexcept {
+        if (result) {
+            ctx["data"] = std::move(*result);
             ctx["code"] = static_cast<int>(JsMsgError::SUCCESS);
-        } catch (const std::exception& e) {
-            ctx["code"] = static_cast<int>(JsMsgError::EXEC_ERROR);
-            ctx["error"] = e.what();
-            return ctx.dump();
+        } else {
+            const std::string& error = result.GetError().error;
+            ctx["code"] = static_cast<int>(result.GetError().code);
+            ctx["error"] = typename Json::string_t{error.begin(), error.end()};
+        }
+        // 响应函数返回的字符串可能不是合法的 UTF-8, 替换后不会抛出异常
+        auto reply = ctx.dump(-1, ' ', false, Json::error_handler_t::replace);
+        if constexpr (std::is_same_v<decltype(reply), std::string>) {
+            return reply;
+        } else {
+            return std::string{reply.data(), reply.size()};
         }
-        return ctx.dump();
     }
 };
 
 namespace detail {
+template <typename Json>
 class DefaultJsMsgMap;
-}
-template <typename Derived = detail::DefaultJsMsgMap>
-class JsMsgMap : public JsMsgHandler<Derived> {
-    friend class JsMsgHandler<Derived>;
+}  // namespace detail
+template <typename Derived = detail::DefaultJsMsgMap<json>, typename Json = json>
+class JsMsgMap : public JsMsgHandler<Derived, Json> {
+    friend class JsMsgHandler<Derived, Json>;
+    using Result = BasicJsMsgResult<Json>;
 
 public:
     /**
      * @brief 绑定请求的url及其响应函数
+     * @details 响应函数可以返回 json 或 JsMsgResult，也可以是返回 Task<json> 的协程响应函数。
+     * 返回类型声明为 JsMsgResult 时可以用 FailJsMsg 返回错误而不抛出异常
      *
      * @param url 需要绑定的 url
      * @param func 响应函数，传入请求json数据，返回响应json数据
      */
-    void bind(std::string url, std::function<json(json&)> func) {
-        handlers_[std::move(url)] = std::move(func);
+    template <typename Func>
+    void bind(std::string url, Func func) {
+        using FuncResult = std::invoke_result_t<Func&, Json&>;
+        if constexpr (detail::kIsJsMsgTask<FuncResult, Json>) {
+            // 协程挂起后消息内存池可能已经重置
+            static_assert(!detail::kIsArenaJson<Json>, "ArenaJson 不支持协程响应函数");
+#if CXXUI_HAS_COROUTINE
+            // 协程响应函数需要通过 GetAsyncHandler 设置到 SetJsMsgHandler
+            handlers_.erase(url);
+            async_handlers_[std::move(url)] = std::move(func);
+#endif
+        } else {
+#if CXXUI_HAS_COROUTINE
+            async_handlers_.erase(url);
+#endif
+            if constexpr (std::is_same_v<FuncResult, Result>) {
+                handlers_[std::move(url)] = std::move(func);
+            } else {
+                static_assert(std::is_convertible_v<FuncResult, Json>,
+                              "响应函数需要返回 json、JsMsgResult 或 Task<json>");
+                handlers_[std::move(url)] = [func = std::move(func)](Json& data) mutable {
+                    return Result{func(data)};
+                };
+            }
+        }
     }
     /**
      * @brief 获取js请求的处理函数，用于设置SetJsMsgHandler
@@ -108,21 +275,71 @@ public:
     std::function<std::string(std::string)> GetHandler() const noexcept {
         return [this](std::string msg) { return this->Handle(std::move(msg)); };
     }
+#if CXXUI_HAS_COROUTINE
+    /**
+     * @brief 获取支持协程响应函数的js请求处理函数，用于设置SetJsMsgHandler
+     *
+     * @return std::function<void(std::string, std::function<void(std::string)>)>
+     */
+    std::function<void(std::string, std::function<void(std::string)>)> GetAsyncHandler()
+        const noexcept {
+        return [this](std::string msg, std::function<void(std::string)> reply) {
+            this->HandleAsync(std::move(msg), std::move(reply));
+        };
+    }
+#endif
 
 protected:
-    std::map<std::string, std::function<json(json&)>> handlers_;
-    std::function<json(json&)> FindHandler(const std::string& url) const {
-        auto it = handlers_.find(url);
-        if (it == handlers_.end()) {
-            throw std::runtime_error("Method not found!");
+    std::map<std::string, BasicJsMsgFunction<Json>, std::less<>> handlers_;
+#if CXXUI_HAS_COROUTINE
+    std::map<std::string, std::function<Task<Json>(Json&)>, std::less<>> async_handlers_;
+    /** 处理请求, 协程响应函数完成后通过 reply 返回响应 */
+    void HandleAsync(std::string msg, std::function<void(std::string)> reply) const {
+        if constexpr (detail::kIsArenaJson<Json>) {
+            reply(this->Handle(std::move(msg)));
         } else {
-            return it->second;
+            Json ctx;
+            auto url = this->Parse(msg, ctx);
+            if (!url) {
+                reply(this->Reply(ctx, Unexpected{std::move(url).GetError()}));
+                return;
+            }
+            auto it = async_handlers_.find(*url);
+            if (it == async_handlers_.end()) {
+                reply(this->Dispatch(ctx, *url));
+                return;
+            }
+            Spawn(RunAsync(std::move(ctx), it->second, std::move(reply)));
+        }
+    }
+    static Task<void> RunAsync(Json ctx,
+                               std::function<Task<Json>(Json&)> func,
+                               std::function<void(std::string)> reply) {
+        Result result = Json{};
+        try {
+            result = co_await func(ctx["data"]);
+        } catch (const std::exception& e) {
+            result = FailJsMsg(e.what());
+        } catch (...) {
+            result = FailJsMsg("unknown exception");
         }
+        reply(JsMsgMap::Reply(ctx, std::move(result)));
+    }
+#endif
+    /** 查找 url 对应的响应函数, 找不到时返回 nullptr */
+    const BasicJsMsgFunction<Json>* FindHandler(std::string_view url) const noexcept {
+        auto it = handlers_.find(url);
+        return it == handlers_.end() ? nullptr : &it->second;
     }
 };
 
 namespace detail {
-class DefaultJsMsgMap : public JsMsgMap<DefaultJsMsgMap> {};
+template <typename Json>
+class DefaultJsMsgMap : public JsMsgMap<DefaultJsMsgMap<Json>, Json> {};
 }  // namespace detail
+/**
+ * @brief 在每条消息的内存池上构造请求和响应的 JsMsgMap, 响应函数传入和返回 ArenaJson
+ */
+using ArenaJsMsgMap = JsMsgMap<detail::DefaultJsMsgMap<ArenaJson>, ArenaJson>;
 
-}  // namespace cxxui
\ No newline at end of file
+}  // namespace cxxui
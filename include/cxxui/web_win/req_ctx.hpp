@@ -1,9 +1,15 @@
 #pragma once
+#include <memory>
+
 #include "impl/req_ctx.inl"
 
 namespace cxxui {
 
-class RequestContext : public detail::RequestContextBase {
+/** 分块读取请求内容, 见 RequestContext::GetBody */
+using BodyReader = detail::BodyReader;
+
+class RequestContext : public detail::RequestContextBase,
+                       public std::enable_shared_from_this<RequestContext> {
     using Base = detail::RequestContextBase;
     using Base::RequestContextBase;
 
@@ -14,6 +20,69 @@ public:
      * @return std::string url字符串
      */
     std::string GetUrl() const { return Base::GetUrl(); };
+    /**
+     * @brief 获取请求方法，比如 GET、POST
+     */
+    std::string_view GetMethod() const { return Base::GetMethod(); }
+    /**
+     * @brief 获取解码后的路径，比如 http://localhost/a%20b.html?x=1 的路径为 /a b.html
+     * @details url 在第一次访问时解析，返回的 string_view 在 RequestContext 销毁前有效，下同
+     */
+    std::string_view GetPath() const { return Base::GetPath(); }
+    /**
+     * @brief 获取解码后的所有查询参数，按出现顺序
+     *
+     * @return 参数名和值
+     */
+    const std::vector<std::pair<std::string_view, std::string_view>>& GetQueries() const {
+        return Base::GetQueries();
+    }
+    /**
+     * @brief 获取第一个名为 name 的查询参数，不存在时返回 std::nullopt
+     */
+    std::optional<std::string_view> GetQuery(std::string_view name) const {
+        return Base::GetQuery(name);
+    }
+    /**
+     * @brief 获取所有请求头，第一次访问时加载
+     *
+     * @return 请求头名和值
+     */
+    const std::vector<std::pair<std::string_view, std::string_view>>& GetHeaders() const {
+        return Base::GetHeaders();
+    }
+    /**
+     * @brief 获取名为 name 的请求头，不区分大小写，不存在时返回 std::nullopt
+     */
+    std::optional<std::string_view> GetHeader(std::string_view name) const {
+        return Base::GetHeader(name);
+    }
+    /**
+     * @brief 获取分块读取请求内容的对象，用于 POST、PUT 上传的文件和表单
+     * @details 每次读取 chunk_size 字节，处理完一块再读下一块，上传多大都只占用一块的内存：
+     *   reader.ForEach([&](std::string_view chunk) { file.write(chunk.data(), chunk.size()); });
+     *   各个 BodyReader 共享同一个流，只应读取一次。没有内容时直接读到结尾。
+     *   读取在调用的线程同步进行：流是 webview 的 COM 对象，只能在处理函数所在的UI线程读取，
+     *   不能交给 Executor 在后台读取，读取期间消息循环被阻塞。耗时的是处理时，
+     *   可以读出每块后把处理投递到 Executor，用 Defer 在处理完成后再响应。
+     *
+     * @param chunk_size 每块的字节数，默认 64KB
+     */
+    BodyReader GetBody(std::size_t chunk_size = BodyReader::kDefaultChunkSize) const {
+        return Base::GetBody(chunk_size);
+    }
+    /**
+     * @brief 推迟响应，处理函数返回后请求继续等待，直到返回的对象和它的副本全部释放
+     * @details 用于在后台准备响应内容，SetResponse 等函数仍然只能在UI线程调用：
+     *   auto deferred = ctx.Defer();
+     *   Executor::GetDefault().Submit([] { return Load(); }).ThenOnUi([deferred](std::string s) {
+     *       deferred->SetResponse(s.data(), s.size());
+     *   });
+     *   在其他线程释放时回到UI线程完成请求。完成时没有设置响应的请求按未拦截处理。
+     *   UI线程退出后才在其他线程释放时，请求和 deferral 不能离开UI线程释放，会被有意泄漏。
+     *   失败时抛出 WindowError
+     */
+    std::shared_ptr<RequestContext> Defer() { return Base::Defer(shared_from_this()); }
     /**
      * @brief 设置 headers 字符串
      *
@@ -0,0 +1,163 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include <cxxui/web_win.hpp>
+#include "impl/detail/patch_log.hpp"
+
+namespace cxxui {
+
+using json = nlohmann::json;
+
+/**
+ * @brief 保存在 C++ 端的应用状态, 以 RFC 6902 补丁同步到页面
+ * @details 修改通过 json pointer 路径进行，每次修改直接记录为补丁操作。同一帧内的修改合并，
+ *   在窗口的帧结束时生成一次补丁，和本帧的其他脚本一起提交到所有关联的窗口。只能在UI线程使用。
+ *
+ *   js 端：window.cxxui.store.get(name) 获取状态，
+ *   window.cxxui.store.subscribe(name, (state, patch) => {}) 监听变化
+ */
+class Store {
+public:
+    explicit Store(json state = json::object())
+        : core_(std::make_shared<Core>(std::move(state))) {}
+
+    /** 获取整个状态 */
+    const json& Get() const noexcept { return core_->log.Get(); }
+    /**
+     * @brief 获取路径上的值
+     *
+     * @param path json pointer, 如 "/user/name", 格式错误或不存在时抛出 std::out_of_range
+     */
+    const json& Get(std::string_view path) const { return core_->log.Get(path); }
+    bool Contains(std::string_view path) const { return core_->log.Contains(path); }
+    /**
+     * @brief 设置值, 对象成员不存在时添加, 数组下标等于长度时追加
+     *
+     * @param path json pointer, 格式错误、父节点不存在或数组下标无效时抛出 std::out_of_range
+     * @param value 新的值
+     */
+    Store& Set(std::string_view path, json value) {
+        core_->log.Set(path, std::move(value));
+        core_->MarkDirty();
+        return *this;
+    }
+    /**
+     * @brief 在数组中插入值
+     *
+     * @param path 数组元素的 json pointer, 最后一段为下标或 "-"(末尾), 无效时抛出 std::out_of_range
+     * @param value 插入的值
+     */
+    Store& Insert(std::string_view path, json value) {
+        core_->log.Insert(path, std::move(value));
+        core_->MarkDirty();
+        return *this;
+    }
+    /**
+     * @brief 删除值, 路径不存在时抛出 std::out_of_range
+     */
+    Store& Remove(std::string_view path) {
+        core_->log.Remove(path);
+        core_->MarkDirty();
+        return *this;
+    }
+    /**
+     * @brief 替换整个状态
+     */
+    Store& Reset(json state) {
+        core_->log.Reset(std::move(state));
+        core_->MarkDirty();
+        return *this;
+    }
+    /**
+     * @brief 关联窗口, 立即发送完整状态, 之后在窗口的每一帧结束时发送补丁
+     * @details 页面跳转后状态副本丢失，页面加载完成后调用 Resync 重新发送
+     *
+     * @param win 窗口, 窗口销毁后自动取消关联
+     * @param name js 端的状态名
+     */
+    template <typename Derived>
+    void Attach(WebWindow<Derived>& win, std::string name = "default") {
+        // 先把未提交的补丁发给已关联的窗口, 新窗口只需要完整状态
+        core_->Flush();
+        auto sink = std::make_shared<Sink>();
+        sink->name = std::move(name);
+        sink->request_frame = [&win] { win.RequestFrame(); };
+        sink->run_js = [&win](std::string_view js) { win.RunJs(js); };
+        core_->sinks.push_back(sink);
+        // 窗口持有 sink, 窗口销毁后这里的弱引用失效
+        win.AddFrameHook([core = core_, sink] { core->Flush(); });
+        core_->Send(*sink, core_->GetFullPatch());
+    }
+    /**
+     * @brief 立即发送未提交的补丁
+     */
+    void Flush() { core_->Flush(); }
+    /**
+     * @brief 重新发送完整状态到所有关联的窗口
+     * @details 页面跳转后或窗口丢弃了暂停期间的脚本(OnJsDropped)后调用
+     */
+    void Resync() {
+        core_->Flush();
+        std::string patch = core_->GetFullPatch();
+        core_->ForEachSink([this, &patch](Sink& sink) { core_->Send(sink, patch); });
+    }
+
+private:
+    struct Sink {
+        std::string name;
+        std::function<void()> request_frame;
+        std::function<void(std::string_view)> run_js;
+    };
+    struct Core {
+        detail::PatchLog log;
+        std::vector<std::weak_ptr<Sink>> sinks;
+        /** 是否已请求帧, 避免每次修改都请求 */
+        bool requested = false;
+
+        explicit Core(json state)
+            : log(std::move(state)) {}
+        template <typename Fn>
+        void ForEachSink(Fn&& fn) {
+            for (auto it = sinks.begin(); it != sinks.end();) {
+                if (auto sink = it->lock(); sink) {
+                    fn(*sink);
+                    ++it;
+                } else {
+                    it = sinks.erase(it);
+                }
+            }
+        }
+        void MarkDirty() {
+            if (!requested) {
+                requested = true;
+                ForEachSink([](Sink& sink) { sink.request_frame(); });
+            }
+        }
+        void Flush() {
+            requested = false;
+            if (!log.IsDirty()) {
+                return;
+            }
+            std::string patch = log.TakePatch();
+            ForEachSink([this, &patch](Sink& sink) { Send(sink, patch); });
+        }
+        std::string GetFullPatch() const {
+            json op{{"op", "replace"}, {"path", ""}, {"value", log.Get()}};
+            return json::array({std::move(op)}).dump();
+        }
+        void Send(const Sink& sink, const std::string& patch) const {
+            std::string js = "window.cxxui.store.apply(";
+            js.append(json(sink.name).dump()).append(", ").append(patch).append(");");
+            sink.run_js(js);
+        }
+    };
+    std::shared_ptr<Core> core_;
+};
+
+}  // namespace cxxui
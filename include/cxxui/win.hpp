@@ -5,6 +5,9 @@
 #include "win/error.hpp"
 #include "win/options.hpp"
 #include "win/event.hpp"
+#include "win/canvas.hpp"
+#include "win/timer.hpp"
+#include "win/idle.hpp"
 #include "win/impl/win.inl"
 
 namespace cxxui {
@@ -17,7 +20,10 @@ public:
     Window() = default;
     Window(WindowOptions opts) { Create(std::move(opts)); }
     /**
-     * @brief 开始运行消息循环，调用Run函数的窗口会定义为主窗口，主窗口退出则整个进程退出
+     * @brief 开始运行当前线程的消息循环，调用Run函数的窗口会定义为当前线程的主窗口
+     * @details 每个线程可以运行自己的消息循环和窗口，窗口只能在创建它的线程上使用。
+     * 第一个调用Run的线程为主UI线程，它的主窗口关闭则所有UI线程的消息循环结束；
+     * 其他线程的主窗口关闭只结束该线程的消息循环
      *
      * @return int 消息循环结束的退出码
      */
@@ -60,6 +66,29 @@ public:
      * @param icon_id 图标资源ID
      */
     void SetIcon(std::uint32_t icon_id) { Base::SetIcon(icon_id); }
+    /**
+     * @brief 请求下一帧, 在显示器的下一个刷新周期触发一次 OnFrame
+     * @details 需要连续动画时在 OnFrame 中再次调用 RequestFrame
+     */
+    void RequestFrame() { Base::RequestFrame(); }
+    /**
+     * @brief 标记客户区内的矩形需要重绘
+     * @details 下一次 OnPaint 前的多次调用会被合并成少量互不重叠的矩形，通过 PaintEvent::GetDamageRects 获取
+     */
+    void Invalidate(const Rect& rect) { Base::Invalidate(rect); }
+    /**
+     * @brief 标记整个客户区需要重绘
+     */
+    void Invalidate() { Base::Invalidate(); }
+    /**
+     * @brief 获取原生子窗口的根布局节点, 根节点占满窗口客户区
+     * @details 通过 LayoutNode::SetHandle 绑定子窗口句柄，窗口大小变化时自动计算并批量移动子窗口
+     */
+    LayoutNode& GetLayout() { return Base::GetLayout(); }
+    /**
+     * @brief 修改布局后立即计算并应用到子窗口
+     */
+    void UpdateLayout() { Base::UpdateLayout(); }
 
 protected:
     friend class detail::WindowBase<Derived>;
@@ -75,10 +104,46 @@ protected:
      * @brief 窗口激活或失去激活触发的事件
      */
     void OnActivate(const ActivateEvent&) {}
+    /**
+     * @brief 帧时钟事件, 调用 RequestFrame 后按显示器刷新率触发
+     */
+    void OnFrame(const FrameEvent&) {}
+    /**
+     * @brief 鼠标移动的事件
+     */
+    void OnMouseMove(const MouseEvent&) {}
+    /**
+     * @brief 鼠标按键按下的事件
+     */
+    void OnMouseDown(const MouseEvent&) {}
+    /**
+     * @brief 鼠标按键抬起的事件
+     */
+    void OnMouseUp(const MouseEvent&) {}
+    /**
+     * @brief 鼠标滚轮的事件
+     */
+    void OnMouseWheel(const WheelEvent&) {}
+    /**
+     * @brief 键盘按下的事件
+     */
+    void OnKeyDown(const KeyEvent&) {}
+    /**
+     * @brief 键盘抬起的事件
+     */
+    void OnKeyUp(const KeyEvent&) {}
+    /**
+     * @brief 窗口重绘的事件
+     */
+    void OnPaint(const PaintEvent&) {}
+    /**
+     * @brief 窗口所在显示器DPI变化的事件
+     */
+    void OnDpiChanged(const DpiEvent&) {}
 };
 
 /**
- * @brief 退出整个程序
+ * @brief 退出整个程序，结束所有UI线程的消息循环
  *
  * @param exit_code 退出码, 程序执行的返回值， 默认为 0
  */
@@ -0,0 +1,59 @@
+#pragma once
+#include "event.hpp"
+#include "impl/canvas.inl"
+
+namespace cxxui {
+
+/**
+ * @brief 软件绘制的画布, 持有一块持久的32位像素缓冲区, 在 OnPaint 中一次性提交到窗口
+ * @details 像素格式为预乘alpha的BGRA，填充、复制、混合和颜色转换按编译选项使用 AVX2/SSE2/NEON 实现。
+ */
+class Canvas : public detail::CanvasBase {
+public:
+    /**
+     * @brief 调整画布大小, 一般在 OnSize 中调用, 调整后内容未定义
+     */
+    void Resize(int width, int height) { surface_.Resize(width, height); }
+    int GetWidth() const noexcept { return surface_.GetWidth(); }
+    int GetHeight() const noexcept { return surface_.GetHeight(); }
+    /**
+     * @brief 获取像素缓冲区, 每行 GetWidth() 个像素
+     */
+    std::uint32_t* GetPixels() noexcept { return surface_.GetPixels(); }
+    /**
+     * @brief 用颜色填充整个画布
+     */
+    void Clear(const Color& color) noexcept { surface_.Clear(color); }
+    /**
+     * @brief 填充矩形, 半透明颜色与原内容混合
+     */
+    void FillRect(const Rect& rect, const Color& color) noexcept { surface_.FillRect(rect, color); }
+    /**
+     * @brief 绘制像素块
+     *
+     * @param pos 绘制到的左上角位置
+     * @param pixels 预乘alpha的BGRA像素
+     * @param size 像素块的大小
+     * @param stride 像素块每行的像素数
+     * @param blend 是否与原内容混合, false 时直接覆盖
+     */
+    void DrawPixels(Point pos,
+                    const std::uint32_t* pixels,
+                    Size size,
+                    int stride,
+                    bool blend = true) noexcept {
+        surface_.DrawPixels(pos, pixels, size, stride, blend);
+    }
+    /**
+     * @brief 绘制另一个画布
+     */
+    void DrawCanvas(Point pos, const Canvas& src, bool blend = true) noexcept {
+        surface_.DrawSurface(pos, src.surface_, blend);
+    }
+    /**
+     * @brief 在 OnPaint 中把画布提交到窗口
+     */
+    void Present(const PaintEvent& event) const noexcept { CanvasBase::Present(event); }
+};
+
+}  // namespace cxxui
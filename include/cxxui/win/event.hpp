@@ -31,4 +31,129 @@ public:
     bool IsActive() const { return ActivateEventBase::IsActive(); }
 };
 
+/**
+ * @brief 帧时钟事件，按显示器刷新率触发
+ */
+class FrameEvent : public detail::FrameEventBase {
+public:
+    /**
+     * @brief 获取本帧的时间戳
+     * @details 子类回调函数定义：void OnFrame(const cxxui::FrameEvent&);
+     */
+    std::chrono::steady_clock::time_point GetTimestamp() const {
+        return FrameEventBase::GetTimestamp();
+    }
+    /**
+     * @brief 获取帧间隔
+     */
+    std::chrono::steady_clock::duration GetInterval() const { return FrameEventBase::GetInterval(); }
+};
+
+/**
+ * @brief 鼠标移动、按下、抬起的事件
+ */
+class MouseEvent : public detail::MouseEventBase {
+public:
+    /**
+     * @brief 获取鼠标在客户区的x坐标
+     * @details 子类回调函数定义：
+     *   void OnMouseMove(const cxxui::MouseEvent&);
+     *   void OnMouseDown(const cxxui::MouseEvent&);
+     *   void OnMouseUp(const cxxui::MouseEvent&);
+     */
+    int GetX() const { return MouseEventBase::GetX(); }
+    /**
+     * @brief 获取鼠标在客户区的y坐标
+     */
+    int GetY() const { return MouseEventBase::GetY(); }
+    /**
+     * @brief 获取触发事件的按键, 鼠标移动时为 MouseButton::NONE
+     */
+    MouseButton GetButton() const { return MouseEventBase::GetButton(); }
+    /**
+     * @brief Ctrl键是否按下
+     */
+    bool IsCtrlDown() const { return MouseEventBase::IsCtrlDown(); }
+    /**
+     * @brief Shift键是否按下
+     */
+    bool IsShiftDown() const { return MouseEventBase::IsShiftDown(); }
+};
+
+/**
+ * @brief 鼠标滚轮事件
+ */
+class WheelEvent : public detail::WheelEventBase {
+public:
+    /**
+     * @brief 获取鼠标在客户区的x坐标
+     * @details 子类回调函数定义：void OnMouseWheel(const cxxui::WheelEvent&);
+     */
+    int GetX() const { return WheelEventBase::GetX(); }
+    /**
+     * @brief 获取鼠标在客户区的y坐标
+     */
+    int GetY() const { return WheelEventBase::GetY(); }
+    /**
+     * @brief 获取滚动量, 一格为 120
+     */
+    int GetDelta() const { return WheelEventBase::GetDelta(); }
+    /**
+     * @brief 是否水平滚动
+     */
+    bool IsHorizontal() const { return WheelEventBase::IsHorizontal(); }
+};
+
+/**
+ * @brief 键盘按下、抬起的事件
+ */
+class KeyEvent : public detail::KeyEventBase {
+public:
+    /**
+     * @brief 获取虚拟键码
+     * @details 子类回调函数定义：
+     *   void OnKeyDown(const cxxui::KeyEvent&);
+     *   void OnKeyUp(const cxxui::KeyEvent&);
+     */
+    int GetKeyCode() const { return KeyEventBase::GetKeyCode(); }
+    /**
+     * @brief 是否为按住不放产生的重复按下
+     */
+    bool IsRepeat() const { return KeyEventBase::IsRepeat(); }
+};
+
+/**
+ * @brief 窗口重绘事件
+ */
+class PaintEvent : public detail::PaintEventBase {
+public:
+    /**
+     * @brief 获取需要重绘的区域
+     * @details 子类回调函数定义：void OnPaint(const cxxui::PaintEvent&);
+     */
+    Rect GetDirtyRect() const { return PaintEventBase::GetDirtyRect(); }
+    /**
+     * @brief 获取需要重绘的区域列表, 由 Window::Invalidate 和系统失效的区域合并而成, 互不重叠
+     */
+    const std::vector<Rect>& GetDamageRects() const noexcept {
+        return PaintEventBase::GetDamageRects();
+    }
+};
+
+/**
+ * @brief 窗口所在显示器DPI变化的事件
+ */
+class DpiEvent : public detail::DpiEventBase {
+public:
+    /**
+     * @brief 获取新的DPI
+     * @details 子类回调函数定义：void OnDpiChanged(const cxxui::DpiEvent&);
+     */
+    int GetDpi() const { return DpiEventBase::GetDpi(); }
+    /**
+     * @brief 获取新的缩放比例, 1.0 表示 100%
+     */
+    float GetScale() const { return DpiEventBase::GetScale(); }
+};
+
 }  // namespace cxxui
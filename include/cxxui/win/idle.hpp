@@ -0,0 +1,52 @@
+#pragma once
+#include "impl/idle.inl"
+
+namespace cxxui {
+
+/**
+ * @brief 空闲任务的优先级
+ */
+enum class IdlePriority {
+    LOW = -1,
+    NORMAL = 0,
+    HIGH = 1,
+};
+
+/**
+ * @brief 添加空闲任务，当前线程的消息队列为空时才执行
+ * @details 每个时间片执行到预算用完或有新的输入为止，任务应拆分得足够小。
+ * 等待超过截止时间的任务会提升到最前执行，截止时间默认 HIGH 100ms，NORMAL 1s，LOW 10s。
+ *
+ * @param fn 任务函数
+ * @param priority 优先级
+ * @param timeout 截止时间，0 表示使用优先级的默认值
+ * @return std::uint64_t 任务ID，用于 CancelIdle
+ */
+inline std::uint64_t ScheduleIdle(std::function<void()> fn,
+                                  IdlePriority priority = IdlePriority::NORMAL,
+                                  std::chrono::milliseconds timeout = {}) {
+    int level = static_cast<int>(priority);
+    if (timeout.count() <= 0) {
+        timeout = detail::GetIdleTimeout(level);
+    }
+    return detail::GetIdleScheduler().Schedule(
+        std::move(fn), level, detail::IdleScheduler::Clock::now() + timeout);
+}
+
+/**
+ * @brief 取消未执行的空闲任务
+ *
+ * @return bool 任务存在且被取消返回true
+ */
+inline bool CancelIdle(std::uint64_t id) { return detail::GetIdleScheduler().Cancel(id); }
+
+/**
+ * @brief 设置当前线程每个空闲时间片的执行预算
+ *
+ * @param budget 默认 5ms
+ */
+inline void SetIdleBudget(std::chrono::milliseconds budget) {
+    detail::GetIdleScheduler().SetBudget(budget);
+}
+
+}  // namespace cxxui
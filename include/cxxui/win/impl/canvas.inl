@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <windows.h>
+
+#include <cxxui/core/detail/surface.hpp>
+
+namespace cxxui::detail {
+
+class CanvasBase {
+protected:
+    Surface surface_;
+    /** 把整个缓冲区提交到 hdc, 实际绘制范围由 BeginPaint 的裁剪区域限制 */
+    void Present(HDC hdc) const noexcept {
+        Present(hdc, {0, 0, surface_.GetWidth(), surface_.GetHeight()});
+    }
+    /** 只提交 rect 覆盖的行, 源区域正好是整个行带, 不受DIB行方向影响 */
+    void Present(HDC hdc, const Rect& rect) const noexcept {
+        Rect r{(std::max)(rect.left, 0), (std::max)(rect.top, 0),
+               (std::min)(rect.right, surface_.GetWidth()),
+               (std::min)(rect.bottom, surface_.GetHeight())};
+        if (!hdc || r.IsEmpty()) {
+            return;
+        }
+        int width = surface_.GetWidth();
+        int height = r.Height();
+        BITMAPINFO bmi{};
+        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        bmi.bmiHeader.biWidth = width;
+        bmi.bmiHeader.biHeight = -height;  // 自上而下的行顺序
+        bmi.bmiHeader.biPlanes = 1;
+        bmi.bmiHeader.biBitCount = 32;
+        bmi.bmiHeader.biCompression = BI_RGB;
+        const std::uint32_t* rows =
+            surface_.GetPixels() + static_cast<std::size_t>(r.top) * static_cast<std::size_t>(width);
+        SetDIBitsToDevice(hdc, r.left, r.top, static_cast<DWORD>(r.Width()),
+                          static_cast<DWORD>(height), r.left, 0, 0, static_cast<UINT>(height),
+                          rows, &bmi, DIB_RGB_COLORS);
+    }
+    /** 只提交合并后的脏区域, 没有脏区域信息时提交整个画布 */
+    void Present(const PaintEventBase& event) const noexcept {
+        const auto& rects = event.GetDamageRects();
+        if (rects.empty()) {
+            Present(event.ps_.hdc);
+            return;
+        }
+        for (const Rect& rect : rects) {
+            Present(event.ps_.hdc, rect);
+        }
+    }
+};
+
+}  // namespace cxxui::detail
@@ -0,0 +1,65 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <cxxui/core/detail/placement.hpp>
+
+#include "shcore.hpp"
+
+namespace cxxui::detail {
+
+/**
+ * @brief 进程内共享的显示器布局缓存
+ * @details 第一次使用时枚举所有显示器的区域和DPI，之后直接返回快照，
+ *   收到 WM_DISPLAYCHANGE 或 WM_DPICHANGED 时失效并在下次使用时重新枚举。
+ */
+class MonitorCache {
+public:
+    using Snapshot = std::shared_ptr<const std::vector<MonitorInfo>>;
+
+    static MonitorCache& GetInstance() {
+        static MonitorCache instance;
+        return instance;
+    }
+    /** 获取显示器快照, 快照在失效后仍可安全使用 */
+    Snapshot Get() {
+        std::lock_guard lock(mutex_);
+        if (!snapshot_) {
+            snapshot_ = Enumerate();
+        }
+        return snapshot_;
+    }
+    /** 显示器布局或DPI变化后调用, 下次获取时重新枚举 */
+    void Invalidate() {
+        std::lock_guard lock(mutex_);
+        snapshot_.reset();
+    }
+
+private:
+    std::mutex mutex_;
+    Snapshot snapshot_;
+
+    static BOOL CALLBACK OnMonitor(HMONITOR monitor, HDC, LPRECT, LPARAM param) {
+        auto& monitors = *reinterpret_cast<std::vector<MonitorInfo>*>(param);
+        MONITORINFO mi{};
+        mi.cbSize = sizeof(MONITORINFO);
+        if (GetMonitorInfoW(monitor, &mi)) {
+            monitors.push_back(
+                {{mi.rcMonitor.left, mi.rcMonitor.top, mi.rcMonitor.right, mi.rcMonitor.bottom},
+                 Shcore::GetDpiForMonitor(monitor) / 96.0f});
+        }
+        return TRUE;
+    }
+    static Snapshot Enumerate() {
+        std::vector<MonitorInfo> monitors;
+        EnumDisplayMonitors(nullptr, nullptr, OnMonitor, reinterpret_cast<LPARAM>(&monitors));
+        if (monitors.empty()) {
+            Rect screen{0, 0, GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN)};
+            monitors.push_back({screen, Shcore::GetDpiForMonitor(nullptr) / 96.0f});
+        }
+        return std::make_shared<const std::vector<MonitorInfo>>(std::move(monitors));
+    }
+};
+
+}  // namespace cxxui::detail
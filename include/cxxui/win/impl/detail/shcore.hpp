@@ -1,5 +1,6 @@
 #pragma once
 
+#include <windows.h>
 #include <shellscalingapi.h>
 #ifdef _MSC_VER
     #pragma comment(lib, "shcore.lib")  // GetDpiForMonitor
@@ -10,8 +11,8 @@
 namespace cxxui::detail {
 class Shcore {
 public:
-    UINT GetDpiForMonitor(HMONITOR hmonitor) {
-        if (auto func = lib_.Get<GetDpiForMonitorPtr>("GetDpiForMonitor"); func) {
+    static UINT GetDpiForMonitor(HMONITOR hmonitor) {
+        if (auto func = get_dpi_for_monitor_.Get(); func) {
             UINT dpi_x, dpi_y;
             if (SUCCEEDED(func(hmonitor, MDT_DEFAULT, &dpi_x, &dpi_y))) {
                 return dpi_x;
@@ -21,7 +22,7 @@ public:
     }
 
 private:
-    UINT GetDefaultDpi() const noexcept {
+    static UINT GetDefaultDpi() noexcept {
         HDC hdc = GetDC(nullptr);
         UINT dpi = GetDeviceCaps(hdc, LOGPIXELSX);
         ReleaseDC(nullptr, hdc);
@@ -31,7 +32,8 @@ private:
                                                  MONITOR_DPI_TYPE dpiType,
                                                  UINT* dpiX,
                                                  UINT* dpiY);
-    Library lib_{"shcore.dll"};
+    inline static Symbol<GetDpiForMonitorPtr> get_dpi_for_monitor_{"shcore.dll",
+                                                                   "GetDpiForMonitor"};
 };
 
 }  // namespace cxxui::detail
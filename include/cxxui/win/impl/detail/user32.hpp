@@ -1,5 +1,7 @@
 #pragma once
 
+#include <windows.h>
+
 #include <cxxui/core/detail/library.hpp>
 
 namespace cxxui::detail {
@@ -7,8 +9,8 @@ class User32 {
 public:
     using SetThreadDpiAwarenessContextPtr =
         DPI_AWARENESS_CONTEXT(WINAPI*)(DPI_AWARENESS_CONTEXT dpiContext);
-    void SetThreadDpiAwarenessContext(DPI_AWARENESS_CONTEXT dpiContext) {
-        auto func = lib_.Get<SetThreadDpiAwarenessContextPtr>("SetThreadDpiAwarenessContext");
+    static void SetThreadDpiAwarenessContext(DPI_AWARENESS_CONTEXT dpiContext) {
+        auto func = set_thread_dpi_awareness_context_.Get();
         if (!func) {
             return;
         }
@@ -16,7 +18,8 @@ public:
     }
 
 private:
-    Library lib_{"user32.dll"};
+    inline static Symbol<SetThreadDpiAwarenessContextPtr> set_thread_dpi_awareness_context_{
+        "user32.dll", "SetThreadDpiAwarenessContext"};
 };
 
 }  // namespace cxxui::detail
@@ -1,5 +1,24 @@
 #include <type_traits>
+#include <vector>
 #include <windows.h>
+#include <windowsx.h>
+
+#include <cxxui/core/rect.hpp>
+#include <cxxui/core/detail/frame_clock.hpp>
+
+namespace cxxui {
+
+/**
+ * @brief 鼠标按键
+ */
+enum class MouseButton {
+    NONE,
+    LEFT,
+    RIGHT,
+    MIDDLE,
+};
+
+}  // namespace cxxui
 
 namespace cxxui::detail {
 
@@ -13,6 +32,7 @@ public:
 
 protected:
     LPARAM lp_;
+    void Set(HWND, UINT, WPARAM, LPARAM lp) { lp_ = lp; }
 };
 
 class ActivateEventBase {
@@ -24,6 +44,143 @@ public:
 
 protected:
     WPARAM wp_;
+    void Set(HWND, UINT, WPARAM wp, LPARAM) { wp_ = wp; }
+};
+
+class FrameEventBase {
+    template <typename T>
+    friend class WindowBase;
+
+public:
+    FrameClock::time_point GetTimestamp() const { return timestamp_; }
+    FrameClock::duration GetInterval() const { return interval_; }
+
+protected:
+    FrameClock::time_point timestamp_;
+    FrameClock::duration interval_;
+};
+
+class MouseEventBase {
+    template <typename T>
+    friend class WindowBase;
+
+public:
+    int GetX() const { return GET_X_LPARAM(lp_); }
+    int GetY() const { return GET_Y_LPARAM(lp_); }
+    MouseButton GetButton() const {
+        switch (msg_) {
+            case WM_LBUTTONDOWN:
+            case WM_LBUTTONUP:
+                return MouseButton::LEFT;
+            case WM_RBUTTONDOWN:
+            case WM_RBUTTONUP:
+                return MouseButton::RIGHT;
+            case WM_MBUTTONDOWN:
+            case WM_MBUTTONUP:
+                return MouseButton::MIDDLE;
+            default:
+                return MouseButton::NONE;
+        }
+    }
+    bool IsCtrlDown() const { return wp_ & MK_CONTROL; }
+    bool IsShiftDown() const { return wp_ & MK_SHIFT; }
+
+protected:
+    UINT msg_;
+    WPARAM wp_;
+    LPARAM lp_;
+    void Set(HWND, UINT msg, WPARAM wp, LPARAM lp) {
+        msg_ = msg;
+        wp_ = wp;
+        lp_ = lp;
+    }
+};
+
+class WheelEventBase {
+    template <typename T>
+    friend class WindowBase;
+
+public:
+    int GetX() const { return pt_.x; }
+    int GetY() const { return pt_.y; }
+    int GetDelta() const { return GET_WHEEL_DELTA_WPARAM(wp_); }
+    bool IsHorizontal() const { return msg_ == WM_MOUSEHWHEEL; }
+
+protected:
+    UINT msg_;
+    WPARAM wp_;
+    POINT pt_;
+    void Set(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp) {
+        msg_ = msg;
+        wp_ = wp;
+        // 滚轮消息的坐标是屏幕坐标, 统一转为客户区坐标
+        pt_ = {GET_X_LPARAM(lp), GET_Y_LPARAM(lp)};
+        ScreenToClient(hwnd, &pt_);
+    }
+};
+
+class KeyEventBase {
+    template <typename T>
+    friend class WindowBase;
+
+public:
+    int GetKeyCode() const { return static_cast<int>(wp_); }
+    bool IsRepeat() const { return (lp_ & (1 << 30)) != 0; }
+
+protected:
+    WPARAM wp_;
+    LPARAM lp_;
+    void Set(HWND, UINT, WPARAM wp, LPARAM lp) {
+        wp_ = wp;
+        lp_ = lp;
+    }
+};
+
+class PaintEventBase {
+    template <typename T>
+    friend class WindowBase;
+    friend class CanvasBase;
+
+public:
+    PaintEventBase() = default;
+    PaintEventBase(const PaintEventBase&) = delete;
+    PaintEventBase& operator=(const PaintEventBase&) = delete;
+    ~PaintEventBase() {
+        if (hwnd_) {
+            EndPaint(hwnd_, &ps_);
+        }
+    }
+    Rect GetDirtyRect() const {
+        return {ps_.rcPaint.left, ps_.rcPaint.top, ps_.rcPaint.right, ps_.rcPaint.bottom};
+    }
+    const std::vector<Rect>& GetDamageRects() const noexcept {
+        static const std::vector<Rect> empty;
+        return damage_ ? *damage_ : empty;
+    }
+
+protected:
+    HWND hwnd_ = nullptr;
+    PAINTSTRUCT ps_{};
+    /** 合并后的脏区域, 由窗口在派发前设置 */
+    const std::vector<Rect>* damage_ = nullptr;
+    void Set(HWND hwnd, UINT, WPARAM, LPARAM) {
+        if (BeginPaint(hwnd, &ps_)) {
+            hwnd_ = hwnd;
+        }
+    }
+};
+
+class DpiEventBase {
+    template <typename T>
+    friend class WindowBase;
+
+public:
+    int GetDpi() const { return LOWORD(wp_); }
+    float GetScale() const { return LOWORD(wp_) / 96.0f; }
+
+protected:
+    WPARAM wp_;
+    void Set(HWND, UINT, WPARAM wp, LPARAM) { wp_ = wp; }
 };
 
 }  // namespace cxxui::detail
@@ -0,0 +1,37 @@
+#include <chrono>
+#include <functional>
+
+#include <windows.h>
+
+#include <cxxui/core/detail/idle_scheduler.hpp>
+
+namespace cxxui::detail {
+
+/** 当前线程的空闲任务调度器, 由该线程的消息循环驱动 */
+inline IdleScheduler& GetIdleScheduler() {
+    thread_local IdleScheduler scheduler;
+    return scheduler;
+}
+
+/** 消息队列为空时执行一个时间片的空闲任务, 返回是否还有剩余任务 */
+inline bool RunIdleTasks() {
+    IdleScheduler& scheduler = GetIdleScheduler();
+    if (scheduler.IsEmpty()) {
+        return false;
+    }
+    scheduler.RunSlice([] { return IdleScheduler::Clock::now(); },
+                       [] { return HIWORD(GetQueueStatus(QS_ALLINPUT)) != 0; });
+    return !scheduler.IsEmpty();
+}
+
+/** 不同优先级的默认截止时间 */
+inline std::chrono::milliseconds GetIdleTimeout(int priority) {
+    if (priority > 0) {
+        return std::chrono::milliseconds(100);
+    } else if (priority < 0) {
+        return std::chrono::milliseconds(10000);
+    }
+    return std::chrono::milliseconds(1000);
+}
+
+}  // namespace cxxui::detail
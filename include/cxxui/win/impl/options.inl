@@ -1,7 +1,7 @@
 #include <limits>
 #include <string_view>
 
-#include "detail/shcore.hpp"
+#include "detail/monitor_cache.hpp"
 
 namespace cxxui::detail {
 
@@ -22,6 +22,10 @@ protected:
     int GetY() const { return y_; }
     void SetScale(bool scale) { scale_ = scale; }
     bool GetScale() const { return scale_; }
+    void SetCoalesceSize(bool coalesce) { coalesce_size_ = coalesce; }
+    bool GetCoalesceSize() const { return coalesce_size_; }
+    void SetRedrawOnResize(bool redraw) { redraw_on_resize_ = redraw; }
+    bool GetRedrawOnResize() const { return redraw_on_resize_; }
 
 protected:
     /** 窗口标题 */
@@ -36,30 +40,13 @@ protected:
     int y_ = (std::numeric_limits<int>::min)();
     /** 是否根据显示器的DPI缩放窗口到合适的比例 */
     bool scale_ = true;
+    /** 是否合并同一帧内的窗口大小变化事件 */
+    bool coalesce_size_ = false;
+    /** 窗口大小变化时是否重绘整个客户区 */
+    bool redraw_on_resize_ = true;
     DWORD style_ = WS_OVERLAPPEDWINDOW;
     DWORD ex_style_ = 0;
     HWND parent_ = nullptr;
-    /** 获取坐标点所在屏幕的相关信息 */
-    void GetPointInfo(POINT pt, RECT& screen, float& dpi) {
-        // 获取鼠标所在屏幕
-        if (pt.x > 0) {
-            --pt.x;
-        }
-        if (pt.y > 0) {
-            --pt.y;
-        }
-        HMONITOR monitor = MonitorFromPoint(pt, MONITOR_DEFAULTTONEAREST);
-        // 获取屏幕DPI
-        dpi = Shcore{}.GetDpiForMonitor(monitor) / 96.0f;
-        // 获取屏幕区域
-        MONITORINFO mi{};
-        mi.cbSize = sizeof(MONITORINFO);
-        if (!GetMonitorInfoW(monitor, &mi)) {
-            screen = {0, 0, GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN)};
-        } else {
-            screen = mi.rcMonitor;
-        }
-    }
     /** 处理DPI导致的窗口大小变化 */
     void ScaleRect() {
         if (width_ == CW_USEDEFAULT) {
@@ -68,74 +55,17 @@ protected:
         if (height_ == CW_USEDEFAULT) {
             height_ = 480;
         }
-        int center_count = 0;  // 0 - 不居中, 1 - x居中, 2 - y居中, 3 - 全居中
-        if (x_ == CW_USEDEFAULT) {
-            center_count += 1;
-        }
-        if (y_ == CW_USEDEFAULT) {
-            center_count += 2;
-        }
-        if (!scale_ && center_count == 0) {
+        Placement place{x_, y_, width_, height_, x_ == CW_USEDEFAULT, y_ == CW_USEDEFAULT};
+        if (!scale_ && !place.center_x && !place.center_y) {
             return;
         }
-        // 获取鼠标所在屏幕
         POINT pt;
         GetCursorPos(&pt);
-        RECT cur_screen;
-        float dpi;
-        GetPointInfo(pt, cur_screen, dpi);
-        // 显示在屏幕中央
-        if (center_count == 3) {
-            if (scale_ && dpi != 1.0f) {
-                width_ = static_cast<int>(width_ * dpi);
-                height_ = static_cast<int>(height_ * dpi);
-            }
-            x_ = (cur_screen.left + cur_screen.right - width_) / 2;
-            y_ = (cur_screen.top + cur_screen.bottom - height_) / 2;
-            return;
-        }
-        // 计算窗口中心位置所在屏幕信息
-        if (center_count == 1) {
-            x_ = (cur_screen.left + cur_screen.right - width_) / 2;
-        } else if (center_count == 2) {
-            y_ = (cur_screen.top + cur_screen.bottom - height_) / 2;
-        }
-        POINT center{x_ + width_ / 2, y_ + height_ / 2};
-        RECT screen;
-        GetPointInfo(center, screen, dpi);
-        if (screen.left != cur_screen.left || screen.top != cur_screen.top) {
-            // 窗口不在鼠标所在屏幕, 重新计算中点
-            if (center_count == 1) {
-                x_ = (screen.left + screen.right - width_) / 2;
-            } else if (center_count == 2) {
-                y_ = (screen.top + screen.bottom - height_) / 2;
-            }
-        }
-        if (!scale_ || dpi == 1.0f) {
-            return;
-        }
-        int new_width = static_cast<int>(width_ * dpi);
-        int new_height = static_cast<int>(height_ * dpi);
-        if (center_count == 1) {
-            x_ = (screen.left + screen.right - new_width) / 2;
-        } else if (center_count == 2) {
-            y_ = (screen.top + screen.bottom - new_height) / 2;
-        }
-        // 检查改变后的中点
-        center = {x_ + new_width / 2, y_ + new_height / 2};
-        float dpi2;
-        GetPointInfo(center, screen, dpi2);
-        if (dpi2 == dpi) {
-            width_ = new_width;
-            height_ = new_height;
-            return;
-        }
-        width_ = static_cast<int>(width_ * dpi2);
-        height_ = static_cast<int>(height_ * dpi2);
-        if (dpi2 < dpi) {
-            x_ = center.x - width_ / 2;
-            y_ = center.y - height_ / 2;
-        }
+        place = PlaceWindow(*MonitorCache::GetInstance().Get(), {pt.x, pt.y}, place, scale_);
+        x_ = place.x;
+        y_ = place.y;
+        width_ = place.width;
+        height_ = place.height;
     }
 };
 
@@ -0,0 +1,71 @@
+#include <chrono>
+#include <functional>
+
+#include <windows.h>
+
+#include <cxxui/core/detail/timer_wheel.hpp>
+
+namespace cxxui::detail {
+
+/** 定时器的 tick, 单位毫秒 */
+inline std::uint64_t TimerTicks() noexcept {
+    using namespace std::chrono;
+    return static_cast<std::uint64_t>(
+        duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+/** 当前线程的时间轮, 由该线程的消息循环驱动 */
+inline TimerWheel& GetTimerWheel() {
+    thread_local TimerWheel wheel{TimerTicks()};
+    return wheel;
+}
+
+/** 触发当前线程到期的定时器 */
+inline void RunTimers() { GetTimerWheel().Advance(TimerTicks()); }
+
+/** 距离下一个定时器的等待时间(毫秒), 没有定时器时返回 INFINITE */
+inline DWORD GetTimersTimeout() {
+    auto next = GetTimerWheel().NextTick();
+    if (!next) {
+        return INFINITE;
+    }
+    std::uint64_t now = TimerTicks();
+    if (*next <= now) {
+        return 0;
+    }
+    std::uint64_t timeout = *next - now;
+    return timeout >= INFINITE ? INFINITE - 1 : static_cast<DWORD>(timeout);
+}
+
+class TimerBase {
+public:
+    TimerBase() = default;
+    TimerBase(const TimerBase&) = delete;
+    TimerBase& operator=(const TimerBase&) = delete;
+    ~TimerBase() { Stop(); }
+
+protected:
+    void Start(std::chrono::milliseconds timeout, std::function<void()> callback, bool repeat) {
+        Stop();
+        wheel_ = &GetTimerWheel();
+        auto ticks = static_cast<std::uint64_t>(timeout.count() > 0 ? timeout.count() : 0);
+        std::uint64_t period = repeat ? (ticks ? ticks : 1) : 0;
+        // 消息循环无限期等待时时间轮没有推进, 按真实时间计算延迟, 避免提前触发
+        std::uint64_t now = TimerTicks();
+        std::uint64_t lag = now > wheel_->Now() ? now - wheel_->Now() : 0;
+        node_.callback = std::move(callback);
+        wheel_->Schedule(node_, (ticks ? ticks : 1) + lag, period);
+    }
+    void Stop() noexcept {
+        if (wheel_) {
+            wheel_->Cancel(node_);
+        }
+    }
+    bool IsActive() const noexcept { return wheel_ && wheel_->IsScheduled(node_); }
+
+private:
+    TimerWheel* wheel_ = nullptr;
+    TimerNode node_;
+};
+
+}  // namespace cxxui::detail
@@ -1,4 +1,12 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <type_traits>
+#include <vector>
 
 #include <dwmapi.h>
 #ifdef _MSC_VER
@@ -10,7 +18,17 @@
     #pragma comment(linker, "/SUBSYSTEM:WINDOWS /ENTRY:mainCRTStartup")
 #endif
 
+#include <cxxui/core/log.hpp>
+#include <cxxui/core/trace.hpp>
 #include <cxxui/core/detail/string_coder.hpp>
+#include <cxxui/core/detail/wm_msg.h>
+#include <cxxui/core/detail/frame_clock.hpp>
+#include <cxxui/core/detail/ui_queue.hpp>
+#include <cxxui/core/detail/dispatch.hpp>
+#include <cxxui/core/detail/damage.hpp>
+#include <cxxui/core/detail/ui_threads.hpp>
+#include <cxxui/core/rect.hpp>
+#include <cxxui/core/layout.hpp>
 #include "detail/user32.hpp"
 
 /** 定义窗口类名称, 用户可以定义该宏定义以覆盖默认值 */
@@ -18,11 +36,143 @@
     #define CXXUI_WIN32_CLASS_NAME L"cxxui_window"
 #endif
 
+namespace cxxui {
+template <typename Derived>
+class Window;
+}  // namespace cxxui
+
 namespace cxxui::detail {
 
 class DefaultWindow;
 
-void Exit(int exit_code = 0) noexcept { PostQuitMessage(exit_code); }
+/**
+ * @brief 结束UI线程消息循环的平台实现
+ * @details 每个UI线程在消息循环期间有一个只接收消息的窗口，结束时向它发送 UM_QUIT。
+ *   MessageBox、菜单和拖动等模态循环会丢弃没有窗口的线程消息，但仍然派发窗口消息
+ */
+struct Win32UiThreads {
+    using ThreadId = DWORD;
+    using Window = HWND;
+    /** 为当前线程创建接收 UM_QUIT 的消息窗口, 窗口类需要已注册, 嵌套的消息循环共用一个 */
+    static void AttachQuitWindow() {
+        auto& windows = GetQuitWindows();
+        {
+            std::lock_guard<std::mutex> lock(windows.mutex);
+            if (auto it = windows.entries.find(GetCurrentThreadId()); it != windows.entries.end()) {
+                ++it->second.refs;
+                return;
+            }
+        }
+        HWND hwnd = CreateWindowExW(0, CXXUI_WIN32_CLASS_NAME, nullptr, 0, 0, 0, 0, 0, HWND_MESSAGE,
+                                    nullptr, GetModuleHandle(nullptr), nullptr);
+        if (!hwnd) {
+            CXXUI_LOG_WARN("Create quit window failed", GetLastError());
+            return;
+        }
+        std::lock_guard<std::mutex> lock(windows.mutex);
+        windows.entries[GetCurrentThreadId()] = {hwnd, 1};
+    }
+    static void DetachQuitWindow() {
+        HWND hwnd = nullptr;
+        {
+            auto& windows = GetQuitWindows();
+            std::lock_guard<std::mutex> lock(windows.mutex);
+            auto it = windows.entries.find(GetCurrentThreadId());
+            if (it == windows.entries.end() || --it->second.refs > 0) {
+                return;
+            }
+            hwnd = it->second.hwnd;
+            windows.entries.erase(it);
+        }
+        DestroyWindow(hwnd);
+    }
+    void Quit(DWORD thread_id, int exit_code) {
+        if (thread_id == GetCurrentThreadId()) {
+            PostQuitMessage(exit_code);
+            return;
+        }
+        // 由目标线程的窗口过程调用 PostQuitMessage
+        HWND hwnd = nullptr;
+        {
+            auto& windows = GetQuitWindows();
+            std::lock_guard<std::mutex> lock(windows.mutex);
+            if (auto it = windows.entries.find(thread_id); it != windows.entries.end()) {
+                hwnd = it->second.hwnd;
+            }
+        }
+        if (hwnd && PostMessageW(hwnd, UM_QUIT, static_cast<WPARAM>(exit_code), 0)) {
+            return;
+        }
+        // 没有消息窗口时退回线程消息, 由消息循环处理
+        if (!PostThreadMessageW(thread_id, UM_QUIT, static_cast<WPARAM>(exit_code), 0)) {
+            CXXUI_LOG_WARN("PostThreadMessageW failed", GetLastError(), std::to_string(thread_id));
+        }
+    }
+
+private:
+    struct QuitWindow {
+        HWND hwnd;
+        int refs;
+    };
+    struct QuitWindows {
+        std::mutex mutex;
+        std::map<DWORD, QuitWindow> entries;
+    };
+    static QuitWindows& GetQuitWindows() {
+        static QuitWindows windows;
+        return windows;
+    }
+};
+
+/** 进程内所有运行消息循环的UI线程 */
+inline UiThreadRegistry<Win32UiThreads>& GetUiThreads() {
+    static UiThreadRegistry<Win32UiThreads> threads;
+    return threads;
+}
+
+inline void Exit(int exit_code = 0) noexcept {
+    if (GetUiThreads().ExitAll(exit_code) == 0) {
+        PostQuitMessage(exit_code);
+    }
+}
+
+/**
+ * @brief 消息循环, 没有消息时执行空闲任务, 然后按最近的定时器超时等待, 空闲时不占用CPU
+ *
+ * @param on_msg 每条消息派发后调用, 返回 true 则结束循环
+ * @return std::optional<int> 收到 WM_QUIT 时返回退出码, 被 on_msg 结束时返回空
+ */
+template <typename OnMsg>
+std::optional<int> RunMessageLoop(OnMsg&& on_msg) {
+    UiQueue& queue = GetUiQueue();
+    DWORD thread_id = GetCurrentThreadId();
+    queue.SetWake([thread_id] { PostThreadMessageW(thread_id, UM_WAKE, 0, 0); });
+    MSG msg;
+    for (;;) {
+        while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE)) {
+            if (msg.message == WM_QUIT) {
+                return static_cast<int>(msg.wParam);
+            }
+            if (msg.message == UM_WAKE && !msg.hwnd) {
+                queue.RunPending();
+                continue;
+            } else if (msg.message == UM_QUIT && !msg.hwnd) {
+                PostQuitMessage(static_cast<int>(msg.wParam));
+                continue;
+            }
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
+            if (on_msg(msg)) {
+                return std::nullopt;
+            }
+        }
+        queue.RunPending();
+        RunTimers();
+        // 还有空闲任务时不阻塞, 处理完新消息后继续执行下一个时间片
+        DWORD timeout = RunIdleTasks() ? 0 : GetTimersTimeout();
+        MsgWaitForMultipleObjectsEx(0, nullptr, timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+    }
+}
 
 class WndProcBase {
     friend class WinFactory;
@@ -38,54 +188,62 @@ protected:
 class WinFactory {
 public:
     /**
-     * @brief 窗口初始化函数, 整个进程运行过程只初始化一次
+     * @brief 窗口初始化函数, 窗口类整个进程只注册一次, DPI感知每个线程设置一次
      *
      * @return bool 初始化成功返回true, 失败返回false
      */
     static bool Init() {
-        if (main_hwnd_ != 0) {
-            return true;
-        } else {
-            main_hwnd_ = reinterpret_cast<HWND>(-1);
-        }
-        // 设置DPI感知
-        User32{}.SetThreadDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
-        // 注册窗口类
-        WNDCLASSEXW wc{};
-        wc.cbSize = sizeof(WNDCLASSEXW);
-        wc.style = CS_HREDRAW | CS_VREDRAW;                             // 窗口水平、垂直重绘
-        wc.lpfnWndProc = WndProc;                                       // 指定窗口过程函数
-        wc.hInstance = GetModuleHandle(nullptr);                        // 应用程序实例句柄
-        wc.hCursor = LoadCursor(nullptr, IDC_ARROW);                    // 使用系统默认的箭头光标
-        wc.hbrBackground = reinterpret_cast<HBRUSH>(COLOR_WINDOW + 1);  // 默认背景颜色
-        wc.lpszClassName = CXXUI_WIN32_CLASS_NAME;                      // 窗口类名
-        return RegisterClassExW(&wc);
-    }
-    static void SetMainWindow(HWND hwnd) { main_hwnd_ = hwnd; }
+        thread_local bool thread_inited = false;
+        if (!thread_inited) {
+            thread_inited = true;
+            // 设置DPI感知
+            User32::SetThreadDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
+        }
+        static const bool registered = [] {
+            CXXUI_TRACE_SCOPE("RegisterClassExW");
+            // 注册窗口类
+            WNDCLASSEXW wc{};
+            wc.cbSize = sizeof(WNDCLASSEXW);
+            // 不使用 CS_HREDRAW | CS_VREDRAW, 大小变化时是否整体重绘由窗口选项决定
+            wc.style = 0;
+            wc.lpfnWndProc = WndProc;                                       // 指定窗口过程函数
+            wc.hInstance = GetModuleHandle(nullptr);                        // 应用程序实例句柄
+            wc.hCursor = LoadCursor(nullptr, IDC_ARROW);                    // 使用系统默认的箭头光标
+            wc.hbrBackground = reinterpret_cast<HBRUSH>(COLOR_WINDOW + 1);  // 默认背景颜色
+            wc.lpszClassName = CXXUI_WIN32_CLASS_NAME;                      // 窗口类名
+            return RegisterClassExW(&wc) != 0;
+        }();
+        return registered;
+    }
 
 private:
-    inline static HWND main_hwnd_ = 0;
     /** 消息处理函数 */
     static LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp) {
         WndProcBase* win;
         if (msg == WM_NCCREATE) {
             LPCREATESTRUCT pcs = reinterpret_cast<LPCREATESTRUCT>(lp);
             win = reinterpret_cast<WndProcBase*>(pcs->lpCreateParams);
+            if (!win) {
+                // 只接收消息的窗口, 如 Win32UiThreads 的消息窗口
+                return DefWindowProcW(hwnd, msg, wp, lp);
+            }
             win->hwnd_ = hwnd;
             SetWindowLongPtr(hwnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(win));
         } else {
             win = reinterpret_cast<WndProcBase*>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
             if (!win) {
+                if (msg == UM_QUIT) {
+                    PostQuitMessage(static_cast<int>(wp));
+                    return 0;
+                }
                 return DefWindowProcW(hwnd, msg, wp, lp);
             }
         }
         std::optional<LRESULT> result = win->OnWndProc(msg, wp, lp);
         switch (msg) {
             case WM_DESTROY: {
-                // 如果是主窗口, 则退出进程
-                if (win->hwnd_ == main_hwnd_) {
-                    PostQuitMessage(0);
-                }
+                // 如果是线程的主窗口, 则按退出策略结束消息循环
+                GetUiThreads().OnWindowDestroyed(GetCurrentThreadId(), hwnd);
                 win->hwnd_ = 0;
                 break;
             }
@@ -116,23 +274,26 @@ public:
 
 protected:
     int Run() noexcept {
-        detail::WinFactory::SetMainWindow(hwnd_);  // 设置主窗口
+        DWORD thread_id = GetCurrentThreadId();
+        Win32UiThreads::AttachQuitWindow();      // 先创建消息窗口, 注册后即可被结束
+        GetUiThreads().Enter(thread_id, hwnd_);  // 设置当前线程的主窗口
         // 消息循环
-        MSG msg;
-        while (GetMessageW(&msg, NULL, 0, 0) > 0) {
-            TranslateMessage(&msg);
-            DispatchMessageW(&msg);
-        }
-        detail::WinFactory::SetMainWindow(nullptr);  // 置空，防止重复发送WM_QUIT
-        return static_cast<int>(msg.wParam);
+        int exit_code = RunMessageLoop([](const MSG&) { return false; }).value_or(0);
+        GetUiThreads().Leave(thread_id);  // 移除，防止重复发送WM_QUIT
+        Win32UiThreads::DetachQuitWindow();
+        return exit_code;
     }
-    void Exit(int exit_code) noexcept { PostQuitMessage(exit_code); }
+    /** 与 cxxui::Exit 相同, 结束所有UI线程的消息循环 */
+    void Exit(int exit_code) noexcept { detail::Exit(exit_code); }
     void Create(WindowOptionsBase& opts) {
         if (hwnd_) {
             throw WindowError(ERROR_ALREADY_EXISTS, "Window already exists!");
         }
+        CXXUI_TRACE_SCOPE("CreateWindow");
         detail::WinFactory::Init();
         opts.ScaleRect();
+        coalesce_size_ = opts.coalesce_size_;
+        redraw_on_resize_ = opts.redraw_on_resize_;
         CreateWindowExW(opts.ex_style_,
                         CXXUI_WIN32_CLASS_NAME,             // 窗口类名
                         detail::U82W(opts.title_).c_str(),  // 窗口标题
@@ -179,35 +340,277 @@ protected:
         // 设置小图标（任务栏、Alt+Tab）
         SendMessageW(hwnd_, WM_SETICON, ICON_SMALL, lp);
     }
+    void RequestFrame() {
+        pacer_.Request(FrameClock::now());
+        ScheduleFrame();
+    }
+    /** 标记客户区内的矩形需要重绘, 同一次绘制前的多次调用会被合并 */
+    void Invalidate(const Rect& rect) {
+        damage_.Add(rect);
+        RECT rc{rect.left, rect.top, rect.right, rect.bottom};
+        InvalidateRect(hwnd_, &rc, FALSE);
+    }
+    /** 标记整个客户区需要重绘 */
+    void Invalidate() {
+        RECT rc;
+        if (GetClientRect(hwnd_, &rc)) {
+            Invalidate({rc.left, rc.top, rc.right, rc.bottom});
+        }
+    }
+    LayoutNode& GetLayout() {
+        if (!layout_) {
+            layout_ = std::make_unique<LayoutNode>();
+        }
+        return *layout_;
+    }
+    void UpdateLayout() {
+        // 最小化时客户区为空, 保留原来的布局
+        if (!layout_ || !hwnd_ || IsIconic(hwnd_)) {
+            return;
+        }
+        RECT rc;
+        GetClientRect(hwnd_, &rc);
+        layout_changed_.clear();
+        layout_->Compute({rc.left, rc.top, rc.right, rc.bottom}, &layout_changed_);
+        if (layout_changed_.empty()) {
+            return;
+        }
+        // 一次性提交所有子窗口的位置, 避免逐个移动造成的多次重绘
+        HDWP hdwp = BeginDeferWindowPos(static_cast<int>(layout_changed_.size()));
+        for (LayoutNode* node : layout_changed_) {
+            const Rect& r = node->GetRect();
+            HWND child = static_cast<HWND>(node->GetHandle());
+            UINT flags = SWP_NOZORDER | SWP_NOACTIVATE | SWP_NOOWNERZORDER;
+            if (hdwp) {
+                hdwp = DeferWindowPos(hdwp, child, nullptr, r.left, r.top, r.Width(), r.Height(),
+                                      flags);
+            } else {
+                SetWindowPos(child, nullptr, r.left, r.top, r.Width(), r.Height(), flags);
+            }
+        }
+        if (hdwp) {
+            EndDeferWindowPos(hdwp);
+        }
+    }
 
 protected:
     /**
      * @brief 子类接收win32消息的事件
      */
     std::optional<LRESULT> OnWin32Msg(UINT, WPARAM, LPARAM) { return std::nullopt; }
+    /**
+     * @brief 框架中派生的窗口(如 WebWindow)处理自身需要的win32消息, 在 OnWin32Msg 之前调用
+     * @details 用户重写 OnWin32Msg 时不调用基类的版本也不会跳过这里的处理
+     */
+    virtual void OnFrameworkMsg(UINT, WPARAM, LPARAM) {}
+    /**
+     * @brief 每一帧的事件处理完成后调用, 供派生的窗口提交本帧累积的工作
+     */
+    void OnFrameEnd() {}
+
+private:
+    FramePacer pacer_;
+    Coalescer<Size> pending_size_;
+    bool coalesce_size_ = false;
+    /** 原生子窗口的布局, 第一次使用时创建 */
+    std::unique_ptr<LayoutNode> layout_;
+    std::vector<LayoutNode*> layout_changed_;
+    /** 窗口大小变化时是否重绘整个客户区 */
+    bool redraw_on_resize_ = true;
+    /** 下一次绘制前累积的脏区域 */
+    DamageTracker damage_;
+    /** 当前绘制事件使用的脏区域 */
+    std::vector<Rect> paint_damage_;
+    std::vector<char> region_buffer_;
+    /** 按显示器刷新率设置帧间隔 */
+    void UpdateRefreshRate() {
+        MONITORINFOEXW mi{};
+        mi.cbSize = sizeof(MONITORINFOEXW);
+        HMONITOR monitor = MonitorFromWindow(hwnd_, MONITOR_DEFAULTTONEAREST);
+        DEVMODEW dm{};
+        dm.dmSize = sizeof(DEVMODEW);
+        if (GetMonitorInfoW(monitor, &mi) &&
+            EnumDisplaySettingsW(mi.szDevice, ENUM_CURRENT_SETTINGS, &dm)) {
+            pacer_.SetRefreshRate(static_cast<int>(dm.dmDisplayFrequency));
+        }
+    }
+    /** 根据下一帧的时间点设置定时器, 没有请求帧时不占用定时器 */
+    void ScheduleFrame() {
+        auto timeout = pacer_.GetTimeout(FrameClock::now());
+        if (!timeout) {
+            KillTimer(hwnd_, TM_FRAME);
+            return;
+        }
+        auto ms = static_cast<UINT>(std::chrono::ceil<std::chrono::milliseconds>(*timeout).count());
+        SetTimer(hwnd_, TM_FRAME, (std::max)(ms, static_cast<UINT>(USER_TIMER_MINIMUM)), nullptr);
+    }
+    void DispatchSize(LPARAM lp) {
+        UpdateLayout();
+        if constexpr (kOverrides<&Derived::OnSize, &Defaults::OnSize>) {
+            SizeEvent event;
+            event.Set(hwnd_, WM_SIZE, 0, lp);
+            static_cast<Derived*>(this)->OnSize(event);
+        }
+    }
+    void DispatchFrame() {
+        auto now = FrameClock::now();
+        if (!pacer_.IsDue(now)) {
+            ScheduleFrame();
+            return;
+        }
+        FrameEvent event;
+        event.timestamp_ = pacer_.BeginFrame(now);
+        event.interval_ = pacer_.GetInterval();
+        // 先派发本帧合并后的窗口大小
+        if (auto size = pending_size_.Take(); size) {
+            DispatchSize(MAKELPARAM(size->width, size->height));
+        }
+        if constexpr (kOverrides<&Derived::OnFrame, &Defaults::OnFrame>) {
+            static_cast<Derived*>(this)->OnFrame(event);
+        }
+        static_cast<Derived*>(this)->OnFrameEnd();
+        ScheduleFrame();
+    }
+    /** 把系统失效的区域(遮挡、露出等)合并到脏区域, 然后取出本次绘制使用的矩形 */
+    void CollectDamage() {
+        HRGN rgn = CreateRectRgn(0, 0, 0, 0);
+        if (rgn && GetUpdateRgn(hwnd_, rgn, FALSE) > NULLREGION) {
+            DWORD bytes = GetRegionData(rgn, 0, nullptr);
+            if (bytes > region_buffer_.size()) {
+                region_buffer_.resize(bytes);
+            }
+            auto* data = reinterpret_cast<RGNDATA*>(region_buffer_.data());
+            if (bytes && GetRegionData(rgn, bytes, data)) {
+                const auto* rects = reinterpret_cast<const RECT*>(data->Buffer);
+                for (DWORD i = 0; i < data->rdh.nCount; ++i) {
+                    Rect r{rects[i].left, rects[i].top, rects[i].right, rects[i].bottom};
+                    if (!damage_.Covers(r)) {
+                        damage_.Add(r);
+                    }
+                }
+            }
+        }
+        if (rgn) {
+            DeleteObject(rgn);
+        }
+        paint_damage_ = damage_.Take();
+    }
+
+    /** 提供默认(空)事件处理函数的类 */
+    using Defaults = cxxui::Window<Derived>;
+    /** 子类是否重写了事件处理函数 */
+    template <auto Handler, auto Default>
+    static constexpr bool kOverrides = IsOverridden<decltype(Handler), decltype(Default)>;
+    /** win32消息到事件处理函数的表项, 子类没有重写处理函数时不启用 */
+    template <UINT Msg, typename Event, auto Handler, auto Default>
+    struct EventEntry {
+        static constexpr std::uint32_t kMsg = Msg;
+        static constexpr bool kEnabled = kOverrides<Handler, Default>;
+        static void Invoke(Derived& self, UINT msg, WPARAM wp, LPARAM lp) {
+            if constexpr (std::is_void_v<Event>) {
+                (self.*Handler)();
+            } else {
+                Event event;
+                if constexpr (std::is_base_of_v<PaintEventBase, Event>) {
+                    self.CollectDamage();
+                    event.damage_ = &self.paint_damage_;
+                }
+                event.Set(self.hwnd_, msg, wp, lp);
+                (self.*Handler)(event);
+            }
+        }
+    };
 
 protected:
     std::optional<LRESULT> OnWndProc(UINT msg, WPARAM wp, LPARAM lp) override final {
+        // 框架内部需要处理的消息
         switch (msg) {
             case WM_CREATE: {
-                static_cast<Derived*>(this)->OnCreated();
+                UpdateRefreshRate();
                 break;
             }
             case WM_SIZE: {
-                SizeEvent event;
-                event.lp_ = lp;
-                static_cast<Derived*>(this)->OnSize(event);
+                bool has_size_handler =
+                    layout_ || kOverrides<&Derived::OnSize, &Defaults::OnSize>;
+                if (coalesce_size_ && has_size_handler) {
+                    pending_size_.Push({LOWORD(lp), HIWORD(lp)});
+                    RequestFrame();
+                } else {
+                    DispatchSize(lp);
+                }
+                // 窗口类不带 CS_HREDRAW | CS_VREDRAW, 需要时手动让整个客户区失效
+                if (redraw_on_resize_ && wp != SIZE_MINIMIZED) {
+                    InvalidateRect(hwnd_, nullptr, TRUE);
+                }
+                break;
+            }
+            case WM_TIMER: {
+                if (wp == TM_FRAME) {
+                    DispatchFrame();
+                    return 0;
+                } else if (wp == TM_TIMER_WHEEL) {
+                    // 模态循环会丢弃线程消息, 一并执行UI任务队列
+                    GetUiQueue().RunPending();
+                    RunTimers();
+                    return 0;
+                }
                 break;
             }
-            case WM_ACTIVATE: {
-                ActivateEvent event;
-                event.wp_ = wp;
-                static_cast<Derived*>(this)->OnActivate(event);
+            case WM_ENTERSIZEMOVE:
+            case WM_ENTERMENULOOP: {
+                // 模态循环期间消息循环不运行, 由窗口定时器驱动时间轮
+                SetTimer(this->hwnd_, TM_TIMER_WHEEL, USER_TIMER_MINIMUM, nullptr);
+                break;
+            }
+            case WM_EXITSIZEMOVE:
+            case WM_EXITMENULOOP: {
+                KillTimer(this->hwnd_, TM_TIMER_WHEEL);
+                break;
+            }
+            case WM_ENABLE: {
+                // 以本窗口为所有者的模态对话框(如 MessageBox)期间窗口被禁用, 同样由窗口定时器驱动
+                if (wp) {
+                    KillTimer(this->hwnd_, TM_TIMER_WHEEL);
+                } else {
+                    SetTimer(this->hwnd_, TM_TIMER_WHEEL, USER_TIMER_MINIMUM, nullptr);
+                }
+                break;
+            }
+            case WM_PAINT: {
+                // 没有绘制处理函数时丢弃累积的脏区域
+                if constexpr (!kOverrides<&Derived::OnPaint, &Defaults::OnPaint>) {
+                    damage_.Clear();
+                }
+                break;
+            }
+            case WM_DISPLAYCHANGE:
+            case WM_DPICHANGED: {
+                MonitorCache::GetInstance().Invalidate();
+                UpdateRefreshRate();
                 break;
             }
             default:
                 break;
         }
+        // 编译期生成的事件派发表, 只包含子类重写了的事件
+        using EventTable = DispatchTable<
+            EventEntry<WM_CREATE, void, &Derived::OnCreated, &Defaults::OnCreated>,
+            EventEntry<WM_ACTIVATE, ActivateEvent, &Derived::OnActivate, &Defaults::OnActivate>,
+            EventEntry<WM_MOUSEMOVE, MouseEvent, &Derived::OnMouseMove, &Defaults::OnMouseMove>,
+            EventEntry<WM_LBUTTONDOWN, MouseEvent, &Derived::OnMouseDown, &Defaults::OnMouseDown>,
+            EventEntry<WM_RBUTTONDOWN, MouseEvent, &Derived::OnMouseDown, &Defaults::OnMouseDown>,
+            EventEntry<WM_MBUTTONDOWN, MouseEvent, &Derived::OnMouseDown, &Defaults::OnMouseDown>,
+            EventEntry<WM_LBUTTONUP, MouseEvent, &Derived::OnMouseUp, &Defaults::OnMouseUp>,
+            EventEntry<WM_RBUTTONUP, MouseEvent, &Derived::OnMouseUp, &Defaults::OnMouseUp>,
+            EventEntry<WM_MBUTTONUP, MouseEvent, &Derived::OnMouseUp, &Defaults::OnMouseUp>,
+            EventEntry<WM_MOUSEWHEEL, WheelEvent, &Derived::OnMouseWheel, &Defaults::OnMouseWheel>,
+            EventEntry<WM_MOUSEHWHEEL, WheelEvent, &Derived::OnMouseWheel, &Defaults::OnMouseWheel>,
+            EventEntry<WM_KEYDOWN, KeyEvent, &Derived::OnKeyDown, &Defaults::OnKeyDown>,
+            EventEntry<WM_KEYUP, KeyEvent, &Derived::OnKeyUp, &Defaults::OnKeyUp>,
+            EventEntry<WM_PAINT, PaintEvent, &Derived::OnPaint, &Defaults::OnPaint>,
+            EventEntry<WM_DPICHANGED, DpiEvent, &Derived::OnDpiChanged, &Defaults::OnDpiChanged>>;
+        EventTable::Dispatch(msg, *static_cast<Derived*>(this), msg, wp, lp);
+        OnFrameworkMsg(msg, wp, lp);
         return static_cast<Derived*>(this)->OnWin32Msg(msg, wp, lp);
     }
 };
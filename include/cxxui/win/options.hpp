@@ -75,6 +75,30 @@ public:
         return *this;
     }
     bool GetScale() const { return WindowOptionsBase::GetScale(); }
+    /**
+     * @brief 是否合并同一帧内的窗口大小变化事件
+     * @details 开启后拖动改变窗口大小时，每帧只触发一次 OnSize，传入最新的大小
+     *
+     * @param coalesce 默认不合并
+     * @return WindowOptions&
+     */
+    WindowOptions& SetCoalesceSize(bool coalesce) {
+        WindowOptionsBase::SetCoalesceSize(coalesce);
+        return *this;
+    }
+    bool GetCoalesceSize() const { return WindowOptionsBase::GetCoalesceSize(); }
+    /**
+     * @brief 窗口大小变化时是否重绘整个客户区
+     * @details 关闭后只重绘新露出的区域，适合只按脏区域绘制的窗口
+     *
+     * @param redraw 默认重绘
+     * @return WindowOptions&
+     */
+    WindowOptions& SetRedrawOnResize(bool redraw) {
+        WindowOptionsBase::SetRedrawOnResize(redraw);
+        return *this;
+    }
+    bool GetRedrawOnResize() const { return WindowOptionsBase::GetRedrawOnResize(); }
 };
 
 }  // namespace cxxui
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#include "impl/timer.inl"
+
+namespace cxxui {
+
+/**
+ * @brief 定时器，由启动它的线程的消息循环驱动
+ * @details 基于分层时间轮实现，启动和停止都是 O(1) 且不分配内存，适合大量短时定时器。
+ * 定时器只能在启动它的线程上使用，析构时自动停止。
+ * 窗口拖动、菜单和以本库窗口为所有者的模态对话框期间由窗口定时器继续驱动；
+ * 没有所有者的 MessageBox 等其他模态循环期间定时器暂停，结束后错过的周期只触发一次。
+ */
+class Timer : public detail::TimerBase {
+public:
+    Timer() = default;
+    /**
+     * @brief 创建并启动定时器
+     */
+    Timer(std::chrono::milliseconds timeout, std::function<void()> callback, bool repeat = false) {
+        Start(timeout, std::move(callback), repeat);
+    }
+    /**
+     * @brief 启动定时器，已启动的定时器会重新计时
+     *
+     * @param timeout 超时时间
+     * @param callback 超时的回调函数
+     * @param repeat 是否按 timeout 周期重复触发, 默认只触发一次
+     */
+    void Start(std::chrono::milliseconds timeout,
+               std::function<void()> callback,
+               bool repeat = false) {
+        TimerBase::Start(timeout, std::move(callback), repeat);
+    }
+    /**
+     * @brief 停止定时器
+     */
+    void Stop() noexcept { TimerBase::Stop(); }
+    /**
+     * @brief 定时器是否在运行
+     */
+    bool IsActive() const noexcept { return TimerBase::IsActive(); }
+};
+
+}  // namespace cxxui
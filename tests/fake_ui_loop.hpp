@@ -0,0 +1,63 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+#include <cxxui/core/detail/ui_queue.hpp>
+
+namespace cxxui::test {
+
+/**
+ * @brief 模拟UI线程的消息循环
+ * @details 队列的唤醒函数代替 PostThreadMessage 通知条件变量，Pump 等待唤醒后执行队列中的任务
+ */
+class FakeUiLoop {
+public:
+    explicit FakeUiLoop(detail::UiQueue& queue)
+        : queue_(queue) {
+        queue_.SetWake([this] {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++wakes_;
+            cv_.notify_one();
+        });
+    }
+    ~FakeUiLoop() { queue_.SetWake(nullptr); }
+    FakeUiLoop(const FakeUiLoop&) = delete;
+    FakeUiLoop& operator=(const FakeUiLoop&) = delete;
+
+    /**
+     * @brief 执行任务直到 done 返回 true
+     *
+     * @return bool 超时返回 false
+     */
+    template <typename Pred>
+    bool PumpUntil(Pred done, std::chrono::milliseconds timeout = std::chrono::seconds{10}) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!done()) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (!cv_.wait_until(lock, deadline, [this] { return wakes_ > handled_; })) {
+                    return done();
+                }
+                handled_ = wakes_;
+            }
+            queue_.RunPending();
+        }
+        return true;
+    }
+    /** 唤醒的次数 */
+    std::size_t GetWakes() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return wakes_;
+    }
+
+private:
+    detail::UiQueue& queue_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::size_t wakes_ = 0;
+    std::size_t handled_ = 0;
+};
+
+}  // namespace cxxui::test
@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <string_view>
+
+#include "test.hpp"
+
+using namespace cxxui::test;
+
+void cxxui::test::Fail(const char* file, int line, const std::string& message) {
+    std::fprintf(stderr, "  %s:%d: %s\n", file, line, message.c_str());
+    ++GetFailures();
+}
+
+int main(int argc, char* argv[]) {
+    std::string_view filter;
+    bool list = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg.substr(0, 9) == "--filter=") {
+            filter = arg.substr(9);
+        } else if (arg == "--list") {
+            list = true;
+        } else {
+            std::fprintf(stderr, "usage: cxxui_tests [--filter=PREFIX] [--list]\n");
+            return 2;
+        }
+    }
+
+    // 不同源文件的注册顺序不确定, 按名字排序使输出稳定
+    std::vector<TestCase> tests = GetTests();
+    std::stable_sort(tests.begin(), tests.end(),
+                     [](const TestCase& a, const TestCase& b) { return a.name < b.name; });
+    std::size_t run = 0;
+    std::size_t failed = 0;
+    for (const TestCase& test : tests) {
+        if (test.name.compare(0, filter.size(), filter) != 0) {
+            continue;
+        }
+        if (list) {
+            std::printf("%s\n", test.name.c_str());
+            continue;
+        }
+        GetFailures() = 0;
+        try {
+            test.fn();
+        } catch (const std::exception& e) {
+            Fail(__FILE__, __LINE__, std::string{"uncaught exception: "} + e.what());
+        } catch (...) {
+            Fail(__FILE__, __LINE__, "uncaught exception");
+        }
+        ++run;
+        if (GetFailures()) {
+            ++failed;
+            std::printf("FAIL %s\n", test.name.c_str());
+        } else {
+            std::printf("ok   %s\n", test.name.c_str());
+        }
+    }
+    if (list) {
+        return 0;
+    }
+    std::printf("%zu tests, %zu failed\n", run, failed);
+    // 过滤条件写错时不应当悄悄通过
+    return failed || run == 0 ? 1 : 0;
+}
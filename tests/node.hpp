@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#ifdef _WIN32
+    #include <process.h>
+#else
+    #include <unistd.h>
+#endif
+
+namespace cxxui::test {
+
+/** 是否可以用 node 运行 javascript, 由构建时找到的 node 决定 */
+inline bool HasNode() noexcept {
+#ifdef CXXUI_TEST_NODE
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 用 node 运行脚本, 返回标准输出
+ *
+ * @return 没有 node 或运行失败时返回空
+ */
+inline std::optional<std::string> RunNode([[maybe_unused]] std::string_view script) {
+#ifdef CXXUI_TEST_NODE
+    // C++17 和 C++20 的测试程序可能并行运行, 文件名带上进程号
+    #ifdef _WIN32
+    int pid = _getpid();
+    #else
+    int pid = static_cast<int>(getpid());
+    #endif
+    static int counter = 0;
+    auto path = std::filesystem::temp_directory_path() /
+                ("cxxui_test_" + std::to_string(pid) + "_" + std::to_string(++counter) + ".js");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(script.data(), static_cast<std::streamsize>(script.size()));
+    }
+    std::string command = std::string{"\""} + CXXUI_TEST_NODE + "\" \"" + path.string() + "\"";
+    #ifdef _WIN32
+    FILE* pipe = _popen(command.c_str(), "r");
+    #else
+    FILE* pipe = popen(command.c_str(), "r");
+    #endif
+    if (!pipe) {
+        return std::nullopt;
+    }
+    std::string output;
+    char buffer[4096];
+    while (std::size_t n = std::fread(buffer, 1, sizeof(buffer), pipe)) {
+        output.append(buffer, n);
+    }
+    #ifdef _WIN32
+    int status = _pclose(pipe);
+    #else
+    int status = pclose(pipe);
+    #endif
+    std::filesystem::remove(path);
+    if (status != 0) {
+        return std::nullopt;
+    }
+    return output;
+#else
+    return std::nullopt;
+#endif
+}
+
+}  // namespace cxxui::test
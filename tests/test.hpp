@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cxxui::test {
+
+/** 注册的测试 */
+struct TestCase {
+    std::string name;
+    void (*fn)();
+};
+
+/** 所有测试, 按注册顺序运行 */
+inline std::vector<TestCase>& GetTests() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+/**
+ * @brief 注册测试
+ *
+ * @param name 测试名, 以 / 分隔分组, 如 "ui_queue/run_in_order"
+ * @return 总是 true, 用于在静态初始化时注册
+ */
+inline bool Register(std::string name, void (*fn)()) {
+    GetTests().push_back({std::move(name), fn});
+    return true;
+}
+
+/** 当前测试失败的检查数量 */
+inline std::size_t& GetFailures() {
+    static std::size_t failures = 0;
+    return failures;
+}
+
+/** 记录一次失败的检查, 测试继续执行 */
+void Fail(const char* file, int line, const std::string& message);
+
+template <typename T>
+std::string ToString(const T& value) {
+    std::ostringstream stream;
+    if constexpr (std::is_same_v<T, bool>) {
+        stream << (value ? "true" : "false");
+    } else if constexpr (std::is_enum_v<T>) {
+        stream << static_cast<long long>(value);
+    } else {
+        stream << value;
+    }
+    return stream.str();
+}
+
+}  // namespace cxxui::test
+
+#define CXXUI_TEST_CONCAT_IMPL(a, b) a##b
+#define CXXUI_TEST_CONCAT(a, b) CXXUI_TEST_CONCAT_IMPL(a, b)
+/** 定义一个测试, 名字为 "group/name" */
+#define CXXUI_TEST(group, name)                                                              \
+    static void CXXUI_TEST_CONCAT(Test_##group##_, name)();                                  \
+    static const bool CXXUI_TEST_CONCAT(test_registered_##group##_, name) =                  \
+        ::cxxui::test::Register(#group "/" #name, CXXUI_TEST_CONCAT(Test_##group##_, name)); \
+    static void CXXUI_TEST_CONCAT(Test_##group##_, name)()
+/** 检查条件, 失败时记录表达式并继续 */
+#define CXXUI_CHECK(cond)                                                \
+    do {                                                                 \
+        if (!(cond)) {                                                   \
+            ::cxxui::test::Fail(__FILE__, __LINE__, "CHECK(" #cond ")"); \
+        }                                                                \
+    } while (0)
+/** 检查两个值相等, 失败时记录两边的值 */
+#define CXXUI_CHECK_EQ(a, b)                                                          \
+    do {                                                                              \
+        const auto& cxxui_check_a = (a);                                              \
+        const auto& cxxui_check_b = (b);                                              \
+        if (!(cxxui_check_a == cxxui_check_b)) {                                      \
+            ::cxxui::test::Fail(__FILE__,                                             \
+                                __LINE__,                                             \
+                                "CHECK_EQ(" #a ", " #b "): " +                        \
+                                    ::cxxui::test::ToString(cxxui_check_a) + " != " + \
+                                    ::cxxui::test::ToString(cxxui_check_b));          \
+        }                                                                             \
+    } while (0)
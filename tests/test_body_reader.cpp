@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <cxxui/web_win/impl/detail/body_reader.hpp>
+#include "test.hpp"
+
+using namespace cxxui;
+using namespace cxxui::detail;
+
+namespace {
+
+constexpr long kReadError = -5;
+
+/** 内存中的流, 每次随机读取 1..max_read 字节, 读到 fail_at 后失败 */
+struct MemStream {
+    std::string data;
+    std::size_t max_read = 1;
+    std::optional<std::size_t> fail_at;
+    std::mt19937* rng = nullptr;
+    std::size_t pos = 0;
+
+    Expected<std::size_t, long> Read(void* buffer, std::size_t size) {
+        if (fail_at && pos >= *fail_at) {
+            return Unexpected{kReadError};
+        }
+        std::size_t limit = static_cast<std::size_t>((*rng)() % max_read + 1);
+        std::size_t read = (std::min)({size, data.size() - pos, limit});
+        std::memcpy(buffer, data.data() + pos, read);
+        pos += read;
+        return read;
+    }
+};
+
+/** 文件流, 用 fread 读取, 与 ComReadStream 一样可能读到少于请求的字节数 */
+struct FileStream {
+    std::FILE* file;
+
+    Expected<std::size_t, long> Read(void* buffer, std::size_t size) {
+        std::size_t read = std::fread(buffer, 1, size, file);
+        if (read == 0 && std::ferror(file)) {
+            return Unexpected{-1L};
+        }
+        return read;
+    }
+};
+
+std::string RandomBytes(std::mt19937& rng, std::size_t size) {
+    std::string data(size, '\0');
+    for (char& c : data) {
+        c = static_cast<char>(rng());
+    }
+    return data;
+}
+
+/** 写入临时文件并移到开头, 失败时返回 nullptr */
+std::FILE* WriteTempFile(const std::string& data) {
+    std::FILE* file = std::tmpfile();
+    if (file && std::fwrite(data.data(), 1, data.size(), file) != data.size()) {
+        std::fclose(file);
+        return nullptr;
+    }
+    if (file) {
+        std::rewind(file);
+    }
+    return file;
+}
+
+}  // namespace
+
+CXXUI_TEST(body_reader, random_short_reads_and_errors) {
+    std::mt19937 rng(42);
+    for (int i = 0; i < 5000; ++i) {
+        MemStream stream;
+        stream.data = RandomBytes(rng, rng() % 5000);
+        stream.max_read = rng() % 700 + 1;
+        stream.rng = &rng;
+        if (rng() % 4 == 0) {
+            stream.fail_at = rng() % (stream.data.size() + 1);
+        }
+        std::string data = stream.data;
+        bool may_fail = stream.fail_at.has_value();
+        // 0 表示默认大小
+        std::size_t chunk_size = rng() % 2 ? rng() % 300 + 1 : 0;
+        ChunkReader<MemStream> reader(std::move(stream), chunk_size);
+        std::size_t expected_size = chunk_size ? chunk_size : reader.kDefaultChunkSize;
+        CXXUI_CHECK_EQ(reader.GetChunkSize(), expected_size);
+        std::string read;
+        bool failed = false;
+        bool ok = true;
+        while (ok) {
+            auto chunk = reader.Next();
+            if (!chunk) {
+                failed = true;
+                // 失败后每次都返回同一个错误码
+                auto again = reader.Next();
+                ok = chunk.GetError() == kReadError && !again && again.GetError() == kReadError;
+                break;
+            }
+            if (chunk->empty()) {
+                ok = reader.IsEnd() && reader.Next()->empty();
+                break;
+            }
+            // 除最后一块外每块都是 chunk_size 字节
+            ok = chunk->size() == expected_size || reader.IsEnd();
+            read.append(*chunk);
+        }
+        if (failed) {
+            ok = ok && may_fail && data.compare(0, read.size(), read) == 0;
+        } else {
+            ok = ok && read == data && reader.GetBytesRead() == data.size();
+        }
+        if (!ok) {
+            CXXUI_CHECK_EQ(i, -1);
+            return;
+        }
+    }
+}
+
+CXXUI_TEST(body_reader, for_each_stops_and_resumes) {
+    std::mt19937 rng(1);
+    MemStream stream;
+    stream.data.assign(1000, 'x');
+    stream.max_read = 1000;
+    stream.rng = &rng;
+    ChunkReader<MemStream> reader(std::move(stream), 100);
+    int count = 0;
+    auto first = reader.ForEach([&](std::string_view) { return ++count < 3; });
+    CXXUI_CHECK(first.HasValue());
+    CXXUI_CHECK_EQ(*first, std::uint64_t{300});
+    CXXUI_CHECK_EQ(count, 3);
+    CXXUI_CHECK(!reader.IsEnd());
+    auto rest = reader.ForEach([](std::string_view) {});
+    CXXUI_CHECK_EQ(*rest, std::uint64_t{700});
+    CXXUI_CHECK_EQ(reader.GetBytesRead(), std::uint64_t{1000});
+    CXXUI_CHECK(reader.IsEnd());
+}
+
+CXXUI_TEST(body_reader, for_each_reports_error) {
+    std::mt19937 rng(2);
+    MemStream stream;
+    stream.data.assign(1000, 'x');
+    // 每次最多读 10 字节, 第三块一定在读满前失败
+    stream.max_read = 10;
+    stream.fail_at = 250;
+    stream.rng = &rng;
+    ChunkReader<MemStream> reader(std::move(stream), 100);
+    std::size_t read = 0;
+    auto result = reader.ForEach([&](std::string_view chunk) { read += chunk.size(); });
+    CXXUI_CHECK(!result.HasValue());
+    CXXUI_CHECK_EQ(result.GetError(), kReadError);
+    CXXUI_CHECK_EQ(read, 200u);
+}
+
+CXXUI_TEST(body_reader, file_backed) {
+    std::mt19937 rng(3);
+    // 不是块大小的整数倍, 最后一块不满
+    std::string data = RandomBytes(rng, 3 * 1024 * 1024 + 17);
+    std::FILE* file = WriteTempFile(data);
+    CXXUI_CHECK(file != nullptr);
+    if (!file) {
+        return;
+    }
+    ChunkReader<FileStream> reader(FileStream{file});
+    std::string read;
+    std::size_t chunks = 0;
+    auto total = reader.ForEach([&](std::string_view chunk) {
+        read.append(chunk);
+        ++chunks;
+    });
+    std::fclose(file);
+    CXXUI_CHECK(total.HasValue());
+    CXXUI_CHECK_EQ(*total, std::uint64_t{data.size()});
+    CXXUI_CHECK(read == data);
+    CXXUI_CHECK_EQ(chunks, data.size() / reader.kDefaultChunkSize + 1);
+}
+
+CXXUI_TEST(body_reader, empty_file) {
+    std::FILE* file = WriteTempFile("");
+    CXXUI_CHECK(file != nullptr);
+    if (!file) {
+        return;
+    }
+    ChunkReader<FileStream> reader(FileStream{file}, 16);
+    auto chunk = reader.Next();
+    std::fclose(file);
+    CXXUI_CHECK(chunk.HasValue());
+    CXXUI_CHECK(chunk->empty());
+    CXXUI_CHECK(reader.IsEnd());
+    CXXUI_CHECK_EQ(reader.GetBytesRead(), std::uint64_t{0});
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <cxxui/core/detail/damage.hpp>
+#include "test.hpp"
+
+using namespace cxxui;
+using namespace cxxui::detail;
+
+namespace {
+
+constexpr int kWidth = 96;
+constexpr int kHeight = 64;
+
+/** 按像素记录的失效区域 */
+class Coverage {
+public:
+    void Mark(const Rect& r) {
+        for (int y = r.top; y < r.bottom; ++y) {
+            for (int x = r.left; x < r.right; ++x) {
+                pixels_[Index(x, y)] = true;
+            }
+        }
+    }
+    /** rects 覆盖了记录的所有像素 */
+    bool IsCoveredBy(const std::vector<Rect>& rects) const {
+        std::vector<bool> covered(pixels_.size());
+        for (const Rect& r : rects) {
+            for (int y = r.top; y < r.bottom; ++y) {
+                for (int x = r.left; x < r.right; ++x) {
+                    covered[Index(x, y)] = true;
+                }
+            }
+        }
+        for (std::size_t i = 0; i < pixels_.size(); ++i) {
+            if (pixels_[i] && !covered[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::vector<bool> pixels_ = std::vector<bool>(kWidth * kHeight);
+
+    static std::size_t Index(int x, int y) { return static_cast<std::size_t>(y * kWidth + x); }
+};
+
+bool HasOverlap(const std::vector<Rect>& rects) {
+    for (std::size_t i = 0; i < rects.size(); ++i) {
+        for (std::size_t j = i + 1; j < rects.size(); ++j) {
+            if (!DamageTracker::Intersect(rects[i], rects[j]).IsEmpty()) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool IsInside(const std::vector<Rect>& rects, const Rect& bounds) {
+    for (const Rect& r : rects) {
+        if (r.IsEmpty() || !DamageTracker::Contains(bounds, r)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+CXXUI_TEST(damage, random_rects_stay_disjoint_and_covered) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> x_dist(0, kWidth - 1);
+    std::uniform_int_distribution<int> y_dist(0, kHeight - 1);
+    std::uniform_int_distribution<int> size_dist(1, 24);
+    const std::size_t max_rects_list[] = {1, 3, DamageTracker::kDefaultMaxRects};
+    const std::int64_t costs[] = {0, 16, DamageTracker::kDefaultRectCost};
+    for (std::size_t max_rects : max_rects_list) {
+        for (std::int64_t cost : costs) {
+            DamageTracker tracker;
+            tracker.SetMaxRects(max_rects);
+            tracker.SetRectCost(cost);
+            for (int round = 0; round < 20; ++round) {
+                Coverage coverage;
+                Rect bounds;
+                for (int i = 0; i < 30; ++i) {
+                    int left = x_dist(rng);
+                    int top = y_dist(rng);
+                    Rect r{left, top, (std::min)(left + size_dist(rng), kWidth),
+                           (std::min)(top + size_dist(rng), kHeight)};
+                    tracker.Add(r);
+                    coverage.Mark(r);
+                    bounds = i == 0 ? r : DamageTracker::Union(bounds, r);
+                    const auto& rects = tracker.GetRects();
+                    CXXUI_CHECK(rects.size() <= max_rects);
+                    CXXUI_CHECK(!HasOverlap(rects));
+                    CXXUI_CHECK(IsInside(rects, bounds));
+                    CXXUI_CHECK(coverage.IsCoveredBy(rects));
+                }
+                Rect tracked = tracker.GetBounds();
+                CXXUI_CHECK(tracked.left == bounds.left && tracked.top == bounds.top &&
+                            tracked.right == bounds.right && tracked.bottom == bounds.bottom);
+                CXXUI_CHECK(coverage.IsCoveredBy(tracker.Take()));
+                CXXUI_CHECK(tracker.IsEmpty());
+            }
+        }
+    }
+}
+
+CXXUI_TEST(damage, merges_near_and_keeps_far) {
+    DamageTracker tracker;
+    tracker.SetRectCost(100);
+    // 相距很远的小矩形分别保留
+    tracker.Add({0, 0, 10, 10});
+    tracker.Add({80, 50, 90, 60});
+    CXXUI_CHECK_EQ(tracker.GetRects().size(), 2u);
+    // 相邻的矩形合并后不多绘制像素
+    tracker.Add({10, 0, 20, 10});
+    CXXUI_CHECK_EQ(tracker.GetRects().size(), 2u);
+    CXXUI_CHECK(tracker.Covers({0, 0, 20, 10}));
+    // 已覆盖的矩形和空矩形不改变结果
+    tracker.Add({2, 2, 8, 8});
+    tracker.Add({5, 5, 5, 9});
+    CXXUI_CHECK_EQ(tracker.GetRects().size(), 2u);
+}
+
+CXXUI_TEST(damage, full_window_fallback) {
+    const Rect window{0, 0, kWidth, kHeight};
+    DamageTracker tracker;
+    tracker.SetRectCost(0);
+    for (int i = 0; i < 8; ++i) {
+        tracker.Add({i * 11, i * 7, i * 11 + 5, i * 7 + 5});
+    }
+    CXXUI_CHECK(tracker.GetRects().size() > 1);
+    // 整个窗口失效时只剩下一个矩形
+    tracker.Add(window);
+    CXXUI_CHECK_EQ(tracker.GetRects().size(), 1u);
+    CXXUI_CHECK(DamageTracker::Contains(tracker.GetRects().front(), window));
+    CXXUI_CHECK(DamageTracker::Contains(window, tracker.GetRects().front()));
+    // 上限为 1 时退化为所有失效矩形的外接矩形
+    tracker.Clear();
+    tracker.SetMaxRects(1);
+    tracker.Add({0, 0, 4, 4});
+    tracker.Add({kWidth - 4, kHeight - 4, kWidth, kHeight});
+    CXXUI_CHECK_EQ(tracker.GetRects().size(), 1u);
+    CXXUI_CHECK(DamageTracker::Contains(tracker.GetRects().front(), window));
+}
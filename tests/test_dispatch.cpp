@@ -0,0 +1,98 @@
+#include <cstdint>
+#include <vector>
+
+#include <cxxui/core/detail/dispatch.hpp>
+#include "test.hpp"
+
+using namespace cxxui::detail;
+
+namespace {
+
+/** 模拟窗口基类的默认(空)事件处理函数, 与 Window 的结构相同 */
+template <typename Derived>
+struct FakeWindow {
+    std::vector<int> calls;
+    void OnA(int) {}
+    void OnB(int) {}
+    void OnC(int) {}
+    void OnD(int) {}
+};
+/** 模拟 WebWindow 这样的中间基类, 重写了部分处理函数 */
+template <typename Derived>
+struct FakeMiddle : FakeWindow<Derived> {
+    void OnB(int x) { this->calls.push_back(20 + x); }
+};
+struct FakeApp : FakeMiddle<FakeApp> {
+    void OnA(int x) { calls.push_back(10 + x); }
+    void OnD(int x) { calls.push_back(40 + x); }
+};
+/** 直接使用基类, 没有重写任何处理函数 */
+struct FakeEmpty : FakeWindow<FakeEmpty> {};
+
+template <typename App, std::uint32_t Msg, auto Handler, auto Default>
+struct FakeEntry {
+    static constexpr std::uint32_t kMsg = Msg;
+    static constexpr bool kEnabled = IsOverridden<decltype(Handler), decltype(Default)>;
+    static void Invoke(App& app, int x) { (app.*Handler)(x); }
+};
+
+using AppBase = FakeWindow<FakeApp>;
+// 0x0002 和 0x0003 共用一个处理函数, 与鼠标按下的几个消息一样
+using AppTable = DispatchTable<FakeEntry<FakeApp, 0x0001, &FakeApp::OnA, &AppBase::OnA>,
+                               FakeEntry<FakeApp, 0x0002, &FakeApp::OnB, &AppBase::OnB>,
+                               FakeEntry<FakeApp, 0x0003, &FakeApp::OnB, &AppBase::OnB>,
+                               FakeEntry<FakeApp, 0x0004, &FakeApp::OnC, &AppBase::OnC>,
+                               FakeEntry<FakeApp, 0x0005, &FakeApp::OnD, &AppBase::OnD>>;
+using EmptyBase = FakeWindow<FakeEmpty>;
+using EmptyTable = DispatchTable<FakeEntry<FakeEmpty, 0x0001, &FakeEmpty::OnA, &EmptyBase::OnA>,
+                                 FakeEntry<FakeEmpty, 0x0002, &FakeEmpty::OnB, &EmptyBase::OnB>>;
+
+}  // namespace
+
+CXXUI_TEST(dispatch, overridden_handlers) {
+    // 子类重写的处理函数
+    static_assert(IsOverridden<decltype(&FakeApp::OnA), decltype(&AppBase::OnA)>);
+    static_assert(IsOverridden<decltype(&FakeApp::OnD), decltype(&AppBase::OnD)>);
+    // 中间基类重写的处理函数
+    static_assert(IsOverridden<decltype(&FakeApp::OnB), decltype(&AppBase::OnB)>);
+    // 继承自基类的默认处理函数
+    static_assert(!IsOverridden<decltype(&FakeApp::OnC), decltype(&AppBase::OnC)>);
+    static_assert(!IsOverridden<decltype(&FakeEmpty::OnA), decltype(&EmptyBase::OnA)>);
+    CXXUI_CHECK((IsOverridden<decltype(&FakeApp::OnB), decltype(&AppBase::OnB)>));
+    CXXUI_CHECK((!IsOverridden<decltype(&FakeApp::OnC), decltype(&AppBase::OnC)>));
+}
+
+CXXUI_TEST(dispatch, table_contains_only_overridden) {
+    static_assert(AppTable::kSize == 4);
+    CXXUI_CHECK_EQ(AppTable::kSize, 4u);
+    CXXUI_CHECK((std::vector<std::uint32_t>(AppTable::kMessages.begin(),
+                                            AppTable::kMessages.end()) ==
+                 std::vector<std::uint32_t>{0x0001, 0x0002, 0x0003, 0x0005}));
+    static_assert(AppTable::Contains(0x0002) && !AppTable::Contains(0x0004));
+    CXXUI_CHECK(!AppTable::Contains(0x0004));
+    CXXUI_CHECK(!AppTable::Contains(0x0100));
+    static_assert(EmptyTable::kSize == 0 && EmptyTable::kMessages.empty());
+    CXXUI_CHECK(!EmptyTable::Contains(0x0001));
+}
+
+CXXUI_TEST(dispatch, dispatch_calls_handler) {
+    FakeApp app;
+    CXXUI_CHECK(AppTable::Dispatch(0x0001, app, 1));
+    CXXUI_CHECK(AppTable::Dispatch(0x0002, app, 2));
+    CXXUI_CHECK(AppTable::Dispatch(0x0003, app, 3));
+    CXXUI_CHECK(AppTable::Dispatch(0x0005, app, 5));
+    CXXUI_CHECK((app.calls == std::vector<int>{11, 22, 23, 45}));
+}
+
+CXXUI_TEST(dispatch, unhandled_messages) {
+    FakeApp app;
+    // 没有重写的处理函数和表中没有的消息都不处理
+    CXXUI_CHECK(!AppTable::Dispatch(0x0004, app, 4));
+    CXXUI_CHECK(!AppTable::Dispatch(0x0000, app, 0));
+    CXXUI_CHECK(!AppTable::Dispatch(0x0100, app, 1));
+    CXXUI_CHECK(app.calls.empty());
+    FakeEmpty empty;
+    CXXUI_CHECK(!EmptyTable::Dispatch(0x0001, empty, 1));
+    CXXUI_CHECK(!EmptyTable::Dispatch(0x0002, empty, 2));
+    CXXUI_CHECK(empty.calls.empty());
+}
@@ -0,0 +1,255 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cxxui/core/executor.hpp>
+#include <cxxui/core/task.hpp>
+#include "fake_ui_loop.hpp"
+#include "test.hpp"
+
+using namespace cxxui;
+using namespace cxxui::detail;
+using namespace cxxui::test;
+
+namespace {
+
+/** 等待其他线程中的条件成立, 超时返回 false */
+template <typename Pred>
+bool WaitFor(Pred done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+/** 阻塞线程池线程直到 Open, 用来控制任务完成的时机 */
+class Gate {
+public:
+    void Wait() const {
+        WaitFor([this] { return open_.load(); });
+    }
+    void Open() { open_.store(true); }
+
+private:
+    std::atomic<bool> open_{false};
+};
+
+}  // namespace
+
+CXXUI_TEST(executor, then_chain) {
+    Executor executor(2);
+    CXXUI_CHECK_EQ(executor.GetThreadCount(), 2u);
+    CXXUI_CHECK_EQ(executor.Submit([] { return 41; }).Then([](int v) { return v + 1; }).Get(), 42);
+    // 只能移动的结果
+    int moved = executor.Submit([] { return std::make_unique<int>(5); })
+                    .Then([](std::unique_ptr<int> v) { return *v * 2; })
+                    .Get();
+    CXXUI_CHECK_EQ(moved, 10);
+    std::atomic<int> count{0};
+    int last = executor.Submit([&] { ++count; })
+                   .Then([&] { ++count; })
+                   .Then([&] {
+                       ++count;
+                       return 3;
+                   })
+                   .Get();
+    CXXUI_CHECK_EQ(last, 3);
+    CXXUI_CHECK_EQ(count.load(), 3);
+}
+
+CXXUI_TEST(executor, error_skips_continuations) {
+    Executor executor(2);
+    bool called = false;
+    Future<int> future = executor.Submit([]() -> int { throw std::runtime_error("failed"); })
+                             .Then([&](int) {
+                                 called = true;
+                                 return 1;
+                             })
+                             .Then([](int v) { return v; });
+    std::string error;
+    try {
+        future.Get();
+    } catch (const std::runtime_error& e) {
+        error = e.what();
+    }
+    CXXUI_CHECK_EQ(error, std::string("failed"));
+    CXXUI_CHECK(!called);
+    // Post 的任务抛出异常不影响线程
+    executor.Post([] { throw std::runtime_error("ignored"); });
+    CXXUI_CHECK_EQ(executor.Submit([] { return 1; }).Get(), 1);
+}
+
+CXXUI_TEST(executor, priority_order) {
+    Executor executor(1);
+    Gate gate;
+    std::atomic<bool> started{false};
+    executor.Post([&] {
+        started.store(true);
+        gate.Wait();
+    });
+    CXXUI_CHECK(WaitFor([&] { return started.load(); }));
+    std::mutex mutex;
+    std::vector<int> order;
+    auto add = [&](int value, TaskPriority priority) {
+        executor.Post(
+            [&, value] {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back(value);
+            },
+            priority);
+    };
+    for (int i = 0; i < 3; ++i) {
+        add(i + 10, TaskPriority::LOW);
+        add(i, TaskPriority::HIGH);
+        add(i + 5, TaskPriority::NORMAL);
+    }
+    gate.Open();
+    executor.Submit([] {}, TaskPriority::LOW).Get();
+    // 外部投递的任务按优先级, 同优先级按投递顺序
+    CXXUI_CHECK(order == (std::vector<int>{0, 1, 2, 5, 6, 7, 10, 11, 12}));
+}
+
+CXXUI_TEST(executor, destruction_runs_queued_jobs) {
+    std::atomic<int> count{0};
+    {
+        Executor executor(2);
+        for (int i = 0; i < 1000; ++i) {
+            executor.Post([&] { ++count; });
+        }
+    }
+    CXXUI_CHECK_EQ(count.load(), 1000);
+}
+
+CXXUI_TEST(executor, then_on_ui_runs_in_message_loop) {
+    FakeUiLoop loop(GetUiQueue());
+    Executor executor(2);
+    std::thread::id ui_thread = std::this_thread::get_id();
+    std::thread::id seen;
+    bool done = false;
+    Future<int> future = executor.Submit([] { return 7; }).ThenOnUi([&](int v) {
+        seen = std::this_thread::get_id();
+        done = true;
+        return v + 1;
+    });
+    // 消息循环处理之前不执行
+    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    CXXUI_CHECK(!done);
+    CXXUI_CHECK(loop.PumpUntil([&] { return done; }));
+    CXXUI_CHECK(seen == ui_thread);
+    CXXUI_CHECK_EQ(std::move(future).Then([](int v) { return v * 10; }).Get(), 80);
+}
+
+CXXUI_TEST(executor, then_on_ui_after_thread_exit) {
+    Executor executor(1);
+    Gate gate;
+    std::atomic<bool> ran{false};
+    auto guard = std::make_shared<int>(0);
+    std::weak_ptr<int> watch = guard;
+    Future<int> future;
+    std::thread ui([&] {
+        future = executor
+                     .Submit([&] {
+                         gate.Wait();
+                         return 1;
+                     })
+                     .ThenOnUi([&ran, guard = std::move(guard)](int v) {
+                         ran.store(true);
+                         return v;
+                     });
+    });
+    // 线程退出时关闭它的队列, 之后完成的任务不再投递到已销毁的队列
+    ui.join();
+    gate.Open();
+    std::string error;
+    try {
+        future.Get();
+    } catch (const std::runtime_error& e) {
+        error = e.what();
+    }
+    CXXUI_CHECK_EQ(error, std::string("UI thread exited"));
+    CXXUI_CHECK(!ran.load());
+    // 丢弃的任务释放了捕获的对象
+    CXXUI_CHECK(WaitFor([&] { return watch.expired(); }));
+}
+
+#if CXXUI_HAS_COROUTINE
+namespace {
+
+Task<int> SumInBackground(Executor& executor, std::vector<std::thread::id>& threads) {
+    int a = co_await executor.Submit([] { return 20; });
+    threads.push_back(std::this_thread::get_id());
+    int b = co_await executor.Submit([] { return 1; }).Then([](int v) { return v * 2; });
+    threads.push_back(std::this_thread::get_id());
+    try {
+        co_await executor.Submit([]() -> int { throw std::runtime_error("failed"); });
+        b = 0;
+    } catch (const std::runtime_error&) {
+        threads.push_back(std::this_thread::get_id());
+    }
+    co_await executor.Submit([] {});
+    co_return a + b;
+}
+
+Task<> StoreSum(Executor& executor, std::vector<std::thread::id>& threads, int& sum) {
+    sum = co_await SumInBackground(executor, threads);
+}
+
+Task<> AwaitGate(Executor& executor, Gate& gate, std::atomic<bool>& resumed) {
+    co_await executor.Submit([&gate] { gate.Wait(); });
+    resumed.store(true);
+}
+
+}  // namespace
+
+CXXUI_TEST(executor, co_await_resumes_on_ui_thread) {
+    FakeUiLoop loop(GetUiQueue());
+    Executor executor(2);
+    std::vector<std::thread::id> threads;
+    int sum = 0;
+    Spawn(StoreSum(executor, threads, sum));
+    CXXUI_CHECK(loop.PumpUntil([&] { return sum != 0; }));
+    CXXUI_CHECK_EQ(sum, 22);
+    CXXUI_CHECK_EQ(threads.size(), 3u);
+    for (std::thread::id id : threads) {
+        CXXUI_CHECK(id == std::this_thread::get_id());
+    }
+}
+
+CXXUI_TEST(executor, co_await_destroyed_coroutine) {
+    FakeUiLoop loop(GetUiQueue());
+    Executor executor(1);
+    Gate gate;
+    std::atomic<bool> resumed{false};
+    {
+        Task<> task = AwaitGate(executor, gate, resumed);
+        // 开始执行到 co_await 挂起, 然后在完成之前销毁协程
+        task.await_suspend(std::noop_coroutine()).resume();
+    }
+    gate.Open();
+    executor.Submit([] {}).Get();
+    loop.PumpUntil([] { return false; }, std::chrono::milliseconds{20});
+    CXXUI_CHECK(!resumed.load());
+}
+
+CXXUI_TEST(executor, co_await_after_thread_exit) {
+    Executor executor(1);
+    Gate gate;
+    std::atomic<bool> resumed{false};
+    std::thread ui([&] { Spawn(AwaitGate(executor, gate, resumed)); });
+    ui.join();
+    gate.Open();
+    // 单线程的线程池按顺序执行, 之后的任务完成时恢复协程的投递已被丢弃
+    executor.Submit([] {}).Get();
+    CXXUI_CHECK(!resumed.load());
+}
+#endif
@@ -0,0 +1,167 @@
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <cxxui/core/detail/frame_clock.hpp>
+#include "test.hpp"
+
+using namespace cxxui::detail;
+using namespace std::chrono_literals;
+
+namespace {
+
+using TimePoint = FramePacer::TimePoint;
+using Duration = FramePacer::Duration;
+
+/** 模拟时钟的起点, 不从 0 开始以免与 FramePacer 的初始状态重合 */
+const TimePoint kStart{std::chrono::hours{1}};
+
+}  // namespace
+
+CXXUI_TEST(frame_clock, refresh_rate) {
+    FramePacer pacer;
+    CXXUI_CHECK(pacer.GetInterval() == Duration{1s} / 60);
+    pacer.SetRefreshRate(144);
+    CXXUI_CHECK(pacer.GetInterval() == Duration{1s} / 144);
+    // 无效的刷新率按 60Hz 处理
+    for (int rate : {1, 0, -30}) {
+        pacer.SetRefreshRate(rate);
+        CXXUI_CHECK(pacer.GetInterval() == Duration{1s} / 60);
+    }
+    CXXUI_CHECK(FramePacer{0}.GetInterval() == Duration{1s} / 60);
+}
+
+CXXUI_TEST(frame_clock, request_and_deadline) {
+    FramePacer pacer(100);
+    const Duration interval = pacer.GetInterval();
+    CXXUI_CHECK(!pacer.IsRequested());
+    CXXUI_CHECK(!pacer.IsDue(kStart));
+    CXXUI_CHECK(!pacer.GetTimeout(kStart));
+    // 第一帧立即到期
+    pacer.Request(kStart);
+    CXXUI_CHECK(pacer.IsRequested());
+    CXXUI_CHECK(pacer.IsDue(kStart));
+    CXXUI_CHECK(pacer.GetTimeout(kStart) == Duration::zero());
+    CXXUI_CHECK(pacer.BeginFrame(kStart) == kStart);
+    CXXUI_CHECK(!pacer.IsRequested());
+    // 距离上一帧不足一个周期时等到下一个周期
+    TimePoint now = kStart + 3ms;
+    pacer.Request(now);
+    CXXUI_CHECK(!pacer.IsDue(now));
+    CXXUI_CHECK(pacer.GetTimeout(now) == interval - 3ms);
+    // 重复请求不改变时间点
+    pacer.Request(now + 1ms);
+    CXXUI_CHECK(pacer.GetTimeout(now) == interval - 3ms);
+    // 允许提前半个周期
+    CXXUI_CHECK(!pacer.IsDue(kStart + interval / 2 - 1ns));
+    CXXUI_CHECK(pacer.IsDue(kStart + interval / 2));
+    CXXUI_CHECK(pacer.IsDue(kStart + interval - 1ms));
+    CXXUI_CHECK(pacer.GetTimeout(kStart + interval + 1ms) == Duration::zero());
+    // 空闲很久后请求, 立即到期
+    pacer.BeginFrame(kStart + interval);
+    now = kStart + 10s;
+    pacer.Request(now);
+    CXXUI_CHECK(pacer.IsDue(now));
+}
+
+CXXUI_TEST(frame_clock, late_frames_keep_phase) {
+    FramePacer pacer(100);
+    const Duration interval = pacer.GetInterval();
+    pacer.Request(kStart);
+    pacer.BeginFrame(kStart);
+    // 晚了不到一个周期, 下一帧仍然在原来的相位上
+    pacer.Request(kStart + 1ms);
+    pacer.BeginFrame(kStart + interval + 4ms);
+    pacer.Request(kStart + interval + 5ms);
+    CXXUI_CHECK(!pacer.IsDue(kStart + 2 * interval - interval / 2 - 1ns));
+    CXXUI_CHECK(pacer.IsDue(kStart + 2 * interval - 1ms));
+    CXXUI_CHECK(pacer.GetTimeout(kStart + interval + 5ms) == interval - 5ms);
+    // 落后超过一个周期时以当前时间重新对齐
+    TimePoint late = kStart + 5 * interval + 3ms;
+    pacer.BeginFrame(late);
+    pacer.Request(late);
+    CXXUI_CHECK(pacer.GetTimeout(late) == interval);
+    CXXUI_CHECK(!pacer.IsDue(late + interval / 2 - 1ns));
+    CXXUI_CHECK(pacer.IsDue(late + interval));
+}
+
+CXXUI_TEST(frame_clock, steady_frame_rate) {
+    // 每 1ms 请求一次帧, 第二秒内的帧数由刷新率决定
+    FramePacer pacer(50);
+    int frames = 0;
+    for (TimePoint now = kStart; now < kStart + 2s; now += 1ms) {
+        pacer.Request(now);
+        if (pacer.IsDue(now)) {
+            pacer.BeginFrame(now);
+            frames += now >= kStart + 1s;
+        }
+    }
+    CXXUI_CHECK_EQ(frames, 50);
+}
+
+CXXUI_TEST(frame_clock, early_timer_keeps_refresh_rate) {
+    // 模拟 WM_TIMER: 按毫秒向上取整, 不少于 USER_TIMER_MINIMUM(10ms), 实际提前 1ms 触发
+    auto fire_time = [](TimePoint now, Duration timeout) {
+        Duration ms = std::chrono::ceil<std::chrono::milliseconds>(timeout);
+        return now + (ms > 10ms ? ms : Duration{10ms}) - 1ms;
+    };
+    FramePacer pacer(60);
+    const Duration interval = pacer.GetInterval();
+    std::vector<TimePoint> frames;
+    TimePoint now = kStart;
+    pacer.Request(now);
+    while (now < kStart + 1s) {
+        if (pacer.IsDue(now)) {
+            pacer.BeginFrame(now);
+            frames.push_back(now);
+            pacer.Request(now);
+        }
+        now = fire_time(now, *pacer.GetTimeout(now));
+    }
+    // 提前触发的定时器不会把帧推迟到下一次定时器
+    CXXUI_CHECK(frames.size() >= 59 && frames.size() <= 61);
+    for (std::size_t i = 1; i < frames.size(); ++i) {
+        CXXUI_CHECK(frames[i] - frames[i - 1] <= interval + 1ms);
+    }
+}
+
+CXXUI_TEST(frame_clock, coalescer_latest_value_once_per_frame) {
+    FramePacer pacer(100);
+    Coalescer<std::string> moves;
+    std::vector<std::string> delivered;
+    int frames = 0;
+    auto run_frame = [&](TimePoint now) {
+        if (!pacer.IsDue(now)) {
+            return;
+        }
+        pacer.BeginFrame(now);
+        ++frames;
+        if (auto value = moves.Take()) {
+            delivered.push_back(*value);
+        }
+    };
+    CXXUI_CHECK(!moves.HasPending());
+    CXXUI_CHECK(!moves.Take());
+    // 每 2ms 一个事件, 定时器每 10ms 触发一帧, 每帧只处理最新的事件
+    for (int ms = 0; ms < 30; ms += 2) {
+        TimePoint now = kStart + std::chrono::milliseconds{ms};
+        std::string move = "move";
+        moves.Push(move += std::to_string(ms));
+        pacer.Request(now);
+        if (ms % 10 == 0) {
+            run_frame(now);
+        }
+    }
+    CXXUI_CHECK_EQ(frames, 3);
+    CXXUI_CHECK(delivered == (std::vector<std::string>{"move0", "move10", "move20"}));
+    CXXUI_CHECK(moves.HasPending());
+    // 剩下的事件在下一帧处理, 没有新事件的帧不产生回调
+    run_frame(kStart + 30ms);
+    pacer.Request(kStart + 31ms);
+    run_frame(kStart + 40ms);
+    CXXUI_CHECK_EQ(frames, 5);
+    CXXUI_CHECK(delivered == (std::vector<std::string>{"move0", "move10", "move20", "move28"}));
+    CXXUI_CHECK(!moves.HasPending());
+    CXXUI_CHECK(!moves.Take());
+}
@@ -0,0 +1,187 @@
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <cxxui/core/detail/idle_scheduler.hpp>
+#include "test.hpp"
+
+using namespace cxxui::detail;
+using namespace std::chrono_literals;
+
+namespace {
+
+using TimePoint = IdleScheduler::TimePoint;
+
+/** 模拟的时钟, 只在测试推进时走动 */
+struct FakeClock {
+    TimePoint now{};
+    TimePoint operator()() const { return now; }
+};
+
+/**
+ * @brief 模拟的消息源
+ * @details 按时间点到达的输入消息，消息循环先处理完已到达的消息再进入空闲时间片
+ */
+struct FakeMessages {
+    FakeClock& clock;
+    std::deque<TimePoint> arrivals;
+    /** 是否有已到达但未处理的输入 */
+    bool HasInput() const { return !arrivals.empty() && arrivals.front() <= clock.now; }
+    /** 处理已到达的输入, 每条消息耗时 1ms */
+    void Dispatch() {
+        while (HasInput()) {
+            arrivals.pop_front();
+            clock.now += 1ms;
+        }
+    }
+};
+
+/** 执行时记录名字并推进时钟的任务 */
+std::function<void()> Work(std::vector<std::string>& log,
+                           FakeClock& clock,
+                           std::string name,
+                           IdleScheduler::Duration cost = 1ms) {
+    return [&log, &clock, name = std::move(name), cost] {
+        log.push_back(name);
+        clock.now += cost;
+    };
+}
+
+}  // namespace
+
+CXXUI_TEST(idle, priority_then_fifo) {
+    FakeClock clock;
+    IdleScheduler scheduler;
+    std::vector<std::string> log;
+    TimePoint far = clock.now + 1h;
+    scheduler.Schedule(Work(log, clock, "low"), -1, far);
+    scheduler.Schedule(Work(log, clock, "normal1"), 0, far);
+    scheduler.Schedule(Work(log, clock, "high"), 1, far);
+    scheduler.Schedule(Work(log, clock, "normal2"), 0, far);
+    scheduler.SetBudget(1h);
+    CXXUI_CHECK_EQ(scheduler.RunSlice(clock, [] { return false; }), 4u);
+    CXXUI_CHECK(log == (std::vector<std::string>{"high", "normal1", "normal2", "low"}));
+    CXXUI_CHECK(scheduler.IsEmpty());
+}
+
+CXXUI_TEST(idle, budget_limits_slice) {
+    FakeClock clock;
+    IdleScheduler scheduler;
+    std::vector<std::string> log;
+    for (int i = 0; i < 10; ++i) {
+        scheduler.Schedule(Work(log, clock, std::to_string(i), 2ms), 0, clock.now + 1h);
+    }
+    scheduler.SetBudget(5ms);
+    // 2ms 的任务在 5ms 预算内执行 3 个, 第 3 个执行完才超出预算
+    CXXUI_CHECK_EQ(scheduler.RunSlice(clock, [] { return false; }), 3u);
+    CXXUI_CHECK_EQ(scheduler.Size(), 7u);
+    CXXUI_CHECK_EQ(scheduler.RunSlice(clock, [] { return false; }), 3u);
+    CXXUI_CHECK_EQ(scheduler.RunSlice(clock, [] { return false; }), 3u);
+    CXXUI_CHECK_EQ(scheduler.RunSlice(clock, [] { return false; }), 1u);
+    CXXUI_CHECK(scheduler.IsEmpty());
+}
+
+CXXUI_TEST(idle, yields_to_pending_input) {
+    FakeClock clock;
+    IdleScheduler scheduler;
+    std::vector<std::string> log;
+    scheduler.Schedule(Work(log, clock, "a"), 0, clock.now + 1h);
+    scheduler.Schedule(Work(log, clock, "b"), 0, clock.now + 1h);
+    CXXUI_CHECK_EQ(scheduler.RunSlice(clock, [] { return true; }), 0u);
+    // 第一个任务执行后输入到达, 立即让出
+    bool input = false;
+    auto has_input = [&input] { return input; };
+    scheduler.Schedule([&input] { input = true; }, 1, clock.now + 1h);
+    CXXUI_CHECK_EQ(scheduler.RunSlice(clock, has_input), 1u);
+    CXXUI_CHECK(log.empty());
+    CXXUI_CHECK_EQ(scheduler.Size(), 2u);
+}
+
+CXXUI_TEST(idle, overdue_runs_one_despite_input) {
+    FakeClock clock;
+    IdleScheduler scheduler;
+    std::vector<std::string> log;
+    scheduler.Schedule(Work(log, clock, "late1"), -1, clock.now + 10ms);
+    scheduler.Schedule(Work(log, clock, "late2"), -1, clock.now + 10ms);
+    scheduler.Schedule(Work(log, clock, "fresh"), 1, clock.now + 1h);
+    clock.now += 20ms;
+    CXXUI_CHECK_EQ(scheduler.RunSlice(clock, [] { return true; }), 1u);
+    CXXUI_CHECK(log == (std::vector<std::string>{"late1"}));
+    // 没有输入时超时的任务仍然先于优先级高的任务
+    CXXUI_CHECK_EQ(scheduler.RunSlice(clock, [] { return false; }), 2u);
+    CXXUI_CHECK(log == (std::vector<std::string>{"late1", "late2", "fresh"}));
+}
+
+CXXUI_TEST(idle, cancel) {
+    FakeClock clock;
+    IdleScheduler scheduler;
+    std::vector<std::string> log;
+    auto a = scheduler.Schedule(Work(log, clock, "a"), 0, clock.now + 1ms);
+    scheduler.Schedule(Work(log, clock, "b"), 0, clock.now + 1h);
+    CXXUI_CHECK(scheduler.Cancel(a));
+    CXXUI_CHECK(!scheduler.Cancel(a));
+    clock.now += 1s;
+    scheduler.RunSlice(clock, [] { return false; });
+    CXXUI_CHECK(log == (std::vector<std::string>{"b"}));
+    CXXUI_CHECK(!scheduler.Cancel(a + 1));
+}
+
+CXXUI_TEST(idle, simulated_input_never_waits_for_tasks) {
+    FakeClock clock;
+    FakeMessages messages{clock, {}};
+    // 每 3ms 一条输入, 持续 300ms
+    for (int i = 0; i < 100; ++i) {
+        messages.arrivals.push_back(clock.now + i * 3ms);
+    }
+    IdleScheduler scheduler;
+    scheduler.SetBudget(5ms);
+    std::vector<std::string> log;
+    std::vector<TimePoint> ran_at;
+    for (int i = 0; i < 200; ++i) {
+        scheduler.Schedule(
+            [&] {
+                // 没有超时的任务只在没有待处理输入时执行
+                if (messages.HasInput()) {
+                    log.push_back("ran with input");
+                }
+                ran_at.push_back(clock.now);
+                clock.now += 1ms;
+            },
+            0, clock.now + 1h);
+    }
+    std::size_t slices = 0;
+    while (!scheduler.IsEmpty() && slices < 10000) {
+        messages.Dispatch();
+        scheduler.RunSlice(clock, [&messages] { return messages.HasInput(); });
+        // 消息循环空闲等待到下一条输入或下一个时间片
+        clock.now += 100us;
+        ++slices;
+    }
+    CXXUI_CHECK(log.empty());
+    CXXUI_CHECK(scheduler.IsEmpty());
+    CXXUI_CHECK_EQ(ran_at.size(), 200u);
+}
+
+CXXUI_TEST(idle, deadline_prevents_starvation) {
+    FakeClock clock;
+    IdleScheduler scheduler;
+    scheduler.SetBudget(5ms);
+    TimePoint deadline = clock.now + 50ms;
+    std::optional<TimePoint> ran;
+    scheduler.Schedule([&] { ran = clock.now; }, -1, deadline);
+    // 高优先级的任务源源不断, 每个任务再投递一个新任务
+    std::function<void()> flood = [&] {
+        clock.now += 1ms;
+        scheduler.Schedule(flood, 1, clock.now + 1h);
+    };
+    scheduler.Schedule(flood, 1, clock.now + 1h);
+    for (int i = 0; i < 100 && !ran; ++i) {
+        scheduler.RunSlice(clock, [] { return false; });
+    }
+    CXXUI_CHECK(ran.has_value());
+    // 超时后的下一个任务就是它
+    CXXUI_CHECK(ran && *ran >= deadline && *ran - deadline <= 1ms);
+}
@@ -0,0 +1,110 @@
+#include <sstream>
+#include <string>
+#include <nlohmann/json.hpp>
+
+#include <cxxui/web_win/js_msg_map.hpp>
+#include <cxxui/web_win/impl/detail/js_bridge.hpp>
+#include "node.hpp"
+#include "test.hpp"
+
+using namespace cxxui;
+using namespace cxxui::test;
+
+namespace {
+
+JsMsgMap<> MakeMap() {
+    JsMsgMap<> map;
+    map.bind("/add", [](json& data) { return data.at(0).get<int>() + data.at(1).get<int>(); });
+    map.bind("/fail", [](json&) -> JsMsgResult { return FailJsMsg("no user"); });
+    return map;
+}
+
+/**
+ * @brief 在 node 中模拟 webview 运行消息接口
+ * @details 发起 3 个 cxxui.call，输出发出的消息；然后按相反顺序派发 replies 中的响应，
+ *   再派发一条带有 id 字段的普通消息，输出各个请求和普通消息的处理结果
+ */
+std::string MakePage(const json& replies) {
+    std::string script = R"JS(
+var window = globalThis;
+const posted = [];
+let listener;
+window.chrome = { webview: {
+    postMessage: (msg) => posted.push(msg),
+    addEventListener: (type, fn) => { listener = fn; },
+} };
+)JS";
+    script.append(detail::kJsBridgeScript);
+    script.append(R"JS(
+const results = [];
+window.SetCppMsgHandler((msg) => results.push(['user', msg]));
+[cxxui.call('/add', [1, 2]), cxxui.call('/fail', null), cxxui.call('/none', 1)].forEach((p, i) => {
+    p.then((v) => results.push(['ok', i, v]), (e) => results.push(['error', i, e.code, e.message]));
+});
+console.log(JSON.stringify(posted));
+)JS");
+    script.append("const replies = ").append(replies.dump()).append(";\n");
+    script.append(R"JS(
+replies.reverse().forEach((reply) => listener({ data: reply }));
+listener({ data: { id: 1, text: 'hello' } });
+setTimeout(() => console.log(JSON.stringify(results)), 0);
+)JS");
+    return script;
+}
+
+}  // namespace
+
+CXXUI_TEST(js_bridge, reply_echoes_call_id) {
+    JsMsgMap<> map = MakeMap();
+    auto handler = map.GetHandler();
+    json reply = json::parse(handler(R"({"__cxxui_id": 3, "url": "/add", "data": [4, 5]})"));
+    CXXUI_CHECK_EQ(reply.value("__cxxui_id", 0), 3);
+    CXXUI_CHECK_EQ(reply.value("data", 0), 9);
+    // 错误响应同样带回编号, 用户的 id 字段也原样返回
+    reply = json::parse(handler(R"({"__cxxui_id": 4, "id": "user", "url": "/none"})"));
+    CXXUI_CHECK_EQ(reply.value("__cxxui_id", 0), 4);
+    CXXUI_CHECK_EQ(reply.value("id", std::string{}), "user");
+    CXXUI_CHECK_EQ(reply.value("code", 0), static_cast<int>(JsMsgError::NO_METHOD));
+    reply = json::parse(handler(R"({"__cxxui_id": 5})"));
+    CXXUI_CHECK_EQ(reply.value("__cxxui_id", 0), 5);
+    CXXUI_CHECK_EQ(reply.value("code", 0), static_cast<int>(JsMsgError::INVALID_REQ));
+}
+
+CXXUI_TEST(js_bridge, call_round_trip) {
+    if (!HasNode()) {
+        return;
+    }
+    // 第一次运行取得页面发出的请求, 由 C++ 处理后在第二次运行中派发响应
+    auto first = RunNode(MakePage(json::array()));
+    CXXUI_CHECK(first.has_value());
+    std::istringstream first_lines(first.value_or(""));
+    std::string line;
+    std::getline(first_lines, line);
+    json requests = json::parse(line, nullptr, false);
+    CXXUI_CHECK(requests.is_array() && requests.size() == 3);
+    if (!requests.is_array()) {
+        return;
+    }
+    CXXUI_CHECK_EQ(requests[0].dump(), R"({"__cxxui_id":1,"data":[1,2],"url":"/add"})");
+
+    JsMsgMap<> map = MakeMap();
+    auto handler = map.GetHandler();
+    json replies = json::array();
+    for (const json& request : requests) {
+        replies.push_back(json::parse(handler(request.dump())));
+    }
+    auto second = RunNode(MakePage(replies));
+    CXXUI_CHECK(second.has_value());
+    std::istringstream second_lines(second.value_or(""));
+    std::getline(second_lines, line);
+    CXXUI_CHECK_EQ(json::parse(line, nullptr, false), requests);
+    std::getline(second_lines, line);
+    // 带有 id 的普通消息交给 SetCppMsgHandler, 响应按编号找到各自的请求
+    json expected = json::array({
+        json::array({"user", {{"id", 1}, {"text", "hello"}}}),
+        json::array({"error", 2, static_cast<int>(JsMsgError::NO_METHOD), "Method not found!"}),
+        json::array({"error", 1, static_cast<int>(JsMsgError::EXEC_ERROR), "no user"}),
+        json::array({"ok", 0, 3}),
+    });
+    CXXUI_CHECK_EQ(json::parse(line, nullptr, false), expected);
+}
@@ -0,0 +1,132 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include <cxxui/web_win/js_msg_map.hpp>
+#include "test.hpp"
+
+using namespace cxxui;
+
+namespace {
+
+/** nlohmann 对同一个错误抛出的异常信息, func 返回 json */
+template <typename Func>
+std::string GetLibraryError(Func&& func) {
+    try {
+        json value = func();
+        static_cast<void>(value);
+    } catch (const std::exception& e) {
+        return e.what();
+    }
+    return {};
+}
+
+template <typename Map>
+json Call(const Map& map, const std::string& msg) {
+    return json::parse(map.GetHandler()(msg));
+}
+
+template <typename Map>
+void CheckInvalidRequests() {
+    Map map;
+    struct Case {
+        const char* msg;
+        std::string error;
+    };
+    const Case cases[] = {
+        {"{\"url\": ", GetLibraryError([] { return json::parse("{\"url\": "); })},
+        {"[1]", "missing url"},
+        {"\"text\"", "missing url"},
+        {"{\"id\": 1}", "missing url"},
+        {"{\"url\": 5}", "url must be a string, but is number"},
+        {"{\"url\": null}", "url must be a string, but is null"},
+    };
+    for (const Case& c : cases) {
+        json reply = Call(map, c.msg);
+        CXXUI_CHECK_EQ(reply.value("code", -1), static_cast<int>(JsMsgError::INVALID_REQ));
+        CXXUI_CHECK(!c.error.empty());
+        CXXUI_CHECK_EQ(reply.value("error", std::string{}), c.error);
+    }
+    // 能解析出对象时其他字段原样返回
+    CXXUI_CHECK_EQ(Call(map, "{\"id\": 7, \"url\": null}").value("id", 0), 7);
+}
+
+}  // namespace
+
+CXXUI_TEST(js_msg, invalid_requests) {
+    CheckInvalidRequests<JsMsgMap<>>();
+    CheckInvalidRequests<ArenaJsMsgMap>();
+}
+
+CXXUI_TEST(js_msg, dispatch_results) {
+    JsMsgMap<> map;
+    map.bind("/add", [](json& data) { return data.at(0).get<int>() + data.at(1).get<int>(); });
+    map.bind("/fail", [](json&) -> JsMsgResult { return FailJsMsg("no user"); });
+    map.bind("/throw", [](json&) -> json { throw std::runtime_error("broken"); });
+    map.bind("/throw_int", [](json&) -> json { throw 1; });
+
+    json reply = Call(map, R"({"id": 1, "url": "/add", "data": [2, 3]})");
+    CXXUI_CHECK_EQ(reply.value("code", -1), static_cast<int>(JsMsgError::SUCCESS));
+    CXXUI_CHECK_EQ(reply.value("data", 0), 5);
+    CXXUI_CHECK_EQ(reply.value("id", 0), 1);
+
+    reply = Call(map, R"({"url": "/fail"})");
+    CXXUI_CHECK_EQ(reply.value("code", -1), static_cast<int>(JsMsgError::EXEC_ERROR));
+    CXXUI_CHECK_EQ(reply.value("error", std::string{}), "no user");
+
+    reply = Call(map, R"({"url": "/throw"})");
+    CXXUI_CHECK_EQ(reply.value("code", -1), static_cast<int>(JsMsgError::EXEC_ERROR));
+    CXXUI_CHECK_EQ(reply.value("error", std::string{}), "broken");
+
+    // 不是 std::exception 的异常返回通用的错误
+    reply = Call(map, R"({"url": "/throw_int"})");
+    CXXUI_CHECK_EQ(reply.value("code", -1), static_cast<int>(JsMsgError::EXEC_ERROR));
+    CXXUI_CHECK_EQ(reply.value("error", std::string{}), "unknown exception");
+
+    // 响应函数中的 json 异常也原样返回
+    reply = Call(map, R"({"url": "/add", "data": [1]})");
+    CXXUI_CHECK_EQ(reply.value("error", std::string{}),
+                   GetLibraryError([] { return json::array({1}).at(1); }));
+
+    reply = Call(map, R"({"url": "/none"})");
+    CXXUI_CHECK_EQ(reply.value("code", -1), static_cast<int>(JsMsgError::NO_METHOD));
+}
+
+CXXUI_TEST(js_msg, arena_dispatch) {
+    ArenaJsMsgMap map;
+    map.bind("/echo", [](ArenaJson& data) { return data; });
+    for (int i = 0; i < 100; ++i) {
+        std::string msg = R"({"id": )" + std::to_string(i) + R"(, "url": "/echo", "data": "x"})";
+        json reply = Call(map, msg);
+        CXXUI_CHECK_EQ(reply.value("id", -1), i);
+        CXXUI_CHECK_EQ(reply.value("data", std::string{}), "x");
+    }
+}
+
+#if CXXUI_HAS_COROUTINE
+CXXUI_TEST(js_msg, async_exceptions) {
+    JsMsgMap<> map;
+    map.bind("/throw", [](json&) -> Task<json> {
+        co_await Yield();
+        throw std::runtime_error("broken");
+    });
+    map.bind("/throw_int", [](json&) -> Task<json> {
+        co_await Yield();
+        throw 1;
+    });
+    std::vector<json> replies;
+    auto handler = map.GetAsyncHandler();
+    auto reply = [&replies](std::string msg) { replies.push_back(json::parse(msg)); };
+    handler(R"({"id": 1, "url": "/throw"})", reply);
+    handler(R"({"id": 2, "url": "/throw_int"})", reply);
+    while (detail::GetUiQueue().RunPending()) {
+    }
+    CXXUI_CHECK_EQ(replies.size(), 2u);
+    for (const json& r : replies) {
+        CXXUI_CHECK_EQ(r.value("code", -1), static_cast<int>(JsMsgError::EXEC_ERROR));
+    }
+    CXXUI_CHECK_EQ(replies.at(0).value("error", std::string{}), "broken");
+    CXXUI_CHECK_EQ(replies.at(1).value("error", std::string{}), "unknown exception");
+}
+#endif
@@ -0,0 +1,286 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <cxxui/core/layout.hpp>
+#include "test.hpp"
+
+using namespace cxxui;
+
+namespace {
+
+bool Same(const Rect& a, const Rect& b) {
+    return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+}
+
+bool Contains(const std::vector<LayoutNode*>& nodes, const LayoutNode& node) {
+    return std::find(nodes.begin(), nodes.end(), &node) != nodes.end();
+}
+
+/** 句柄只用于标记, 不需要指向真实对象 */
+void* Handle(int id) { return reinterpret_cast<void*>(static_cast<std::uintptr_t>(id)); }
+
+}  // namespace
+
+CXXUI_TEST(layout, row_fixed_and_grow) {
+    LayoutNode root;
+    LayoutNode& a = root.AddChild().SetWidth(200);
+    LayoutNode& b = root.AddChild().SetGrow(1);
+    LayoutNode& c = root.AddChild().SetGrow(3);
+    root.Compute({0, 0, 1000, 100});
+    CXXUI_CHECK(Same(a.GetRect(), {0, 0, 200, 100}));
+    CXXUI_CHECK(Same(b.GetRect(), {200, 0, 400, 100}));
+    CXXUI_CHECK(Same(c.GetRect(), {400, 0, 1000, 100}));
+    CXXUI_CHECK(!root.IsDirty() && !c.IsDirty());
+}
+
+CXXUI_TEST(layout, column_padding_gap_margin) {
+    LayoutNode root;
+    root.SetDirection(FlexDirection::COLUMN).SetPadding(10).SetGap(5);
+    LayoutNode& a = root.AddChild().SetHeight(50).SetMargin({2, 3, 4, 0});
+    LayoutNode& b = root.AddChild().SetGrow(1);
+    root.Compute({100, 100, 300, 400});
+    CXXUI_CHECK(Same(a.GetRect(), {112, 113, 286, 163}));
+    // 剩余高度: 300 - 20(padding) - 53(a) - 5(gap)
+    CXXUI_CHECK(Same(b.GetRect(), {110, 168, 290, 390}));
+}
+
+CXXUI_TEST(layout, justify) {
+    auto run = [](FlexJustify justify) {
+        LayoutNode root;
+        root.SetJustify(justify);
+        root.AddChild().SetWidth(100);
+        root.AddChild().SetWidth(100);
+        root.AddChild().SetWidth(100);
+        root.Compute({0, 0, 600, 10});
+        std::vector<int> lefts;
+        for (std::size_t i = 0; i < root.GetChildCount(); ++i) {
+            lefts.push_back(root.GetChild(i).GetRect().left);
+        }
+        return lefts;
+    };
+    CXXUI_CHECK(run(FlexJustify::START) == (std::vector<int>{0, 100, 200}));
+    CXXUI_CHECK(run(FlexJustify::CENTER) == (std::vector<int>{150, 250, 350}));
+    CXXUI_CHECK(run(FlexJustify::END) == (std::vector<int>{300, 400, 500}));
+    CXXUI_CHECK(run(FlexJustify::SPACE_BETWEEN) == (std::vector<int>{0, 250, 500}));
+}
+
+CXXUI_TEST(layout, align_cross_axis) {
+    LayoutNode root;
+    LayoutNode& child = root.AddChild().SetWidth(50).SetHeight(40);
+    LayoutNode& autosize = root.AddChild().SetWidth(50);
+    root.SetAlign(FlexAlign::CENTER).Compute({0, 0, 100, 100});
+    CXXUI_CHECK(Same(child.GetRect(), {0, 30, 50, 70}));
+    // 不拉伸时自动尺寸为 0
+    CXXUI_CHECK(Same(autosize.GetRect(), {50, 50, 100, 50}));
+    root.SetAlign(FlexAlign::END).Compute({0, 0, 100, 100});
+    CXXUI_CHECK(Same(child.GetRect(), {0, 60, 50, 100}));
+    root.SetAlign(FlexAlign::START).Compute({0, 0, 100, 100});
+    CXXUI_CHECK(Same(child.GetRect(), {0, 0, 50, 40}));
+    root.SetAlign(FlexAlign::STRETCH).Compute({0, 0, 100, 100});
+    CXXUI_CHECK(Same(child.GetRect(), {0, 0, 50, 40}));
+    CXXUI_CHECK(Same(autosize.GetRect(), {50, 0, 100, 100}));
+}
+
+CXXUI_TEST(layout, shrink_respects_min_size) {
+    LayoutNode root;
+    LayoutNode& a = root.AddChild().SetWidth(400);
+    LayoutNode& b = root.AddChild().SetWidth(400);
+    LayoutNode& c = root.AddChild().SetWidth(400);
+    root.Compute({0, 0, 900, 10});
+    CXXUI_CHECK_EQ(a.GetRect().Width(), 300);
+    CXXUI_CHECK_EQ(b.GetRect().Width(), 300);
+    CXXUI_CHECK(Same(c.GetRect(), {600, 0, 900, 10}));
+    // 受最小宽度限制的部分溢出, 不再二次分配
+    c.SetMinWidth(380);
+    root.Compute({0, 0, 900, 10});
+    CXXUI_CHECK(Same(c.GetRect(), {600, 0, 980, 10}));
+    // 不收缩的节点保持基础尺寸
+    a.SetShrink(0);
+    root.Compute({0, 0, 900, 10});
+    CXXUI_CHECK_EQ(a.GetRect().Width(), 400);
+}
+
+CXXUI_TEST(layout, rounding_leaves_no_gaps) {
+    LayoutNode root;
+    for (int i = 0; i < 7; ++i) {
+        root.AddChild().SetGrow(1);
+    }
+    root.Compute({3, 0, 103, 10});
+    int expected_left = 3;
+    for (std::size_t i = 0; i < root.GetChildCount(); ++i) {
+        const Rect& r = root.GetChild(i).GetRect();
+        CXXUI_CHECK_EQ(r.left, expected_left);
+        CXXUI_CHECK(r.Width() == 14 || r.Width() == 15);
+        expected_left = r.right;
+    }
+    CXXUI_CHECK_EQ(expected_left, 103);
+}
+
+CXXUI_TEST(layout, incremental_touches_affected_subtree) {
+    // 根节点横向排列两列, 每列两个绑定了句柄的叶子
+    LayoutNode root;
+    LayoutNode& left = root.AddChild().SetGrow(1).SetDirection(FlexDirection::COLUMN);
+    LayoutNode& right = root.AddChild().SetGrow(1).SetDirection(FlexDirection::COLUMN);
+    LayoutNode& l0 = left.AddChild().SetHeight(100).SetHandle(Handle(1));
+    LayoutNode& l1 = left.AddChild().SetHeight(100).SetHandle(Handle(2));
+    LayoutNode& r0 = right.AddChild().SetHeight(100).SetHandle(Handle(3));
+    LayoutNode& r1 = right.AddChild().SetGrow(1).SetHandle(Handle(4));
+    std::vector<LayoutNode*> changed;
+    root.Compute({0, 0, 400, 300}, &changed);
+    CXXUI_CHECK_EQ(changed.size(), 4u);
+    changed.clear();
+    root.Compute({0, 0, 400, 300}, &changed);
+    CXXUI_CHECK(changed.empty());
+    // 只修改左列的第一个叶子, 右列不受影响
+    l0.SetHeight(150);
+    CXXUI_CHECK(left.IsDirty() && root.IsDirty() && !right.IsDirty());
+    root.Compute({0, 0, 400, 300}, &changed);
+    CXXUI_CHECK_EQ(changed.size(), 2u);
+    CXXUI_CHECK(Contains(changed, l0) && Contains(changed, l1));
+    CXXUI_CHECK(Same(l1.GetRect(), {0, 150, 200, 250}));
+    // 只改变高度时, 右列只有拉伸的叶子变化
+    changed.clear();
+    root.Compute({0, 0, 400, 500}, &changed);
+    CXXUI_CHECK_EQ(changed.size(), 1u);
+    CXXUI_CHECK(Contains(changed, r1));
+    CXXUI_CHECK(Same(r0.GetRect(), {200, 0, 400, 100}));
+    CXXUI_CHECK(Same(r1.GetRect(), {200, 100, 400, 500}));
+}
+
+CXXUI_TEST(layout, move_translates_subtree) {
+    LayoutNode root;
+    LayoutNode& a = root.AddChild().SetGrow(1).SetHandle(Handle(1));
+    LayoutNode& inner = a.AddChild().SetWidth(10).SetHandle(Handle(2));
+    root.Compute({0, 0, 100, 100});
+    std::vector<LayoutNode*> changed;
+    root.Compute({20, 30, 120, 130}, &changed);
+    CXXUI_CHECK_EQ(changed.size(), 2u);
+    CXXUI_CHECK(Same(a.GetRect(), {20, 30, 120, 130}));
+    CXXUI_CHECK(Same(inner.GetRect(), {20, 30, 30, 130}));
+}
+
+CXXUI_TEST(layout, remove_child_reflows) {
+    LayoutNode root;
+    LayoutNode& a = root.AddChild().SetGrow(1);
+    LayoutNode& b = root.AddChild().SetGrow(1);
+    root.Compute({0, 0, 100, 10});
+    CXXUI_CHECK_EQ(b.GetRect().Width(), 50);
+    root.RemoveChild(a);
+    CXXUI_CHECK(root.IsDirty());
+    root.Compute({0, 0, 100, 10});
+    CXXUI_CHECK_EQ(root.GetChildCount(), 1u);
+    CXXUI_CHECK(Same(b.GetRect(), {0, 0, 100, 10}));
+    CXXUI_CHECK(b.GetParent() == &root);
+}
+
+namespace {
+
+/** 随机测试中节点的样式 */
+struct Style {
+    int width = LayoutNode::kAuto;
+    int height = LayoutNode::kAuto;
+    int min_size = 0;
+    float grow = 0.0f;
+    float shrink = 1.0f;
+    int margin = 0;
+    int padding = 0;
+    int gap = 0;
+    FlexDirection direction = FlexDirection::ROW;
+    FlexAlign align = FlexAlign::STRETCH;
+    FlexJustify justify = FlexJustify::START;
+};
+
+Style RandomStyle(std::mt19937& rng) {
+    Style s;
+    s.width = rng() % 3 ? LayoutNode::kAuto : static_cast<int>(rng() % 200);
+    s.height = rng() % 3 ? LayoutNode::kAuto : static_cast<int>(rng() % 200);
+    s.min_size = rng() % 4 ? 0 : static_cast<int>(rng() % 50);
+    s.grow = static_cast<float>(rng() % 3);
+    s.shrink = static_cast<float>(rng() % 3);
+    s.margin = static_cast<int>(rng() % 5);
+    s.padding = static_cast<int>(rng() % 5);
+    s.gap = static_cast<int>(rng() % 5);
+    s.direction = rng() % 2 ? FlexDirection::ROW : FlexDirection::COLUMN;
+    s.align = static_cast<FlexAlign>(rng() % 4);
+    s.justify = static_cast<FlexJustify>(rng() % 4);
+    return s;
+}
+
+void Apply(LayoutNode& node, const Style& s) {
+    node.SetWidth(s.width)
+        .SetHeight(s.height)
+        .SetMinWidth(s.min_size)
+        .SetMinHeight(s.min_size)
+        .SetGrow(s.grow)
+        .SetShrink(s.shrink)
+        .SetMargin(s.margin)
+        .SetPadding(s.padding)
+        .SetGap(s.gap)
+        .SetDirection(s.direction)
+        .SetAlign(s.align)
+        .SetJustify(s.justify);
+}
+
+/** 按前序遍历的样式构建固定形状的树: 根节点 4 个子节点, 每个子节点 3 个叶子 */
+constexpr std::size_t kBranches = 4;
+constexpr std::size_t kLeaves = 3;
+constexpr std::size_t kNodes = 1 + kBranches * (1 + kLeaves);
+
+void Collect(LayoutNode& node, std::vector<LayoutNode*>& nodes) {
+    nodes.push_back(&node);
+    for (std::size_t i = 0; i < node.GetChildCount(); ++i) {
+        Collect(node.GetChild(i), nodes);
+    }
+}
+
+std::vector<LayoutNode*> Build(LayoutNode& root, const std::vector<Style>& styles) {
+    for (std::size_t i = 0; i < kBranches; ++i) {
+        LayoutNode& branch = root.AddChild();
+        for (std::size_t k = 0; k < kLeaves; ++k) {
+            branch.AddChild();
+        }
+    }
+    std::vector<LayoutNode*> nodes;
+    Collect(root, nodes);
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        Apply(*nodes[i], styles[i]);
+    }
+    return nodes;
+}
+
+}  // namespace
+
+CXXUI_TEST(layout, random_incremental_matches_full) {
+    std::mt19937 rng(36);
+    std::vector<Style> styles;
+    for (std::size_t i = 0; i < kNodes; ++i) {
+        styles.push_back(RandomStyle(rng));
+    }
+    LayoutNode incremental;
+    std::vector<LayoutNode*> nodes = Build(incremental, styles);
+    std::size_t mismatches = 0;
+    for (int step = 0; step < 500; ++step) {
+        // 随机修改一个节点的样式或根节点的区域
+        Rect bounds{static_cast<int>(rng() % 50), static_cast<int>(rng() % 50), 0, 0};
+        bounds.right = bounds.left + 100 + static_cast<int>(rng() % 900);
+        bounds.bottom = bounds.top + 100 + static_cast<int>(rng() % 700);
+        if (rng() % 2) {
+            std::size_t index = rng() % kNodes;
+            styles[index] = RandomStyle(rng);
+            Apply(*nodes[index], styles[index]);
+        }
+        incremental.Compute(bounds);
+        // 用最终样式重新构建并完整计算
+        LayoutNode full;
+        std::vector<LayoutNode*> expected = Build(full, styles);
+        full.Compute(bounds);
+        for (std::size_t i = 0; i < kNodes; ++i) {
+            if (!Same(nodes[i]->GetRect(), expected[i]->GetRect())) {
+                ++mismatches;
+            }
+        }
+    }
+    CXXUI_CHECK_EQ(mismatches, 0u);
+}
@@ -0,0 +1,99 @@
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cxxui/core/log.hpp>
+#include "test.hpp"
+
+using namespace cxxui;
+using namespace cxxui::detail;
+
+namespace {
+
+/** 收集输出的日志, 后台线程的间隔足够长, 只由测试调用 FlushLog 写入 */
+struct Capture {
+    std::mutex mutex;
+    std::string text;
+
+    Capture() {
+        StartLog(
+            [this](std::string_view data) {
+                std::lock_guard lock(mutex);
+                text.append(data);
+            },
+            LogFormat::TEXT, std::chrono::hours{1});
+    }
+    ~Capture() { StopLog(); }
+    std::string Get() {
+        std::lock_guard lock(mutex);
+        return text;
+    }
+};
+
+std::size_t Count(const std::string& text, const std::string& word) {
+    std::size_t count = 0;
+    for (auto pos = text.find(word); pos != std::string::npos; pos = text.find(word, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+void LogFromThreads(std::size_t threads, std::size_t records) {
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([records] {
+            for (std::size_t j = 0; j < records; ++j) {
+                LogWrite(LogLevel::WARN, "worker record", 5, "detail");
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+}  // namespace
+
+CXXUI_TEST(log, exited_rings_are_removed) {
+    Capture capture;
+    Logger& logger = Logger::GetInstance();
+    LogWrite(LogLevel::WARN, "main record");
+    std::size_t base = logger.GetRingCount();
+    LogFromThreads(8, 10);
+    CXXUI_CHECK_EQ(logger.GetRingCount(), base + 8);
+    // 一次写入就取空并移除已退出线程的暂存区
+    FlushLog();
+    CXXUI_CHECK_EQ(logger.GetRingCount(), base);
+    std::string text = capture.Get();
+    CXXUI_CHECK_EQ(Count(text, "worker record code=0x00000005 detail\n"), 80u);
+    CXXUI_CHECK_EQ(Count(text, "main record\n"), 1u);
+    // 重复的线程不会让暂存区累积
+    for (int round = 0; round < 10; ++round) {
+        LogFromThreads(4, 1);
+        FlushLog();
+    }
+    CXXUI_CHECK_EQ(logger.GetRingCount(), base);
+}
+
+CXXUI_TEST(log, dropped_records_are_reported) {
+    Capture capture;
+    LogFromThreads(1, LogRing::kCapacity + 10);
+    FlushLog();
+    std::string text = capture.Get();
+    CXXUI_CHECK_EQ(Count(text, "worker record"), LogRing::kCapacity);
+    CXXUI_CHECK(text.find(" W t") != std::string::npos);
+    CXXUI_CHECK(text.find("log records dropped code=0x0000000A\n") != std::string::npos);
+}
+
+CXXUI_TEST(log, disabled_after_stop) {
+    {
+        Capture capture;
+    }
+    std::size_t rings = Logger::GetInstance().GetRingCount();
+    LogFromThreads(2, 1);
+    CXXUI_CHECK(!Logger::GetInstance().IsEnabled());
+    CXXUI_CHECK_EQ(Logger::GetInstance().GetRingCount(), rings);
+}
@@ -0,0 +1,142 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cxxui/core/detail/page_cache.hpp>
+#include "test.hpp"
+
+using namespace cxxui::detail;
+
+namespace {
+
+using Cache = PageCache<int>;
+
+std::vector<int> Rows(int first, int count) {
+    std::vector<int> rows;
+    for (int i = 0; i < count; ++i) {
+        rows.push_back(first + i);
+    }
+    return rows;
+}
+
+std::string Name(std::string prefix, int i) {
+    prefix += std::to_string(i);
+    return prefix;
+}
+
+}  // namespace
+
+CXXUI_TEST(page_cache, find_put_evict) {
+    Cache cache(10, 2);
+    CXXUI_CHECK_EQ(cache.GetPage(25), 2u);
+    CXXUI_CHECK(!cache.Find(0, 0));
+    cache.Put(0, 0, Rows(0, 10));
+    cache.Put(0, 1, Rows(10, 10));
+    CXXUI_CHECK(cache.Find(0, 0));
+    // 第1页最久未使用, 被淘汰
+    cache.Put(0, 2, Rows(20, 10));
+    CXXUI_CHECK(cache.Contains(0, 0));
+    CXXUI_CHECK(!cache.Contains(0, 1));
+    CXXUI_CHECK_EQ(cache.Find(0, 2)->at(3), 23);
+    PageCacheStats stats = cache.GetStats();
+    CXXUI_CHECK_EQ(stats.hits, 2u);
+    CXXUI_CHECK_EQ(stats.misses, 1u);
+    CXXUI_CHECK_EQ(stats.evictions, 1u);
+    CXXUI_CHECK_EQ(stats.pages, 2u);
+    cache.SetMaxPages(1);
+    CXXUI_CHECK_EQ(cache.GetStats().pages, 1u);
+    CXXUI_CHECK(cache.Contains(0, 2));
+}
+
+CXXUI_TEST(page_cache, views_and_invalidate) {
+    Cache cache(10, 8);
+    Cache::ViewId sorted = cache.GetView("name", "");
+    CXXUI_CHECK(sorted != 0);
+    CXXUI_CHECK_EQ(cache.GetView("name", ""), sorted);
+    CXXUI_CHECK(cache.GetView("", "name") != sorted);
+    CXXUI_CHECK_EQ(cache.GetView("", ""), 0u);
+    cache.Put(0, 0, Rows(0, 10));
+    cache.Put(0, 3, Rows(30, 10));
+    cache.Put(sorted, 0, Rows(0, 10));
+    cache.SetTotal(0, 100);
+    cache.SetTotal(sorted, 50);
+    std::uint64_t generation = cache.GetGeneration();
+    // 原始视图只失效受影响的页, 其他视图整体失效
+    cache.Invalidate(31, 2);
+    CXXUI_CHECK(cache.GetGeneration() != generation);
+    CXXUI_CHECK(cache.Contains(0, 0));
+    CXXUI_CHECK(!cache.Contains(0, 3));
+    CXXUI_CHECK(!cache.Contains(sorted, 0));
+    CXXUI_CHECK_EQ(cache.GetTotal(0).value_or(0), 100u);
+    CXXUI_CHECK(!cache.GetTotal(sorted));
+    cache.InvalidateFrom(0);
+    CXXUI_CHECK(!cache.Contains(0, 0));
+    CXXUI_CHECK(!cache.GetTotal(0));
+}
+
+CXXUI_TEST(page_cache, views_are_bounded) {
+    Cache cache(10, 4);
+    // 不断变化的过滤条件不会让视图无限增长
+    for (int i = 0; i < 1000; ++i) {
+        Cache::ViewId view = cache.GetView("", Name("filter", i));
+        cache.SetTotal(view, 10);
+        if (i % 3 == 0) {
+            cache.Put(view, 0, Rows(i, 10));
+        }
+        CXXUI_CHECK(cache.GetStats().views <= 4u + 2u);
+    }
+    CXXUI_CHECK_EQ(cache.GetStats().pages, 4u);
+}
+
+CXXUI_TEST(page_cache, view_eviction_keeps_cached_pages) {
+    Cache cache(10, 2);
+    Cache::ViewId a = cache.GetView("a", "");
+    Cache::ViewId b = cache.GetView("b", "");
+    cache.Put(a, 0, Rows(0, 10));
+    cache.Put(b, 0, Rows(0, 10));
+    cache.SetTotal(a, 10);
+    // 只有空视图会被淘汰, 有缓存页的视图保留编号和总行数
+    for (int i = 0; i < 10; ++i) {
+        cache.GetView(Name("c", i), "");
+    }
+    CXXUI_CHECK_EQ(cache.GetView("a", ""), a);
+    CXXUI_CHECK_EQ(cache.GetView("b", ""), b);
+    CXXUI_CHECK_EQ(cache.GetTotal(a).value_or(0), 10u);
+    CXXUI_CHECK(cache.Contains(a, 0));
+    CXXUI_CHECK_EQ(cache.GetStats().views, 4u);
+}
+
+CXXUI_TEST(page_cache, evicted_view_ids_are_not_reused) {
+    Cache cache(10, 1);
+    Cache::ViewId first = cache.GetView("first", "");
+    std::uint64_t generation = cache.GetGeneration();
+    for (int i = 0; i < 3; ++i) {
+        CXXUI_CHECK(cache.GetView(Name("other", i), "") != first);
+    }
+    // 淘汰视图递增版本号, 持有旧编号的异步加载据此丢弃结果
+    CXXUI_CHECK(cache.GetGeneration() != generation);
+    CXXUI_CHECK(!cache.Contains(first, 0));
+    bool thrown = false;
+    try {
+        cache.Put(first, 0, Rows(0, 10));
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    CXXUI_CHECK(thrown);
+    // 重新查询得到新的视图
+    Cache::ViewId again = cache.GetView("first", "");
+    CXXUI_CHECK(again != first);
+    CXXUI_CHECK(!cache.GetTotal(again));
+}
+
+CXXUI_TEST(page_cache, prefetch_plan) {
+    PrefetchPlanner planner;
+    // 方向未知时两侧都预取 2 页, 近的先
+    CXXUI_CHECK(planner.Plan(0, 5, 6, 100) == (std::vector<PrefetchPlanner::PageId>{7, 4, 8, 3}));
+    // 向下滚动: 下方 2 页, 上方 1 页
+    CXXUI_CHECK(planner.Plan(0, 7, 8, 100) == (std::vector<PrefetchPlanner::PageId>{9, 6, 10}));
+    // 向上滚动, 不超过开头
+    CXXUI_CHECK(planner.Plan(0, 1, 2, 100) == (std::vector<PrefetchPlanner::PageId>{0, 3}));
+    // 不超过末尾
+    CXXUI_CHECK(planner.Plan(1, 9, 9, 10) == (std::vector<PrefetchPlanner::PageId>{8, 7}));
+}
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <cxxui/core/detail/pixel_kernels.hpp>
+#include <cxxui/core/detail/surface.hpp>
+#include "test.hpp"
+
+using namespace cxxui;
+using namespace cxxui::detail;
+
+namespace {
+
+/** 独立于内核实现的参考算法: 逐通道计算并四舍五入 */
+std::uint32_t RoundDiv255(std::uint32_t x) { return (x * 2 + 255) / 510; }
+std::uint32_t RefToPixel(const Color& c) {
+    std::uint32_t a = c.alpha;
+    return (a << 24) | (RoundDiv255(c.red * a) << 16) | (RoundDiv255(c.green * a) << 8) |
+           RoundDiv255(c.blue * a);
+}
+std::uint32_t RefBlend(std::uint32_t dst, std::uint32_t src) {
+    std::uint32_t inv = 255 - (src >> 24);
+    std::uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        std::uint32_t d = (dst >> shift) & 0xFF;
+        std::uint32_t s = (src >> shift) & 0xFF;
+        out |= (s + RoundDiv255(d * inv)) << shift;
+    }
+    return out;
+}
+
+/** 随机的预乘alpha像素, 各通道不超过alpha; 包含全透明和不透明的边界值 */
+std::uint32_t RandomPixel(std::mt19937& rng) {
+    std::uint32_t a;
+    switch (rng() % 4) {
+        case 0:
+            a = 0;
+            break;
+        case 1:
+            a = 255;
+            break;
+        default:
+            a = rng() % 256;
+            break;
+    }
+    std::uint32_t px = a << 24;
+    for (int shift = 0; shift < 24; shift += 8) {
+        px |= (a ? rng() % (a + 1) : 0) << shift;
+    }
+    return px;
+}
+
+Color RandomColor(std::mt19937& rng) {
+    return Color(static_cast<std::uint8_t>(rng()), static_cast<std::uint8_t>(rng()),
+                 static_cast<std::uint8_t>(rng()), static_cast<std::uint8_t>(rng()));
+}
+
+/** 处理区间前后各留的哨兵像素, 检查内核没有越界写入 */
+constexpr std::size_t kGuard = 9;
+constexpr std::uint32_t kSentinel = 0xDEADBEEF;
+/** 覆盖 SIMD 主循环和各种长度的尾部, 以及不对齐的起始地址 */
+constexpr std::size_t kMaxCount = 71;
+
+bool GuardsIntact(const std::vector<std::uint32_t>& buffer, std::size_t count) {
+    for (std::size_t i = 0; i < kGuard; ++i) {
+        if (buffer[i] != kSentinel || buffer[kGuard + count + i] != kSentinel) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+CXXUI_TEST(pixels, div255_exhaustive) {
+    std::size_t mismatches = 0;
+    for (std::uint32_t x = 0; x <= 255 * 255; ++x) {
+        mismatches += Div255(x) != RoundDiv255(x);
+    }
+    CXXUI_CHECK_EQ(mismatches, 0u);
+}
+
+CXXUI_TEST(pixels, blend_pixel_exhaustive_channels) {
+    // 所有 alpha 和通道值的组合, dst 的通道取遍 0..255
+    std::size_t mismatches = 0;
+    for (std::uint32_t a = 0; a < 256; ++a) {
+        for (std::uint32_t c = 0; c <= a; c += 3) {
+            std::uint32_t src = (a << 24) | (c << 16) | (c << 8) | (a - c);
+            for (std::uint32_t d = 0; d < 256; ++d) {
+                std::uint32_t dst = (d << 24) | (d << 16) | ((255 - d) << 8) | d;
+                mismatches += BlendPixel(dst, src) != RefBlend(dst, src);
+            }
+        }
+    }
+    CXXUI_CHECK_EQ(mismatches, 0u);
+}
+
+CXXUI_TEST(pixels, fill_lengths_and_guards) {
+    for (std::size_t count = 0; count <= kMaxCount; ++count) {
+        std::vector<std::uint32_t> buffer(count + 2 * kGuard, kSentinel);
+        FillPixels(buffer.data() + kGuard, count, 0x80402010);
+        CXXUI_CHECK(GuardsIntact(buffer, count));
+        for (std::size_t i = 0; i < count; ++i) {
+            CXXUI_CHECK_EQ(buffer[kGuard + i], 0x80402010u);
+        }
+    }
+}
+
+CXXUI_TEST(pixels, copy_lengths_and_guards) {
+    std::mt19937 rng(1);
+    for (std::size_t count = 0; count <= kMaxCount; ++count) {
+        std::vector<std::uint32_t> src(count);
+        for (auto& px : src) {
+            px = rng();
+        }
+        std::vector<std::uint32_t> buffer(count + 2 * kGuard, kSentinel);
+        CopyPixels(buffer.data() + kGuard, src.data(), count);
+        CXXUI_CHECK(GuardsIntact(buffer, count));
+        CXXUI_CHECK(std::equal(src.begin(), src.end(), buffer.begin() + kGuard));
+    }
+}
+
+CXXUI_TEST(pixels, blend_matches_reference) {
+    std::mt19937 rng(37);
+    std::size_t mismatches = 0;
+    for (int round = 0; round < 20; ++round) {
+        for (std::size_t count = 0; count <= kMaxCount; ++count) {
+            std::vector<std::uint32_t> src(count);
+            std::vector<std::uint32_t> buffer(count + 2 * kGuard, kSentinel);
+            std::vector<std::uint32_t> expected(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                src[i] = RandomPixel(rng);
+                buffer[kGuard + i] = RandomPixel(rng);
+                expected[i] = RefBlend(buffer[kGuard + i], src[i]);
+            }
+            BlendPixels(buffer.data() + kGuard, src.data(), count);
+            CXXUI_CHECK(GuardsIntact(buffer, count));
+            for (std::size_t i = 0; i < count; ++i) {
+                mismatches += buffer[kGuard + i] != expected[i];
+            }
+        }
+    }
+    CXXUI_CHECK_EQ(mismatches, 0u);
+}
+
+CXXUI_TEST(pixels, blend_fill_matches_reference) {
+    std::mt19937 rng(38);
+    std::size_t mismatches = 0;
+    for (int round = 0; round < 20; ++round) {
+        for (std::size_t count = 0; count <= kMaxCount; ++count) {
+            std::uint32_t pixel = RandomPixel(rng);
+            std::vector<std::uint32_t> buffer(count + 2 * kGuard, kSentinel);
+            std::vector<std::uint32_t> expected(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                buffer[kGuard + i] = RandomPixel(rng);
+                expected[i] = RefBlend(buffer[kGuard + i], pixel);
+            }
+            BlendFill(buffer.data() + kGuard, count, pixel);
+            CXXUI_CHECK(GuardsIntact(buffer, count));
+            for (std::size_t i = 0; i < count; ++i) {
+                mismatches += buffer[kGuard + i] != expected[i];
+            }
+        }
+    }
+    CXXUI_CHECK_EQ(mismatches, 0u);
+}
+
+CXXUI_TEST(pixels, colors_match_reference) {
+    std::mt19937 rng(39);
+    std::size_t mismatches = 0;
+    for (int round = 0; round < 20; ++round) {
+        for (std::size_t count = 0; count <= kMaxCount; ++count) {
+            std::vector<Color> colors(count);
+            for (auto& color : colors) {
+                color = RandomColor(rng);
+            }
+            std::vector<std::uint32_t> buffer(count + 2 * kGuard, kSentinel);
+            ColorsToPixels(buffer.data() + kGuard, colors.data(), count);
+            CXXUI_CHECK(GuardsIntact(buffer, count));
+            for (std::size_t i = 0; i < count; ++i) {
+                mismatches += buffer[kGuard + i] != RefToPixel(colors[i]);
+                mismatches += ToPixel(colors[i]) != RefToPixel(colors[i]);
+            }
+        }
+    }
+    CXXUI_CHECK_EQ(mismatches, 0u);
+}
+
+CXXUI_TEST(pixels, surface_clips_drawing) {
+    Surface surface;
+    surface.Resize(8, 4);
+    surface.Clear(Color(0, 0, 0, 255));
+    surface.FillRect({-5, -5, 2, 2}, Color(255, 0, 0, 255));
+    surface.FillRect({6, 3, 100, 100}, Color(0, 0, 255, 255));
+    const std::uint32_t* px = surface.GetPixels();
+    CXXUI_CHECK_EQ(px[0], 0xFFFF0000u);
+    CXXUI_CHECK_EQ(px[1 * 8 + 1], 0xFFFF0000u);
+    CXXUI_CHECK_EQ(px[1 * 8 + 2], 0xFF000000u);
+    CXXUI_CHECK_EQ(px[3 * 8 + 6], 0xFF0000FFu);
+    CXXUI_CHECK_EQ(px[3 * 8 + 7], 0xFF0000FFu);
+    CXXUI_CHECK_EQ(px[2 * 8 + 7], 0xFF000000u);
+    // 半透明填充与原内容混合
+    surface.FillRect({3, 0, 4, 1}, Color(255, 255, 255, 128));
+    CXXUI_CHECK_EQ(px[3], RefBlend(0xFF000000u, RefToPixel(Color(255, 255, 255, 128))));
+    // 绘制部分在缓冲区外的像素块, 只写入重叠的部分
+    std::vector<std::uint32_t> block(3 * 3, 0xFF00FF00u);
+    surface.DrawPixels({-1, 2}, block.data(), {3, 3}, 3, false);
+    CXXUI_CHECK_EQ(px[2 * 8 + 0], 0xFF00FF00u);
+    CXXUI_CHECK_EQ(px[2 * 8 + 1], 0xFF00FF00u);
+    CXXUI_CHECK_EQ(px[2 * 8 + 2], 0xFF000000u);
+    CXXUI_CHECK_EQ(px[3 * 8 + 1], 0xFF00FF00u);
+    surface.DrawPixels({100, 100}, block.data(), {3, 3}, 3);
+    surface.FillRect({5, 5, 2, 2}, Color(1, 2, 3));
+}
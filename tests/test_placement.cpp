@@ -0,0 +1,91 @@
+#include <vector>
+
+#include <cxxui/core/detail/placement.hpp>
+#include "test.hpp"
+
+using namespace cxxui;
+using namespace cxxui::detail;
+
+namespace {
+
+/** 三个显示器: 主屏 100%, 右侧 150%, 上方 125% */
+std::vector<MonitorInfo> MakeMonitors() {
+    return {
+        {{0, 0, 1920, 1080}, 1.0f},
+        {{1920, 0, 4480, 1440}, 1.5f},
+        {{0, -1200, 1920, -120}, 1.25f},
+    };
+}
+
+bool Equal(const Placement& a, const Placement& b) {
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+}  // namespace
+
+CXXUI_TEST(placement, find_monitor) {
+    auto monitors = MakeMonitors();
+    CXXUI_CHECK(FindMonitor(monitors, {10, 10}) == &monitors[0]);
+    CXXUI_CHECK(FindMonitor(monitors, {1920, 10}) == &monitors[1]);
+    CXXUI_CHECK(FindMonitor(monitors, {10, -500}) == &monitors[2]);
+    // 不在任何显示器上时取最近的
+    CXXUI_CHECK(FindMonitor(monitors, {-50, 500}) == &monitors[0]);
+    CXXUI_CHECK(FindMonitor(monitors, {5000, 100}) == &monitors[1]);
+    CXXUI_CHECK(FindMonitor(monitors, {100, -110}) == &monitors[2]);
+    CXXUI_CHECK(FindMonitor({}, {0, 0}) == nullptr);
+}
+
+CXXUI_TEST(placement, unchanged_without_center_or_scale) {
+    auto monitors = MakeMonitors();
+    Placement place{100, 200, 800, 600};
+    CXXUI_CHECK(Equal(PlaceWindow(monitors, {3000, 100}, place, false), place));
+    // 没有显示器时保持原样
+    place.center_x = place.center_y = true;
+    CXXUI_CHECK(Equal(PlaceWindow({}, {0, 0}, place, true), place));
+}
+
+CXXUI_TEST(placement, center_on_cursor_monitor) {
+    auto monitors = MakeMonitors();
+    Placement place{0, 0, 800, 600, true, true};
+    CXXUI_CHECK(Equal(PlaceWindow(monitors, {100, 100}, place, false), {560, 240, 800, 600}));
+    // 缩放的显示器上先放大再居中
+    CXXUI_CHECK(Equal(PlaceWindow(monitors, {3000, 100}, place, true), {2600, 270, 1200, 900}));
+    CXXUI_CHECK(Equal(PlaceWindow(monitors, {3000, 100}, place, false), {2800, 420, 800, 600}));
+    CXXUI_CHECK(Equal(PlaceWindow(monitors, {100, -500}, place, true), {460, -1035, 1000, 750}));
+}
+
+CXXUI_TEST(placement, right_edge_belongs_to_left_monitor) {
+    auto monitors = MakeMonitors();
+    Placement place{0, 0, 800, 600, true, true};
+    // 与 MonitorFromPoint 一致, 两个显示器交界上的光标归入左边的显示器
+    CXXUI_CHECK(Equal(PlaceWindow(monitors, {1920, 100}, place, true), {560, 240, 800, 600}));
+    CXXUI_CHECK(Equal(PlaceWindow(monitors, {1921, 100}, place, true), {2600, 270, 1200, 900}));
+}
+
+CXXUI_TEST(placement, scale_by_window_center) {
+    auto monitors = MakeMonitors();
+    // 窗口中心在上方 125% 的显示器, 按该比例放大, 左上角不变
+    Placement place{100, -1000, 400, 300};
+    CXXUI_CHECK(Equal(PlaceWindow(monitors, {100, 100}, place, true), {100, -1000, 500, 375}));
+    // 主屏上不缩放
+    Placement primary{100, 100, 400, 300};
+    CXXUI_CHECK(Equal(PlaceWindow(monitors, {3000, 100}, primary, true), primary));
+}
+
+CXXUI_TEST(placement, center_one_axis) {
+    auto monitors = MakeMonitors();
+    Placement place{0, 50, 800, 600, true, false};
+    // 只水平居中, 垂直位置保持
+    CXXUI_CHECK(Equal(PlaceWindow(monitors, {100, 100}, place, false), {560, 50, 800, 600}));
+    CXXUI_CHECK(Equal(PlaceWindow(monitors, {3000, 100}, place, true), {2600, 50, 1200, 900}));
+}
+
+CXXUI_TEST(placement, scaled_center_moves_to_lower_scale_monitor) {
+    // 左 150%, 右 100%; 放大后中心落到右边的显示器时改用 100% 并保持放大后的中心
+    std::vector<MonitorInfo> monitors{
+        {{0, 0, 1920, 1080}, 1.5f},
+        {{1920, 0, 3840, 1080}, 1.0f},
+    };
+    Placement place{1800, 100, 200, 100};
+    CXXUI_CHECK(Equal(PlaceWindow(monitors, {100, 100}, place, true), {1850, 125, 200, 100}));
+}
@@ -0,0 +1,182 @@
+#include <cctype>
+#include <cstddef>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <cxxui/web_win/impl/detail/request_view.hpp>
+#include "test.hpp"
+
+using namespace cxxui::detail;
+
+namespace {
+
+using Pairs = std::vector<std::pair<std::string, std::string>>;
+
+/** 逐字符解码的参考实现, 不完整的 % 转义原样保留 */
+std::string RefDecode(std::string_view input, bool plus_as_space) {
+    auto hex = [](char c) { return std::isxdigit(static_cast<unsigned char>(c)) != 0; };
+    std::string output;
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        if (plus_as_space && input[i] == '+') {
+            output += ' ';
+        } else if (input[i] == '%' && i + 2 < input.size() && hex(input[i + 1]) &&
+                   hex(input[i + 2])) {
+            std::string digits(input.substr(i + 1, 2));
+            output += static_cast<char>(std::stoi(digits, nullptr, 16));
+            i += 2;
+        } else {
+            output += input[i];
+        }
+    }
+    return output;
+}
+
+/** 按 & 拆分查询字符串的参考实现, 跳过空的参数 */
+Pairs RefQueries(std::string_view query) {
+    Pairs pairs;
+    while (!query.empty()) {
+        std::size_t end = query.find('&');
+        std::string_view pair = query.substr(0, end);
+        if (!pair.empty()) {
+            std::size_t eq = pair.find('=');
+            pairs.emplace_back(RefDecode(pair.substr(0, eq), true),
+                               eq == std::string_view::npos ? ""
+                                                            : RefDecode(pair.substr(eq + 1), true));
+        }
+        if (end == std::string_view::npos) {
+            break;
+        }
+        query.remove_prefix(end + 1);
+    }
+    return pairs;
+}
+
+/** 偏向 url 分隔符和转义字符的随机字符串, 偶尔加上 scheme 和主机 */
+std::string RandomUrl(std::mt19937& rng) {
+    static const std::string kAlphabet = "%%%++&&==??##//::aAfF09zZ.-  \xff\x80";
+    std::string url;
+    std::size_t size = rng() % 40;
+    for (std::size_t i = 0; i < size; ++i) {
+        url += rng() % 8 ? kAlphabet[rng() % kAlphabet.size()] : static_cast<char>(rng() % 256);
+    }
+    if (rng() % 3 == 0) {
+        url.insert(0, "http://localhost");
+    }
+    return url;
+}
+
+/** RFC 3986 附录 B 的正则表达式 */
+const std::regex& GetRfcRegex() {
+    static const std::regex regex(
+        R"(^(([A-Za-z][A-Za-z0-9+.\-]*):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#([\s\S]*))?)");
+    return regex;
+}
+
+constexpr int kIterations = 20000;
+
+}  // namespace
+
+CXXUI_TEST(request_view, split_known_urls) {
+    UrlParts parts = SplitUrl("http://localhost:8080/docs/a%20b.html?x=1&y#top");
+    CXXUI_CHECK(parts.scheme == "http");
+    CXXUI_CHECK(parts.authority == "localhost:8080");
+    CXXUI_CHECK(parts.path == "/docs/a%20b.html");
+    CXXUI_CHECK(parts.query == "x=1&y");
+    CXXUI_CHECK(parts.fragment == "top");
+    // 第一个字符不是字母时没有 scheme
+    parts = SplitUrl("1a:b");
+    CXXUI_CHECK(parts.scheme.empty());
+    CXXUI_CHECK(parts.path == "1a:b");
+    parts = SplitUrl("?#");
+    CXXUI_CHECK(parts.path.empty());
+    CXXUI_CHECK(parts.query.empty());
+    CXXUI_CHECK(parts.fragment.empty());
+}
+
+CXXUI_TEST(request_view, decode_known_inputs) {
+    std::string output;
+    PercentDecode("a%20b+c%2x%", output, true);
+    CXXUI_CHECK_EQ(output, std::string("a b c%2x%"));
+    CXXUI_CHECK(!NeedsPercentDecode("a+b", false));
+    CXXUI_CHECK(NeedsPercentDecode("a+b", true));
+    RequestView view("http://h/a%2Fb?k=v%26w&=x&&k=2&flag");
+    CXXUI_CHECK(view.GetPath() == "/a/b");
+    CXXUI_CHECK_EQ(view.GetQueries().size(), 4u);
+    CXXUI_CHECK(view.GetQuery("k") == std::string_view("v&w"));
+    CXXUI_CHECK(view.GetQuery("") == std::string_view("x"));
+    CXXUI_CHECK(view.GetQuery("flag") == std::string_view(""));
+    CXXUI_CHECK(!view.GetQuery("missing"));
+}
+
+CXXUI_TEST(request_view, random_split_matches_rfc) {
+    std::mt19937 rng(1);
+    for (int i = 0; i < kIterations; ++i) {
+        std::string url = RandomUrl(rng);
+        UrlParts parts = SplitUrl(url);
+        std::smatch match;
+        CXXUI_CHECK(std::regex_match(url, match, GetRfcRegex()));
+        if (parts.scheme != match[2].str() || parts.authority != match[4].str() ||
+            parts.path != match[5].str() || parts.query != match[7].str() ||
+            parts.fragment != match[9].str()) {
+            CXXUI_CHECK_EQ(url, std::string("<split matches rfc>"));
+            return;
+        }
+    }
+}
+
+CXXUI_TEST(request_view, random_decode_matches_reference) {
+    std::mt19937 rng(2);
+    for (int i = 0; i < kIterations; ++i) {
+        std::string url = RandomUrl(rng);
+        for (bool plus_as_space : {false, true}) {
+            std::string output;
+            PercentDecode(url, output, plus_as_space);
+            bool ok = output == RefDecode(url, plus_as_space) && output.size() <= url.size() &&
+                      (NeedsPercentDecode(url, plus_as_space) || output == url);
+            if (!ok) {
+                CXXUI_CHECK_EQ(url, std::string("<decode matches reference>"));
+                return;
+            }
+        }
+    }
+}
+
+CXXUI_TEST(request_view, random_queries_match_reference) {
+    std::mt19937 rng(3);
+    for (int i = 0; i < kIterations; ++i) {
+        std::string url = RandomUrl(rng);
+        RequestView view(url);
+        // 先解码路径, 查询参数解码到同一块缓冲区后路径仍然有效
+        std::string_view path = view.GetPath();
+        Pairs expected = RefQueries(SplitUrl(url).query);
+        const auto& queries = view.GetQueries();
+        bool ok = queries.size() == expected.size() && path == RefDecode(SplitUrl(url).path, false);
+        for (std::size_t j = 0; ok && j < expected.size(); ++j) {
+            ok = queries[j].first == expected[j].first && queries[j].second == expected[j].second;
+        }
+        if (ok && !expected.empty()) {
+            ok = view.GetQuery(expected[0].first) == std::string_view(expected[0].second);
+        }
+        if (!ok) {
+            CXXUI_CHECK_EQ(url, std::string("<queries match reference>"));
+            return;
+        }
+    }
+}
+
+CXXUI_TEST(request_view, headers_ignore_case) {
+    RequestView view("/");
+    view.SetMethod("POST");
+    view.AddHeader("Content-Type", "text/plain");
+    view.AddHeader("X-a", "1");
+    view.AddHeader("x-A", "2");
+    CXXUI_CHECK(view.GetMethod() == "POST");
+    CXXUI_CHECK_EQ(view.GetHeaders().size(), 3u);
+    CXXUI_CHECK(view.GetHeader("content-TYPE") == std::string_view("text/plain"));
+    CXXUI_CHECK(view.GetHeader("x-a") == std::string_view("1"));
+    CXXUI_CHECK(!view.GetHeader("x-b"));
+}
@@ -0,0 +1,78 @@
+#include <optional>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include <cxxui/web_win/impl/detail/script_batch.hpp>
+#include "node.hpp"
+#include "test.hpp"
+
+using namespace cxxui::detail;
+using namespace cxxui::test;
+using json = nlohmann::json;
+
+namespace {
+
+/** 在 node 中模拟页面, 每次提交单独作为一段脚本运行, 与 ExecuteScript 一样 */
+std::optional<std::string> RunScripts(const std::vector<std::string>& scripts) {
+    std::string page = "const vm = require('vm');\nconsole.error = () => {};\n";
+    page += "for (const script of " + json(scripts).dump() + ") {\n";
+    page += "    try { vm.runInThisContext(script); } catch (e) {}\n}\n";
+    return RunNode(page);
+}
+
+}  // namespace
+
+CXXUI_TEST(script_batch, take_resets) {
+    ScriptBatch batch;
+    CXXUI_CHECK(batch.IsEmpty());
+    batch.Add("a()");
+    batch.AddCall(0, "1");
+    batch.AddCall(1, "2");
+    batch.Add("b()");
+    batch.AddCall(0, "3");
+    CXXUI_CHECK_EQ(batch.GetCount(), 5u);
+    std::size_t size = batch.GetSize();
+    std::vector<std::string> scripts = batch.Take();
+    // 普通脚本原样单独提交, 连续的调用合并提交
+    CXXUI_CHECK_EQ(scripts.size(), 4u);
+    CXXUI_CHECK_EQ(scripts[0], std::string{"a()"});
+    CXXUI_CHECK(scripts[1].find("window.__cxxui_fn[0](1)") <
+                scripts[1].find("window.__cxxui_fn[1](2)"));
+    CXXUI_CHECK_EQ(scripts[2], std::string{"b()"});
+    CXXUI_CHECK(scripts[3].find("window.__cxxui_fn[0](3)") != std::string::npos);
+    std::size_t total = 0;
+    for (const std::string& script : scripts) {
+        total += script.size();
+    }
+    CXXUI_CHECK_EQ(size, total);
+    CXXUI_CHECK(batch.IsEmpty());
+    CXXUI_CHECK_EQ(batch.GetSize(), 0u);
+    CXXUI_CHECK(batch.Take().empty());
+}
+
+CXXUI_TEST(script_batch, scripts_keep_global_semantics) {
+    if (!HasNode()) {
+        return;
+    }
+    ScriptRegistry registry;
+    ScriptBatch batch;
+    batch.Add("var window = globalThis; var log = [];");
+    batch.Add(registry.GetDefinition(registry.Register("push", "(x) => log.push(x)")));
+    batch.Add("log.push(1) // 末尾的注释");
+    // 语法错误和异常都只影响自己这一段
+    batch.Add("this is not javascript");
+    batch.Add("throw new Error('failed')");
+    batch.AddCall(0, "2");
+    batch.AddCall(0, "undefined_variable");
+    batch.AddCall(0, "3");
+    // 顶层的 let/class 在之后的脚本中仍然有效, 重复声明只影响这一段
+    batch.Add("let counter = 4; class Point {}");
+    batch.Add("log.push(counter, typeof Point)");
+    batch.Add("let counter = 5");
+    batch.Add("log.push(counter)");
+    batch.Add("console.log(JSON.stringify(log))");
+    auto output = RunScripts(batch.Take());
+    CXXUI_CHECK(output.has_value());
+    CXXUI_CHECK_EQ(output.value_or(""), "[1,2,3,4,\"function\",4]\n");
+}
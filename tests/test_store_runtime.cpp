@@ -0,0 +1,217 @@
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include <cxxui/web_win/impl/detail/patch_log.hpp>
+#include <cxxui/web_win/impl/detail/store_runtime.hpp>
+#include "node.hpp"
+#include "test.hpp"
+
+using namespace cxxui::detail;
+using namespace cxxui::test;
+using json = nlohmann::json;
+
+namespace {
+
+/** 在 node 中模拟页面, 注入 store 运行时 */
+std::string MakePage() {
+    std::string script = "var window = globalThis;\n";
+    script.append(kStoreScript);
+    return script;
+}
+
+std::string Escape(std::string key) {
+    std::string out;
+    for (char c : key) {
+        if (c == '~') {
+            out.append("~0");
+        } else if (c == '/') {
+            out.append("~1");
+        } else {
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+/** 随机修改文档, 覆盖对象和数组的增删改、特殊字符的键和整体替换 */
+class RandomEditor {
+public:
+    explicit RandomEditor(unsigned seed)
+        : rng_(seed) {}
+
+    void Edit(PatchLog& log) {
+        std::vector<std::string> containers;
+        Collect(log.Get(), "", containers);
+        const std::string& path = containers[Pick(containers.size())];
+        const json& target = log.Get(path);
+        if (Pick(50) == 0) {
+            log.Reset(json{{"list", json::array()}, {"obj", MakeValue(2)}});
+        } else if (target.is_array()) {
+            std::size_t index = Pick(target.size() + 1);
+            std::string element = path + "/" + std::to_string(index);
+            switch (Pick(4)) {
+                case 0:
+                    log.Insert(index == target.size() ? path + "/-" : element, MakeValue(2));
+                    break;
+                case 1:
+                    if (index < target.size()) {
+                        log.Remove(element);
+                    }
+                    break;
+                default:
+                    log.Set(element, MakeValue(2));
+                    break;
+            }
+        } else {
+            static const char* const kKeys[] = {"a", "b", "a/b", "~c", "", "数据"};
+            std::string key = Escape(kKeys[Pick(std::size(kKeys))]);
+            if (Pick(3) == 0 && target.contains(json::json_pointer(path + "/" + key))) {
+                log.Remove(path + "/" + key);
+            } else {
+                log.Set(path + "/" + key, MakeValue(2));
+            }
+        }
+    }
+
+private:
+    std::mt19937 rng_;
+
+    std::size_t Pick(std::size_t n) {
+        return std::uniform_int_distribution<std::size_t>(0, n - 1)(rng_);
+    }
+    json MakeValue(int depth) {
+        switch (Pick(depth > 0 ? 5 : 3)) {
+            case 0:
+                return static_cast<int>(Pick(100));
+            case 1:
+                return "s" + std::to_string(Pick(10));
+            case 2:
+                return Pick(2) == 0 ? json(nullptr) : json(true);
+            case 3: {
+                json array = json::array();
+                for (std::size_t i = Pick(4); i > 0; --i) {
+                    array.push_back(MakeValue(depth - 1));
+                }
+                return array;
+            }
+            default: {
+                json object = json::object();
+                object["k" + std::to_string(Pick(3))] = MakeValue(depth - 1);
+                return object;
+            }
+        }
+    }
+    static void Collect(const json& value,
+                        const std::string& path,
+                        std::vector<std::string>& out) {
+        if (value.is_object()) {
+            out.push_back(path);
+            for (const auto& [key, child] : value.items()) {
+                Collect(child, path + "/" + Escape(key), out);
+            }
+        } else if (value.is_array()) {
+            out.push_back(path);
+            for (std::size_t i = 0; i < value.size(); ++i) {
+                Collect(value[i], path + "/" + std::to_string(i), out);
+            }
+        }
+    }
+};
+
+}  // namespace
+
+CXXUI_TEST(store_runtime, subscribe) {
+    if (!HasNode()) {
+        return;
+    }
+    std::string script = MakePage();
+    script.append(R"JS(
+const store = window.cxxui.store;
+const log = [];
+const off = store.subscribe('s', (state, patch) => log.push([state.n, patch.length]));
+store.apply('s', [{ op: 'replace', path: '', value: { n: 1 } }]);
+store.apply('s', [{ op: 'replace', path: '/n', value: 2 }, { op: 'add', path: '/m', value: 0 }]);
+store.apply('other', [{ op: 'replace', path: '', value: 5 }]);
+off();
+store.apply('s', [{ op: 'replace', path: '/n', value: 3 }]);
+console.log(JSON.stringify([log, store.get('s'), store.get('other'), store.get('none')]));
+)JS");
+    auto output = RunNode(script);
+    CXXUI_CHECK(output.has_value());
+    CXXUI_CHECK_EQ(output.value_or(""), "[[[1,1],[2,2]],{\"n\":3,\"m\":0},5,null]\n");
+}
+
+CXXUI_TEST(store_runtime, applies_patch_log) {
+    if (!HasNode()) {
+        return;
+    }
+    // PatchLog 合并后的补丁在页面中应用后与 C++ 端的文档一致
+    std::string script = MakePage();
+    std::vector<json> expected;
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        RandomEditor editor(seed);
+        PatchLog log(json{{"list", json::array({1, 2, 3})}, {"obj", json::object()}});
+        std::string name = json("doc" + std::to_string(seed)).dump();
+        script.append("window.cxxui.store.apply(").append(name).append(", ");
+        script.append(json::array({{{"op", "replace"}, {"path", ""}, {"value", log.Get()}}}).dump());
+        script.append(");\n");
+        for (int frame = 0; frame < 30; ++frame) {
+            for (int i = static_cast<int>(seed % 5); i >= 0; --i) {
+                editor.Edit(log);
+            }
+            script.append("window.cxxui.store.apply(").append(name).append(", ");
+            script.append(log.TakePatch()).append(");\n");
+            script.append("console.log(JSON.stringify(window.cxxui.store.get(").append(name);
+            script.append(")));\n");
+            expected.push_back(log.Get());
+        }
+    }
+    auto output = RunNode(script);
+    CXXUI_CHECK(output.has_value());
+    std::istringstream lines(output.value_or(""));
+    std::string line;
+    std::size_t count = 0;
+    while (std::getline(lines, line) && count < expected.size()) {
+        if (json::parse(line) != expected[count]) {
+            CXXUI_CHECK_EQ(line, expected[count].dump());
+            return;
+        }
+        ++count;
+    }
+    CXXUI_CHECK_EQ(count, expected.size());
+}
+
+CXXUI_TEST(store_runtime, invalid_path_throws_out_of_range) {
+    PatchLog log(json{{"list", json::array({1, 2})}, {"obj", json{{"a", 1}}}});
+    auto throws = [](auto&& edit) {
+        try {
+            edit();
+        } catch (const std::out_of_range&) {
+            return true;
+        } catch (...) {
+            return false;
+        }
+        return false;
+    };
+    // 格式错误的路径、不存在的父节点和无效的数组下标都抛出 std::out_of_range
+    CXXUI_CHECK(throws([&] { log.Set("no-slash", 1); }));
+    CXXUI_CHECK(throws([&] { log.Set("/missing/a", 1); }));
+    CXXUI_CHECK(throws([&] { log.Set("/list/x", 1); }));
+    CXXUI_CHECK(throws([&] { log.Set("/list/-1", 1); }));
+    CXXUI_CHECK(throws([&] { log.Set("/list/+1", 1); }));
+    CXXUI_CHECK(throws([&] { log.Set("/list/99999999999999999999", 1); }));
+    CXXUI_CHECK(throws([&] { log.Set("/list/3", 1); }));
+    CXXUI_CHECK(throws([&] { log.Set("/obj/a/b", 1); }));
+    CXXUI_CHECK(throws([&] { log.Insert("/obj/a", 1); }));
+    CXXUI_CHECK(throws([&] { log.Remove("/list/2"); }));
+    CXXUI_CHECK(throws([&] { log.Remove("/obj/b"); }));
+    CXXUI_CHECK(throws([&] { log.Get("/obj/b"); }));
+    // 失败的修改不产生操作
+    CXXUI_CHECK(!log.IsDirty());
+    log.Set("/list/2", 3);
+    CXXUI_CHECK_EQ(log.TakePatch(), R"([{"op":"add","path":"/list/2","value":3}])");
+}
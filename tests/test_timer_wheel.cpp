@@ -0,0 +1,126 @@
+#include <cstdint>
+#include <vector>
+
+#include <cxxui/core/detail/timer_wheel.hpp>
+#include "test.hpp"
+
+using namespace cxxui::detail;
+
+CXXUI_TEST(timer_wheel, fire_in_order) {
+    TimerWheel wheel{1000};
+    std::vector<int> log;
+    TimerNode a, b, c;
+    a.callback = [&] { log.push_back(1); };
+    b.callback = [&] { log.push_back(2); };
+    c.callback = [&] { log.push_back(3); };
+    wheel.Schedule(c, 30);
+    wheel.Schedule(a, 10);
+    wheel.Schedule(b, 20);
+    CXXUI_CHECK_EQ(wheel.Size(), 3u);
+    CXXUI_CHECK_EQ(wheel.Advance(1009), 0u);
+    CXXUI_CHECK_EQ(wheel.Advance(1020), 2u);
+    CXXUI_CHECK((log == std::vector<int>{1, 2}));
+    CXXUI_CHECK_EQ(wheel.Advance(2000), 1u);
+    CXXUI_CHECK((log == std::vector<int>{1, 2, 3}));
+    CXXUI_CHECK_EQ(wheel.Size(), 0u);
+    CXXUI_CHECK(!wheel.IsScheduled(a));
+    CXXUI_CHECK_EQ(wheel.Now(), 2000u);
+}
+
+CXXUI_TEST(timer_wheel, cascade_across_levels) {
+    // 起点不对齐, 延迟跨过第 1、2、3 层的边界
+    TimerWheel wheel{12345};
+    const std::uint64_t delays[] = {1, 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 300000};
+    std::vector<TimerNode> nodes(std::size(delays));
+    std::vector<std::uint64_t> fired(nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i].callback = [&wheel, &fired, i] { fired[i] = wheel.Now(); };
+        wheel.Schedule(nodes[i], delays[i]);
+    }
+    // 按 NextTick 一步步推进, 每个定时器都在准确的 tick 触发
+    while (auto next = wheel.NextTick()) {
+        wheel.Advance(*next);
+    }
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        CXXUI_CHECK_EQ(fired[i], 12345 + delays[i]);
+    }
+    // 一次推进很远也一样
+    TimerWheel jump{12345};
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        fired[i] = 0;
+        nodes[i].callback = [&fired, i] { ++fired[i]; };
+        jump.Schedule(nodes[i], delays[i]);
+    }
+    CXXUI_CHECK_EQ(jump.Advance(12345 + 1000000), nodes.size());
+    for (std::uint64_t count : fired) {
+        CXXUI_CHECK_EQ(count, 1u);
+    }
+}
+
+CXXUI_TEST(timer_wheel, cancel_after_cascade) {
+    TimerWheel wheel{0};
+    int fired = 0;
+    TimerNode node, other;
+    node.callback = [&] { ++fired; };
+    other.callback = [&] { ++fired; };
+    wheel.Schedule(node, 5000);
+    wheel.Schedule(other, 5001);
+    // 推进到 4096 时从第 2 层降级到低层
+    wheel.Advance(4100);
+    CXXUI_CHECK(wheel.IsScheduled(node));
+    wheel.Cancel(node);
+    CXXUI_CHECK(!wheel.IsScheduled(node));
+    CXXUI_CHECK_EQ(wheel.Size(), 1u);
+    // 重复取消没有影响
+    wheel.Cancel(node);
+    CXXUI_CHECK_EQ(wheel.Size(), 1u);
+    CXXUI_CHECK_EQ(wheel.Advance(6000), 1u);
+    CXXUI_CHECK_EQ(fired, 1);
+}
+
+CXXUI_TEST(timer_wheel, periodic_skips_missed_periods) {
+    TimerWheel wheel{0};
+    std::vector<std::uint64_t> fired;
+    TimerNode node;
+    node.callback = [&] { fired.push_back(wheel.Now()); };
+    wheel.Schedule(node, 16, 16);
+    CXXUI_CHECK_EQ(wheel.Advance(32), 2u);
+    CXXUI_CHECK((fired == std::vector<std::uint64_t>{16, 32}));
+    // 停顿 5 秒后只触发一次, 之后保持原来的相位
+    CXXUI_CHECK_EQ(wheel.Advance(5032 + 3), 1u);
+    CXXUI_CHECK(wheel.NextTick().value_or(0) <= 5040);
+    CXXUI_CHECK_EQ(wheel.Advance(5040), 1u);
+    CXXUI_CHECK_EQ(fired.back(), 5040u);
+    CXXUI_CHECK_EQ(wheel.Advance(5055), 0u);
+    CXXUI_CHECK_EQ(wheel.Advance(5056), 1u);
+    CXXUI_CHECK(wheel.IsScheduled(node));
+    // 回调中取消自己
+    node.callback = [&] { wheel.Cancel(node); };
+    CXXUI_CHECK_EQ(wheel.Advance(100000), 1u);
+    CXXUI_CHECK(!wheel.IsScheduled(node));
+    CXXUI_CHECK_EQ(wheel.Size(), 0u);
+}
+
+CXXUI_TEST(timer_wheel, next_tick) {
+    TimerWheel wheel{100};
+    CXXUI_CHECK(!wheel.NextTick());
+    TimerNode soon, later;
+    wheel.Schedule(later, 10000);
+    // 高层的槽位可能返回较早的降级时间点, 但不会晚于到期时间
+    auto next = wheel.NextTick();
+    CXXUI_CHECK(next.has_value());
+    CXXUI_CHECK(*next > 100 && *next <= 10100);
+    wheel.Schedule(soon, 7);
+    CXXUI_CHECK_EQ(wheel.NextTick().value_or(0), 107u);
+    wheel.Cancel(soon);
+    next = wheel.NextTick();
+    CXXUI_CHECK(next.has_value() && *next <= 10100);
+    // 只按 NextTick 推进也能到达真实的到期时间
+    int steps = 0;
+    while (later.slot != TimerWheel::kNoSlot && steps < 100) {
+        wheel.Advance(*wheel.NextTick());
+        ++steps;
+    }
+    CXXUI_CHECK_EQ(wheel.Now(), 10100u);
+    CXXUI_CHECK(!wheel.NextTick());
+}
@@ -0,0 +1,112 @@
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include <cxxui/core/trace.hpp>
+#include "test.hpp"
+
+using namespace cxxui::detail;
+
+CXXUI_TEST(trace, wrap_keeps_latest_in_order) {
+    auto ring = std::make_unique<TraceRing>(1);
+    CXXUI_CHECK(ring->Snapshot().empty());
+    const std::uint64_t total = TraceRing::kCapacity + 10;
+    for (std::uint64_t i = 0; i < total; ++i) {
+        ring->Push(TraceEvent{"event", 'X', i, i, 0});
+    }
+    CXXUI_CHECK_EQ(ring->GetDropped(), 10u);
+    auto events = ring->Snapshot();
+    CXXUI_CHECK_EQ(events.size(), TraceRing::kCapacity);
+    // 最旧的 10 个被覆盖, 其余按写入顺序导出
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        CXXUI_CHECK_EQ(events[i].ts, i + 10);
+    }
+}
+
+CXXUI_TEST(trace, snapshot_while_writing) {
+    // 写入的同时导出, 导出的事件必须完整且按顺序
+    auto ring = std::make_unique<TraceRing>(1);
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (std::uint64_t i = 1; i <= 200000; ++i) {
+            ring->Push(TraceEvent{"event", 'b', i, i * 2, i * 3});
+        }
+        done = true;
+    });
+    bool ok = true;
+    while (!done) {
+        std::uint64_t last = 0;
+        for (const auto& event : ring->Snapshot()) {
+            ok = ok && event.ts > last && event.dur == event.ts * 2 && event.id == event.ts * 3;
+            last = event.ts;
+        }
+    }
+    writer.join();
+    CXXUI_CHECK(ok);
+    CXXUI_CHECK_EQ(ring->Snapshot().size(), TraceRing::kCapacity);
+}
+
+CXXUI_TEST(trace, chrome_json_format) {
+    std::vector<std::shared_ptr<TraceRing>> rings{std::make_shared<TraceRing>(3),
+                                                  std::make_shared<TraceRing>(4)};
+    rings[0]->Push(TraceEvent{"scope \"a\"\\\n", 'X', 10, 5, 0});
+    rings[0]->Push(TraceEvent{"instant", 'i', 20, 0, 0});
+    rings[1]->Push(TraceEvent{"async", 'b', 30, 0, 7});
+    rings[1]->Push(TraceEvent{"async", 'e', 40, 0, 7});
+    std::ostringstream out;
+    WriteTraceEvents(out, rings);
+    auto json = nlohmann::json::parse(out.str());
+    CXXUI_CHECK(json["displayTimeUnit"] == "ms");
+    const auto& events = json["traceEvents"];
+    CXXUI_CHECK_EQ(events.size(), 4u);
+    for (const auto& event : events) {
+        CXXUI_CHECK(event["cat"] == "cxxui");
+        CXXUI_CHECK(event["pid"] == 1);
+    }
+    CXXUI_CHECK(events[0]["name"] == "scope \"a\"\\\n");
+    CXXUI_CHECK(events[0]["ph"] == "X");
+    CXXUI_CHECK(events[0]["tid"] == 3);
+    CXXUI_CHECK(events[0]["ts"] == 10);
+    CXXUI_CHECK(events[0]["dur"] == 5);
+    CXXUI_CHECK(events[1]["ph"] == "i");
+    CXXUI_CHECK(events[1]["s"] == "t");
+    CXXUI_CHECK(!events[1].contains("dur"));
+    CXXUI_CHECK(events[2]["ph"] == "b");
+    CXXUI_CHECK(events[2]["tid"] == 4);
+    CXXUI_CHECK(events[2]["id"] == 7);
+    CXXUI_CHECK(events[3]["ph"] == "e");
+    CXXUI_CHECK(events[3]["ts"] == 40);
+    // 没有事件时仍是合法的 json
+    std::ostringstream empty;
+    WriteTraceEvents(empty, {});
+    CXXUI_CHECK(nlohmann::json::parse(empty.str())["traceEvents"].empty());
+}
+
+CXXUI_TEST(trace, exited_thread_released_after_export) {
+    auto& registry = TraceRegistry::GetInstance();
+    std::shared_ptr<TraceRing> exited;
+    std::thread([&] {
+        TraceRecord('i', "exited");
+        exited = registry.GetRings().back();
+    }).join();
+    auto contains = [&] {
+        for (const auto& ring : registry.GetRings()) {
+            if (ring == exited) {
+                return true;
+            }
+        }
+        return false;
+    };
+    // 退出的线程在导出前仍保留, 导出后释放
+    CXXUI_CHECK(contains());
+    std::ostringstream out;
+    cxxui::WriteTrace(out);
+    CXXUI_CHECK(out.str().find("\"exited\"") != std::string::npos);
+    CXXUI_CHECK(!contains());
+    CXXUI_CHECK(exited.use_count() == 1);
+}
@@ -0,0 +1,320 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <cxxui/core/log.hpp>
+#include <cxxui/core/task.hpp>
+#include <cxxui/core/detail/ui_queue.hpp>
+#include "fake_ui_loop.hpp"
+#include "test.hpp"
+
+using namespace cxxui;
+using namespace cxxui::detail;
+using namespace cxxui::test;
+
+namespace {
+
+/** 执行时把编号追加到 log 的任务 */
+struct LogTask : UiTask {
+    LogTask(std::vector<int>& log, int id)
+        : log_(log),
+          id_(id) {
+        run = [](UiTask* task) {
+            auto* self = static_cast<LogTask*>(task);
+            self->log_.push_back(self->id_);
+        };
+    }
+    std::vector<int>& log_;
+    int id_;
+};
+
+/** 堆上的任务, 执行或丢弃后释放自己 */
+struct HeapTask : UiTask {
+    HeapTask(std::atomic<int>& runs, std::atomic<int>& drops)
+        : runs_(runs),
+          drops_(drops) {
+        run = [](UiTask* task) {
+            std::unique_ptr<HeapTask> self{static_cast<HeapTask*>(task)};
+            self->runs_.fetch_add(1);
+        };
+        drop = [](UiTask* task) {
+            std::unique_ptr<HeapTask> self{static_cast<HeapTask*>(task)};
+            self->drops_.fetch_add(1);
+        };
+    }
+    std::atomic<int>& runs_;
+    std::atomic<int>& drops_;
+};
+
+}  // namespace
+
+CXXUI_TEST(ui_queue, run_in_post_order) {
+    UiQueue queue;
+    std::vector<int> log;
+    LogTask a{log, 1}, b{log, 2}, c{log, 3};
+    CXXUI_CHECK(queue.IsEmpty());
+    queue.Post(a);
+    queue.Post(b);
+    queue.Post(c);
+    CXXUI_CHECK(!queue.IsEmpty());
+    CXXUI_CHECK(log.empty());
+    CXXUI_CHECK_EQ(queue.RunPending(), 3u);
+    CXXUI_CHECK(log == (std::vector<int>{1, 2, 3}));
+    CXXUI_CHECK(queue.IsEmpty());
+    CXXUI_CHECK_EQ(queue.RunPending(), 0u);
+}
+
+CXXUI_TEST(ui_queue, wake_once_per_batch) {
+    UiQueue queue;
+    int wakes = 0;
+    queue.SetWake([&wakes] { ++wakes; });
+    std::vector<int> log;
+    LogTask a{log, 1}, b{log, 2};
+    queue.Post(a);
+    queue.Post(b);
+    CXXUI_CHECK_EQ(wakes, 1);
+    queue.RunPending();
+    // 执行后再投递需要重新唤醒
+    queue.Post(a);
+    CXXUI_CHECK_EQ(wakes, 2);
+    queue.RunPending();
+    CXXUI_CHECK(log == (std::vector<int>{1, 2, 1}));
+}
+
+CXXUI_TEST(ui_queue, task_posted_while_running_runs_next_round) {
+    UiQueue queue;
+    std::vector<int> log;
+    LogTask inner{log, 2};
+    struct Reposter : UiTask {
+        UiQueue* queue;
+        LogTask* inner;
+        std::vector<int>* log;
+    } outer;
+    outer.queue = &queue;
+    outer.inner = &inner;
+    outer.log = &log;
+    outer.run = [](UiTask* task) {
+        auto* self = static_cast<Reposter*>(task);
+        self->log->push_back(1);
+        self->queue->Post(*self->inner);
+    };
+    queue.Post(outer);
+    CXXUI_CHECK_EQ(queue.RunPending(), 1u);
+    CXXUI_CHECK(log == (std::vector<int>{1}));
+    CXXUI_CHECK_EQ(queue.RunPending(), 1u);
+    CXXUI_CHECK(log == (std::vector<int>{1, 2}));
+}
+
+CXXUI_TEST(ui_queue, post_from_threads_to_fake_loop) {
+    constexpr int kThreads = 4;
+    constexpr int kTasks = 2000;
+    UiQueue queue;
+    FakeUiLoop loop{queue};
+    std::atomic<int> runs{0};
+    std::atomic<int> drops{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&] {
+            for (int k = 0; k < kTasks; ++k) {
+                queue.Post(*new HeapTask{runs, drops});
+            }
+        });
+    }
+    bool done = loop.PumpUntil([&] { return runs.load() == kThreads * kTasks; });
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CXXUI_CHECK(done);
+    CXXUI_CHECK_EQ(runs.load(), kThreads * kTasks);
+    CXXUI_CHECK_EQ(drops.load(), 0);
+    // 合并唤醒: 唤醒次数不超过任务数
+    CXXUI_CHECK(loop.GetWakes() <= static_cast<std::size_t>(kThreads * kTasks));
+}
+
+CXXUI_TEST(ui_queue, close_drops_pending_and_later_posts) {
+    std::atomic<int> runs{0};
+    std::atomic<int> drops{0};
+    UiQueue queue;
+    int wakes = 0;
+    queue.SetWake([&wakes] { ++wakes; });
+    CXXUI_CHECK(queue.Post(*new HeapTask{runs, drops}));
+    CXXUI_CHECK(queue.Post(*new HeapTask{runs, drops}));
+    CXXUI_CHECK_EQ(queue.Close(), 2u);
+    CXXUI_CHECK(queue.IsClosed());
+    CXXUI_CHECK_EQ(drops.load(), 2);
+    CXXUI_CHECK(!queue.Post(*new HeapTask{runs, drops}));
+    CXXUI_CHECK_EQ(drops.load(), 3);
+    CXXUI_CHECK_EQ(queue.RunPending(), 0u);
+    CXXUI_CHECK_EQ(runs.load(), 0);
+    CXXUI_CHECK_EQ(wakes, 1);
+    // 没有 drop 的节点直接丢弃
+    std::vector<int> log;
+    LogTask plain{log, 1};
+    CXXUI_CHECK(!queue.Post(plain));
+    CXXUI_CHECK(log.empty());
+}
+
+CXXUI_TEST(ui_queue, destroy_drops_pending) {
+    std::atomic<int> runs{0};
+    std::atomic<int> drops{0};
+    {
+        UiQueue queue;
+        queue.Post(*new HeapTask{runs, drops});
+    }
+    CXXUI_CHECK_EQ(runs.load(), 0);
+    CXXUI_CHECK_EQ(drops.load(), 1);
+}
+
+CXXUI_TEST(ui_queue, thread_exit_closes_shared_queue) {
+    std::atomic<int> runs{0};
+    std::atomic<int> drops{0};
+    std::shared_ptr<UiQueue> queue;
+    std::thread ui([&] {
+        queue = GetSharedUiQueue();
+        CXXUI_CHECK(&GetUiQueue() == queue.get());
+        queue->Post(*new HeapTask{runs, drops});
+    });
+    ui.join();
+    // UI线程退出后仍然持有队列, 投递的任务被丢弃而不是在其他线程执行
+    CXXUI_CHECK(queue->IsClosed());
+    CXXUI_CHECK(!queue->Post(*new HeapTask{runs, drops}));
+    CXXUI_CHECK_EQ(runs.load(), 0);
+    CXXUI_CHECK_EQ(drops.load(), 2);
+    CXXUI_CHECK(&GetUiQueue() != queue.get());
+}
+
+#if CXXUI_HAS_COROUTINE
+namespace {
+
+Task<> YieldTwice(std::vector<std::string>& log, std::string name) {
+    log.push_back(name + "0");
+    co_await Yield();
+    log.push_back(name + "1");
+    co_await Yield();
+    log.push_back(name + "2");
+}
+
+Task<int> Answer() {
+    co_await Yield();
+    co_return 42;
+}
+
+Task<int> Throw() {
+    co_await Yield();
+    throw std::runtime_error("failed");
+}
+
+Task<> Outer(std::vector<std::string>& log) {
+    int value = co_await Answer();
+    log.push_back(std::to_string(value));
+    try {
+        co_await Throw();
+        log.push_back("not thrown");
+    } catch (const std::runtime_error& e) {
+        log.push_back(e.what());
+    }
+}
+
+/** 析构时计数, 检查协程帧是否被销毁 */
+struct FrameGuard {
+    std::atomic<int>& destroyed;
+    ~FrameGuard() { ++destroyed; }
+};
+
+Task<> YieldForever(std::atomic<int>& destroyed) {
+    FrameGuard guard{destroyed};
+    for (;;) {
+        co_await Yield();
+    }
+}
+
+Task<> AwaitForever(std::atomic<int>& destroyed) {
+    FrameGuard guard{destroyed};
+    co_await YieldForever(destroyed);
+}
+
+/** 模拟消息循环, 执行UI队列直到没有任务 */
+std::size_t Drain() {
+    std::size_t rounds = 0;
+    while (GetUiQueue().RunPending()) {
+        ++rounds;
+    }
+    return rounds;
+}
+
+}  // namespace
+
+CXXUI_TEST(task, spawn_runs_until_first_suspend) {
+    std::vector<std::string> log;
+    Spawn(YieldTwice(log, "a"));
+    CXXUI_CHECK(log == (std::vector<std::string>{"a0"}));
+    CXXUI_CHECK_EQ(GetUiQueue().RunPending(), 1u);
+    CXXUI_CHECK(log == (std::vector<std::string>{"a0", "a1"}));
+    CXXUI_CHECK_EQ(Drain(), 1u);
+    CXXUI_CHECK(log == (std::vector<std::string>{"a0", "a1", "a2"}));
+}
+
+CXXUI_TEST(task, yields_interleave_in_message_loop) {
+    std::vector<std::string> log;
+    Spawn(YieldTwice(log, "a"));
+    Spawn(YieldTwice(log, "b"));
+    Drain();
+    CXXUI_CHECK(log == (std::vector<std::string>{"a0", "b0", "a1", "b1", "a2", "b2"}));
+}
+
+CXXUI_TEST(task, await_value_and_exception) {
+    std::vector<std::string> log;
+    Spawn(Outer(log));
+    Drain();
+    CXXUI_CHECK(log == (std::vector<std::string>{"42", "failed"}));
+}
+CXXUI_TEST(task, detached_error_is_logged) {
+    std::string text;
+    StartLog([&text](std::string_view data) { text.append(data); }, LogFormat::TEXT,
+             std::chrono::hours{1});
+    Spawn(Throw());
+    Drain();
+    FlushLog();
+    StopLog();
+    // 没有等待者的异常记录为错误日志, 协程帧照常销毁
+    CXXUI_CHECK(text.find("Detached task failed") != std::string::npos);
+    CXXUI_CHECK(text.find("failed", text.find("Detached task failed") + 20) != std::string::npos);
+}
+CXXUI_TEST(task, empty_task_throws) {
+    std::string error;
+    auto await_empty = [](std::string& out) -> Task<> {
+        try {
+            co_await Task<int>{};
+        } catch (const std::logic_error& e) {
+            out = e.what();
+        }
+    };
+    CXXUI_CHECK(!Task<>{}.IsValid());
+    Spawn(await_empty(error));
+    CXXUI_CHECK(!error.empty());
+}
+
+CXXUI_TEST(task, closed_queue_destroys_frames) {
+    std::atomic<int> destroyed{0};
+    std::thread ui([&] {
+        Spawn(AwaitForever(destroyed));
+        GetUiQueue().RunPending();
+        CXXUI_CHECK_EQ(destroyed.load(), 0);
+    });
+    ui.join();
+    // UI线程退出时队列关闭, 挂起的协程和等待它的协程都被销毁
+    CXXUI_CHECK_EQ(destroyed.load(), 2);
+    // 队列关闭后挂起的协程在 Post 时被销毁
+    std::thread closed([&] {
+        GetUiQueue().Close();
+        Spawn(YieldForever(destroyed));
+    });
+    closed.join();
+    CXXUI_CHECK_EQ(destroyed.load(), 3);
+}
+#endif
@@ -0,0 +1,152 @@
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cxxui/core/detail/ui_threads.hpp>
+#include "test.hpp"
+
+using namespace cxxui::detail;
+
+namespace {
+
+/** 记录结束消息循环调用的后端 */
+struct RecordBackend {
+    using ThreadId = int;
+    using Window = int;
+    std::vector<std::pair<int, int>> quits;
+    void Quit(ThreadId thread, int exit_code) { quits.emplace_back(thread, exit_code); }
+};
+
+/**
+ * @brief 模拟多个UI线程的后端
+ * @details 每个线程的"消息循环"等待自己的退出码，Quit 相当于 PostThreadMessage(WM_QUIT)
+ */
+struct LoopBackend {
+    using ThreadId = int;
+    using Window = int;
+    struct Loops {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::map<int, int> exit_codes;
+    };
+    std::shared_ptr<Loops> loops = std::make_shared<Loops>();
+    void Quit(ThreadId thread, int exit_code) {
+        std::lock_guard<std::mutex> lock(loops->mutex);
+        loops->exit_codes.emplace(thread, exit_code);
+        loops->cv.notify_all();
+    }
+    /** 运行线程的消息循环直到收到退出 */
+    int Run(ThreadId thread) {
+        std::unique_lock<std::mutex> lock(loops->mutex);
+        loops->cv.wait(lock, [&] { return loops->exit_codes.count(thread) > 0; });
+        return loops->exit_codes[thread];
+    }
+};
+
+using Quits = std::vector<std::pair<int, int>>;
+
+}  // namespace
+
+CXXUI_TEST(ui_threads, first_thread_is_primary) {
+    UiThreadRegistry<RecordBackend> registry;
+    registry.Enter(1, 100);
+    registry.Enter(2, 200);
+    CXXUI_CHECK(registry.IsPrimary(1));
+    CXXUI_CHECK(!registry.IsPrimary(2));
+    CXXUI_CHECK(registry.IsMainWindow(2, 200));
+    CXXUI_CHECK(!registry.IsMainWindow(2, 100));
+    CXXUI_CHECK_EQ(registry.Size(), 2u);
+    // 主UI线程离开后没有主线程, 下一个进入的线程成为主线程
+    registry.Leave(1);
+    CXXUI_CHECK(!registry.IsPrimary(2));
+    registry.Enter(3, 300);
+    CXXUI_CHECK(registry.IsPrimary(3));
+}
+
+CXXUI_TEST(ui_threads, secondary_main_window_quits_own_thread) {
+    UiThreadRegistry<RecordBackend> registry;
+    registry.Enter(1, 100);
+    registry.Enter(2, 200);
+    // 不是主窗口的窗口不影响消息循环
+    CXXUI_CHECK(!registry.OnWindowDestroyed(2, 201));
+    CXXUI_CHECK(!registry.OnWindowDestroyed(3, 200));
+    CXXUI_CHECK(registry.GetBackend().quits.empty());
+    CXXUI_CHECK(registry.OnWindowDestroyed(2, 200));
+    CXXUI_CHECK(registry.GetBackend().quits == (Quits{{2, 0}}));
+    // 同一个窗口的重复通知不会再次结束
+    CXXUI_CHECK(!registry.OnWindowDestroyed(2, 200));
+    CXXUI_CHECK_EQ(registry.GetBackend().quits.size(), 1u);
+}
+
+CXXUI_TEST(ui_threads, primary_main_window_quits_all) {
+    UiThreadRegistry<RecordBackend> registry;
+    registry.Enter(1, 100);
+    registry.Enter(2, 200);
+    registry.Enter(3, 300);
+    CXXUI_CHECK(registry.OnWindowDestroyed(1, 100));
+    CXXUI_CHECK(registry.GetBackend().quits == (Quits{{1, 0}, {2, 0}, {3, 0}}));
+}
+
+CXXUI_TEST(ui_threads, nested_enter_replaces_main_window) {
+    UiThreadRegistry<RecordBackend> registry;
+    registry.Enter(1, 100);
+    registry.Enter(1, 101);
+    CXXUI_CHECK_EQ(registry.Size(), 1u);
+    CXXUI_CHECK(!registry.OnWindowDestroyed(1, 100));
+    CXXUI_CHECK(registry.OnWindowDestroyed(1, 101));
+}
+
+CXXUI_TEST(ui_threads, exit_all_with_code) {
+    UiThreadRegistry<RecordBackend> registry;
+    CXXUI_CHECK_EQ(registry.ExitAll(3), 0u);
+    registry.Enter(1, 100);
+    registry.Enter(2, 200);
+    CXXUI_CHECK_EQ(registry.ExitAll(7), 2u);
+    CXXUI_CHECK(registry.GetBackend().quits == (Quits{{1, 7}, {2, 7}}));
+    registry.Leave(1);
+    registry.Leave(2);
+    CXXUI_CHECK_EQ(registry.Size(), 0u);
+}
+
+CXXUI_TEST(ui_threads, headless_threads_exit_with_primary) {
+    constexpr int kThreads = 8;
+    UiThreadRegistry<LoopBackend> registry;
+    LoopBackend backend = registry.GetBackend();
+    std::atomic<int> entered{0};
+    std::vector<int> exit_codes(kThreads, -1);
+    // 主UI线程先进入消息循环
+    registry.Enter(0, 1000);
+    std::vector<std::thread> threads;
+    for (int i = 1; i < kThreads; ++i) {
+        threads.emplace_back([&, i] {
+            registry.Enter(i, 1000 + i);
+            entered.fetch_add(1);
+            exit_codes[i] = backend.Run(i);
+            registry.Leave(i);
+        });
+    }
+    while (entered.load() < kThreads - 1) {
+        std::this_thread::yield();
+    }
+    // 次要线程的主窗口只结束自己
+    CXXUI_CHECK(registry.OnWindowDestroyed(3, 1003));
+    threads[2].join();
+    CXXUI_CHECK_EQ(exit_codes[3], 0);
+    CXXUI_CHECK_EQ(registry.Size(), static_cast<std::size_t>(kThreads - 1));
+    // 主窗口销毁时结束所有线程
+    CXXUI_CHECK(registry.OnWindowDestroyed(0, 1000));
+    exit_codes[0] = backend.Run(0);
+    registry.Leave(0);
+    for (int i = 1; i < kThreads; ++i) {
+        if (i != 3) {
+            threads[i - 1].join();
+        }
+    }
+    CXXUI_CHECK(exit_codes == std::vector<int>(kThreads, 0));
+    CXXUI_CHECK_EQ(registry.Size(), 0u);
+}
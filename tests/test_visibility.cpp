@@ -0,0 +1,202 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <cxxui/web_win/impl/detail/script_batch.hpp>
+#include <cxxui/web_win/impl/detail/visibility_policy.hpp>
+#include "test.hpp"
+
+using namespace cxxui::detail;
+using namespace std::chrono_literals;
+
+namespace {
+
+using TimePoint = VisibilityPolicy::TimePoint;
+
+/** 按窗口消息的顺序模拟事件, 记录每次事件后的状态 */
+struct Simulator {
+    VisibilityPolicy policy;
+    TimePoint now{std::chrono::hours{1}};
+
+    VisibilityState Show(bool visible) {
+        policy.SetVisible(visible, now);
+        return policy.Update(now);
+    }
+    VisibilityState Minimize(bool minimized) {
+        policy.SetMinimized(minimized, now);
+        return policy.Update(now);
+    }
+    VisibilityState Activate(bool active) {
+        policy.SetActive(active, now);
+        return policy.Update(now);
+    }
+    /** 时间前进 d 后的状态 */
+    VisibilityState Advance(VisibilityOptions::Duration d) {
+        now += d;
+        return policy.Update(now);
+    }
+};
+
+VisibilityState State(bool paused, bool low_memory, bool suspended) {
+    VisibilityState state;
+    state.paused = paused;
+    state.low_memory = low_memory;
+    state.suspended = suspended;
+    return state;
+}
+
+}  // namespace
+
+CXXUI_TEST(visibility, foreground_keeps_resources) {
+    Simulator sim;
+    CXXUI_CHECK(sim.policy.Update(sim.now) == State(false, false, false));
+    CXXUI_CHECK(!sim.policy.GetNextDeadline(sim.now));
+    // 默认失去焦点不降低内存
+    CXXUI_CHECK(sim.Activate(false) == State(false, false, false));
+    CXXUI_CHECK(!sim.policy.GetNextDeadline(sim.now));
+}
+
+CXXUI_TEST(visibility, hide_pauses_then_suspends) {
+    Simulator sim;
+    CXXUI_CHECK(sim.Show(false) == State(true, true, false));
+    auto deadline = sim.policy.GetNextDeadline(sim.now);
+    CXXUI_CHECK(deadline && *deadline == sim.now + 30s);
+    CXXUI_CHECK(sim.Advance(29s) == State(true, true, false));
+    CXXUI_CHECK(sim.Advance(1s) == State(true, true, true));
+    CXXUI_CHECK(!sim.policy.GetNextDeadline(sim.now));
+    CXXUI_CHECK(sim.Show(true) == State(false, false, false));
+}
+
+CXXUI_TEST(visibility, minimize_and_hide_overlap) {
+    Simulator sim;
+    sim.Minimize(true);
+    sim.Advance(10s);
+    // 最小化后再隐藏不重新计时
+    CXXUI_CHECK(sim.Show(false) == State(true, true, false));
+    CXXUI_CHECK(sim.Advance(20s) == State(true, true, true));
+    // 只恢复一个条件仍然不可见
+    CXXUI_CHECK(sim.Minimize(false) == State(true, true, true));
+    CXXUI_CHECK(sim.Show(true) == State(false, false, false));
+    // 再次隐藏重新计时
+    sim.Minimize(true);
+    CXXUI_CHECK(sim.Advance(29s) == State(true, true, false));
+}
+
+CXXUI_TEST(visibility, repeated_events_do_not_restart) {
+    Simulator sim;
+    CXXUI_CHECK(sim.policy.SetVisible(false, sim.now));
+    sim.Advance(20s);
+    CXXUI_CHECK(!sim.policy.SetVisible(false, sim.now));
+    CXXUI_CHECK(sim.Advance(10s) == State(true, true, true));
+    CXXUI_CHECK(!sim.policy.SetActive(true, sim.now));
+}
+
+CXXUI_TEST(visibility, inactive_low_memory) {
+    Simulator sim;
+    VisibilityOptions options;
+    options.inactive_low_memory = 5s;
+    sim.policy.SetOptions(options);
+    CXXUI_CHECK(sim.Activate(false) == State(false, false, false));
+    auto deadline = sim.policy.GetNextDeadline(sim.now);
+    CXXUI_CHECK(deadline && *deadline == sim.now + 5s);
+    CXXUI_CHECK(sim.Advance(5s) == State(false, true, false));
+    CXXUI_CHECK(sim.Activate(true) == State(false, false, false));
+    // 重新失去焦点重新计时
+    CXXUI_CHECK(sim.Activate(false) == State(false, false, false));
+    CXXUI_CHECK(sim.Advance(4s) == State(false, false, false));
+}
+
+CXXUI_TEST(visibility, memory_pressure) {
+    Simulator sim;
+    sim.policy.SetMemoryPressure(true);
+    // 前台窗口不受影响
+    CXXUI_CHECK(sim.policy.Update(sim.now) == State(false, false, false));
+    CXXUI_CHECK(sim.Activate(false) == State(false, true, false));
+    sim.policy.SetMemoryPressure(false);
+    CXXUI_CHECK(sim.policy.Update(sim.now) == State(false, false, false));
+}
+
+CXXUI_TEST(visibility, options) {
+    Simulator sim;
+    VisibilityOptions options;
+    options.pause_when_hidden = false;
+    options.hidden_low_memory = 1s;
+    options.hidden_suspend = VisibilityOptions::kNever;
+    sim.policy.SetOptions(options);
+    CXXUI_CHECK(sim.Show(false) == State(false, false, false));
+    CXXUI_CHECK(sim.Advance(1s) == State(false, true, false));
+    CXXUI_CHECK(!sim.policy.GetNextDeadline(sim.now));
+    CXXUI_CHECK(sim.Advance(1h) == State(false, true, false));
+
+    options.enabled = false;
+    sim.policy.SetOptions(options);
+    CXXUI_CHECK(sim.policy.Update(sim.now) == State(false, false, false));
+    CXXUI_CHECK(!sim.policy.GetNextDeadline(sim.now));
+}
+
+CXXUI_TEST(visibility, paused_batch_limit) {
+    ScriptBatch batch;
+    std::string code(100, 'x');
+    std::size_t dropped = 0;
+    // 模拟长时间隐藏的窗口不断添加脚本, 每次添加前检查上限
+    for (int i = 0; i < 1000; ++i) {
+        dropped += batch.DropIfOver(1000);
+        batch.Add(code);
+        CXXUI_CHECK(batch.GetSize() <= 1000 + code.size() + 64);
+    }
+    CXXUI_CHECK(dropped > 0);
+    CXXUI_CHECK_EQ(dropped + batch.GetCount(), 1000u);
+    CXXUI_CHECK_EQ(batch.DropIfOver(0), 0u);
+    std::size_t count = batch.GetCount();
+    CXXUI_CHECK_EQ(batch.DropIfOver(1), count);
+    CXXUI_CHECK(batch.IsEmpty());
+    CXXUI_CHECK_EQ(batch.GetSize(), 0u);
+}
+
+CXXUI_TEST(visibility, paused_messages_keep_order) {
+    ScriptBatch batch;
+    JsMsgQueue msgs;
+    batch.Add("a()");
+    batch.Add("b()");
+    msgs.Push(batch, R"("m1")");
+    CXXUI_CHECK(batch.IsEmpty());
+    // 连续的消息之间没有脚本
+    msgs.Push(batch, R"("m2")");
+    batch.Add("c()");
+    CXXUI_CHECK_EQ(msgs.GetCount(), 4u);
+    auto entries = msgs.Take();
+    CXXUI_CHECK(msgs.IsEmpty());
+    CXXUI_CHECK_EQ(msgs.GetCount(), 0u);
+    CXXUI_CHECK_EQ(msgs.GetSize(), 0u);
+    CXXUI_CHECK_EQ(entries.size(), 2u);
+    CXXUI_CHECK_EQ(entries[0].script_count, 2u);
+    CXXUI_CHECK(entries[0].scripts == (std::vector<std::string>{"a()", "b()"}));
+    CXXUI_CHECK_EQ(entries[0].msg, std::string(R"("m1")"));
+    CXXUI_CHECK(entries[1].scripts.empty());
+    CXXUI_CHECK_EQ(entries[1].msg, std::string(R"("m2")"));
+    // 最后一条消息之后的脚本留在批次中
+    CXXUI_CHECK_EQ(batch.GetCount(), 1u);
+}
+
+CXXUI_TEST(visibility, paused_messages_limit) {
+    ScriptBatch batch;
+    JsMsgQueue msgs;
+    std::string msg(100, 'm');
+    std::size_t dropped = 0;
+    // 只发送消息也受上限约束
+    for (int i = 0; i < 100; ++i) {
+        msgs.Push(batch, msg);
+        dropped += msgs.DropIfOver(batch, 1000);
+        CXXUI_CHECK(msgs.GetSize() <= 1000);
+    }
+    CXXUI_CHECK(dropped > 0);
+    CXXUI_CHECK_EQ(dropped + msgs.GetCount(), 100u);
+    // 消息和批次中的脚本合计超过上限时一起丢弃
+    batch.Add(std::string(500, 'x'));
+    CXXUI_CHECK_EQ(msgs.DropIfOver(batch, 0), 0u);
+    std::size_t count = msgs.GetCount() + batch.GetCount();
+    CXXUI_CHECK_EQ(msgs.DropIfOver(batch, msgs.GetSize()), count);
+    CXXUI_CHECK(msgs.IsEmpty());
+    CXXUI_CHECK(batch.IsEmpty());
+    CXXUI_CHECK_EQ(batch.GetSize(), 0u);
+}
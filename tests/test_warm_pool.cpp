@@ -0,0 +1,108 @@
+#include <memory>
+#include <string>
+
+#include <cxxui/web_win/impl/detail/warm_pool.hpp>
+#include "test.hpp"
+
+using namespace cxxui::detail;
+
+namespace {
+
+/** 模拟异步创建: 开始创建 NeedRefill 个对象, 之后由测试决定成功或失败 */
+std::size_t StartRefill(WarmPool<std::unique_ptr<int>>& pool) {
+    std::size_t need = pool.NeedRefill();
+    for (std::size_t i = 0; i < need; ++i) {
+        pool.OnCreateStarted();
+    }
+    return need;
+}
+
+}  // namespace
+
+CXXUI_TEST(warm_pool, disabled_by_default) {
+    WarmPool<std::unique_ptr<int>> pool;
+    CXXUI_CHECK_EQ(pool.GetTarget(), 0u);
+    CXXUI_CHECK_EQ(pool.NeedRefill(), 0u);
+    CXXUI_CHECK(!pool.Acquire());
+    // 没有开启预创建时不算未命中
+    CXXUI_CHECK_EQ(pool.GetStats().misses, 0u);
+}
+
+CXXUI_TEST(warm_pool, refill_counts_pending) {
+    WarmPool<std::unique_ptr<int>> pool;
+    pool.SetTarget(2);
+    CXXUI_CHECK_EQ(StartRefill(pool), 2u);
+    // 后台创建中的对象也计入, 不会重复创建
+    CXXUI_CHECK_EQ(pool.NeedRefill(), 0u);
+    CXXUI_CHECK_EQ(pool.GetStats().pending, 2u);
+    pool.OnCreated(std::make_unique<int>(1));
+    CXXUI_CHECK_EQ(pool.NeedRefill(), 0u);
+    pool.OnCreated(std::make_unique<int>(2));
+    auto stats = pool.GetStats();
+    CXXUI_CHECK_EQ(stats.ready, 2u);
+    CXXUI_CHECK_EQ(stats.pending, 0u);
+}
+
+CXXUI_TEST(warm_pool, acquire_hits_in_order_then_misses) {
+    WarmPool<std::unique_ptr<int>> pool;
+    pool.SetTarget(2);
+    StartRefill(pool);
+    pool.OnCreated(std::make_unique<int>(1));
+    pool.OnCreated(std::make_unique<int>(2));
+    auto a = pool.Acquire();
+    CXXUI_CHECK(a && **a == 1);
+    CXXUI_CHECK_EQ(pool.NeedRefill(), 1u);
+    auto b = pool.Acquire();
+    CXXUI_CHECK(b && **b == 2);
+    CXXUI_CHECK(!pool.Acquire());
+    auto stats = pool.GetStats();
+    CXXUI_CHECK_EQ(stats.hits, 2u);
+    CXXUI_CHECK_EQ(stats.misses, 1u);
+    CXXUI_CHECK_EQ(pool.NeedRefill(), 2u);
+}
+
+CXXUI_TEST(warm_pool, stop_after_failures_in_row) {
+    WarmPool<std::unique_ptr<int>> pool;
+    pool.SetTarget(1);
+    for (std::size_t i = 0; i < WarmPool<std::unique_ptr<int>>::kMaxFailures; ++i) {
+        CXXUI_CHECK_EQ(StartRefill(pool), 1u);
+        pool.OnCreateFailed();
+    }
+    // 连续失败后停止补充, 重新设置目标后恢复
+    CXXUI_CHECK_EQ(pool.NeedRefill(), 0u);
+    CXXUI_CHECK_EQ(pool.GetStats().failures, 3u);
+    pool.SetTarget(1);
+    CXXUI_CHECK_EQ(pool.NeedRefill(), 1u);
+}
+
+CXXUI_TEST(warm_pool, success_resets_failures) {
+    WarmPool<std::unique_ptr<int>> pool;
+    pool.SetTarget(1);
+    for (int round = 0; round < 5; ++round) {
+        StartRefill(pool);
+        pool.OnCreateFailed();
+        StartRefill(pool);
+        pool.OnCreateFailed();
+        StartRefill(pool);
+        pool.OnCreated(std::make_unique<int>(round));
+        CXXUI_CHECK(pool.Acquire());
+    }
+    CXXUI_CHECK_EQ(pool.NeedRefill(), 1u);
+    CXXUI_CHECK_EQ(pool.GetStats().failures, 10u);
+}
+
+CXXUI_TEST(warm_pool, drain_releases_ready) {
+    WarmPool<std::unique_ptr<int>> pool;
+    pool.SetTarget(3);
+    StartRefill(pool);
+    for (int i = 0; i < 3; ++i) {
+        pool.OnCreated(std::make_unique<int>(i));
+    }
+    auto drained = pool.Drain();
+    CXXUI_CHECK_EQ(drained.size(), 3u);
+    CXXUI_CHECK_EQ(pool.GetStats().ready, 0u);
+    CXXUI_CHECK_EQ(pool.NeedRefill(), 3u);
+    // 目标调为 0 后不再补充
+    pool.SetTarget(0);
+    CXXUI_CHECK_EQ(pool.NeedRefill(), 0u);
+}